@@ -6,10 +6,14 @@ layout(location = 1) in float lifetime_particle;
 uniform mat4 modelMatrix;
 uniform vec3 billboardPosition;
 
+#include "cameraInstance.glsl"
+
 out float lifetimes_particle;
+flat out int cameraIndex_vertex;
 
 void main() {
 	// gl_Position = vec4(vertexPosition_model + billboardPosition, 1.0);
 	gl_Position = modelMatrix * vec4(vertexPosition_model, 1.0);
 	lifetimes_particle = lifetime_particle;
+	cameraIndex_vertex = GetCameraIndex();
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#version 430
+
+in vec2 fragmentUv;
+
+uniform sampler2D image;
+uniform vec2 imageUvScale;      // The part of the image this frame's render size uses
+uniform vec2 texelSize;
+
+out vec4 fragmentColor;
+
+// Clamped to the used part of the image, so the filter never reaches into the unused rest of it
+vec3 Tap(vec2 uv) {
+	return texture(image, min(uv, imageUvScale - 0.5 * texelSize)).rgb;
+}
+
+// 13 bilinear taps over a 6x6 texel footprint, so no texel of the level above is skipped
+vec3 Downsample(vec2 uv) {
+	vec3 a = Tap(uv + texelSize * vec2(-2.0, 2.0));
+	vec3 b = Tap(uv + texelSize * vec2(0.0, 2.0));
+	vec3 c = Tap(uv + texelSize * vec2(2.0, 2.0));
+	vec3 d = Tap(uv + texelSize * vec2(-2.0, 0.0));
+	vec3 e = Tap(uv);
+	vec3 f = Tap(uv + texelSize * vec2(2.0, 0.0));
+	vec3 g = Tap(uv + texelSize * vec2(-2.0, -2.0));
+	vec3 h = Tap(uv + texelSize * vec2(0.0, -2.0));
+	vec3 i = Tap(uv + texelSize * vec2(2.0, -2.0));
+	vec3 j = Tap(uv + texelSize * vec2(-1.0, 1.0));
+	vec3 k = Tap(uv + texelSize * vec2(1.0, 1.0));
+	vec3 l = Tap(uv + texelSize * vec2(-1.0, -1.0));
+	vec3 m = Tap(uv + texelSize * vec2(1.0, -1.0));
+
+	vec3 c0 = e * 0.125;
+	c0 += (a + c + g + i) * 0.03125;
+	c0 += (b + d + f + h) * 0.0625;
+	c0 += (j + k + l + m) * 0.125;
+	return c0;
+}
+
+void main() {
+	fragmentColor = vec4(Downsample(fragmentUv * imageUvScale), 1.0);
+}
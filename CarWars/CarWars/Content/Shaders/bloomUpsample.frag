@@ -0,0 +1,32 @@
+#version 430
+
+in vec2 fragmentUv;
+
+uniform sampler2D image;
+uniform vec2 imageUvScale;      // The part of the image this frame's render size uses
+uniform vec2 texelSize;
+
+out vec4 fragmentColor;
+
+// Clamped to the used part of the image, so the filter never reaches into the unused rest of it
+vec3 Tap(vec2 uv) {
+	return texture(image, min(uv, imageUvScale - 0.5 * texelSize)).rgb;
+}
+
+// 3x3 tent filter over the level below. Blended additively onto this level.
+vec3 Upsample(vec2 uv) {
+	vec3 c = Tap(uv) * 4.0;
+	c += Tap(uv + texelSize * vec2(-1.0, 0.0)) * 2.0;
+	c += Tap(uv + texelSize * vec2(1.0, 0.0)) * 2.0;
+	c += Tap(uv + texelSize * vec2(0.0, -1.0)) * 2.0;
+	c += Tap(uv + texelSize * vec2(0.0, 1.0)) * 2.0;
+	c += Tap(uv + texelSize * vec2(-1.0, -1.0));
+	c += Tap(uv + texelSize * vec2(1.0, -1.0));
+	c += Tap(uv + texelSize * vec2(-1.0, 1.0));
+	c += Tap(uv + texelSize * vec2(1.0, 1.0));
+	return c / 16.0;
+}
+
+void main() {
+	fragmentColor = vec4(Upsample(fragmentUv * imageUvScale), 1.0);
+}
@@ -0,0 +1,15 @@
+#include "cameras.glsl"
+
+// The cameras this draw is instanced to, one bit each
+uniform int cameraMask;
+
+// The camera for this instance, i.e. the gl_InstanceID'th camera in cameraMask
+int GetCameraIndex() {
+	int remaining = gl_InstanceID;
+	for (int i = 0; i < cameras.length(); ++i) {
+		if ((cameraMask & (1 << i)) == 0) continue;
+		if (remaining == 0) return i;
+		remaining--;
+	}
+	return 0;
+}
@@ -0,0 +1,8 @@
+// Every camera as uploaded by Graphics::LoadCameras, one per split-screen viewport
+struct Camera {
+	mat4 viewMatrix;
+	mat4 projectionMatrix;
+	mat4 viewProjectionMatrix;
+};
+
+layout (std430, binding = 3) buffer cameraData { Camera cameras[]; };
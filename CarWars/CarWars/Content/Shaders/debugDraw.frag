@@ -1,12 +1,13 @@
 #version 430
 
-uniform vec4 diffuseColor;
+in vec4 color;
+
 uniform float materialEmissiveness;
 
 out vec4 fragmentColor;
 out vec4 glowColor;
 
 void main() {
-	fragmentColor = diffuseColor;
+	fragmentColor = color;
 	glowColor = fragmentColor * materialEmissiveness;
 }
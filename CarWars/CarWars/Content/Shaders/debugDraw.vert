@@ -0,0 +1,22 @@
+#version 430
+#extension GL_ARB_shader_viewport_layer_array : enable
+
+layout(location = 0) in vec3 vertexPosition_model;
+// Above the mesh attributes, so meshes drawn from their own buffers take it from glVertexAttrib instead
+layout(location = 3) in vec4 vertexColor;
+
+// Identity for the line lists, which are already in world space
+uniform mat4 modelMatrix;
+
+out vec4 color;
+
+#include "cameraInstance.glsl"
+
+void main() {
+	int cameraIndex = GetCameraIndex();
+	gl_Position = cameras[cameraIndex].viewProjectionMatrix * modelMatrix * vec4(vertexPosition_model, 1);
+	color = vertexColor;
+#ifdef GL_ARB_shader_viewport_layer_array
+	gl_ViewportIndex = cameraIndex;
+#endif
+}
@@ -23,7 +23,7 @@ layout (std430, binding = 0) buffer pointLightData { PointLight pointLights[]; }
 layout (std430, binding = 1) buffer directionLightData { DirectionLight directionLights[]; };
 layout (std430, binding = 2) buffer spotLightData { SpotLight spotLights[]; };
 
-uniform mat4 viewMatrix;
+#include "cameras.glsl"
 
 uniform vec4 materialDiffuseColor;
 uniform vec4 materialSpecularColor;
@@ -47,6 +47,7 @@ in vec3 surfaceNormal_camera;
 in vec3 eyeDirection_camera;
 in vec2 fragmentUv;
 in vec4 shadowCoord;
+flat in int cameraIndex;
 
 out vec4 fragmentColor;
 out vec4 glowColor;
@@ -76,6 +77,8 @@ vec4 getColorFromLight(vec4 diffuseColor, vec3 lightDirection_camera, vec4 light
 }
 
 void main() {
+	mat4 viewMatrix = cameras[cameraIndex].viewMatrix;
+
 	// float bias = 0.005 * tan(acos(dot(surfaceNormal_camera, l)));
 	// bias = clamp(bias, 0, 0.01);
 	float bias = 0.005;
@@ -1,23 +1,34 @@
 #version 430
+#extension GL_ARB_shader_viewport_layer_array : enable
 
 layout(location = 0) in vec3 vertexPosition_model;
 layout(location = 1) in vec2 vertexUv;
 layout(location = 2) in vec3 vertexNormal_model;
 
 uniform mat4 modelMatrix;
-uniform mat4 viewMatrix;
-uniform mat4 modelViewProjectionMatrix;
 uniform mat4 depthBiasModelViewProjectionMatrix;
 
+// The depth pre-pass runs this too, so the lit pass's equal depth test has to see bit-identical depths
+invariant gl_Position;
+
+#include "cameraInstance.glsl"
+
 out vec3 fragmentPosition_camera;
 out vec3 surfaceNormal_camera;
 out vec3 eyeDirection_camera;
 out vec2 fragmentUv;
 out vec4 shadowCoord;
+flat out int cameraIndex;
 
 
 void main() {
-	gl_Position = modelViewProjectionMatrix * vec4(vertexPosition_model, 1);
+	cameraIndex = GetCameraIndex();
+	mat4 viewMatrix = cameras[cameraIndex].viewMatrix;
+
+	gl_Position = cameras[cameraIndex].viewProjectionMatrix * modelMatrix * vec4(vertexPosition_model, 1);
+#ifdef GL_ARB_shader_viewport_layer_array
+	gl_ViewportIndex = cameraIndex;
+#endif
 
 	vec3 vertexPosition_camera = (viewMatrix * modelMatrix * vec4(vertexPosition_model, 1)).xyz;
 	eyeDirection_camera = -vertexPosition_camera;
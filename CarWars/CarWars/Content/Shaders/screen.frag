@@ -3,9 +3,75 @@
 in vec2 fragmentUv;
 
 uniform sampler2D screen;
+uniform vec2 screenUvScale;     // The part of the screen this frame's render size uses
+uniform vec2 screenTexelSize;
+uniform bool screenScaled;
+uniform sampler2D bloom;
+uniform vec2 bloomUvScale;      // The part of the top bloom level this frame's render size uses
+uniform vec2 texelSize;
+uniform float bloomIntensity;
 
 out vec4 fragmentColor;
 
+// Both are clamped to the part this frame uses, so no filter reaches into the unused rest
+vec3 ScreenTap(vec2 uv) {
+	return texture(screen, min(uv, screenUvScale - 0.5 * screenTexelSize)).rgb;
+}
+
+vec3 BloomTap(vec2 uv) {
+	return texture(bloom, min(uv, bloomUvScale - 0.5 * texelSize)).rgb;
+}
+
+// 3x3 tent filter over the top bloom level, which holds the whole chain by now
+vec3 Upsample(vec2 uv) {
+	vec3 c = BloomTap(uv) * 4.0;
+	c += BloomTap(uv + texelSize * vec2(-1.0, 0.0)) * 2.0;
+	c += BloomTap(uv + texelSize * vec2(1.0, 0.0)) * 2.0;
+	c += BloomTap(uv + texelSize * vec2(0.0, -1.0)) * 2.0;
+	c += BloomTap(uv + texelSize * vec2(0.0, 1.0)) * 2.0;
+	c += BloomTap(uv + texelSize * vec2(-1.0, -1.0));
+	c += BloomTap(uv + texelSize * vec2(1.0, -1.0));
+	c += BloomTap(uv + texelSize * vec2(-1.0, 1.0));
+	c += BloomTap(uv + texelSize * vec2(1.0, 1.0));
+	return c / 16.0;
+}
+
+// Catmull-Rom over the 4x4 texels around the pixel, folded into 9 bilinear taps. Keeps a screen rendered below the
+// window's resolution sharper than bilinear does. Clamped since its negative lobes can ring below zero.
+vec3 UpsampleScreen(vec2 uv) {
+	vec2 position = uv / screenTexelSize;
+	vec2 center = floor(position - 0.5) + 0.5;
+	vec2 f = position - center;
+
+	vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+	vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+	vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+	vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+	// The middle two texels on each axis are read with one bilinear tap
+	vec2 w12 = w1 + w2;
+	vec2 offset12 = w2 / w12;
+
+	vec2 uv0 = (center - 1.0) * screenTexelSize;
+	vec2 uv3 = (center + 2.0) * screenTexelSize;
+	vec2 uv12 = (center + offset12) * screenTexelSize;
+
+	vec3 c = ScreenTap(vec2(uv0.x, uv0.y)) * w0.x * w0.y;
+	c += ScreenTap(vec2(uv12.x, uv0.y)) * w12.x * w0.y;
+	c += ScreenTap(vec2(uv3.x, uv0.y)) * w3.x * w0.y;
+	c += ScreenTap(vec2(uv0.x, uv12.y)) * w0.x * w12.y;
+	c += ScreenTap(vec2(uv12.x, uv12.y)) * w12.x * w12.y;
+	c += ScreenTap(vec2(uv3.x, uv12.y)) * w3.x * w12.y;
+	c += ScreenTap(vec2(uv0.x, uv3.y)) * w0.x * w3.y;
+	c += ScreenTap(vec2(uv12.x, uv3.y)) * w12.x * w3.y;
+	c += ScreenTap(vec2(uv3.x, uv3.y)) * w3.x * w3.y;
+	return max(c, vec3(0.0));
+}
+
 void main() {
-	fragmentColor = vec4(texture(screen, fragmentUv).rgb, 1);
+	vec3 color = screenScaled ? UpsampleScreen(fragmentUv * screenUvScale) : ScreenTap(fragmentUv * screenUvScale);
+	if (bloomIntensity > 0.0) {
+		color += Upsample(fragmentUv * bloomUvScale) * bloomIntensity;
+	}
+	fragmentColor = vec4(color, 1);
 }
@@ -1,13 +1,19 @@
 #version 430
+#extension GL_ARB_shader_viewport_layer_array : enable
 
 layout (location = 0) in vec3 vertexPosition;
 
-uniform mat4 viewProjectionMatrix;
+#include "cameraInstance.glsl"
 
 out vec3 fragmentUv;
 
 void main() {
 	fragmentUv = vertexPosition;
+	int cameraIndex = GetCameraIndex();
+	mat4 viewProjectionMatrix = cameras[cameraIndex].projectionMatrix * mat4(mat3(cameras[cameraIndex].viewMatrix));
 	vec4 pos = viewProjectionMatrix * vec4(vertexPosition, 1.0);
+#ifdef GL_ARB_shader_viewport_layer_array
+	gl_ViewportIndex = cameraIndex;
+#endif
 	gl_Position = pos.xyww;
 }
\ No newline at end of file
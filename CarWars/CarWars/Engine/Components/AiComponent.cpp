@@ -13,6 +13,8 @@
 
 #include "../Entities/EntityManager.h"
 
+#include <algorithm>
+
 float AiComponent::MAX_DIFFICULTY;
 float AiComponent::STUCK_TIME;
 float AiComponent::UPDATE_TIME;
@@ -26,11 +28,6 @@ float AiComponent::ACCELERATION;
 
 
 
-AiComponent::~AiComponent() {
-    glDeleteBuffers(1, &pathVbo);
-    glDeleteVertexArrays(1, &pathVao);
-}
-
 AiComponent::AiComponent(nlohmann::json data) : vehicleEntity(nullptr), powerupEntity(nullptr), lastPathUpdate(0) {
 	MAX_DIFFICULTY = Game::gameData.MAX_AI_DIFFICULTY;
 	ACCELERATION = ContentManager::GetFromJson<float>(data["Acceleration"], .5f);
@@ -52,15 +49,16 @@ AiComponent::AiComponent(nlohmann::json data) : vehicleEntity(nullptr), powerupE
 
 	modeStartTime = Time(-UPDATE_TIME);
 	lastSearchTime = Time(-UPDATE_TIME);
-
-
-    InitializeRenderBuffers();
 }
 
 size_t AiComponent::GetPathLength() const {
     return path.size();
 }
 
+const std::vector<glm::vec3>& AiComponent::GetPath() const {
+    return path;
+}
+
 ComponentType AiComponent::GetType() {
     return ComponentType_AI;
 }
@@ -96,7 +94,6 @@ void AiComponent::UpdatePath(glm::vec3 _targetPosition) {
 
 	if (!newPath.empty() || FinishedPath()) {
 		path = newPath;
-		UpdateRenderBuffers();
 	}
 }
 
@@ -118,28 +115,6 @@ bool AiComponent::FinishedPath() const {
     return path.size() == 0;
 }
 
-
-void AiComponent::InitializeRenderBuffers() {
-    glGenBuffers(1, &pathVbo);
-    UpdateRenderBuffers();
-
-    glGenVertexArrays(1, &pathVao);
-    glBindVertexArray(pathVao);
-    glBindBuffer(GL_ARRAY_BUFFER, pathVbo);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<void*>(0));        // position
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-}
-
-void AiComponent::UpdateRenderBuffers() {
-    glBindBuffer(GL_ARRAY_BUFFER, pathVbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * path.size(), path.data(), GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-}
-
 Time AiComponent::GetModeDuration() {
 	return StateManager::gameTime - modeStartTime;
 }
@@ -192,7 +167,7 @@ void AiComponent::SetMode() {
 	AiData* myData = static_cast<AiData*>(Game::GetPlayerFromEntity(GetEntity()));
 	if (!enabled || !myData->alive) return;
 
-	VehicleComponent* vehicle = GetEntity()->GetComponent<VehicleComponent>();
+	VehicleComponent* vehicle = myData->vehicle;
 	float speed = vehicle->pxVehicle->computeForwardSpeed();
 
 	//detect being stuck
@@ -223,7 +198,7 @@ void AiComponent::Drive() {
 	AiData* myData = static_cast<AiData*>(Game::GetPlayerFromEntity(GetEntity()));
 	if (!enabled || !myData->alive) return;
 
-	VehicleComponent* vehicle = GetEntity()->GetComponent<VehicleComponent>();
+	VehicleComponent* vehicle = myData->vehicle;
 
 	// Driving Stuff
 	Transform &myTransform = GetEntity()->transform;
@@ -303,11 +278,12 @@ bool AiComponent::GetLineOfSight(glm::vec3 _position) {
 
 	PxQueryFilterData filterData;
 
-	filterData.data.word0 = RaycastGroups::GetGroupsMask(GetEntity()->GetComponent<VehicleComponent>()->GetRaycastGroup() | RaycastGroups::GetPowerUpGroup());
+	filterData.data.word0 = RaycastGroups::GetGroupsMask(myData->vehicle->GetRaycastGroup() | RaycastGroups::GetPowerUpGroup());
 
 	//PxQueryFilterData filterData;
 	//filterData.data.word0 = -1 ^ GetEntity()->GetComponent<VehicleComponent>()->GetRaycastGroup();  //TODO: remove powerups as well
-	VehicleComponent* enemyVehicleComponent = vehicleEntity->GetComponent<VehicleComponent>();
+	PlayerData* enemyData = Game::GetPlayerFromEntity(vehicleEntity);
+	VehicleComponent* enemyVehicleComponent = enemyData ? enemyData->vehicle : nullptr;
 	if (enemyVehicleComponent) filterData.data.word0 ^= enemyVehicleComponent->GetRaycastGroup();
 
 	//Raycast for line of sight
@@ -334,48 +310,29 @@ void AiComponent::FindTargets() {
 
 	bool foundTarget = false;
 
-	GameData gameData = Game::Instance().gameData;
-	std::vector<PlayerData*> players;
+	SpatialIndex& spatialIndex = Physics::Instance().GetSpatialIndex();
 
 	if (!(GetTargetEntity() && enemyData && enemyData->alive)) { // dont always scan to look for enemy stay locked on one
-		// get players
-		for (size_t i = 0; i < 4; ++i) {
-            HumanData& player = Game::humanPlayers[i];
-            if (!player.ready) continue;
-			players.push_back(&player);
-		}
-		for (size_t i = 0; i < gameData.aiCount; ++i) {
-			players.push_back(&Game::aiPlayers[i]);
-		}
+		//find attack target: closest enemy vehicle in targeting range that we can see
+		// The spatial index only visits the cells in range and skips our own team, so teammates are never resolved
+		SpatialQueryFilter enemyFilter;
+		enemyFilter.tag = "Vehicle";
+		enemyFilter.excludeTeam = static_cast<int>(myData->teamIndex);
+		enemyFilter.exclude = GetEntity();
 
-		//find attack target
-		float bestRating = INFINITY;
 		Entity* bestTarget = nullptr;
+		for (Entity* enemy : spatialIndex.QueryNearest(localPosition, Game::MAX_VEHICLE_COUNT, myData->difficulty * TARGETING_RANGE, enemyFilter)) {
+			PlayerData* enemyPlayer = Game::GetPlayerFromEntity(enemy);
+			if (!enemyPlayer || !enemyPlayer->alive) continue;
 
-		for (PlayerData* enemyPlayer : players) {
-			if ((enemyPlayer->teamIndex != myData->teamIndex) // if they are not on my team
-				&& enemyPlayer->vehicleEntity						 // have a vehicle
-				&& enemyPlayer->alive
-				&& !enemyPlayer->vehicleEntity->IsMarkedForDeletion()) {							 // are alive
-				glm::vec3 enemyPosition = enemyPlayer->vehicleEntity->transform.GetGlobalPosition();
-				float distanceToEnemy = glm::length(enemyPosition - localPosition);
-				if (distanceToEnemy < (myData->difficulty * TARGETING_RANGE)) { //see if they are in targeting range
-					//set target to entity and check line of sight
-					vehicleEntity = enemyPlayer->vehicleEntity;
-					bool sightOnTarget = GetLineOfSight(enemyPosition);
-					if (sightOnTarget) {
-						float rating = distanceToEnemy; // this is used to select who to attack
-						if (rating <= bestRating) {
-							if (rating < bestRating || distanceToEnemy < glm::length(localPosition - bestTarget->transform.GetGlobalPosition())) { // if two are same rating. attack the closer one
-								bestRating = rating;
-								bestTarget = enemyPlayer->vehicleEntity;
-							}
-						}
-					}
-				}
+			//set target to entity and check line of sight
+			vehicleEntity = enemy;
+			if (GetLineOfSight(enemy->transform.GetGlobalPosition())) {
+				bestTarget = enemy;
+				break;
 			}
 		}
-		if (bestRating == INFINITY) { // couldn't find a target
+		if (!bestTarget) { // couldn't find a target
 			UpdateMode(AiMode_GetPowerup);
 			vehicleEntity = nullptr;
 		}
@@ -386,25 +343,23 @@ void AiComponent::FindTargets() {
 
 	//find powerup
 	//TODO: pick a better one that is on your way to the vehicle target
-	std::vector<Component*> powerupComponents = EntityManager::GetComponents(ComponentType_PowerUpSpawner);
-	float bestDistance = INFINITY;
-	for (Component* component : powerupComponents) {
-		PowerUpSpawnerComponent* powerup = static_cast<PowerUpSpawnerComponent*>(component);
-		if (powerup->GetEntity()->GetId() != GetEntity()->GetId()) {
-			if (powerup->enabled && powerup->HasActivePowerup()) {
-				float distance = glm::length(powerup->GetEntity()->transform.GetGlobalPosition() - GetEntity()->transform.GetGlobalPosition());
-				if (distance < bestDistance) {
-					bestDistance = distance;
-					powerupEntity = powerup->GetEntity();
-				}
-			}
-		}
-	}
-	if (bestDistance == INFINITY) {
+	SpatialQueryFilter powerupFilter;
+	powerupFilter.tag = "PowerUpSpawner";
+	powerupFilter.exclude = GetEntity();
+	powerupFilter.accept = [](Entity* entity) {
+		PowerUpSpawnerComponent* powerup = entity->GetComponent<PowerUpSpawnerComponent>();
+		return powerup && powerup->enabled && powerup->HasActivePowerup();
+	};
+
+	const FrameVector<Entity*> powerups = spatialIndex.QueryNearest(GetEntity()->transform.GetGlobalPosition(), 1, INFINITY, powerupFilter);
+	if (powerups.empty()) {
 		UpdateMode(AiMode_Attack);
 		powerupEntity = nullptr;
-	}
-
+	}
+	else {
+		powerupEntity = powerups.front();
+	}
+
 	lastSearchTime = StateManager::gameTime;
 }
 
@@ -417,7 +372,7 @@ void AiComponent::Act() {
 	glm::vec3 localPosition = myData->vehicleEntity->transform.GetGlobalPosition();
 
 	if (previousMode == AiMode_Attack && mode != AiMode_Attack && myData->weaponType == WeaponType::RailGun) {
-		WeaponComponent* weapon = GetEntity()->GetComponent<WeaponComponent>();
+		WeaponComponent* weapon = myData->weapon;
 		RailGunComponent* railgun = static_cast<RailGunComponent*>(weapon);
 		if (railgun) railgun->ChargeRelease();
 		StopCharge();
@@ -428,7 +383,7 @@ void AiComponent::Act() {
 		glm::vec3 vehicleTargetPosition = vehicleEntity->transform.GetGlobalPosition();
 		distanceToTarget = glm::length(vehicleTargetPosition - localPosition);
 		lineOfSight = GetLineOfSight(vehicleTargetPosition);
-		WeaponComponent* weapon = GetEntity()->GetComponent<WeaponComponent>();
+		WeaponComponent* weapon = myData->weapon;
 
 		if (lineOfSight && distanceToTarget < (TARGETING_RANGE * myData->difficulty)) lostTargetTime = Time(-1);
 		if (!lineOfSight) LostTargetTime();
@@ -5,7 +5,6 @@
 #include <glm/detail/type_vec3.hpp>
 #include <deque>
 #include "../Systems/Time.h"
-#include <GL/glew.h>
 
 enum AiMode {
 	AiMode_GetPowerup,
@@ -14,12 +13,9 @@ enum AiMode {
 
 class AiComponent : public Component {
 public:
-    ~AiComponent() override;
     AiComponent(nlohmann::json data);
     size_t GetPathLength() const;
-
-    GLuint pathVbo;
-    GLuint pathVao;
+    const std::vector<glm::vec3>& GetPath() const;
 
     ComponentType GetType() override;
     void HandleEvent(Event* event) override;
@@ -95,7 +91,4 @@ private:
 
 	float distanceToTarget;
 	bool lineOfSight;
-
-    void InitializeRenderBuffers();
-    void UpdateRenderBuffers();
 };
\ No newline at end of file
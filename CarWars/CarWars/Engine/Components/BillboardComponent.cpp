@@ -1,5 +1,6 @@
 #include "BillboardComponent.h"
 #include "../Systems/Content/ContentManager.h"
+#include "../Systems/Content/ContentStreamer.h"
 #include "imgui/imgui.h"
 #include <glm/gtc/type_ptr.hpp>
 
@@ -7,7 +8,7 @@ BillboardComponent::BillboardComponent(nlohmann::json data) {
     transform = Transform(data);
 
     const std::string texturePath = ContentManager::GetFromJson<std::string>(data["Texture"], "DiamondPlate.jpg");
-    texture = ContentManager::GetTexture(texturePath);
+    texture = ContentStreamer::Instance().LoadTexture(texturePath);
 
     uvScale = ContentManager::JsonToVec2(data["UvScale"], glm::vec2(1.f));
 }
@@ -33,7 +34,7 @@ void BillboardComponent::RenderDebugGui() {
 }
 
 Texture* BillboardComponent::GetTexture() const {
-    return texture;
+    return texture.Get(ContentStreamer::Instance().GetPlaceholderTexture());
 }
 
 glm::vec2 BillboardComponent::GetUvScale() const {
@@ -3,6 +3,7 @@
 #include "Component.h"
 #include <json/json.hpp>
 #include "../Systems/Content/Texture.h"
+#include "../Systems/Content/ContentHandle.h"
 #include "../Entities/Transform.h"
 
 class BillboardComponent : public Component {
@@ -21,6 +22,6 @@ public:
 
     Transform transform;
 private:
-    Texture *texture;
+    ContentHandle<Texture> texture;
     glm::vec2 uvScale;
 };
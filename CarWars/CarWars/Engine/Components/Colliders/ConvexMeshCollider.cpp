@@ -41,21 +41,19 @@ void ConvexMeshCollider::InitializeGeometry(Mesh *mesh) {
     PxConvexMeshDesc convexDesc;
 	convexDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX; //| PxConvexFlag::e16_BIT_INDICES;
 
-	glm::vec3 *vertices = new glm::vec3[mesh->vertexCount];
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vbos[VBOs::Vertices]);
-	glGetBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3) * mesh->vertexCount, vertices);
+	std::vector<glm::vec3> vertices;
+	mesh->ReadVertices(vertices);
 
     convexDesc.points.count = mesh->vertexCount;
     convexDesc.points.stride = sizeof(glm::vec3);
-    convexDesc.points.data = vertices;
+    convexDesc.points.data = vertices.data();
 
-	glm::vec3 *triangles = new glm::vec3[mesh->triangleCount];
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->eabs[EABs::Triangles]);
-	glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(Triangle) * mesh->triangleCount, triangles);
+	std::vector<Triangle> triangles;
+	mesh->ReadTriangles(triangles);
 
     convexDesc.indices.count = mesh->triangleCount;
     convexDesc.indices.stride = sizeof(Triangle);
-    convexDesc.indices.data = triangles;
+    convexDesc.indices.data = triangles.data();
 
     convexMesh = nullptr;
     PxDefaultMemoryOutputStream buf;
@@ -65,9 +63,6 @@ void ConvexMeshCollider::InitializeGeometry(Mesh *mesh) {
         convexMesh = physics.GetApi().createConvexMesh(id);
     }
 
-	delete[] vertices;
-	delete[] triangles;
-
     InitializeGeometry();
 }
 
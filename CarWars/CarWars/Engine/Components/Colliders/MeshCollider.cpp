@@ -3,6 +3,7 @@
 #include "../../Systems/Content/Mesh.h"
 #include "../../Systems/Physics.h"
 #include "../../Systems/Content/ContentManager.h"
+#include "../../Systems/Content/MapPackage.h"
 #include <iostream>
 
 using namespace physx;
@@ -20,8 +21,21 @@ MeshCollider::MeshCollider(std::string _collisionGroup, physx::PxMaterial *_mate
 MeshCollider::MeshCollider(nlohmann::json data) : Collider(data), fromHeightMap(false) {
     if (data["HeightMap"].is_string()) {
         fromHeightMap = true;
-        HeightMap* map = ContentManager::GetHeightMap(data["HeightMap"]);
-        InitializeGeometry(map->GetMesh());
+        const std::string dirPath = data["HeightMap"];
+        HeightMap* map = ContentManager::GetHeightMap(dirPath);
+
+        // Use the package's cooked mesh when there is one, rather than reading the render mesh back and cooking it
+        MapPackage* package = ContentManager::GetMapPackage(dirPath);
+        if (package) {
+            mesh = map->GetMesh();
+            size_t size;
+            const PxU8* cooked = static_cast<const PxU8*>(package->GetCollision(size));
+            PxDefaultMemoryInputData readBuffer(const_cast<PxU8*>(cooked), static_cast<PxU32>(size));
+            triangleMesh = Physics::Instance().GetApi().createTriangleMesh(readBuffer);
+            InitializeGeometry();
+        } else {
+            InitializeGeometry(map->GetMesh());
+        }
     } else {
         InitializeGeometry(ContentManager::GetMesh(data["Mesh"]));
     }
@@ -38,46 +52,46 @@ Mesh* MeshCollider::GetRenderMesh() {
 void MeshCollider::InitializeGeometry(Mesh *renderMesh) {
 	mesh = renderMesh;
 
-	PxTriangleMeshDesc meshDesc;
-	//meshDesc.flags |= PxMeshFlag::e16_BIT_INDICES;
+	std::vector<glm::vec3> vertices;
+	mesh->ReadVertices(vertices);
 
-	glm::vec3 *vertices = new glm::vec3[mesh->vertexCount];
-	glBindBuffer(GL_ARRAY_BUFFER, mesh->vbos[VBOs::Vertices]);
-	glGetBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3) * mesh->vertexCount, vertices);
+	std::vector<Triangle> triangles;
+	mesh->ReadTriangles(triangles);
 
-	meshDesc.points.count = mesh->vertexCount;
-	meshDesc.points.stride = sizeof(glm::vec3);
-	meshDesc.points.data = vertices;
+	triangleMesh = nullptr;
+	PxDefaultMemoryOutputStream writeBuffer;
+	if (Cook(vertices, triangles, fromHeightMap, writeBuffer)) {
+		PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
+		triangleMesh = Physics::Instance().GetApi().createTriangleMesh(readBuffer);
+	}
+
+	InitializeGeometry();
+}
+
+bool MeshCollider::Cook(const std::vector<glm::vec3>& vertices, const std::vector<Triangle>& triangles, bool heightMap, PxOutputStream& stream) {
+	PxTriangleMeshDesc meshDesc;
 
-	glm::vec3 *triangles = new glm::vec3[mesh->triangleCount];
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->eabs[EABs::Triangles]);
-	glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(Triangle) * mesh->triangleCount, triangles);
+	meshDesc.points.count = static_cast<PxU32>(vertices.size());
+	meshDesc.points.stride = sizeof(glm::vec3);
+	meshDesc.points.data = vertices.data();
 
-	meshDesc.triangles.count = mesh->triangleCount;
+	meshDesc.triangles.count = static_cast<PxU32>(triangles.size());
 	meshDesc.triangles.stride = sizeof(Triangle);
-	meshDesc.triangles.data = triangles;
+	meshDesc.triangles.data = triangles.data();
 
 	Physics& physics = Physics::Instance();
 
     const PxCookingParams originalCookingParams = physics.GetCooking().getParams();
     PxCookingParams myCookingParams = originalCookingParams;
-    if (fromHeightMap) myCookingParams.meshPreprocessParams |= PxMeshPreprocessingFlag::eDISABLE_CLEAN_MESH;
+    if (heightMap) myCookingParams.meshPreprocessParams |= PxMeshPreprocessingFlag::eDISABLE_CLEAN_MESH;
     physics.GetCooking().setParams(myCookingParams);
 
-	triangleMesh = nullptr;
-	PxDefaultMemoryOutputStream writeBuffer;
 	PxTriangleMeshCookingResult::Enum result;
-	if (physics.GetCooking().cookTriangleMesh(meshDesc, writeBuffer, &result)) {
-		PxDefaultMemoryInputData readBuffer(writeBuffer.getData(), writeBuffer.getSize());
-		triangleMesh = physics.GetApi().createTriangleMesh(readBuffer);
-	}
-    
-    physics.GetCooking().setParams(originalCookingParams);
+	const bool cooked = physics.GetCooking().cookTriangleMesh(meshDesc, stream, &result);
 
-	delete[] vertices;
-	delete[] triangles;
+    physics.GetCooking().setParams(originalCookingParams);
 
-	InitializeGeometry();
+	return cooked;
 }
 
 void MeshCollider::InitializeGeometry() {
@@ -2,8 +2,10 @@
 
 #include "Collider.h"
 #include <json/json.hpp>
+#include <vector>
 
 class Mesh;
+struct Triangle;
 
 class MeshCollider : public Collider {
 public:
@@ -15,6 +17,9 @@ public:
 
     Mesh* GetRenderMesh() override;
 
+    // Cooks a triangle mesh into stream. Height map meshes skip PhysX's cleaning pass since they're generated clean.
+    static bool Cook(const std::vector<glm::vec3>& vertices, const std::vector<Triangle>& triangles, bool heightMap, physx::PxOutputStream& stream);
+
 protected:
 	void InitializeGeometry() override;
 
@@ -39,7 +39,7 @@ void GuiHelper::SelectNextGui(Entity* entity, int dir) {
     if (dir == 0) return;
     dir = dir == 0 ? 0 : dir < 0 ? -1 : 1;
 
-    std::vector<GuiComponent*> components = entity->GetComponents<GuiComponent>();
+    FrameVector<GuiComponent*> components = entity->GetComponents<GuiComponent>();
     for (auto it = components.begin(); it != components.end(); ++it) {
         // Find the currently selected GUI and make it not selected
         GuiComponent *gui = *it;
@@ -176,7 +176,7 @@ void GuiHelper::SetGuisSelected(std::string entityTag, bool selected, int player
 }
 
 void GuiHelper::DestroyGuis(Entity* entity) {
-	std::vector<GuiComponent*> guis = entity->GetComponents<GuiComponent>();
+	FrameVector<GuiComponent*> guis = entity->GetComponents<GuiComponent>();
 	for (GuiComponent* gui : guis) {
 		EntityManager::DestroyComponent(gui);
 	}
@@ -187,13 +187,13 @@ void GuiHelper::DestroyGuis(std::string entityTag, int playerIndex) {
 }
 
 void GuiHelper::SetGuiTexture(Entity* parent, int guiIndex, Texture* texture) {
-    vector<GuiComponent*> guis = parent->GetComponents<GuiComponent>();
+    FrameVector<GuiComponent*> guis = parent->GetComponents<GuiComponent>();
     if (guis.size() <= guiIndex) return;
     guis[guiIndex]->SetTexture(texture);
 }
 
 void GuiHelper::SetGuiText(Entity* entity, int guiIndex, std::string text) {
-    vector<GuiComponent*> guis = entity->GetComponents<GuiComponent>();
+    FrameVector<GuiComponent*> guis = entity->GetComponents<GuiComponent>();
     if (guis.size() <= guiIndex) return;
     guis[guiIndex]->SetText(text);
 }
@@ -340,7 +340,7 @@ void GuiHelper::SetGuiColors(std::string entityTag, glm::vec4 color, int playerI
 }
 
 void GuiHelper::GetGuisRecursive(Entity* parent, std::vector<GuiComponent*>& guis, std::unordered_set<GuiComponent*> ignoreList) {
-	std::vector<GuiComponent*> components = parent->GetComponents<GuiComponent>();
+	FrameVector<GuiComponent*> components = parent->GetComponents<GuiComponent>();
     for (GuiComponent* gui : components) {
         if (ignoreList.find(gui) != ignoreList.end()) continue;
         guis.push_back(gui);
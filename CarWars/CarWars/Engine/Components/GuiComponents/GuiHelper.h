@@ -100,7 +100,7 @@ public:
     static GuiComponent* GetFourthGui(std::string entityTag, int playerIndex = 0);
 
 	template <float Ease(float t, float b, float c, float d)>
-	static TTween<float, Ease>* TweenOpacityRecursive(Entity* parent, const float goalOpacity, const Time duration, Time& clock, std::unordered_set<GuiComponent*> ignoreList = {}) {
+	static TTween<float> TweenOpacityRecursive(Entity* parent, const float goalOpacity, const Time duration, Time& clock, std::unordered_set<GuiComponent*> ignoreList = {}) {
 		std::vector<GuiComponent*> guis = GetGuisRecursive(parent, ignoreList);
 
 		std::vector<glm::vec2> starts;
@@ -109,7 +109,7 @@ public:
 		}
 
 		auto tween = Effects::Instance().CreateTween<float, Ease>(0.f, 1.f, duration, clock);
-		tween->SetUpdateCallback([guis, starts, goalOpacity](float& value) mutable {
+		tween.SetUpdateCallback([guis, starts, goalOpacity](float& value) mutable {
 			for (size_t i = 0; i < guis.size(); ++i) {
 				GuiComponent* gui = guis[i];
 				glm::vec2 start = starts[i];
@@ -2,10 +2,10 @@
 #include "../GuiComponents/GuiComponent.h"
 #include "../../Systems/StateManager.h"
 #include "PennerEasing/Quint.h"
-#include "../../Systems/Effects.h"
+#include <glm/glm.hpp>
 
 OpacityEffect::OpacityEffect(Time duration, float _opacityMod, Time _tweenInTime, Time _tweenOutTime) :
-    GuiEffect(duration), opacityMod(_opacityMod), startedTweenIn(false), startedTweenOut(false), tweenInTime(_tweenInTime), tweenOutTime(_tweenOutTime) { }
+    GuiEffect(duration), opacityMod(_opacityMod), tweenInTime(_tweenInTime), tweenOutTime(_tweenOutTime) { }
 
 void OpacityEffect::Apply(GuiComponent* gui) {
     previousTextureOpacity = gui->GetTextureOpacity();
@@ -23,18 +23,17 @@ void OpacityEffect::Update(GuiComponent* gui) {
     float thisTextureOpacity = opacityMod;
     float thisFontOpacity = opacityMod;
 
-    // tweening in
-    if (!startedTweenIn && time <= startTime + tweenInTime) {
-        startedTweenIn = true;
-        Effects::Instance().CreateTween<float, easing::Quint::easeOut>(thisTextureOpacity, previousTextureOpacity, opacityMod, tweenInTime.GetSeconds(), StateManager::globalTime)->Start();
-        Effects::Instance().CreateTween<float, easing::Quint::easeOut>(thisFontOpacity, previousFontOpacity, opacityMod, tweenInTime.GetSeconds(), StateManager::globalTime)->Start();
-    }
-
-    // tweening out
-    if (!startedTweenOut && time >= expireTime - tweenOutTime) {
-        startedTweenOut = true;
-        Effects::Instance().CreateTween<float, easing::Quint::easeIn>(thisTextureOpacity, opacityMod, previousTextureOpacity, tweenOutTime.GetSeconds(), StateManager::globalTime)->Start();
-        Effects::Instance().CreateTween<float, easing::Quint::easeIn>(thisFontOpacity, opacityMod, previousFontOpacity, tweenOutTime.GetSeconds(), StateManager::globalTime)->Start();
+    // Ease here rather than with tweens, since the effect is already updated every frame
+    if (time < startTime + tweenInTime) {
+        // tweening in
+        const float t = easing::Quint::easeOut((time - startTime).GetSeconds(), 0.f, 1.f, tweenInTime.GetSeconds());
+        thisTextureOpacity = glm::mix(previousTextureOpacity, opacityMod, t);
+        thisFontOpacity = glm::mix(previousFontOpacity, opacityMod, t);
+    } else if (time > expireTime - tweenOutTime) {
+        // tweening out
+        const float t = easing::Quint::easeIn((time - (expireTime - tweenOutTime)).GetSeconds(), 0.f, 1.f, tweenOutTime.GetSeconds());
+        thisTextureOpacity = glm::mix(opacityMod, previousTextureOpacity, t);
+        thisFontOpacity = glm::mix(opacityMod, previousFontOpacity, t);
     }
     
     gui->SetTextureOpacity(thisTextureOpacity);
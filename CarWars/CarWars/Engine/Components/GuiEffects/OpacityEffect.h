@@ -16,9 +16,6 @@ private:
     float previousTextureOpacity;
     float previousFontOpacity;
 
-    bool startedTweenIn;
-    bool startedTweenOut;
-
     Time tweenInTime;
     Time tweenOutTime;
 };
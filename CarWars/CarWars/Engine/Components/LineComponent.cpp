@@ -3,11 +3,6 @@
 
 using namespace nlohmann;
 
-LineComponent::~LineComponent() {
-    glDeleteBuffers(1, &vbo);
-    glDeleteVertexArrays(1, &vao);
-}
-
 LineComponent::LineComponent(json data) {
     color = ContentManager::GetColorFromJson(data["Color"], glm::vec4(1.f, 0.f, 0.f, 1.f));
     if (data["Points"].is_array()) {
@@ -15,13 +10,9 @@ LineComponent::LineComponent(json data) {
             points.push_back(ContentManager::JsonToVec3(point));
         }
     }
-
-    InitializeRenderBuffers();
 }
 
-LineComponent::LineComponent(std::vector<glm::vec3> _points, glm::vec4 _color) : points(_points), color(_color) {
-    InitializeRenderBuffers();
-}
+LineComponent::LineComponent(std::vector<glm::vec3> _points, glm::vec4 _color) : points(_points), color(_color) {}
 
 ComponentType LineComponent::GetType() {
     return ComponentType_Line;
@@ -35,12 +26,10 @@ void LineComponent::RenderDebugGui() {
 
 void LineComponent::SetPoints(std::vector<glm::vec3> _points) {
     points = _points;
-    UpdateRenderBuffers();
 }
 
 void LineComponent::SetPoint(size_t index, glm::vec3 point) {
     points[index] = point;
-    UpdateRenderBuffers();
 }
 
 void LineComponent::SetPoint0(glm::vec3 point) {
@@ -55,7 +44,7 @@ void LineComponent::SetPoint2(glm::vec3 point) {
     SetPoint(2, point);
 }
 
-std::vector<glm::vec3> LineComponent::GetPoints() const {
+const std::vector<glm::vec3>& LineComponent::GetPoints() const {
     return points;
 }
 
@@ -86,28 +75,3 @@ glm::vec4 LineComponent::GetColor() const {
 size_t LineComponent::GetPointCount() const {
     return points.size();
 }
-
-GLuint LineComponent::GetVaoId() const {
-    return vao;
-}
-
-void LineComponent::InitializeRenderBuffers() {
-    glGenBuffers(1, &vbo);
-    UpdateRenderBuffers();
-
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<void*>(0));        // position
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-}
-
-void LineComponent::UpdateRenderBuffers() {
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * points.size(), points.data(), GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-}
@@ -1,5 +1,6 @@
 #include "MeshComponent.h"
 #include "../Systems/Content/ContentManager.h"
+#include "../Systems/Content/ContentStreamer.h"
 #include "../Entities/Entity.h"
 
 #include "imgui/imgui.h"
@@ -12,45 +13,55 @@ ComponentType MeshComponent::GetType() {
 void MeshComponent::HandleEvent(Event* event) {}
 
 MeshComponent::MeshComponent(nlohmann::json data) {
+    ContentStreamer& streamer = ContentStreamer::Instance();
+    const bool cylinder = ContentManager::GetFromJson<bool>(data["CylinderMesh"], false);
     if (data["HeightMap"].is_string()) {
         HeightMap* map = ContentManager::GetHeightMap(data["HeightMap"]);
-        mesh = map->GetMesh();
+        if (data["HeightMapChunk"].is_number()) {
+            mesh = ContentHandle<Mesh>(map->GetChunks()[data["HeightMapChunk"].get<size_t>()]);
+        } else {
+            mesh = ContentHandle<Mesh>(map->GetMesh());
+        }
+    } else if (cylinder) {
+        // Needs the real radius right away
+        mesh = ContentHandle<Mesh>(ContentManager::GetMesh(data["Mesh"]));
     } else {
-        mesh = ContentManager::GetMesh(data["Mesh"]);
+        mesh = streamer.LoadMesh(data["Mesh"]);
     }
 	material = ContentManager::GetMaterial(data["Material"]);
-	if (!data["Texture"].is_null()) texture = ContentManager::GetTexture(data["Texture"]);
-	else texture = nullptr;
+	if (!data["Texture"].is_null()) texture = streamer.LoadTexture(data["Texture"]);
 	uvScale = ContentManager::JsonToVec2(data["UvScale"], glm::vec2(1.f));
-    if (ContentManager::GetFromJson<bool>(data["CylinderMesh"], false)) MakeCylinder(mesh);
+    occluder = ContentManager::GetFromJson<bool>(data["Occluder"], false);
+    if (cylinder) MakeCylinder(GetMesh());
     transform = Transform(data);
 }
 
 MeshComponent::MeshComponent(MeshComponent* component) {
-	mesh = component->GetMesh();
+	mesh = component->mesh;
 	material = component->GetMaterial();
-	texture = component->GetTexture();
+	texture = component->texture;
 	uvScale = component->GetUvScale();
+    occluder = component->IsOccluder();
     transform = component->transform;
 }
 
-MeshComponent::MeshComponent(std::string meshPath, std::string materialPath) : texture(nullptr) {
-	mesh = ContentManager::GetMesh(meshPath);
+MeshComponent::MeshComponent(std::string meshPath, std::string materialPath) {
+	mesh = ContentStreamer::Instance().LoadMesh(meshPath);
 	material = ContentManager::GetMaterial(materialPath);
 }
 
 MeshComponent::MeshComponent(const std::string meshPath, const std::string materialPath, const std::string texturePath) : uvScale(glm::vec2(1.f)), transform(Transform()) {
-	mesh = ContentManager::GetMesh(meshPath);
+	mesh = ContentStreamer::Instance().LoadMesh(meshPath);
     material = ContentManager::GetMaterial(materialPath);
-    texture = ContentManager::GetTexture(texturePath);
+    texture = ContentStreamer::Instance().LoadTexture(texturePath);
 }
 
-MeshComponent::MeshComponent(std::string meshPath, Material *_material) : material(_material), uvScale(glm::vec2(1.f)), texture(nullptr) {
-	mesh = ContentManager::GetMesh(meshPath);
+MeshComponent::MeshComponent(std::string meshPath, Material *_material) : material(_material), uvScale(glm::vec2(1.f)) {
+	mesh = ContentStreamer::Instance().LoadMesh(meshPath);
 }
 
 Mesh* MeshComponent::GetMesh() const {
-	return mesh;
+	return mesh.Get(ContentStreamer::Instance().GetPlaceholderMesh());
 }
 
 Material* MeshComponent::GetMaterial() const {
@@ -58,13 +69,17 @@ Material* MeshComponent::GetMaterial() const {
 }
 
 Texture* MeshComponent::GetTexture() const {
-	return texture;
+	return texture.Get(ContentStreamer::Instance().GetPlaceholderTexture());
 }
 
 glm::vec2 MeshComponent::GetUvScale() const {
 	return uvScale;
 }
 
+bool MeshComponent::IsOccluder() const {
+    return occluder;
+}
+
 void MeshComponent::RenderDebugGui() {
     Component::RenderDebugGui();
     if (ImGui::TreeNode("Transform")) {
@@ -81,6 +96,10 @@ void MeshComponent::RenderDebugGui() {
 }
 
 void MeshComponent::SetTexture(Texture* _texture) {
+    texture = _texture ? ContentHandle<Texture>(_texture) : ContentHandle<Texture>();
+}
+
+void MeshComponent::SetTexture(ContentHandle<Texture> _texture) {
     texture = _texture;
 }
 
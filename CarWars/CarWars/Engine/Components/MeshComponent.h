@@ -6,6 +6,8 @@
 #include "../Entities/Transform.h"
 #include "../Systems/Content/Material.h"
 #include "../Systems/Content/Texture.h"
+#include "../Systems/Content/ContentHandle.h"
+#include "../Systems/Graphics/LodSelection.h"
 #include <json/json.hpp>
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -13,6 +15,7 @@
 class MeshComponent : public Component {
 public:
 	Transform transform;		// Temporary?
+    LodState lod;               // Levels Graphics drew the mesh at last frame
 
 	ComponentType GetType() override;
 	void HandleEvent(Event* event) override;
@@ -31,16 +34,21 @@ public:
 
 	void SetEntity(Entity* _entity) override;
 
+	// The placeholders are returned while the mesh or texture is still streaming in
 	Mesh* GetMesh() const;
 	Material* GetMaterial() const;
 	Texture* GetTexture() const;
 	glm::vec2 GetUvScale() const;
+    // Rasterized into the occlusion buffer to hide the models behind it (walls, pillars, the terrain)
+    bool IsOccluder() const;
 
     void RenderDebugGui() override;
     void SetTexture(Texture* _texture);
+    void SetTexture(ContentHandle<Texture> _texture);
 private:
-	Mesh *mesh;
+	ContentHandle<Mesh> mesh;
 	Material *material;
-	Texture *texture;
+	ContentHandle<Texture> texture;
 	glm::vec2 uvScale;
+    bool occluder = false;
 };
@@ -5,11 +5,6 @@
 #include <math.h>
 #include <glm/gtx/string_cast.hpp>
 
-ParticleEmitterComponent::~ParticleEmitterComponent() {
-    glDeleteVertexArrays(1, &vao);
-    glDeleteBuffers(1, &vbo);
-}
-
 ParticleEmitterComponent::ParticleEmitterComponent(nlohmann::json data) {
     transform = Transform(data);
 
@@ -41,33 +36,6 @@ ParticleEmitterComponent::ParticleEmitterComponent(nlohmann::json data) {
     lifetime = ContentManager::GetFromJson<double>(data["Lifetime"], 3.0);
     spawnRate = ContentManager::GetFromJson<double>(data["SpawnRate"], 0.1);
     nextSpawn = StateManager::globalTime + spawnRate;
-
-    InitializeBuffers();
-}
-
-void ParticleEmitterComponent::UpdateBuffers() {
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Particle) * particles.size(), particles.data(), GL_DYNAMIC_DRAW);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-}
-
-void ParticleEmitterComponent::InitializeBuffers() {
-    glGenBuffers(1, &vbo);
-    UpdateBuffers();
-
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
-
-    glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Particle), reinterpret_cast<const GLvoid*>(0));                  // position
-    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(Particle), reinterpret_cast<const GLvoid*>(sizeof(float) * 6));  // lifetime
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
 }
 
 void ParticleEmitterComponent::Update() {
@@ -151,11 +119,10 @@ void ParticleEmitterComponent::Sort(glm::vec3 cameraPosition) {
     std::sort(particles.begin(), particles.end(), [localCameraPosition](const Particle& lhs, const Particle& rhs) -> bool {
         return length(lhs.position - localCameraPosition) > length(rhs.position - localCameraPosition);
     });
-    UpdateBuffers();
 }
 
-GLuint ParticleEmitterComponent::GetVao() const {
-    return vao;
+const std::vector<Particle>& ParticleEmitterComponent::GetParticles() const {
+    return particles;
 }
 
 size_t ParticleEmitterComponent::GetParticleCount() const {
@@ -2,7 +2,6 @@
 
 #include "Component.h"
 #include <json/json.hpp>
-#include <GL/glew.h>
 #include <glm/detail/type_vec3.hpp>
 #include "../Systems/Content/Texture.h"
 #include "../Entities/Transform.h"
@@ -18,7 +17,6 @@ struct Particle {
 
 class ParticleEmitterComponent : public Component {
 public:
-    ~ParticleEmitterComponent();
     explicit ParticleEmitterComponent(nlohmann::json data);
 
     ComponentType GetType() override;
@@ -33,7 +31,7 @@ public:
     void Emit(size_t count = 1);
     void SetEmitScale(glm::vec3 _emitScale);
 
-    GLuint GetVao() const;
+    const std::vector<Particle>& GetParticles() const;
     size_t GetParticleCount() const;
 
     void SetEmitCount(size_t _emitCount);
@@ -68,10 +66,6 @@ public:
     Transform transform;
 
 private:
-
-    void UpdateBuffers();
-    void InitializeBuffers();
-
     size_t emitCount;
     size_t emitOnSpawn;
     float emitConeMinAngle;
@@ -102,7 +96,4 @@ private:
     Time nextSpawn;
 
     std::vector<Particle> particles;
-
-    GLuint vao;
-    GLuint vbo;
 };
@@ -7,19 +7,14 @@
 #include "../SpotLightComponent.h"
 
 PowerUp::~PowerUp() {
-    Effects::Instance().DestroyTween("Headlight" + std::to_string(player->id));
-    Effects::Instance().DestroyTween("PowerUpTweenIn" + std::to_string(player->id));
-    Effects::Instance().DestroyTween("PowerUpTweenOut" + std::to_string(player->id));
+    Effects::Instance().DestroyTween(TweenTag("Headlight", player->id));
+    Effects::Instance().DestroyTween(TweenTag("PowerUpTweenIn", player->id));
+    Effects::Instance().DestroyTween(TweenTag("PowerUpTweenOut", player->id));
 }
 
 PowerUp::PowerUp(Time a_duration) : duration(a_duration) {}
 
 void PowerUp::Collect(PlayerData* a_player) {
-	Entity *vehicle = a_player->vehicleEntity;
-	Audio::Instance().PlayAudio3D(Audio::Instance().Environment.powerup, vehicle->transform.GetGlobalPosition(), glm::vec3(0.f, 0.f, 0.f), 10.f);
-
-
-
     collectedTime = StateManager::gameTime;
     a_player->activePowerUp = this;
     player = a_player;
@@ -34,23 +29,23 @@ void PowerUp::TweenVignette() const {
     GuiComponent* gui = guiEntity->GetComponent<GuiComponent>();
 
     auto tweenIn = Effects::Instance().CreateTween<float, easing::Quint::easeOut>(0.f, 1.f, 0.25, StateManager::gameTime);
-    tweenIn->SetTag("PowerUpTweenIn" + std::to_string(human->id));
-    tweenIn->SetUpdateCallback([gui](float &value) mutable {
+    tweenIn.SetTag(TweenTag("PowerUpTweenIn", human->id));
+    tweenIn.SetUpdateCallback([gui](float &value) mutable {
         gui->SetTextureOpacity(value);
         gui->transform.SetScale(glm::mix(glm::vec3(100.f, 100.f, 0.f), glm::vec3(0.f, 0.f, 0.f), value));
     });
-    tweenIn->Start();
+    tweenIn.Start();
 
     const Time delay = duration - 1.0;
 
     auto tweenOut = Effects::Instance().CreateTween<float, easing::Quint::easeOut>(1.f, 0.f, duration - delay, StateManager::gameTime);
-    tweenOut->SetTag("PowerUpTweenOut" + std::to_string(human->id));
-    tweenOut->SetUpdateCallback([gui](float& value) mutable {
+    tweenOut.SetTag(TweenTag("PowerUpTweenOut", human->id));
+    tweenOut.SetUpdateCallback([gui](float& value) mutable {
         gui->SetTextureOpacity(value);
         gui->transform.SetScale(glm::mix(glm::vec3(100.f, 100.f, 0.f), glm::vec3(0.f, 0.f, 0.f), value));
     });
-    tweenOut->SetDelay(delay);
-    tweenOut->Start();
+    tweenOut.SetDelay(delay);
+    tweenOut.Start();
 }
 
 void PowerUp::Remove(bool force) {
@@ -59,25 +54,25 @@ void PowerUp::Remove(bool force) {
     if (force) {
         HumanData* human = Game::GetHumanFromEntity(player->vehicleEntity);
         if (human) {
-            Effects::Instance().DestroyTween("PowerUpTweenIn" + std::to_string(human->id));
-            Effects::Instance().DestroyTween("PowerUpTweenOut" + std::to_string(human->id));
+            Effects::Instance().DestroyTween(TweenTag("PowerUpTweenIn", human->id));
+            Effects::Instance().DestroyTween(TweenTag("PowerUpTweenOut", human->id));
             
             Entity* guiRoot = human->camera->GetGuiRoot();
             Entity* guiEntity = EntityManager::FindFirstChild(guiRoot, GetGuiName());
             GuiComponent* gui = guiEntity->GetComponent<GuiComponent>();
 
             auto tweenOut = Effects::Instance().CreateTween<float, easing::Quint::easeOut>(gui->GetTextureOpacity(), 0.f, 0.25, StateManager::gameTime);
-            tweenOut->SetUpdateCallback([gui](float& value) mutable {
+            tweenOut.SetUpdateCallback([gui](float& value) mutable {
                 gui->SetTextureOpacity(value);
                 gui->transform.SetScale(mix(glm::vec3(100.f, 100.f, 0.f), glm::vec3(0.f, 0.f, 0.f), value));
             });
-            tweenOut->Start();
+            tweenOut.Start();
         }
     }
 
 	if (!force) {
 		RemoveInternal();
-		std::vector<Entity*> headlights = EntityManager::FindChildren(player->vehicleEntity, "HeadLamp");
+		FrameVector<Entity*> headlights = EntityManager::FindChildren(player->vehicleEntity, "HeadLamp");
 		for (Entity* entity : headlights) {
 			SpotLightComponent* light = entity->GetComponent<SpotLightComponent>();
             MeshComponent* mesh = entity->GetComponent<MeshComponent>();
@@ -85,14 +80,14 @@ void PowerUp::Remove(bool force) {
 			const glm::vec3 start = light->GetColor();
 			const glm::vec3 end = glm::vec3(1.f);
 			auto tween = Effects::Instance().CreateTween<float, easing::Quint::easeOut>(0.f, 1.f, 2.0, StateManager::gameTime);
-			tween->SetTag("Headlight" + std::to_string(player->id) + std::to_string(entity->GetId()));
+			tween.SetTag(TweenTag("Headlight", player->id).Append(entity->GetId()));
             PlayerData* thePlayer = player;
-			tween->SetUpdateCallback([thePlayer, start, end, light, mesh](float& value) {
+			tween.SetUpdateCallback([thePlayer, start, end, light, mesh](float& value) {
                 if (!thePlayer->alive) return;
 				light->SetColor(glm::mix(start, end, value));
                 mesh->GetMaterial()->diffuseColor = glm::vec4(mix(mix(start, end, 0.25f), end, value), 1.f);
 			});
-			tween->Start();
+			tween.Start();
 		}
 	}
 
@@ -11,6 +11,8 @@
 #include "../SpotLightComponent.h"
 #include "PennerEasing/Quint.h"
 #include "../../Systems/Effects.h"
+#include "../../Events/EventBus.h"
+#include "../../Events/GameEvents.h"
 
 PowerUpSpawnerComponent::PowerUpSpawnerComponent(nlohmann::json data): RigidStaticComponent(data) {
     respawnDuration = ContentManager::GetFromJson<double>(data["RespawnDuration"], baseDuration);
@@ -71,9 +73,9 @@ void PowerUpSpawnerComponent::Collect(VehicleComponent* vehicle) {
     PlayerData* player = Game::GetPlayerFromEntity(vehicle->GetEntity());
     if (!player || player->activePowerUp) return;
 
-	std::vector<Entity*> headlights = EntityManager::FindChildren(vehicle->GetEntity(), "HeadLamp");
+	FrameVector<Entity*> headlights = EntityManager::FindChildren(vehicle->GetEntity(), "HeadLamp");
 	for (Entity* entity : headlights) {
-		Effects::Instance().DestroyTween("Headlight" + std::to_string(player->id));
+		Effects::Instance().DestroyTween(TweenTag("Headlight", player->id).Append(entity->GetId()));
 		SpotLightComponent* light = entity->GetComponent<SpotLightComponent>();
 		light->SetColor(activePowerUp->GetColor());
 
@@ -81,6 +83,12 @@ void PowerUpSpawnerComponent::Collect(VehicleComponent* vehicle) {
         mesh->GetMaterial()->diffuseColor = glm::mix(activePowerUp->GetColor(), glm::vec4(1.f), 0.25f);
 	}
 
+    PowerUpPickupEvent event;
+    event.player = player;
+    event.position = vehicle->GetEntity()->transform.GetGlobalPosition();
+    event.color = activePowerUp->GetColor();
+    EventBus::Instance().Publish(event);
+
     lastPickupTime = StateManager::gameTime;
     activePowerUp->Collect(player);
     activePowerUp = nullptr;
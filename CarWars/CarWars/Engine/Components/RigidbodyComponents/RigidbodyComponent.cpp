@@ -12,6 +12,7 @@
 RigidbodyComponent::~RigidbodyComponent() {
 	NavigationMesh *navMesh = Game::Instance().GetNavigationMesh();
 	if (navMesh) navMesh->RemoveRigidbody(this);
+    Physics::Instance().GetSpatialIndex().Remove(this);
     Physics::Instance().GetScene().removeActor(static_cast<physx::PxActor&>(*pxRigid));
     for (Collider *collider : colliders) {
         delete collider;
@@ -82,6 +83,7 @@ void RigidbodyComponent::SetEntity(Entity* _entity) {
     Component::SetEntity(_entity);
     pxRigid->setGlobalPose(Transform::ToPx(_entity->transform));
     Physics::Instance().GetScene().addActor(*pxRigid);
+    Physics::Instance().GetSpatialIndex().Insert(this, _entity->transform.GetGlobalPosition());
 
 	for (Collider *collider : colliders) {
 		collider->Scale(_entity->transform.GetLocalScale());
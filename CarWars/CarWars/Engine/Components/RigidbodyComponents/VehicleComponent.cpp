@@ -21,6 +21,8 @@
 #include "PennerEasing/Linear.h"
 #include "../../Systems/Physics/VehicleCreate.h"
 #include "../ParticleEmitterComponent.h"
+#include "../../Events/EventBus.h"
+#include "../../Events/GameEvents.h"
 
 using namespace physx;
 
@@ -471,18 +473,18 @@ void VehicleComponent::UpdateHealthGui(HumanData *myPlayer) {
     Entity* entity = EntityManager::FindFirstChild(myPlayer->camera->GetGuiRoot(), "HealthBar");
     GuiComponent* gui = GuiHelper::GetSecondGui(entity);
 
-    const std::string tweenTag = "HealthBar" + std::to_string(myPlayer->id);
+    const TweenTag tweenTag("HealthBar", myPlayer->id);
     Effects::Instance().DestroyTween(tweenTag);
 
     Transform& mask = gui->GetMask();
     const glm::vec3 start = mask.GetLocalScale();
     const glm::vec3 end = gui->transform.GetLocalScale() * glm::vec3(healthPercent, 1.f, 1.f);
     auto tween = Effects::Instance().CreateTween<glm::vec3, easing::Quint::easeOut>(start, end, 0.1, StateManager::gameTime);
-    tween->SetTag(tweenTag);
-    tween->SetUpdateCallback([&mask](glm::vec3& value) mutable {
+    tween.SetTag(tweenTag);
+    tween.SetUpdateCallback([&mask](glm::vec3& value) mutable {
         mask.SetScale(value);
     });
-    tween->Start();
+    tween.Start();
 }
 
 
@@ -491,150 +493,37 @@ void VehicleComponent::TakeDamage(WeaponComponent* damager, float _damage) {
     PlayerData* attacker = Game::GetPlayerFromEntity(damager->GetEntity());
     PlayerData* me = Game::GetPlayerFromEntity(GetEntity());
 
-    if (damager->GetType() == ComponentType_RailGun) {
-        Audio::Instance().PlayAudio3D(Audio::Instance().Weapons.railgunHitHeavy, GetEntity()->transform.GetGlobalPosition(), glm::vec3(0.f, 0.f, 0.f), 1.f);
-    } else if (damager->GetType() == ComponentType_MachineGun) {
-        if (GetChassisMass() > 1500.f) Audio::Instance().PlayAudio3D(Audio::Instance().Weapons.bulletHitHeavy, GetEntity()->transform.GetGlobalPosition(), glm::vec3(0.f, 0.f, 0.f), .25f);
-        else if (GetChassisMass() > 1000.f)  Audio::Instance().PlayAudio3D(Audio::Instance().Weapons.bulletHitMedium, GetEntity()->transform.GetGlobalPosition(), glm::vec3(0.f, 0.f, 0.f), .25f);
-        else Audio::Instance().PlayAudio3D(Audio::Instance().Weapons.bulletHitLight, GetEntity()->transform.GetGlobalPosition(), glm::vec3(0.f, 0.f, 0.f), .25f);
+    // Sounds and HUD feedback are handled by the damage event subscribers
+    DamageEvent damageEvent;
+    damageEvent.victim = me;
+    damageEvent.attacker = attacker;
+    damageEvent.weaponType = damager->GetType();
+    damageEvent.position = GetEntity()->transform.GetGlobalPosition();
+    damageEvent.chassisMass = GetChassisMass();
+    damageEvent.damage = 0.f;
+
+    if (attacker && attacker->teamIndex == me->teamIndex) {
+        damageEvent.health = health;
+        EventBus::Instance().Publish(damageEvent);
+        return;
     }
 
-    if (attacker && attacker->teamIndex == me->teamIndex) return;
-	if (!attacker || attacker->teamIndex == me->teamIndex) {
+    const float previousHealth = health;
+	if (!attacker || !attacker->vehicle || attacker->teamIndex == me->teamIndex) {
 		health -= (_damage) * (1.f - (resistance * defenceMultiplier));
 	} else {
-		health -= (attacker->vehicleEntity->GetComponent<VehicleComponent>()->baseDamage * _damage) * (1.f - (resistance * defenceMultiplier));
+		health -= (attacker->vehicle->baseDamage * _damage) * (1.f - (resistance * defenceMultiplier));
 	}
 
-    HumanData* attackerPlayer = Game::GetHumanFromEntity(damager->GetEntity());
-    if (attackerPlayer) {
-        Entity* entity = EntityManager::FindFirstChild(attackerPlayer->camera->GetGuiRoot(), "HitIndicator");
-        GuiComponent* gui = entity->GetComponent<GuiComponent>();
-        GuiHelper::OpacityEffect(gui, 0.5, 0.8f, 0.1, 0.1);
-    }
-
-    HumanData *myPlayer = Game::GetHumanFromEntity(GetEntity());
-    if (myPlayer) {
-		if (attacker) {
-            Entity* entity = EntityManager::FindFirstChild(myPlayer->camera->GetGuiRoot(), "DamageIndicator");
-            GuiComponent* gui = entity->GetComponent<GuiComponent>();
-
-            GuiHelper::OpacityEffect(gui, 1.0, 0.8f, 0.25, 0.25);
-
-            // NOTE: This isn't really a tween... but it's a nice hacky use for the tween system
-            // We should probably make a special version of the tween for exactly this case
-            const std::string tweenTag = "DamageIndicator" + std::to_string(myPlayer->id);
-            Tween* oldTween = Effects::Instance().FindTween(tweenTag);
-            if (oldTween) Effects::Instance().DestroyTween(oldTween);
-            auto tween = Effects::Instance().CreateTween<float, easing::Linear::easeIn>(0.f, 1.f, 1.0, StateManager::gameTime);
-            tween->SetTag(tweenTag);
-            tween->SetUpdateCallback([gui, myPlayer, attacker](float& value) mutable {
-                if (!myPlayer->alive || !attacker->alive) return;
-                const glm::vec3 cameraPos = myPlayer->camera->GetPosition();
-                const glm::vec3 cameraForward = normalize(Transform::ProjectVectorOnPlane(myPlayer->camera->GetForward(), Transform::UP));
-                const glm::vec3 cameraRight = normalize(Transform::ProjectVectorOnPlane(myPlayer->camera->GetRight(), Transform::UP));
-                const glm::vec3 direction = normalize(Transform::ProjectVectorOnPlane(cameraPos - attacker->vehicleEntity->transform.GetGlobalPosition(), Transform::UP));
-                const float sign = dot(cameraRight, direction) < 0.f ? 1.f : -1.f;
-                const float theta = sign * acos(dot(cameraForward, direction));
-                gui->transform.SetRotationAxisAngles(-Transform::FORWARD, theta);
-            });
-            tween->Start();
-        }
-        
-        {
-            const float healthPercent = glm::max(0.f, health) / 1000.f;
-            Entity* entity = EntityManager::FindFirstChild(myPlayer->camera->GetGuiRoot(), "HealthBar");
-            GuiComponent* gui = GuiHelper::GetSecondGui(entity);
-
-            const std::string tweenTag = "HealthBar" + std::to_string(myPlayer->id);
-            Effects::Instance().DestroyTween(tweenTag);
-            
-            Transform& mask = gui->GetMask();
-            const glm::vec3 start = mask.GetLocalScale();
-            const glm::vec3 end = gui->transform.GetLocalScale() * glm::vec3(healthPercent, 1.f, 1.f);
-            auto tween = Effects::Instance().CreateTween<glm::vec3, easing::Quint::easeOut>(start, end, 0.1, StateManager::gameTime);
-            tween->SetTag(tweenTag);
-            tween->SetUpdateCallback([&mask](glm::vec3& value) mutable {
-                mask.SetScale(value);
-            });
-            tween->Start();
-        }
-    }
+    damageEvent.damage = previousHealth - health;
+    damageEvent.health = health;
+    EventBus::Instance().Publish(damageEvent);
 
     if (health <= 0) {
 		if (attacker) {
 			attacker->killCount++;
 			Game::gameData.teams[attacker->teamIndex].killCount++;
 		}
-
-        for (size_t i = 0; i < 4; ++i) {
-            HumanData& player = Game::humanPlayers[i];
-            if (!player.ready) continue;
-            Entity* killFeed = EntityManager::FindFirstChild(player.camera->GetGuiRoot(), "KillFeed");
-
-            Entity* row = ContentManager::LoadEntity("Menu/KillFeedRow.json", killFeed);
-            std::vector<GuiComponent*> guis = row->GetComponents<GuiComponent>();
-            GuiComponent* player0Gui = guis[0];
-            GuiComponent* player1Gui = guis[1];
-            GuiComponent* weaponGui = guis[2];
-            
-            vector<Entity*> rows = EntityManager::GetChildren(killFeed);
-
-            player1Gui->SetText(me->name);
-            if (Game::gameData.gameMode == GameModeType::Team) player1Gui->SetFontColor(me->teamIndex ? ContentManager::COLOR_LIGHT_RED : ContentManager::COLOR_LIGHT_GREEN);
-            const glm::vec2 fontDims = player1Gui->GetFontDimensions();
-            
-            Texture* weaponTexture;
-            if (attacker) weaponTexture = ContentManager::GetTexture(WeaponType::texturePaths[attacker->weaponType]);
-            else weaponTexture = ContentManager::GetTexture("HUD/skull.png");
-            
-            weaponGui->SetTexture(weaponTexture);
-            weaponGui->transform.Translate(-glm::vec3(fontDims.x + 10.f, 0.f, 0.f));
-            
-            if (attacker) {
-                player0Gui->SetText(attacker->name);
-                if (Game::gameData.gameMode == GameModeType::Team) player0Gui->SetFontColor(attacker->teamIndex ? ContentManager::COLOR_LIGHT_RED : ContentManager::COLOR_LIGHT_GREEN);
-            }
-            player0Gui->transform.Translate(-glm::vec3(fontDims.x + 50.f, 0.f, 0.f));
-
-            constexpr size_t maxCount = 5;
-
-            const std::string tweenTag = "KillFeed" + player.id;
-            Tween* oldTween = Effects::Instance().FindTween(tweenTag);
-            if (oldTween) Effects::Instance().DestroyTween(oldTween);
-
-            auto tween = Effects::Instance().CreateTween<float, easing::Quint::easeOut>(0.f, 1.f, 0.5, StateManager::gameTime);
-            tween->SetTag(tweenTag);
-            tween->SetUpdateCallback([rows, maxCount](float& value) mutable {
-                for (int j = 0; j < rows.size(); ++j) {
-                    Entity* row = rows[j];
-
-                    // Tween in position
-                    float start = 30.f * (static_cast<int>(rows.size()) - 2 - j);
-                    float end = 30.f * (static_cast<int>(rows.size()) - 1 - j);
-                    GuiHelper::SetGuiYPositions(row, 20.f + glm::mix(start, end, value));
-
-                    // Tween in/out opacity
-                    for (GuiComponent* gui : row->GetComponents<GuiComponent>()) {
-                        if (rows.size() >= maxCount && j < rows.size() - maxCount) {
-                            gui->SetOpacity(1.f - value);
-                        } else if (gui->GetTextureOpacity() < 1.f || gui->GetFontOpacity() < 1.f) {
-                            gui->SetOpacity(value);
-                        }
-                    }
-                }
-            });
-
-            if (rows.size() >= maxCount) {
-                tween->SetFinishedCallback([rows, maxCount](float& value) mutable {
-                    for (size_t i = 0; i < rows.size() - maxCount; ++i) {
-                        EntityManager::DestroyEntity(rows[i]);
-                    }
-                });
-            }
-
-            tween->Start();
-        }
 		if (!attacker) {
 			me->killCount--;
 			Game::gameData.teams[me->teamIndex].killCount--;
@@ -644,6 +533,11 @@ void VehicleComponent::TakeDamage(WeaponComponent* damager, float _damage) {
         me->alive = false;
 		me->diedTime = StateManager::gameTime;
 
+        KillEvent killEvent;
+        killEvent.victim = me;
+        killEvent.attacker = attacker;
+        EventBus::Instance().Publish(killEvent);
+
         Physics::Instance().AddToDelete(GetEntity());
     }
 }
@@ -683,18 +577,18 @@ void VehicleComponent::Boost(glm::vec3 boostDir) {
             const glm::vec3 emptyStart = mask.GetLocalScale();
             const glm::vec3 emptyEnd = boostBar->transform.GetLocalScale() * glm::vec3(0.f, 1.f, 1.f);
 			auto tweenEmpty = Effects::Instance().CreateTween<glm::vec3, easing::Quint::easeOut>(emptyStart, emptyEnd, emptyTime, StateManager::gameTime);
-			tweenEmpty->SetUpdateCallback([&mask](glm::vec3 &value) mutable {
+			tweenEmpty.SetUpdateCallback([&mask](glm::vec3 &value) mutable {
                 mask.SetScale(value);
 			});
 
             const glm::vec3 fillStart = emptyEnd;
             const glm::vec3 fillEnd = boostBar->transform.GetLocalScale();
             auto tweenFill = Effects::Instance().CreateTween<glm::vec3, easing::Linear::easeNone>(fillStart, fillEnd , boostCooldown - emptyTime, StateManager::gameTime);
-			tweenFill->SetUpdateCallback([&mask](glm::vec3 &value) mutable {
+			tweenFill.SetUpdateCallback([&mask](glm::vec3 &value) mutable {
                 mask.SetScale(value);
 			});
-			tweenEmpty->SetNext(tweenFill);
-			tweenEmpty->Start();
+			tweenEmpty.SetNext(tweenFill);
+			tweenEmpty.Start();
 
 			//play boost sound
 		}
@@ -768,16 +662,6 @@ void VehicleComponent::SetBaseDamage(float _baseDamage) {
 	baseDamage = _baseDamage;
 }
 
-void VehicleComponent::OnContact(RigidbodyComponent* body) {
-    VehicleComponent* otherVehicle = body->GetEntity()->GetComponent<VehicleComponent>();
-	Entity* vehicle = body->GetEntity();
-    if (otherVehicle) {
-		Audio::Instance().PlayAudio3D(Audio::Instance().Environment.hitCar, vehicle->transform.GetGlobalPosition(), glm::vec3(0.f, 0.f, 0.f), 0.125f);
-    } else {
-		Audio::Instance().PlayAudio3D(Audio::Instance().Environment.hitGround, vehicle->transform.GetGlobalPosition(), glm::vec3(0.f, 0.f, 0.f), 0.125f);
-    }
-}
-
 void VehicleComponent::OnTrigger(RigidbodyComponent* body) { }
 
 void VehicleComponent::SetDownForce(glm::vec3 force) {
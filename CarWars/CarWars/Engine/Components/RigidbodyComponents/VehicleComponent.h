@@ -76,7 +76,6 @@ public:
 	void SetResistance(float _resistance);
 	void SetBaseDamage(float _baseDamage);
 
-    void OnContact(RigidbodyComponent* body) override;
     void OnTrigger(RigidbodyComponent* body) override;
 
 	glm::vec3 GetDownForce();
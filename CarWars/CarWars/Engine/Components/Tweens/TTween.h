@@ -1,56 +1,24 @@
 #pragma once
 
-#include "../../Systems/Time.h"
-#include <glm/glm.hpp>
-#include "Tween.h"
-#include <functional>
+#include "TweenPool.h"
 
-template <typename V, float Ease(float t, float b, float c, float d)>
+// Handle to a tween of a particular value type, which is what its callbacks are given
+template <typename V>
 class TTween : public Tween {
 friend class Effects;
 public:
-    void Update() override {
-        if (!started || finished) return;
-        Time current = clock - startTime;
-        if (current < delay) return;
-        current -= delay;
-        if (current >= duration) {
-            value = end;
-            Stop(true);
-        } else {
-            value = glm::mix(start, end, Ease(current.GetSeconds(), 0.f, 1.f, duration.GetSeconds()));
-            if (updateCallback) updateCallback(value);
-        }
-    }
-
-    void SetUpdateCallback(std::function<void(V&)> a_callback) {
-        updateCallback = a_callback;
-    }
+    TTween() {}
 
-    void SetFinishedCallback(std::function<void(V&)> a_callback) {
-        finishedCallback = a_callback;
+    template <typename F>
+    void SetUpdateCallback(F callback) {
+        if (pool) static_cast<TweenPool<V>*>(pool)->SetUpdateCallback(index, generation, std::move(callback));
     }
 
-    void Stop(const bool naturalStop=false) override {
-        Tween::Stop(naturalStop);
-        if (naturalStop) {
-            if (updateCallback) updateCallback(value);
-            if (finishedCallback) finishedCallback(value);
-        }
+    template <typename F>
+    void SetFinishedCallback(F callback) {
+        if (pool) static_cast<TweenPool<V>*>(pool)->SetFinishedCallback(index, generation, std::move(callback));
     }
 
 protected:
-    TTween(V a_start, V a_end, const Time a_duration, Time& clock = StateManager::globalTime) : Tween(a_duration, clock),
-        updateCallback(nullptr), finishedCallback(nullptr), initialValue(a_start), value(initialValue), start(a_start), end(a_end) {}
-
-    TTween(V& a_value, V a_start, V a_end, const Time a_duration, Time& clock = StateManager::globalTime) : Tween(a_duration, clock),
-        updateCallback(nullptr), finishedCallback(nullptr), value(a_value), start(a_start), end(a_end) {}
-
-    std::function<void(V&)> updateCallback;
-    std::function<void(V&)> finishedCallback;
-
-    V initialValue;
-    V& value;
-    V start;
-    V end;
+    TTween(TweenPool<V>* _pool, uint32_t _index) : Tween(_pool, _index, _pool->GetGeneration(_index)) {}
 };
@@ -1,72 +1,88 @@
 #pragma once
 
-#include "../../Systems/StateManager.h"
+#include "../../Systems/Time.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
 
-class Tween {
-friend class Effects;
+class TweenPoolBase;
+
+// Names a tween so that it can be found or replaced later. The name is hashed once when the tag is built,
+// so looking tweens up by tag never compares strings.
+class TweenTag {
 public:
-    virtual ~Tween() = default;
-    void Start() {
-        startTime = clock;
-        started = true;
+    TweenTag() : id(0) {}
+    TweenTag(const char* name) : id(Hash(name, strlen(name), OFFSET_BASIS)) {}
+    TweenTag(const std::string& name) : id(Hash(name.data(), name.size(), OFFSET_BASIS)) {}
+    TweenTag(const char* name, size_t index) : TweenTag(TweenTag(name).Append(index)) {}
+    TweenTag(const std::string& name, size_t index) : TweenTag(TweenTag(name).Append(index)) {}
+
+    // Tag for something owned by this tag's owner, e.g. TweenTag("Headlight", playerId).Append(entityId)
+    TweenTag Append(size_t index) const {
+        const uint64_t value = index;
+        TweenTag tag;
+        tag.id = Hash(reinterpret_cast<const char*>(&value), sizeof(value), id);
+        return tag;
     }
 
-    virtual void Update() = 0;
+    uint64_t GetId() const { return id; }
+    bool IsValid() const { return id != 0; }
 
-    bool Finished() const {
-        return finished;
-    }
+    bool operator== (const TweenTag& other) const { return id == other.id; }
+    bool operator!= (const TweenTag& other) const { return id != other.id; }
 
-    void SetNext(Tween* tween) {
-        nextTween = tween;
-    }
+private:
+    static constexpr uint64_t OFFSET_BASIS = 14695981039346656037ull;
+    static constexpr uint64_t PRIME = 1099511628211ull;
 
-    void SetNext(Tween* tween, Time delay) {
-        SetNext(tween);
-        nextTween->SetDelay(delay);
+    // FNV-1a, with 0 kept free to mean "no tag"
+    static uint64_t Hash(const char* data, size_t length, uint64_t hash) {
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= PRIME;
+        }
+        return hash ? hash : 1;
     }
 
-    void SetDelay(Time _delay) {
-        delay = _delay;
-    }
+    uint64_t id;
+};
 
-    void TakeOwnership() {
-        ownedByEffectsSystem = false;
-    }
+// Handle to a tween living in one of the Effects system's pools. Handles are cheap to copy and go stale
+// (IsValid returns false) once the tween finishes or is destroyed, even if its slot has been reused since.
+class Tween {
+friend class TweenPoolBase;
+friend class Effects;
+public:
+    Tween() : pool(nullptr), index(0), generation(0) {}
 
-    bool IsOwnedByEffectsSystem() const {
-        return ownedByEffectsSystem;
-    }
+    bool IsValid() const;
+    explicit operator bool() const { return IsValid(); }
 
-    virtual void Stop(const bool naturalStop = false) {
-        finished = true;
-        if (naturalStop) {
-            if (nextTween) nextTween->Start();
-        }
-    }
+    void Start();
 
-    void SetTag(std::string _tag) {
-        tag = _tag;
-    }
+    // Stops the tween without running its callbacks or starting the next tween
+    void Stop();
 
-    bool HasTag(std::string a_tag) const {
-        return tag.compare(a_tag) == 0;
-    }
-protected:
-    Tween(const Time a_duration, Time& _clock = StateManager::globalTime) :
-        started(false), finished(false), clock(_clock), duration(a_duration), nextTween(nullptr), ownedByEffectsSystem(true) {}
+    bool Finished() const;
 
-    bool started;
-    bool finished;
+    // Starts tween once this one finishes
+    void SetNext(Tween tween);
+    void SetNext(Tween tween, Time delay);
 
-    Time& clock;
-    Time startTime;
-    Time duration;
-    Time delay;
+    void SetDelay(Time delay);
 
-    Tween* nextTween;
+    void SetTag(TweenTag tag);
+    bool HasTag(TweenTag tag) const;
 
-    bool ownedByEffectsSystem;
+    bool operator== (const Tween& other) const {
+        return pool == other.pool && index == other.index && generation == other.generation;
+    }
+    bool operator!= (const Tween& other) const { return !(*this == other); }
+
+protected:
+    Tween(TweenPoolBase* _pool, uint32_t _index, uint32_t _generation) : pool(_pool), index(_index), generation(_generation) {}
 
-    std::string tag;
+    TweenPoolBase* pool;
+    uint32_t index;
+    uint32_t generation;
 };
@@ -0,0 +1,511 @@
+#pragma once
+
+#include "Tween.h"
+#include "../../Systems/Memory/FrameAllocator.h"
+#include <glm/glm.hpp>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+typedef float (*EaseFunction)(float t, float b, float c, float d);
+
+// Callable stored inline in the tween, so that setting a callback doesn't allocate.
+// Callables that don't fit (more than a few captured values) fall back to the heap.
+template <typename V>
+class TweenCallback {
+public:
+    TweenCallback() : invoke(nullptr), destroy(nullptr) {}
+    ~TweenCallback() {
+        Reset();
+    }
+
+    template <typename F>
+    void Set(F callback) {
+        typedef typename std::decay<F>::type Function;
+        Reset();
+        Store<Function>(std::move(callback), std::integral_constant<bool,
+            sizeof(Function) <= sizeof(Storage) && alignof(Function) <= alignof(Storage)>());
+    }
+
+    void Reset() {
+        if (destroy) destroy(&storage);
+        invoke = nullptr;
+        destroy = nullptr;
+    }
+
+    explicit operator bool() const {
+        return invoke != nullptr;
+    }
+
+    void operator() (V& value) {
+        invoke(&storage, value);
+    }
+
+private:
+    TweenCallback(const TweenCallback&) = delete;
+    TweenCallback& operator= (const TweenCallback&) = delete;
+
+    typedef typename std::aligned_storage<64, alignof(std::max_align_t)>::type Storage;
+
+    template <typename Function>
+    void Store(Function&& callback, std::true_type) {
+        new (&storage) Function(std::move(callback));
+        invoke = [](void* function, V& value) { (*static_cast<Function*>(function))(value); };
+        destroy = [](void* function) { static_cast<Function*>(function)->~Function(); };
+    }
+
+    template <typename Function>
+    void Store(Function&& callback, std::false_type) {
+        *reinterpret_cast<Function**>(&storage) = new Function(std::move(callback));
+        invoke = [](void* function, V& value) { (**static_cast<Function**>(function))(value); };
+        destroy = [](void* function) { delete *static_cast<Function**>(function); };
+    }
+
+    Storage storage;
+
+    void (*invoke)(void*, V&);
+    void (*destroy)(void*);
+};
+
+// Open addressing hash table from tag to the most recent tween given that tag
+class TweenTagIndex {
+public:
+    TweenTagIndex() : count(0), used(0) {}
+
+    void Set(TweenTag tag, Tween tween) {
+        if ((used + 1) * 2 > entries.size()) Rehash(entries.empty() ? 64 : entries.size() * (count * 4 > entries.size() ? 2 : 1));
+
+        size_t slot = Find(tag.GetId());
+        if (entries[slot].key == tag.GetId()) {
+            entries[slot].tween = tween;
+            return;
+        }
+
+        // Reuse the first tombstone along the probe sequence if there was one
+        slot = FindInsert(tag.GetId());
+        if (entries[slot].key == EMPTY) ++used;
+        entries[slot].key = tag.GetId();
+        entries[slot].tween = tween;
+        ++count;
+    }
+
+    Tween Get(TweenTag tag) const {
+        if (entries.empty()) return Tween();
+        const Entry& entry = entries[Find(tag.GetId())];
+        return entry.key == tag.GetId() ? entry.tween : Tween();
+    }
+
+    // Removes the tag only if it still refers to tween
+    void Remove(TweenTag tag, Tween tween) {
+        if (entries.empty() || !tag.IsValid()) return;
+        Entry& entry = entries[Find(tag.GetId())];
+        if (entry.key != tag.GetId() || entry.tween != tween) return;
+        entry.key = TOMBSTONE;
+        entry.tween = Tween();
+        --count;
+    }
+
+    void Clear() {
+        entries.clear();
+        count = used = 0;
+    }
+
+private:
+    static constexpr uint64_t EMPTY = 0;
+    static constexpr uint64_t TOMBSTONE = ~0ull;
+
+    struct Entry {
+        Entry() : key(EMPTY) {}
+        uint64_t key;
+        Tween tween;
+    };
+
+    // Slot holding key, or the empty slot ending its probe sequence
+    size_t Find(uint64_t key) const {
+        const size_t mask = entries.size() - 1;
+        size_t slot = static_cast<size_t>(key) & mask;
+        while (entries[slot].key != EMPTY && entries[slot].key != key) slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    size_t FindInsert(uint64_t key) const {
+        const size_t mask = entries.size() - 1;
+        size_t slot = static_cast<size_t>(key) & mask;
+        while (entries[slot].key != EMPTY && entries[slot].key != TOMBSTONE) slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    void Rehash(size_t capacity) {
+        std::vector<Entry> old(capacity);
+        old.swap(entries);
+        count = used = 0;
+        for (const Entry& entry : old) {
+            if (entry.key == EMPTY || entry.key == TOMBSTONE) continue;
+            const size_t slot = FindInsert(entry.key);
+            entries[slot] = entry;
+            ++count;
+            ++used;
+        }
+    }
+
+    std::vector<Entry> entries;
+    size_t count;   // Live entries
+    size_t used;    // Live entries and tombstones
+};
+
+// Untyped access to a pool, used by tween handles
+class TweenPoolBase {
+public:
+    explicit TweenPoolBase(TweenTagIndex& _tags) : tags(_tags) {}
+    virtual ~TweenPoolBase() = default;
+
+    virtual bool IsValid(uint32_t index, uint32_t generation) const = 0;
+    virtual void Start(uint32_t index, uint32_t generation) = 0;
+    virtual void Stop(uint32_t index, uint32_t generation) = 0;
+    virtual bool IsFinished(uint32_t index, uint32_t generation) const = 0;
+    virtual void SetNext(uint32_t index, uint32_t generation, Tween next) = 0;
+    virtual void SetDelay(uint32_t index, uint32_t generation, Time delay) = 0;
+    virtual void SetTag(uint32_t index, uint32_t generation, TweenTag tag) = 0;
+    virtual TweenTag GetTag(uint32_t index, uint32_t generation) const = 0;
+    virtual void Destroy(uint32_t index, uint32_t generation) = 0;
+
+    virtual void Update() = 0;
+    virtual void DestroyAll() = 0;
+    virtual size_t GetActiveCount() const = 0;
+
+protected:
+    Tween MakeHandle(uint32_t index, uint32_t generation) {
+        return Tween(this, index, generation);
+    }
+
+    TweenTagIndex& tags;
+};
+
+// All tweens of one value type. Tween state lives in fixed-size chunks that never move, so handles, callbacks and
+// the values handed to them stay put while tweens are created and destroyed. The indices of live tweens are kept
+// contiguous, and each update eases all running tweens that share an easing function together.
+template <typename V>
+class TweenPool : public TweenPoolBase {
+public:
+    explicit TweenPool(TweenTagIndex& _tags) : TweenPoolBase(_tags), slotCount(0), updating(false) {}
+
+    ~TweenPool() {
+        for (Slot* chunk : chunks) delete[] chunk;
+    }
+
+    // Returns the index of a new tween that has not been started yet
+    uint32_t Create(V start, V end, Time duration, Time& clock, EaseFunction ease) {
+        uint32_t index;
+        if (!freeSlots.empty()) {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            if (slotCount == chunks.size() * CHUNK_SIZE) chunks.push_back(new Slot[CHUNK_SIZE]);
+            index = slotCount++;
+        }
+
+        Slot& slot = GetSlot(index);
+        slot.alive = true;
+        slot.started = false;
+        slot.finished = false;
+        slot.clock = &clock;
+        slot.startTime = 0.0;
+        slot.duration = duration;
+        slot.delay = 0.0;
+        slot.easeIndex = GetEaseIndex(ease);
+        slot.start = start;
+        slot.end = end;
+        slot.value = start;
+        slot.next = Tween();
+        slot.tag = TweenTag();
+
+        slot.activeIndex = static_cast<uint32_t>(active.size());
+        active.push_back(index);
+        return index;
+    }
+
+    uint32_t GetGeneration(uint32_t index) const {
+        return GetSlot(index).generation;
+    }
+
+    template <typename F>
+    void SetUpdateCallback(uint32_t index, uint32_t generation, F callback) {
+        if (IsValid(index, generation)) GetSlot(index).onUpdate.Set(std::move(callback));
+    }
+
+    template <typename F>
+    void SetFinishedCallback(uint32_t index, uint32_t generation, F callback) {
+        if (IsValid(index, generation)) GetSlot(index).onFinished.Set(std::move(callback));
+    }
+
+    bool IsValid(uint32_t index, uint32_t generation) const override {
+        if (index >= slotCount) return false;
+        const Slot& slot = GetSlot(index);
+        return slot.alive && slot.generation == generation;
+    }
+
+    void Start(uint32_t index, uint32_t generation) override {
+        if (!IsValid(index, generation)) return;
+        Slot& slot = GetSlot(index);
+        slot.startTime = *slot.clock;
+        slot.started = true;
+    }
+
+    void Stop(uint32_t index, uint32_t generation) override {
+        if (IsValid(index, generation)) GetSlot(index).finished = true;
+    }
+
+    bool IsFinished(uint32_t index, uint32_t generation) const override {
+        return !IsValid(index, generation) || GetSlot(index).finished;
+    }
+
+    void SetNext(uint32_t index, uint32_t generation, Tween next) override {
+        if (IsValid(index, generation)) GetSlot(index).next = next;
+    }
+
+    void SetDelay(uint32_t index, uint32_t generation, Time delay) override {
+        if (IsValid(index, generation)) GetSlot(index).delay = delay;
+    }
+
+    void SetTag(uint32_t index, uint32_t generation, TweenTag tag) override {
+        if (!IsValid(index, generation)) return;
+        Slot& slot = GetSlot(index);
+        const Tween handle = MakeHandle(index, generation);
+        tags.Remove(slot.tag, handle);
+        slot.tag = tag;
+        if (tag.IsValid()) tags.Set(tag, handle);
+    }
+
+    TweenTag GetTag(uint32_t index, uint32_t generation) const override {
+        return IsValid(index, generation) ? GetSlot(index).tag : TweenTag();
+    }
+
+    void Destroy(uint32_t index, uint32_t generation) override {
+        if (!IsValid(index, generation)) return;
+        Kill(index);
+
+        // Mid-update the slot is released once the update is done with it
+        if (!updating) Remove(index);
+    }
+
+    void DestroyAll() override {
+        for (uint32_t index : active) {
+            if (GetSlot(index).alive) Kill(index);
+        }
+        if (updating) return;
+
+        for (uint32_t index : active) Release(index);
+        active.clear();
+    }
+
+    void Update() override {
+        updating = true;
+
+        // Sort out which tweens are running and how far along they are, bucketing the running ones by easing
+        const size_t count = active.size();
+        FrameVector<uint32_t> running;
+        FrameVector<float> progress;
+        FrameVector<uint32_t> finishing;
+        FrameVector<uint32_t> easeCounts(eases.size(), 0);
+        running.reserve(count);
+        progress.reserve(count);
+
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t index = active[i];
+            const Slot& slot = GetSlot(index);
+            if (!slot.alive || !slot.started || slot.finished) continue;
+
+            Time current = *slot.clock - slot.startTime;
+            if (current < slot.delay) continue;
+            current -= slot.delay;
+
+            if (current >= slot.duration) {
+                finishing.push_back(index);
+            } else {
+                running.push_back(index);
+                progress.push_back(current.GetSeconds() / slot.duration.GetSeconds());
+                easeCounts[slot.easeIndex]++;
+            }
+        }
+
+        // Counting sort by easing, then evaluate each easing over its own contiguous run
+        FrameVector<uint32_t> easeOffsets(eases.size() + 1, 0);
+        for (size_t e = 0; e < eases.size(); ++e) easeOffsets[e + 1] = easeOffsets[e] + easeCounts[e];
+
+        FrameVector<uint32_t> sorted(running.size());
+        FrameVector<float> sortedProgress(running.size());
+        for (size_t i = 0; i < running.size(); ++i) {
+            const uint32_t position = easeOffsets[GetSlot(running[i]).easeIndex]++;
+            sorted[position] = running[i];
+            sortedProgress[position] = progress[i];
+        }
+
+        size_t first = 0;
+        for (size_t e = 0; e < eases.size(); ++e) {
+            const EaseFunction ease = eases[e];
+            const size_t last = first + easeCounts[e];
+            for (size_t i = first; i < last; ++i) {
+                sortedProgress[i] = ease(sortedProgress[i], 0.f, 1.f, 1.f);
+            }
+            first = last;
+        }
+
+        // Apply the values. Callbacks may create or destroy tweens, so skip any that died along the way.
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            Slot& slot = GetSlot(sorted[i]);
+            if (!slot.alive) continue;
+            slot.value = glm::mix(slot.start, slot.end, sortedProgress[i]);
+            if (slot.onUpdate) slot.onUpdate(slot.value);
+        }
+
+        for (uint32_t index : finishing) {
+            Slot& slot = GetSlot(index);
+            if (!slot.alive) continue;
+            slot.finished = true;
+            slot.value = slot.end;
+            slot.next.Start();
+            if (slot.onUpdate) slot.onUpdate(slot.value);
+            if (slot.alive && slot.onFinished) slot.onFinished(slot.value);
+        }
+
+        updating = false;
+
+        // Release everything that finished or was destroyed this frame
+        for (size_t i = 0; i < active.size(); ) {
+            const uint32_t index = active[i];
+            Slot& slot = GetSlot(index);
+            if (slot.alive && slot.finished) Kill(index);
+            if (!slot.alive) {
+                Remove(index);
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    size_t GetActiveCount() const override {
+        return active.size();
+    }
+
+private:
+    static constexpr uint32_t CHUNK_SIZE = 256;
+
+    struct Slot {
+        Slot() : generation(0), activeIndex(0), alive(false), started(false), finished(false), clock(nullptr), easeIndex(0) {}
+
+        uint32_t generation;
+        uint32_t activeIndex;   // Position in active
+        bool alive;
+        bool started;
+        bool finished;
+
+        Time* clock;
+        Time startTime;
+        Time duration;
+        Time delay;
+        uint32_t easeIndex;
+
+        V start;
+        V end;
+        V value;
+
+        Tween next;
+        TweenTag tag;
+
+        TweenCallback<V> onUpdate;
+        TweenCallback<V> onFinished;
+    };
+
+    Slot& GetSlot(uint32_t index) {
+        return chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+    }
+
+    const Slot& GetSlot(uint32_t index) const {
+        return chunks[index / CHUNK_SIZE][index % CHUNK_SIZE];
+    }
+
+    uint32_t GetEaseIndex(EaseFunction ease) {
+        for (size_t i = 0; i < eases.size(); ++i) {
+            if (eases[i] == ease) return static_cast<uint32_t>(i);
+        }
+        eases.push_back(ease);
+        return static_cast<uint32_t>(eases.size() - 1);
+    }
+
+    // Invalidates every handle to the tween, leaving the slot to be released once nothing can be using it
+    void Kill(uint32_t index) {
+        Slot& slot = GetSlot(index);
+        tags.Remove(slot.tag, MakeHandle(index, slot.generation));
+        slot.alive = false;
+        slot.finished = true;
+        slot.generation++;
+    }
+
+    // Releases the slot and swaps the last active tween into its place
+    void Remove(uint32_t index) {
+        const uint32_t activeIndex = GetSlot(index).activeIndex;
+        const uint32_t moved = active.back();
+        active[activeIndex] = moved;
+        GetSlot(moved).activeIndex = activeIndex;
+        active.pop_back();
+        Release(index);
+    }
+
+    // Callbacks are only destroyed here, never while one of them might be running
+    void Release(uint32_t index) {
+        Slot& slot = GetSlot(index);
+        slot.onUpdate.Reset();
+        slot.onFinished.Reset();
+        slot.next = Tween();
+        slot.tag = TweenTag();
+        freeSlots.push_back(index);
+    }
+
+    std::vector<Slot*> chunks;
+    uint32_t slotCount;
+
+    std::vector<uint32_t> active;
+    std::vector<uint32_t> freeSlots;
+    std::vector<EaseFunction> eases;
+
+    bool updating;
+};
+
+inline bool Tween::IsValid() const {
+    return pool && pool->IsValid(index, generation);
+}
+
+inline void Tween::Start() {
+    if (pool) pool->Start(index, generation);
+}
+
+inline void Tween::Stop() {
+    if (pool) pool->Stop(index, generation);
+}
+
+inline bool Tween::Finished() const {
+    return !pool || pool->IsFinished(index, generation);
+}
+
+inline void Tween::SetNext(Tween tween) {
+    if (pool) pool->SetNext(index, generation, tween);
+}
+
+inline void Tween::SetNext(Tween tween, Time delay) {
+    SetNext(tween);
+    tween.SetDelay(delay);
+}
+
+inline void Tween::SetDelay(Time delay) {
+    if (pool) pool->SetDelay(index, generation, delay);
+}
+
+inline void Tween::SetTag(TweenTag tag) {
+    if (pool) pool->SetTag(index, generation, tag);
+}
+
+inline bool Tween::HasTag(TweenTag tag) const {
+    return pool && pool->GetTag(index, generation) == tag;
+}
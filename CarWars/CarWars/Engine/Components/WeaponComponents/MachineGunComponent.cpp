@@ -91,10 +91,10 @@ void MachineGunComponent::Shoot(glm::vec3 position) {
                 duration = std::max(duration, emitter->GetLifetimeSeconds());
             }
             auto tween = Effects::Instance().CreateTween<float, easing::Linear::easeInOut>(0.f, 1.f, duration, StateManager::gameTime);
-            tween->SetFinishedCallback([explosionEffect](float& value) mutable {
+            tween.SetFinishedCallback([explosionEffect](float& value) mutable {
                 EntityManager::DestroyEntity(explosionEffect);
             });
-            tween->Start();
+            tween.Start();
 		} else {
 			hitPosition = gunPosition + (shotDirection * rayLength);
 		}
@@ -108,14 +108,14 @@ void MachineGunComponent::Shoot(glm::vec3 position) {
 		line->SetColor(glm::vec4(1.0f, .1f, .1f, 1.f));
 
 		auto tween = Effects::Instance().CreateTween<float, easing::Linear::easeNone>(1.f, 0.f, timeBetweenShots*0.5, StateManager::gameTime);
-		tween->SetUpdateCallback([line, player, mgTurret, tween](float& value) mutable {
+		tween.SetUpdateCallback([line, player, mgTurret](float& value) mutable {
 			if (!player->alive) return;
 			line->SetPoint0(mgTurret->transform.GetGlobalPosition());
 		});
-		tween->SetFinishedCallback([bullet](float& value) mutable {
+		tween.SetFinishedCallback([bullet](float& value) mutable {
 			EntityManager::DestroyEntity(bullet);
 		});
-		tween->Start();
+		tween.Start();
 
 	} else { // betweeen shots
 	}
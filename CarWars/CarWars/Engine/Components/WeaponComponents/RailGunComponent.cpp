@@ -53,11 +53,11 @@ void RailGunComponent::Shoot(glm::vec3 position) {
 	if (StateManager::gameTime.GetSeconds() >= nextShotTime.GetSeconds()) {
         playingChargeSound = false;
 		//Audio::Instance().StopSound(soundIndex);
-		Audio::Instance().StopSound3D(soundIndex);
+		Audio::Instance().StopSound3D(chargeSound);
 
 		//Get Vehicle
 		Entity* vehicle = GetEntity();
-		Audio::Instance().PlayAudio3D(Audio::Instance().Weapons.railgunShoot, vehicle->transform.GetGlobalPosition(), glm::vec3(0.f, 0.f, 0.f), 1.f);
+		Audio::Instance().PlayAudio3D(Audio::Instance().Weapons.railgunShoot, vehicle->transform.GetGlobalPosition(), glm::vec3(0.f, 0.f, 0.f), 1.f, VoicePriority_High);
 
 		//Calculate Next Shooting Time
 		nextShotTime = StateManager::gameTime + (timeBetweenShots + chargeTime);
@@ -85,7 +85,7 @@ void RailGunComponent::Shoot(glm::vec3 position) {
         ParticleEmitterComponent* emitter = beam->GetComponent<ParticleEmitterComponent>();
 
         auto tweenIn = Effects::Instance().CreateTween<float, easing::Quint::easeOut>(0.f, 1.f, 0.2, StateManager::gameTime);
-        tweenIn->SetUpdateCallback([emitter, &beamTransform, &beamMeshTransform, hitPosition, rgTurret, player](float& value) mutable {
+        tweenIn.SetUpdateCallback([emitter, &beamTransform, &beamMeshTransform, hitPosition, rgTurret, player](float& value) mutable {
             if (!player->alive) return;
             beamTransform.SetPosition(0.5f * (rgTurret->transform.GetGlobalPosition() + hitPosition));
             float radius = glm::mix(0.1f, 1.f, value);
@@ -97,7 +97,7 @@ void RailGunComponent::Shoot(glm::vec3 position) {
 
         float startRadius = beamMeshTransform.GetLocalScale().x;
 		auto tweenOut = Effects::Instance().CreateTween<float, easing::Quint::easeIn>(0.f, 1.f, 0.2, StateManager::gameTime);
-        tweenOut->SetUpdateCallback([emitter, startRadius, &beamTransform, &beamMeshTransform, hitPosition, rgTurret, player](float& value) mutable {
+        tweenOut.SetUpdateCallback([emitter, startRadius, &beamTransform, &beamMeshTransform, hitPosition, rgTurret, player](float& value) mutable {
 			if (!player->alive) return;
             beamTransform.SetPosition(0.5f * (rgTurret->transform.GetGlobalPosition() + hitPosition));
             float radius = glm::mix(startRadius, 0.f, value);
@@ -106,14 +106,14 @@ void RailGunComponent::Shoot(glm::vec3 position) {
             emitter->SetInitialScale(glm::vec2(radius*3.f));
             emitter->SetFinalScale(glm::vec2(radius*3.f));
 		});
-        tweenOut->SetFinishedCallback([this](float& value) mutable {
+        tweenOut.SetFinishedCallback([this](float& value) mutable {
 			EntityManager::DestroyEntity(beam);
             beam = nullptr;
 		});
 
 
-        tweenIn->SetNext(tweenOut, 0.1);
-        tweenIn->Start();
+        tweenIn.SetNext(tweenOut, 0.1);
+        tweenIn.Start();
 
 		HumanData* human = Game::Instance().GetHumanFromEntity(GetEntity());
 		if (human) {
@@ -122,23 +122,23 @@ void RailGunComponent::Shoot(glm::vec3 position) {
 
 			auto tweenOut = Effects::Instance().CreateTween<glm::vec3, easing::Sine::easeIn>(
 				glm::vec3(134.f, 0.f, 0.f), glm::vec3(134.f, 134.f, 0.f), timeBetweenShots, StateManager::gameTime);
-			tweenOut->SetUpdateCallback([&mask](glm::vec3& value) {
+			tweenOut.SetUpdateCallback([&mask](glm::vec3& value) {
 				mask.SetScale(value);
 			});
-			tweenOut->SetTag("RailGunChargeOut" + std::to_string(player->id));
-			tweenOut->Start();
+			tweenOut.SetTag(TweenTag("RailGunChargeOut", player->id));
+			tweenOut.Start();
 		}
 	} else if (StateManager::gameTime > nextChargeTime && StateManager::gameTime < nextShotTime) {
         //Play Charging Sound
         if (!playingChargeSound) {
 			//soundIndex = Audio::Instance().PlaySound("Content/Sounds/railgun-charge.mp3");
-			soundIndex = Audio::Instance().PlaySound3D(Audio::Instance().Weapons.railgunCharge, GetEntity()->transform.GetGlobalPosition(), glm::vec3(0.f, 0.f, 0.f), 0.22f);
+			chargeSound = Audio::Instance().PlaySound3D(Audio::Instance().Weapons.railgunCharge, GetEntity()->transform.GetGlobalPosition(), glm::vec3(0.f, 0.f, 0.f), 0.22f);
             playingChargeSound = true;
         }
 
 		HumanData* player = Game::Instance().GetHumanFromEntity(GetEntity());
 		if (player) {
-			Tween* chargeTween = Effects::Instance().FindTween("RailGunChargeIn" + std::to_string(player->id));
+			Tween chargeTween = Effects::Instance().FindTween(TweenTag("RailGunChargeIn", player->id));
 			if (!chargeTween) Charge();
 		}
 
@@ -165,18 +165,18 @@ void RailGunComponent::Charge() {
 
 		HumanData* player = Game::Instance().GetHumanFromEntity(GetEntity());
 		if (player) {
-			Tween* oldTween = Effects::Instance().FindTween("RailGunChargeOut" + std::to_string(player->id));
+			Tween oldTween = Effects::Instance().FindTween(TweenTag("RailGunChargeOut", player->id));
 			if (oldTween) Effects::Instance().DestroyTween(oldTween);
 
 			GuiComponent* gui = GuiHelper::GetFirstGui(EntityManager::FindFirstChild(player->camera->GetGuiRoot(), "ChargeIndicator"));
 			Transform& mask = gui->GetMask();
 
             auto tweenIn = Effects::Instance().CreateTween <float, easing::Sine::easeOut>(0.f, 1.f, chargeTime, StateManager::gameTime);
-            tweenIn->SetUpdateCallback([&mask](float& value) mutable {
+            tweenIn.SetUpdateCallback([&mask](float& value) mutable {
                 mask.SetScale(glm::vec3(134.f, glm::mix(134.f, 0.f, value), 0.f));
             });
-            tweenIn->SetTag("RailGunChargeIn" + std::to_string(player->id));
-            tweenIn->Start();
+            tweenIn.SetTag(TweenTag("RailGunChargeIn", player->id));
+            tweenIn.Start();
 		}
 	} else { // on cooldown
 	}
@@ -198,12 +198,12 @@ void RailGunComponent::ChargeRelease() {
 	HumanData* player = Game::Instance().GetHumanFromEntity(GetEntity());
     playingChargeSound = false;
 	//Audio::Instance().StopSound(soundIndex);
-	Audio::Instance().StopSound3D(soundIndex);
+	Audio::Instance().StopSound3D(chargeSound);
 	if (player) {
-		Tween* outTween = Effects::Instance().FindTween("RailGunChargeOut" + std::to_string(player->id));
+		Tween outTween = Effects::Instance().FindTween(TweenTag("RailGunChargeOut", player->id));
 		if (outTween) return;
 
-		Tween* oldTween = Effects::Instance().FindTween("RailGunChargeIn" + std::to_string(player->id));
+		Tween oldTween = Effects::Instance().FindTween(TweenTag("RailGunChargeIn", player->id));
 		if (oldTween) Effects::Instance().DestroyTween(oldTween);
 
 		GuiComponent* gui = GuiHelper::GetFirstGui(EntityManager::FindFirstChild(player->camera->GetGuiRoot(), "ChargeIndicator"));
@@ -217,7 +217,7 @@ void RailGunComponent::ChargeRelease() {
         const glm::vec3 scaleStart = mask.GetLocalScale();
         const glm::vec3 scaleEnd = glm::vec3(134.f, 134.f, 0.f);
 		auto tweenOut = Effects::Instance().CreateTween<float, easing::Sine::easeIn>(0.f, 1.f, 0.01, StateManager::gameTime);
-		tweenOut->SetUpdateCallback([emitter, &beamMeshTransform, &transform, &mask, startRadius, scaleStart, scaleEnd](float& value) {
+		tweenOut.SetUpdateCallback([emitter, &beamMeshTransform, &transform, &mask, startRadius, scaleStart, scaleEnd](float& value) {
 			mask.SetScale(mix(scaleStart, scaleEnd, value));
 
             float radius = glm::mix(startRadius, 0.f, value);
@@ -225,12 +225,12 @@ void RailGunComponent::ChargeRelease() {
 		    emitter->SetInitialScale(glm::vec2(radius*3.f));
             emitter->SetFinalScale(glm::vec2(radius*3.f));
 		});
-        tweenOut->SetFinishedCallback([this](float& value) mutable {
+        tweenOut.SetFinishedCallback([this](float& value) mutable {
             EntityManager::DestroyEntity(beam);
             beam = nullptr;
         });
-		tweenOut->SetTag("RailGunChargeOut" + std::to_string(player->id));
-		tweenOut->Start();
+		tweenOut.SetTag(TweenTag("RailGunChargeOut", player->id));
+		tweenOut.Start();
 	}
 }
 
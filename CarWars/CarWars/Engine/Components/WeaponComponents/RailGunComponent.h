@@ -3,6 +3,7 @@
 
 #include "../../Systems/StateManager.h"
 #include "../../Systems/Physics.h"
+#include "../../Systems/Audio/VoiceManager.h"
 #include "../../Entities/EntityManager.h"
 
 #include "../RigidbodyComponents/VehicleComponent.h"
@@ -31,7 +32,7 @@ private:
 	Time chargeTime = 2.0f;
 	Time nextChargeTime = 0.0f;
     bool playingChargeSound = false;
-    int soundIndex;
+    VoiceHandle chargeSound;
 
     Entity* GetBeam();
     Entity* beam;
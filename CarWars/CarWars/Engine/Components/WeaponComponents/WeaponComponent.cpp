@@ -6,6 +6,7 @@
 #include "PennerEasing/Sine.h"
 #include "../CameraComponent.h"
 #include "../../Systems/Effects.h"
+#include "../../Systems/StateManager.h"
 #include "../GuiComponents/GuiComponent.h"
 
 WeaponComponent::WeaponComponent(float _damage) : damage(_damage) {}
@@ -19,18 +20,18 @@ void WeaponComponent::TweenChargeIndicator() {
         
         auto tweenIn = Effects::Instance().CreateTween<glm::vec3, easing::Sine::easeOut>(
             glm::vec3(134.f, 134.f, 0.f), glm::vec3(134.f, 0.f, 0.f), duration, StateManager::gameTime);
-        tweenIn->SetUpdateCallback([&mask](glm::vec3& value) {
+        tweenIn.SetUpdateCallback([&mask](glm::vec3& value) {
 			mask.SetScale(value);
 		});
 
         auto tweenOut = Effects::Instance().CreateTween<glm::vec3, easing::Sine::easeIn>(
             glm::vec3(134.f, 0.f, 0.f), glm::vec3(134.f, 134.f, 0.f), duration, StateManager::gameTime);
-        tweenOut->SetUpdateCallback([&mask](glm::vec3& value) {
+        tweenOut.SetUpdateCallback([&mask](glm::vec3& value) {
 			mask.SetScale(value);
 		});
         
-        tweenIn->SetNext(tweenOut);
-        tweenIn->Start();
+        tweenIn.SetNext(tweenOut);
+        tweenIn.Start();
     }
 }
 
@@ -1,5 +1,4 @@
 #include "Entity.h"
-#include "../Events/Event.h"
 #include "imgui/imgui.h"
 #include "EntityManager.h"
 #include "../Components/WeaponComponents/WeaponComponent.h"
@@ -17,12 +16,6 @@ Entity::~Entity() {
     }
 }
 
-void Entity::HandleEvent(Event* event) {
-	for (size_t i = 0; i < components.size(); i++) {
-		components[i]->HandleEvent(event);		// TODO: Not really correct, use Colton's code
-	}
-}
-
 void Entity::RenderDebugGui() {
     if (ImGui::TreeNode((void*)(intptr_t)GetId(), "Entity %d (%s)", GetId(), GetTag().c_str())) {
         if (ImGui::TreeNode("Properties")) {
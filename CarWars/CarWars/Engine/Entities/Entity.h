@@ -3,11 +3,11 @@
 #include <string>
 #include "Transform.h"
 #include "../Components/Component.h"
+#include "../Systems/Memory/FrameAllocator.h"
 #include <vector>
 
 class WeaponComponent;
 class EntityManager;
-class Event;
 
 class Entity {
 friend class EntityManager;
@@ -28,8 +28,8 @@ public:
 	}
 
 	template <class T>
-	std::vector<T*> GetComponents() {
-		std::vector<T*> found;
+	FrameVector<T*> GetComponents() {
+		FrameVector<T*> found;
 		for (Component* component : components) {
 			T* typedComponent = dynamic_cast<T*>(component);
 			if (typedComponent) {
@@ -39,8 +39,6 @@ public:
 		return found;
 	}
 
-	void HandleEvent(Event *event);
-
     void RenderDebugGui();
 
 	size_t GetId() const;
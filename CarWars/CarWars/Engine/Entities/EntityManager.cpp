@@ -4,6 +4,7 @@
 #include "../Components/RigidbodyComponents/RigidbodyComponent.h"
 #include "../Components/RigidbodyComponents/VehicleComponent.h"
 #include <PxRigidActor.h>
+#include <algorithm>
 
 Entity* EntityManager::root = new Entity(0);
 std::vector<Entity*> EntityManager::staticEntities;
@@ -16,6 +17,9 @@ std::unordered_map<std::type_index, std::vector<Component*>> EntityManager::_com
 
 size_t EntityManager::nextEntityId = 1;
 
+std::vector<std::pair<EntityManager::DestroyListenerId, std::function<void(Entity*)>>> EntityManager::destroyListeners;
+EntityManager::DestroyListenerId EntityManager::nextDestroyListenerId = 1;
+
 Entity* EntityManager::GetRoot() {
     return root;
 }
@@ -29,8 +33,9 @@ Entity* EntityManager::FindEntity(physx::PxRigidActor* _actor) {
 	return component->GetEntity();
 }
 
-std::vector<Entity*> EntityManager::FindEntities(std::string tag) {
-	std::vector<Entity*> ret = tagToEntities[tag];
+FrameVector<Entity*> EntityManager::FindEntities(std::string tag) {
+	const std::vector<Entity*>& tagged = tagToEntities[tag];
+	FrameVector<Entity*> ret(tagged.begin(), tagged.end());
 	for (size_t i = 0; i < ret.size(); i++) ret[i]->transform.Update();
 	return ret;
 }
@@ -77,6 +82,9 @@ void EntityManager::DestroyStaticEntity(Entity *entity) {
 
 void EntityManager::DestroyEntity(Entity *entity, std::vector<Entity*> &entities) {
     if (!entity) return;
+    for (const auto& listener : destroyListeners) {
+        listener.second(entity);
+    }
     ClearTag(entity);
     SetParent(entity, nullptr);
     idToEntity.erase(entity->id);
@@ -91,6 +99,18 @@ void EntityManager::DestroyChildren(Entity *entity) {
 	}
 }
 
+EntityManager::DestroyListenerId EntityManager::AddDestroyListener(std::function<void(Entity*)> listener) {
+    const DestroyListenerId id = nextDestroyListenerId++;
+    destroyListeners.push_back(std::make_pair(id, listener));
+    return id;
+}
+
+void EntityManager::RemoveDestroyListener(DestroyListenerId id) {
+    destroyListeners.erase(std::remove_if(destroyListeners.begin(), destroyListeners.end(),
+        [id](const std::pair<DestroyListenerId, std::function<void(Entity*)>>& listener) { return listener.first == id; }),
+        destroyListeners.end());
+}
+
 size_t EntityManager::GetEntityCount() {
     return dynamicEntities.size() + staticEntities.size();
 }
@@ -163,8 +183,8 @@ Entity* EntityManager::GetParent(Entity* entity) {
     return entity->parent;
 }
 
-std::vector<Entity*> EntityManager::FindChildren(Entity* entity, std::string tag, size_t maxCount) {
-    std::vector<Entity*> children;
+FrameVector<Entity*> EntityManager::FindChildren(Entity* entity, std::string tag, size_t maxCount) {
+    FrameVector<Entity*> children;
     if (maxCount == 0) return children;
     
     for (Entity *child : entity->children) {
@@ -177,13 +197,14 @@ std::vector<Entity*> EntityManager::FindChildren(Entity* entity, std::string tag
     return children;
 }
 
-std::vector<Entity*> EntityManager::FindChildren(Entity* entity, std::string tag) {
+FrameVector<Entity*> EntityManager::FindChildren(Entity* entity, std::string tag) {
     return FindChildren(entity, tag, entity->children.size());
 }
 
 Entity* EntityManager::FindFirstChild(Entity* entity, std::string tag) {
-	std::vector<Entity*> children = FindChildren(entity, tag, 1);
-	if (children.size() > 0) return children[0];
+	for (Entity *child : entity->children) {
+		if (child->HasTag(tag)) return child;
+	}
 	return nullptr;
 }
 
@@ -211,15 +232,16 @@ void EntityManager::DestroyComponent(Component* component) {
 	delete component;
 }
 
-std::vector<Component*> EntityManager::GetComponents(ComponentType type) {
-	return components[type];
+FrameVector<Component*> EntityManager::GetComponents(ComponentType type) {
+	const std::vector<Component*>& list = components[type];
+	return FrameVector<Component*>(list.begin(), list.end());
 }
 
-std::vector<Component*> EntityManager::GetComponents(std::vector<ComponentType> types) {
-    std::vector<Component*> all;
+FrameVector<Component*> EntityManager::GetComponents(std::vector<ComponentType> types) {
+    FrameVector<Component*> all;
     for (ComponentType type : types) {
-        std::vector<Component*> components = GetComponents(type);
-        all.insert(all.end(), components.begin(), components.end());
+        const std::vector<Component*>& list = components[type];
+        all.insert(all.end(), list.begin(), list.end());
     }
     return all;
 }
@@ -233,12 +255,3 @@ size_t EntityManager::GetComponentCount() {
     for (auto it : components) count += it.second.size();
     return count;
 }
-
-void EntityManager::BroadcastEvent(Event* event) {
-	for (size_t i = 0; i < staticEntities.size(); i++) {
-		staticEntities[i]->HandleEvent(event);
-	}
-	for (size_t i = 0; i < dynamicEntities.size(); i++) {
-		dynamicEntities[i]->HandleEvent(event);
-	}
-}
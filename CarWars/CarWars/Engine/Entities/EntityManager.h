@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Entity.h"
+#include <functional>
 #include <map>
 #include <unordered_map>
 #include <typeindex>
@@ -13,7 +14,7 @@ public:
     static Entity* GetRoot();
 	static Entity* FindEntity(size_t id);
 	static Entity* FindEntity(physx::PxRigidActor* _actor);
-	static std::vector<Entity*> FindEntities(std::string tag);
+	static FrameVector<Entity*> FindEntities(std::string tag);
 
 	// Manage entities
 	static Entity* CreateStaticEntity(Entity *parent=nullptr);
@@ -27,6 +28,11 @@ public:
 
     static void DestroyScene();
 
+    // Listeners are told about each entity just before it is deleted, so that anything holding on to it can let go
+    typedef size_t DestroyListenerId;
+    static DestroyListenerId AddDestroyListener(std::function<void(Entity*)> listener);
+    static void RemoveDestroyListener(DestroyListenerId id);
+
 	static void SetTag(size_t entityId, std::string tag);
 	static void SetTag(Entity *entity, std::string tag);
     static void ClearTag(Entity *entity);
@@ -34,8 +40,8 @@ public:
     // Manage entity parenting
     static void SetParent(Entity* child, Entity *parent);
     static Entity* GetParent(Entity* entity);
-    static std::vector<Entity*> FindChildren(Entity* entity, std::string tag, size_t maxCount);
-    static std::vector<Entity*> FindChildren(Entity* entity, std::string tag);
+    static FrameVector<Entity*> FindChildren(Entity* entity, std::string tag, size_t maxCount);
+    static FrameVector<Entity*> FindChildren(Entity* entity, std::string tag);
     static Entity* FindFirstChild(Entity* entity, std::string tag);
     static std::vector<Entity*> GetChildren(Entity* entity);
 
@@ -43,23 +49,22 @@ public:
 	static void AddComponent(size_t entityId, Component* component);
 	static void AddComponent(Entity *entity, Component* component);
 	static void DestroyComponent(Component* component);
-	static std::vector<Component*> GetComponents(ComponentType type);
-    static std::vector<Component*> GetComponents(std::vector<ComponentType> types);
+	// Component lists are copied into frame memory, so they must not be kept past the current frame
+	static FrameVector<Component*> GetComponents(ComponentType type);
+    static FrameVector<Component*> GetComponents(std::vector<ComponentType> types);
     static size_t GetComponentCount(ComponentType type);
     static size_t GetComponentCount();
 	
 	template <class T>
-	static std::vector<T*> GetComponents(ComponentType type) {
-		std::vector<T*> result;
-		std::vector<Component*> temp = components[type];
-		for (Component* component : temp) {
+	static FrameVector<T*> GetComponents(ComponentType type) {
+		const std::vector<Component*>& all = components[type];
+		FrameVector<T*> result;
+		result.reserve(all.size());
+		for (Component* component : all) {
 			result.push_back(static_cast<T*>(component));
 		}
 		return result;
 	}
-
-	// Contact entities
-	static void BroadcastEvent(Event *event);
 private:
 	static Entity* CreateEntity(std::vector<Entity*> &entities, Entity* parent);
 	static void DestroyEntity(Entity *entity, std::vector<Entity*> &entities);
@@ -77,5 +82,8 @@ private:
 
 	static size_t nextEntityId;
 
+	static std::vector<std::pair<DestroyListenerId, std::function<void(Entity*)>>> destroyListeners;
+	static DestroyListenerId nextDestroyListenerId;
+
 	// TODO (if necessary): Object pools (under-the-hood, won't change interface of Create/Destroy)
 };
@@ -1,10 +1,14 @@
 #pragma once
 
 enum EventType {
-
+	EventType_Damage = 0,
+	EventType_Kill,
+	EventType_PowerUpPickup,
+	EventType_Collision,
+	EventType_Count
 };
 
-class Event {
-public:
-	static EventType type;
-};
+// Base for every event. Events are copied into the EventBus queues as raw bytes,
+// so derived events must stay trivially copyable (pointers and plain values only)
+// and declare a static const EventType type.
+class Event {};
@@ -0,0 +1,125 @@
+#include "EventBus.h"
+
+#include <algorithm>
+
+// Singleton
+EventBus::EventBus() : subscribersRemoved(false), inDispatch(false), nextId(0), backQueue(0), dispatchedCount(0) {}
+EventBus &EventBus::Instance() {
+	static EventBus instance;
+	return instance;
+}
+
+void EventBus::Update() {
+	Dispatch();
+}
+
+EventBus::SubscriptionId EventBus::AddSubscriber(EventType type, Handler handler) {
+	Subscriber subscriber;
+	subscriber.id = nextId++;
+	subscriber.handler = handler;
+
+	// Don't grow the list that is being iterated
+	if (inDispatch) {
+		subscribersAddedInDispatch.push_back(std::make_pair(type, subscriber));
+	} else {
+		subscribers[type].push_back(subscriber);
+	}
+	return subscriber.id;
+}
+
+void EventBus::Unsubscribe(SubscriptionId id) {
+	for (size_t type = 0; type < EventType_Count; ++type) {
+		for (Subscriber& subscriber : subscribers[type]) {
+			if (subscriber.id != id) continue;
+			if (inDispatch) {
+				// Removed once dispatching is finished
+				subscriber.handler = nullptr;
+				subscribersRemoved = true;
+			} else {
+				subscribers[type].erase(std::find_if(subscribers[type].begin(), subscribers[type].end(),
+					[id](const Subscriber& s) { return s.id == id; }));
+			}
+			return;
+		}
+	}
+
+	const auto it = std::find_if(subscribersAddedInDispatch.begin(), subscribersAddedInDispatch.end(),
+		[id](const std::pair<EventType, Subscriber>& s) { return s.second.id == id; });
+	if (it != subscribersAddedInDispatch.end()) subscribersAddedInDispatch.erase(it);
+}
+
+void EventBus::Dispatch() {
+	if (inDispatch) return;
+
+	// Swap buffers so anything published while handlers run waits for the next dispatch
+	const size_t frontQueue = backQueue;
+	backQueue = 1 - backQueue;
+
+	{
+		std::lock_guard<std::mutex> lock(deferredMutex);
+		for (size_t type = 0; type < EventType_Count; ++type) {
+			queues[frontQueue][type].Append(deferredQueues[type]);
+			deferredQueues[type].Clear();
+		}
+	}
+
+	inDispatch = true;
+	for (size_t type = 0; type < EventType_Count; ++type) {
+		Queue& queue = queues[frontQueue][type];
+		if (queue.count == 0) continue;
+
+		std::vector<Subscriber>& typeSubscribers = subscribers[type];
+		for (size_t i = 0; i < typeSubscribers.size(); ++i) {
+			if (typeSubscribers[i].handler) typeSubscribers[i].handler(queue.data.data(), queue.count);
+		}
+		dispatchedCount += queue.count;
+		queue.Clear();
+	}
+	inDispatch = false;
+
+	if (subscribersRemoved) {
+		for (size_t type = 0; type < EventType_Count; ++type) {
+			std::vector<Subscriber>& typeSubscribers = subscribers[type];
+			typeSubscribers.erase(std::remove_if(typeSubscribers.begin(), typeSubscribers.end(),
+				[](const Subscriber& s) { return !s.handler; }), typeSubscribers.end());
+		}
+		subscribersRemoved = false;
+	}
+
+	for (const auto& pair : subscribersAddedInDispatch) {
+		subscribers[pair.first].push_back(pair.second);
+	}
+	subscribersAddedInDispatch.clear();
+}
+
+void EventBus::Clear() {
+	for (size_t type = 0; type < EventType_Count; ++type) {
+		queues[0][type].Clear();
+		queues[1][type].Clear();
+	}
+
+	std::lock_guard<std::mutex> lock(deferredMutex);
+	for (size_t type = 0; type < EventType_Count; ++type) {
+		deferredQueues[type].Clear();
+	}
+}
+
+size_t EventBus::GetDispatchedCount() const {
+	return dispatchedCount;
+}
+
+void EventBus::Queue::Push(const void* event, size_t size) {
+	const char* bytes = static_cast<const char*>(event);
+	data.insert(data.end(), bytes, bytes + size);
+	count++;
+}
+
+void EventBus::Queue::Append(const Queue& other) {
+	data.insert(data.end(), other.data.begin(), other.data.end());
+	count += other.count;
+}
+
+void EventBus::Queue::Clear() {
+	data.clear();
+	count = 0;
+}
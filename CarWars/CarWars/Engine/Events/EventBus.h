@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Event.h"
+#include "../Systems/System.h"
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+// Typed, queued replacement for broadcasting events to every entity.
+// Events are queued per type and delivered to that type's subscribers only when the bus is dispatched,
+// which happens at fixed points in the frame (after each physics step and after the game update).
+class EventBus : public System {
+public:
+	typedef size_t SubscriptionId;
+
+	// Access the singleton instance
+	static EventBus& Instance();
+
+	void Update() override;
+
+	// Receive queued events of type T one at a time
+	template <typename T>
+	SubscriptionId Subscribe(std::function<void(const T&)> handler) {
+		return AddSubscriber(T::type, [handler](const void* data, size_t count) {
+			const T* events = static_cast<const T*>(data);
+			for (size_t i = 0; i < count; ++i) handler(events[i]);
+		});
+	}
+
+	// Receive every queued event of type T at once, in publish order, so side effects can be batched
+	template <typename T>
+	SubscriptionId SubscribeBatch(std::function<void(const T*, size_t)> handler) {
+		return AddSubscriber(T::type, [handler](const void* data, size_t count) {
+			handler(static_cast<const T*>(data), count);
+		});
+	}
+
+	void Unsubscribe(SubscriptionId id);
+
+	// Queue an event for the next dispatch. Main thread only.
+	template <typename T>
+	void Publish(const T& event) {
+		static_assert(std::is_trivially_copyable<T>::value, "Events are queued as raw bytes and must be trivially copyable");
+		queues[backQueue][T::type].Push(&event, sizeof(T));
+	}
+
+	// Queue an event from any thread. It joins the main queue at the start of the next dispatch.
+	template <typename T>
+	void PublishDeferred(const T& event) {
+		static_assert(std::is_trivially_copyable<T>::value, "Events are queued as raw bytes and must be trivially copyable");
+		std::lock_guard<std::mutex> lock(deferredMutex);
+		deferredQueues[T::type].Push(&event, sizeof(T));
+	}
+
+	// Deliver everything queued so far. Events published by handlers are held until the next dispatch.
+	void Dispatch();
+
+	// Drop all queued events without delivering them
+	void Clear();
+
+	size_t GetDispatchedCount() const;
+
+private:
+	// No instantiation or copying
+	EventBus();
+	EventBus(const EventBus&) = delete;
+	EventBus& operator= (const EventBus&) = delete;
+
+	typedef std::function<void(const void*, size_t)> Handler;
+
+	struct Subscriber {
+		SubscriptionId id;
+		Handler handler;
+	};
+
+	// Events of one type packed back to back. The storage is kept between frames so queuing doesn't allocate.
+	struct Queue {
+		Queue() : count(0) {}
+		void Push(const void* event, size_t size);
+		void Append(const Queue& other);
+		void Clear();
+
+		std::vector<char> data;
+		size_t count;
+	};
+
+	SubscriptionId AddSubscriber(EventType type, Handler handler);
+
+	std::vector<Subscriber> subscribers[EventType_Count];
+	std::vector<std::pair<EventType, Subscriber>> subscribersAddedInDispatch;
+	bool subscribersRemoved;
+	bool inDispatch;
+	SubscriptionId nextId;
+
+	Queue queues[2][EventType_Count];
+	size_t backQueue;
+
+	Queue deferredQueues[EventType_Count];
+	std::mutex deferredMutex;
+
+	size_t dispatchedCount;
+};
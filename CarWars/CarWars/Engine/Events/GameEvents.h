@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Event.h"
+#include "../Components/Component.h"
+#include <glm/glm.hpp>
+
+struct PlayerData;
+class Entity;
+
+// A vehicle was hit. Friendly hits are published with no damage so that hit effects still play.
+class DamageEvent : public Event {
+public:
+	static const EventType type = EventType_Damage;
+
+	PlayerData* victim;
+	PlayerData* attacker;		// nullptr for environmental damage
+	ComponentType weaponType;
+	glm::vec3 position;
+	float chassisMass;
+	float damage;
+	float health;				// Victim's health after the hit
+};
+
+// A vehicle was destroyed
+class KillEvent : public Event {
+public:
+	static const EventType type = EventType_Kill;
+
+	PlayerData* victim;
+	PlayerData* attacker;		// nullptr for suicides and environmental kills
+};
+
+// A player collected a power up from a spawner
+class PowerUpPickupEvent : public Event {
+public:
+	static const EventType type = EventType_PowerUpPickup;
+
+	PlayerData* player;
+	glm::vec3 position;
+	glm::vec4 color;
+};
+
+// Two rigidbodies started touching. Published during the physics step and dispatched before deleted entities are cleared.
+class CollisionEvent : public Event {
+public:
+	static const EventType type = EventType_Collision;
+
+	Entity* actor0;
+	Entity* actor1;
+};
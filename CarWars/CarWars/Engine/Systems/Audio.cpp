@@ -1,4 +1,7 @@
 #include "Audio.h"
+#include "../Events/EventBus.h"
+#include "../Events/GameEvents.h"
+#include "Content/StartupProfile.h"
 #include <iostream>
 
 // Singleton
@@ -12,9 +15,12 @@ Audio &Audio::Instance() {
 Audio::~Audio() { 
     sound->release();
     sound3d->release();
-    music->release();
-    for (auto s : carSounds) { s.sound->release(); }
-    for (auto s : soundArray3D) { s->release(); }
+    music.Release();
+    StopCars();
+    engineSounds.Release();
+    EntityManager::RemoveDestroyListener(destroyListener);
+    voices.reset();
+    backend.reset();
     soundSystem->close();
     soundSystem->release();
 }
@@ -22,25 +28,27 @@ Audio::~Audio() {
 void Audio::ReleaseSounds() {
     sound->release();
     sound3d->release();
-    for (auto s : carSounds) { s.sound->release(); }
-    for (auto s : soundArray3D) { s->release(); }
+    StopCars();
 }
 
 void Audio::Initialize() { 
-    updateFunctionId = 0;
-	updatePosition = 0;
     srand(time(NULL));
-    currentMusicIndex = rand() % NUM_MUSIC;
     FMOD::System_Create(&soundSystem);
     soundSystem->init(MAX_CHANNELS, FMOD_INIT_NORMAL, 0);
     soundSystem->set3DSettings(1.0f, 1.f, .18f); 
     soundSystem->set3DNumListeners(Game::gameData.humanCount);
 
-	for (int i = 0; i < 100; i++) { availableSound3D[i] = true; }
+    backend = std::make_unique<FmodAudioBackend>(soundSystem);
+    voices = std::make_unique<VoiceManager>(*backend, MAX_REAL_VOICES, MAX_VOICES);
+    voices->SetRolloff(MIN_DISTANCE, .18f);
+    voices->SetFinishedCallback([this](VoiceHandle voice) { OnVoiceFinished(voice); });
+    attachedSoundIndices.assign(MAX_VOICES, 0);
+    destroyListener = EntityManager::AddDestroyListener([this](Entity* entity) { OnEntityDestroyed(entity); });
 
     prevGameState = StateManager::GetState();
     // main screen intro music
-    PlayMusic("Content/Music/imperial-march.mp3");
+    music.Initialize(soundSystem, MUSIC_DIRECTORY, musicVolume, MENU_MUSIC);
+    PlayMusic(MENU_MUSIC);
 
 	// weapons sounds
     AddSoundToMemory("Content/Sounds/rocket-launch.mp3", &Weapons.missleLaunch); 
@@ -73,86 +81,167 @@ void Audio::Initialize() {
     AddSoundToMemory("Content/Sounds/Environment/powerup.mp3", &Environment.powerup);
     AddSoundToMemory("Content/Sounds/Environment/jump.mp3", &Environment.jump);
 
+    // engine sounds, decoded now so that cars never load anything mid-game
+    engineSounds.Load(soundSystem, MIN_DISTANCE, MAX_DISTANCE);
+
+    SetRateLimits();
+
+    // event sounds
+    EventBus& eventBus = EventBus::Instance();
+    eventBus.Subscribe<DamageEvent>([this](const DamageEvent& event) { OnDamage(event); });
+    eventBus.Subscribe<PowerUpPickupEvent>([this](const PowerUpPickupEvent& event) { OnPowerUpPickup(event); });
+    eventBus.Subscribe<CollisionEvent>([this](const CollisionEvent& event) { OnCollision(event); });
+}
+
+void Audio::OnDamage(const DamageEvent& event) {
+    if (event.weaponType == ComponentType_RailGun) {
+        PlayAudio3D(Weapons.railgunHitHeavy, event.position, glm::vec3(0.f, 0.f, 0.f), 1.f);
+    } else if (event.weaponType == ComponentType_MachineGun) {
+        if (event.chassisMass > 1500.f) PlayAudio3D(Weapons.bulletHitHeavy, event.position, glm::vec3(0.f, 0.f, 0.f), .25f, VoicePriority_Low);
+        else if (event.chassisMass > 1000.f) PlayAudio3D(Weapons.bulletHitMedium, event.position, glm::vec3(0.f, 0.f, 0.f), .25f, VoicePriority_Low);
+        else PlayAudio3D(Weapons.bulletHitLight, event.position, glm::vec3(0.f, 0.f, 0.f), .25f, VoicePriority_Low);
+    }
+}
+
+void Audio::OnPowerUpPickup(const PowerUpPickupEvent& event) {
+    PlayAudio3D(Environment.powerup, event.position, glm::vec3(0.f, 0.f, 0.f), 10.f);
+}
+
+void Audio::OnCollision(const CollisionEvent& event) {
+    // Each vehicle in the pair plays a sound at the position of whatever it hit
+    Entity* actors[2] = { event.actor0, event.actor1 };
+    for (size_t i = 0; i < 2; ++i) {
+        Entity* self = actors[i];
+        Entity* other = actors[1 - i];
+        if (!self->HasTag("Vehicle")) continue;
+
+        FMOD::Sound* hitSound = other->HasTag("Vehicle") ? Environment.hitCar : Environment.hitGround;
+        PlayAudio3D(hitSound, other->transform.GetGlobalPosition(), glm::vec3(0.f, 0.f, 0.f), 0.125f, VoicePriority_Low);
+    }
+}
+
+void Audio::SetRateLimits() {
+    // Stops a firefight from stacking dozens of copies of the same shot or hit on top of each other
+    voices->SetRateLimit(Weapons.bulletShoot, 0.02, 16);
+    voices->SetRateLimit(Weapons.bulletHitHeavy, 0.05, 6);
+    voices->SetRateLimit(Weapons.bulletHitMedium, 0.05, 6);
+    voices->SetRateLimit(Weapons.bulletHitLight, 0.05, 6);
+    voices->SetRateLimit(Weapons.railgunHitHeavy, 0.05, 4);
+    voices->SetRateLimit(Weapons.explosion, 0.05, 8);
+    voices->SetRateLimit(Environment.hitCar, 0.1, 4);
+    voices->SetRateLimit(Environment.hitGround, 0.1, 4);
+    voices->SetRateLimit(Environment.powerup, 0.1, 4);
 }
 
 void Audio::AddSoundToMemory(const char *filepath, FMOD::Sound **sound) {
-    result = soundSystem->createSound(filepath, FMOD_3D | FMOD_LOOP_OFF, 0, sound);
+    // Decoded on FMOD's loader thread while the rest of the game boots
+    result = soundSystem->createSound(filepath, FMOD_3D | FMOD_LOOP_OFF | FMOD_NONBLOCKING, 0, sound);
     if (result != FMOD_OK) {
         std::cout << "Error creating sound " << filepath << std::endl;
+        return;
     }
-    result = (*sound)->set3DMinMaxDistance(MIN_DISTANCE, MAX_DISTANCE);
-    if (result != FMOD_OK) {
-        std::cout << "Error setting distance on " << filepath << std::endl;
-    }
+    pendingSounds.push_back({ filepath, *sound, StartupProfile::Now() });
 }
 
-int Audio::PlaySound3D(FMOD::Sound *sound, glm::vec3 position, glm::vec3 velocity, float volume) {
-	FMOD_VECTOR pos = { position.x, position.y, position.z };
-	FMOD_VECTOR vel = { velocity.x, velocity.y, velocity.z };
-	int index = 0;
-	for (auto s : availableSound3D) {
-		if (s) break;
-		index++;
-	}
+void Audio::FinishLoading() {
+    for (const PendingSound& pending : pendingSounds) {
+        if (!FmodAudioBackend::WaitUntilOpen(pending.sound)) {
+            std::cout << "Error creating sound " << pending.filePath << std::endl;
+            continue;
+        }
+        result = pending.sound->set3DMinMaxDistance(MIN_DISTANCE, MAX_DISTANCE);
+        if (result != FMOD_OK) {
+            std::cout << "Error setting distance on " << pending.filePath << std::endl;
+        }
+
+        unsigned int bytes = 0;
+        pending.sound->getLength(&bytes, FMOD_TIMEUNIT_PCMBYTES);
+        StartupProfile::Record(StartupAsset_Sound, pending.filePath, bytes, StartupProfile::Now() - pending.requested, 0.0);
+    }
+    pendingSounds.clear();
 
-	availableSound3D[index] = false;
-	soundSystem->playSound(sound, 0, false, &channelArray3D[index]);
-	channelArray3D[index]->setVolume(volume);
-	channelArray3D[index]->set3DAttributes(&pos, &vel);
-	channelArray3D[index]->setPaused(false);
+    engineSounds.FinishLoading();
+}
 
-	return index;
+VoiceHandle Audio::PlaySound3D(FMOD::Sound *sound, glm::vec3 position, glm::vec3 velocity, float volume, int priority) {
+	VoiceParams params;
+	params.volume = volume;
+	params.priority = priority;
+	params.position = position;
+	params.velocity = velocity;
+	return voices->Play(sound, params);
 }
 
-void Audio::StopSound3D(int index) {
-	availableSound3D[index] = true;
-    channelArray3D[index]->setPaused(true);
+void Audio::StopSound3D(VoiceHandle voice) {
+	voices->Stop(voice);
 }
 
-void Audio::PlayAudio2D(FMOD::Sound* sound, float volume) {
-	soundSystem->playSound(sound, 0, false, &channel);
-	channel->setVolume(volume);
+const VoiceManager& Audio::GetVoices() const {
+	return *voices;
 }
 
-void Audio::PlayAudio3D(FMOD::Sound *s, glm::vec3 position, glm::vec3 velocity, float volume) {
-    FMOD_VECTOR pos = { position.x, position.y, position.z };
-    FMOD_VECTOR vel = { velocity.x, velocity.y, velocity.z };
-    soundSystem->playSound(s, 0, true, &channel3d);
-    channel3d->set3DAttributes(&pos, &vel);
-    channel3d->setPaused(false);
-    channel3d->setVolume(volume);
+void Audio::PlayAudio2D(FMOD::Sound* sound, float volume, int priority) {
+	VoiceParams params;
+	params.volume = volume;
+	params.priority = priority;
+	params.is3D = false;
+	params.pausable = false;     // Menu sounds, which have to be heard over the pause menu
+	voices->Play(sound, params);
 }
 
-void Audio::PlayAudio3DAttached(FMOD::Sound *s, Entity* entity, float volume) {
-	FMOD_VECTOR pos = { entity->transform.GetGlobalPosition().x, entity->transform.GetGlobalPosition().y, entity->transform.GetGlobalPosition().z };
-	FMOD_VECTOR vel = { 0.f, 0.f, 0.f};
+void Audio::PlayAudio3D(FMOD::Sound *s, glm::vec3 position, glm::vec3 velocity, float volume, int priority) {
+    PlaySound3D(s, position, velocity, volume, priority);
+}
 
+void Audio::PlayAudio3DAttached(FMOD::Sound *s, Entity* entity, float volume, int priority) {
 	AttachedSound a;
 	a.entity = entity;
-	soundSystem->playSound(s, 0, true, &a.channel);
-	a.channel->set3DAttributes(&pos, &vel);
-	a.channel->setPaused(false);
-	a.channel->setVolume(volume);
+	a.voice = PlaySound3D(s, entity->transform.GetGlobalPosition(), GetVelocity(entity), volume, priority);
+	if (!a.voice.IsValid()) return;
+
+	attachedSoundIndices[a.voice.index] = attachedSounds.size() + 1;
 	attachedSounds.push_back(a);
 }
 
+void Audio::RemoveAttachedSound(size_t index) {
+	attachedSoundIndices[attachedSounds[index].voice.index] = 0;
+	if (index + 1 < attachedSounds.size()) {
+		attachedSounds[index] = attachedSounds.back();
+		attachedSoundIndices[attachedSounds[index].voice.index] = index + 1;
+	}
+	attachedSounds.pop_back();
+}
+
+void Audio::OnVoiceFinished(VoiceHandle voice) {
+	const size_t index = attachedSoundIndices[voice.index];
+	if (index > 0 && attachedSounds[index - 1].voice == voice) RemoveAttachedSound(index - 1);
+}
+
+void Audio::OnEntityDestroyed(Entity* entity) {
+	// Sounds stay where the entity was and play out
+	for (size_t i = 0; i < attachedSounds.size();) {
+		if (attachedSounds[i].entity == entity) RemoveAttachedSound(i);
+		else ++i;
+	}
+}
+
+glm::vec3 Audio::GetVelocity(Entity* entity) {
+	RigidDynamicComponent* body = entity->GetComponent<RigidDynamicComponent>();
+	if (!body || !body->actor) return glm::vec3(0.f, 0.f, 0.f);
+	return Transform::FromPx(body->actor->getLinearVelocity());
+}
+
 void Audio::PauseSounds() {
-    for (auto c : channelArray3D) c->setPaused(true);
-    for (auto car : carSounds) car.channel->setPaused(true);
-    channel->setPaused(true);
-    channel3d->setPaused(true);
+    voices->SetPaused(true);
+    PauseCars(true);
 }
 void Audio::ResumeSounds() {
-    for (auto c : channelArray3D) c->setPaused(false);
-    for (auto car : carSounds) car.channel->setPaused(false);
-    channel->setPaused(false);
-    channel3d->setPaused(false);
+    voices->SetPaused(false);
+    PauseCars(false);
 }
 
 void Audio::PlayMusic(const char *filename) {
-    result = soundSystem->createStream(filename, FMOD_LOOP_OFF | FMOD_2D, 0, &music);
-    result = soundSystem->playSound(music, 0, false, &musicChannel);
-    musicChannel->setVolume(musicVolume);
+    music.PlayTrack(filename);
 }
 
 void Audio::MenuMusicControl() {
@@ -161,19 +250,15 @@ void Audio::MenuMusicControl() {
         if (currGameState == GameState_Playing) {
 			ResumeSounds();
             if (!gameStarted) {
-                music->release();
-                PlayMusic(musicPlaylist[currentMusicIndex]);
+                music.PlayPlaylist();
                 gameStarted = true;
             }
         } else if (currGameState == GameState_Paused) {
 			PauseSounds();
         } else if (currGameState == GameState_Menu) {
-            srand(time(NULL));
-            currentMusicIndex = rand() % NUM_MUSIC;
             ReleaseSounds();
             if (gameStarted) {
-                music->release();
-                PlayMusic("Content/Music/imperial-march.mp3");
+                PlayMusic(MENU_MUSIC);
                 gameStarted = false;
             }
         }
@@ -185,64 +270,42 @@ void Audio::MenuMusicControl() {
 void Audio::UpdateListeners() {
     // update listener position for every camera/player vehicle
     if (StateManager::GetState() == GameState_Playing) {
+        glm::vec3 listenerPositions[VoiceManager::MAX_LISTENERS];
+        size_t listenerCount = 0;
         for (size_t i = 0; i < Game::gameData.humanCount; ++i) {
             auto player = Game::humanPlayers[i];
             if (!player.ready || !player.alive) continue;
             const auto carForward = player.vehicleEntity->transform.GetForward();
             const auto carUp = player.vehicleEntity->transform.GetUp();
             const auto carPosition = player.vehicleEntity->transform.GetGlobalPosition();
-            const auto carVelocity = glm::vec3(0.0f, 0.0f, 0.0f);
-            player.vehicleEntity->GetComponent<VehicleComponent>()->pxVehicle->computeForwardSpeed(); 
+            const auto carVelocity = GetVelocity(player.vehicleEntity);
             FMOD_VECTOR forward = { carForward.x, carForward.y, carForward.z };
             FMOD_VECTOR up = { carUp.x, carUp.y, carUp.z };
             FMOD_VECTOR position = { carPosition.x, carPosition.y, carPosition.z };
             FMOD_VECTOR velocity = { carVelocity.x, carVelocity.y, carVelocity.z };
             soundSystem->set3DListenerAttributes(i, &position, &velocity, &forward, &up);
+            if (listenerCount < VoiceManager::MAX_LISTENERS) listenerPositions[listenerCount++] = carPosition;
         }
+        voices->SetListeners(listenerPositions, listenerCount);
     }
 }
 
 void Audio::UpdateAttached() {
-	vector<int> toDelete;
-	for (int i = updatePosition; i < attachedSounds.size() && availableUpdates > 0; ++i) {
-		bool isPlaying;
-		attachedSounds[i].channel->isPlaying(&isPlaying);
-		if (!isPlaying || attachedSounds[i].entity == nullptr || &(attachedSounds[i].entity->transform) == nullptr) {
-			//delete
-			toDelete.push_back(i);
-		} else {
-			// update position
-            if (!attachedSounds[i].entity->IsMarkedForDeletion() && &attachedSounds[i].entity != nullptr && &attachedSounds[i].entity->transform != nullptr) {
-                FMOD_VECTOR pos = {
-                    attachedSounds[i].entity->transform.GetGlobalPosition().x,
-                    attachedSounds[i].entity->transform.GetGlobalPosition().y,
-                    attachedSounds[i].entity->transform.GetGlobalPosition().z
-                };
-                FMOD_VECTOR vel = { 0.f, 0.f, 0.f };
-                attachedSounds[i].channel->set3DAttributes(&pos, &vel);
-            } else {
-                toDelete.push_back(i);
-            }
-		}
-        availableUpdates--;
-	}
-
-    // reset position
-    // give way to 2nd function to update
-    updatePosition = 0;
-    updateFunctionId = 1;
-
-
-    // does not count against updates...
-	for (int i = toDelete.size() - 1; i >= 0 && availableUpdates > 0; --i) {
-		attachedSounds.erase(attachedSounds.begin() + i);
-	}
+    // Finished voices and destroyed entities have already been removed, so everything here is live.
+    // Sounds on the same entity (e.g. every shot from one gun) share one position and velocity lookup.
+    FrameUnorderedMap<Entity*, std::pair<glm::vec3, glm::vec3>> motions;
+    for (const AttachedSound& attached : attachedSounds) {
+        auto it = motions.find(attached.entity);
+        if (it == motions.end()) {
+            const auto motion = std::make_pair(attached.entity->transform.GetGlobalPosition(), GetVelocity(attached.entity));
+            it = motions.insert(std::make_pair(attached.entity, motion)).first;
+        }
+        voices->SetPosition(attached.voice, it->second.first, it->second.second);
+    }
 }
 
 void Audio::StartCars() {
-    const char *engineSound = "Content/Sounds/Truck/idle.mp3";
-
-    // channels and sounds for cars
+    // channels for cars, sharing the preloaded engine sounds
     carSounds.resize(
         Game::gameData.aiCount +
         Game::gameData.humanCount);
@@ -251,97 +314,56 @@ void Audio::StartCars() {
     for (int i = 0; i < 4; i++) {
         HumanData& player = Game::humanPlayers[i];
         if (!player.ready || !player.alive) continue;
-        const auto playerPos = player.vehicleEntity->transform.GetGlobalPosition();
-        soundSystem->createSound(engineSound, FMOD_3D | FMOD_LOOP_NORMAL, 0, &carSounds[i].sound);
-        carSounds[i].sound->set3DMinMaxDistance(MIN_DISTANCE, MAX_DISTANCE);
-        soundSystem->playSound(carSounds[i].sound, 0, true, &carSounds[i].channel);
-        FMOD_VECTOR pos = { playerPos.x+1.0f, playerPos.y+1.0f, playerPos.z+1.0f };
-        FMOD_VECTOR vel = { 0.0f, 0.0f, 0.0f };
-        carSounds[i].channel->set3DAttributes(&pos, &vel);
-        carSounds[i].channel->setPaused(false);
-        carSounds[i].channel->setVolume(playerSoundVolume);
+        carSounds[i].Start(soundSystem, engineSounds, playerSoundVolume);
     }
     size_t offset = Game::gameData.humanCount;
     //ai
     for (int i = 0; i < Game::gameData.aiCount; i++) {
 		AiData& player = Game::aiPlayers[i];
 		if (!player.alive) continue;
-        auto aiPos = player.vehicleEntity->transform.GetGlobalPosition();
-        soundSystem->createSound(engineSound, FMOD_3D | FMOD_LOOP_NORMAL, 0, &carSounds[i + offset].sound);
-        carSounds[i + offset].sound->set3DMinMaxDistance(MIN_DISTANCE, MAX_DISTANCE);
-        soundSystem->playSound(carSounds[i + offset].sound, 0, true, &carSounds[i + offset].channel);
-        FMOD_VECTOR pos = { aiPos.x, aiPos.y, aiPos.z };
-        FMOD_VECTOR vel = { 0.0f, 0.0f, 0.0f };
-        carSounds[i + offset].channel->set3DAttributes(&pos, &vel);
-        carSounds[i + offset].channel->setPaused(false);
-        carSounds[i + offset].channel->setVolume(aiSoundVolume);
+        carSounds[i + offset].Start(soundSystem, engineSounds, aiSoundVolume);
     }
     carsStarted = true;
 }
 
 void Audio::PauseCars(bool paused) {
-    for (auto carSound : carSounds) { carSound.channel->setPaused(paused); }
+    for (auto& carSound : carSounds) { carSound.SetPaused(paused); }
 }
 
-void Audio::UpdateCars() {
-    const char *engineIdle = "Content/Sounds/Truck/idle.mp3";
-    const char *engineAccelerate = "Content/Sounds/Truck/accelerate.mp3";
-    const char *engineReverse = "Content/Sounds/Truck/reverse.mp3";
+void Audio::UpdateCar(EngineVoice& carSound, Entity* vehicleEntity, bool alive, float volume) {
+    if (!alive) {
+        // Silent while dead, and started again on the new vehicle once respawned
+        carSound.Stop();
+        return;
+    }
+    if (!carSound.IsStarted()) carSound.Start(soundSystem, engineSounds, volume);
 
-    //player
-    for (int i = updatePosition; i < 4 && availableUpdates > 0; i++) {
-        HumanData& player = Game::humanPlayers[i];
-        if (!player.ready || !player.alive) continue;
-        const auto playerPos = player.vehicleEntity->transform.GetGlobalPosition();
-        VehicleComponent* vehicle = player.vehicleEntity->GetComponent<VehicleComponent>();
-        if (vehicle->pxVehicle->mDriveDynData.getCurrentGear() == PxVehicleGearsData::eREVERSE) {
-            // set reverse sound
-            if (!carSounds[i].reversing) {
-                carSounds[i].sound->release();
-                carSounds[i].reversing = true;
-                carSounds[i].changedDirection = true;
-                soundSystem->createSound(engineReverse, FMOD_3D | FMOD_LOOP_NORMAL, 0, &carSounds[i].sound);
-                carSounds[i].sound->set3DMinMaxDistance(MIN_DISTANCE, MAX_DISTANCE);
-                soundSystem->playSound(carSounds[i].sound, 0, true, &carSounds[i].channel);
-                carSounds[i].channel->setPaused(false);
+    VehicleComponent* vehicle = vehicleEntity->GetComponent<VehicleComponent>();
+    const PxVehicleDriveDynData& driveData = vehicle->pxVehicle->mDriveDynData;
+    const float rpm = driveData.getEngineRotationSpeed() * vehicle->pxVehicle->mDriveSimData.getEngineData().getRecipMaxOmega();
+    const bool reversing = driveData.getCurrentGear() == PxVehicleGearsData::eREVERSE;
 
-            }
-        } else {
-            // set forward sound
-            if (carSounds[i].changedDirection) {
-                carSounds[i].sound->release();
-                carSounds[i].changedDirection = false;
-                carSounds[i].reversing = false;
-                soundSystem->createSound(engineIdle, FMOD_3D | FMOD_LOOP_NORMAL, 0, &carSounds[i].sound);
-                carSounds[i].sound->set3DMinMaxDistance(MIN_DISTANCE, MAX_DISTANCE);
-                soundSystem->playSound(carSounds[i].sound, 0, true, &carSounds[i].channel);
-                carSounds[i].channel->setPaused(false);
+    carSound.SetVolume(volume);
+    carSound.Update(vehicleEntity->transform.GetGlobalPosition() + glm::vec3(0.f, 1.f, 0.f), GetVelocity(vehicleEntity), rpm, reversing, StateManager::deltaTime);
+}
 
-            }
-        }
-        FMOD_VECTOR pos = { playerPos.x, playerPos.y+1.0f, playerPos.z };
-        FMOD_VECTOR vel = { 0.0f, 0.0f, 0.0f };
-        carSounds[i].channel->set3DAttributes(&pos, &vel);
-        //carSounds[i].channel->setPaused(true);
-        carSounds[i].channel->setVolume(playerSoundVolume);
-        availableUpdates--;
+void Audio::UpdateCars() {
+    //player
+    for (int i = 0; i < 4; i++) {
+        HumanData& player = Game::humanPlayers[i];
+        if (!player.ready) continue;
+        UpdateCar(carSounds[i], player.vehicleEntity, player.alive, playerSoundVolume);
     }
     size_t offset = Game::gameData.humanCount;
     //ai
-    for (int i = updatePosition - 4; i < Game::gameData.aiCount && availableUpdates > 0; i++) {
+    for (int i = 0; i < Game::gameData.aiCount; i++) {
         AiData& ai = Game::aiPlayers[i];
-        if (!ai.alive) continue;
-        const auto aiPos = ai.vehicleEntity->transform.GetGlobalPosition();
-        FMOD_VECTOR pos = { aiPos.x, aiPos.y, aiPos.z };
-        FMOD_VECTOR vel = { 0.0f, 0.0f, 0.0f };
-        carSounds[i + offset].channel->set3DAttributes(&pos, &vel);
-        carSounds[i + offset].channel->setVolume(aiSoundVolume);
-        availableUpdates--;
+        UpdateCar(carSounds[i + offset], ai.vehicleEntity, ai.alive, aiSoundVolume);
     }
 }
 
 void Audio::StopCars() {
-    for (auto carSound : carSounds) { carSound.sound->release(); }
+    for (auto& carSound : carSounds) { carSound.Stop(); }
     carsStarted = false;
 }
 
@@ -363,45 +385,27 @@ void Audio::UpdateRunningCars() {
     if (carsStarted && currGameState == GameState_Playing) {
         UpdateCars();
     }
-    // give way to first function
-    updateFunctionId = 0;
-    updatePosition = 0;
-}
-
-void Audio::CheckMusic() {
-	bool isPlaying;
-	musicChannel->isPlaying(&isPlaying);
-
-    if (!isPlaying && (StateManager::GetState() == GameState_Playing || StateManager::GetState() == GameState_Paused)) {
-		//play next song
-        music->release();
-        srand(time(NULL));
-        currentMusicIndex = rand() % NUM_MUSIC;
-        PlayMusic(musicPlaylist[currentMusicIndex]);
-    } else if (!isPlaying && StateManager::GetState() == GameState_Menu) {
-        music->release();
-        PlayMusic("Content/Music/imperial-march.mp3");
-    }
 }
 
-int LimitedUpdate(int updatePosition, int updatesAvailable) {
-
-	return updatePosition;
+SystemAccess Audio::GetAccess() const {
+    // Only reads the scene to place listeners and sounds, so it can run alongside rendering
+    return SystemAccess(SystemResource_GameState | SystemResource_Entities | SystemResource_Physics, SystemResource_Audio, false);
 }
 
 void Audio::Update() { 
-    availableUpdates = UPDATES_TO_RUN;
+	UpdateListeners();
 
-	UpdateListeners(); // 4 updates
-
-    while (availableUpdates > 0 && StateManager::GetState() == GameState_Playing) {
-        if (updateFunctionId == 0) UpdateAttached();
-        if (updateFunctionId == 1) UpdateRunningCars(); // 
-        break; // break out of the loops when there are fewer updtes to be done
+    if (StateManager::GetState() == GameState_Playing) {
+        UpdateAttached();
+        UpdateRunningCars();
     }
 	
-    MenuMusicControl(); // prevGameState saved - 1 update
-    CheckMusic(); // 1 update
+    MenuMusicControl(); // prevGameState saved
+
+    // Moves on to the next track by itself, never waiting on the stream opening
+    music.SetVolume(musicVolume);
+    music.Update(StateManager::deltaTime);
 
+    voices->Update(StateManager::deltaTime);
     soundSystem->update();
 }
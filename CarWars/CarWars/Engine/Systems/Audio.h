@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "System.h"
@@ -11,27 +12,24 @@
 #include "fmod/fmod_errors.h"
 #include "../Entities/EntityManager.h"
 #include "glm/glm.hpp"
+#include "Audio/EngineSounds.h"
+#include "Audio/FmodAudioBackend.h"
+#include "Audio/MusicPlayer.h"
+#include "Audio/VoiceManager.h"
 
 #define MAX_DISTANCE 5000.0
 #define MIN_DISTANCE 0.15
 #define MAX_CHANNELS 200
-#define NUM_MUSIC 7
-
-// 25 is too low
-#define UPDATES_TO_RUN 100 // +6 "mandatory updates"
+#define MAX_VOICES 256
+#define MAX_REAL_VOICES 64 // Leaves the rest of MAX_CHANNELS to engines and music
+#define MUSIC_DIRECTORY "Content/Music"
+#define MENU_MUSIC "Content/Music/imperial-march.mp3"
 
 typedef FMOD::Sound* SoundClass;
 
-struct CarSound {
-    unsigned int currentSoundPos;
-    glm::vec3 currentPosition;
-    glm::vec3 lastPosition;
-    glm::vec3 velocity;
-    FMOD::Sound *sound=0;
-    FMOD::Channel *channel=0;
-    bool changedDirection = false;
-    bool reversing = false;
-};
+class DamageEvent;
+class PowerUpPickupEvent;
+class CollisionEvent;
 
 struct WeaponSounds {
     FMOD::Sound* missleLaunch;
@@ -68,7 +66,7 @@ struct EnvironmentalSounds {
 };
 
 struct AttachedSound {
-	FMOD::Channel *channel;
+	VoiceHandle voice;
 	Entity* entity;
 };
 
@@ -88,50 +86,52 @@ public:
     static Audio& Instance();
     ~Audio();
 
+    // Starts every sound decoding in the background
     void Initialize();
 
+    // Waits for the sounds started by Initialize, so that nothing plays before it has loaded
+    void FinishLoading();
+
     void Update() override;
+    SystemAccess GetAccess() const override;
     void PlayMusic(const char *filename);
 
-	void PlayAudio2D(FMOD::Sound* sound, float volume);
-	void PlayAudio3D(FMOD::Sound *s, glm::vec3 position, glm::vec3 velocity, float volume);
-	void PlayAudio3DAttached(FMOD::Sound *s, Entity* entity, float volume);
+	void PlayAudio2D(FMOD::Sound* sound, float volume, int priority = VoicePriority_Critical);
+	void PlayAudio3D(FMOD::Sound *s, glm::vec3 position, glm::vec3 velocity, float volume, int priority = VoicePriority_Normal);
+	void PlayAudio3DAttached(FMOD::Sound *s, Entity* entity, float volume, int priority = VoicePriority_Normal);
+
+	VoiceHandle PlaySound3D(FMOD::Sound* sound, glm::vec3 position, glm::vec3 velocity, float volume, int priority = VoicePriority_Normal);
+	void StopSound3D(VoiceHandle voice);
 
-	int PlaySound3D(FMOD::Sound* sound, glm::vec3 position, glm::vec3 velocity, float volume);
-	void StopSound3D(int index);
+	const VoiceManager& GetVoices() const;
 
 private:
-    int updateFunctionId;
-    int availableUpdates;
-    int updatePosition;
+	// Packed so that updating them is a straight walk, indexed by voice slot (plus one, zero for none) to remove them
 	vector<AttachedSound> attachedSounds;
+	vector<size_t> attachedSoundIndices;
+	EntityManager::DestroyListenerId destroyListener;
     bool gameStarted = false;
-    int currentMusicIndex = 0;
-    const char *musicPlaylist[NUM_MUSIC] = {
-        "Content/Music/unity.mp3",
-        "Content/Music/hello.mp3",
-        "Content/Music/highscore.mp3",
-        "Content/Music/invincible.mp3",
-        "Content/Music/lone-digger.mp3",
-        "Content/Music/monody.mp3",
-        "Content/Music/xenogenesis.mp3"
-    };
 
     FMOD::System *soundSystem;
     GameState prevGameState;
     bool carsStarted = false;
 
-	FMOD::Sound* soundArray3D[100];
-	FMOD::Channel* channelArray3D[100];
-	bool availableSound3D[100];
+	std::unique_ptr<FmodAudioBackend> backend;
+	std::unique_ptr<VoiceManager> voices;
+
+    EngineSoundBank engineSounds;
 
-    std::vector<CarSound> carSounds;
-    //unsigned int gameMusicPosition, gameMusicLength;
-    FMOD::Sound *music;
-    FMOD::Channel *musicChannel;
+    // Sounds still opening in the background, with when they were asked for
+    struct PendingSound {
+        const char* filePath;
+        FMOD::Sound* sound;
+        double requested;
+    };
+    std::vector<PendingSound> pendingSounds;
+    std::vector<EngineVoice> carSounds;
+    MusicPlayer music;
 
     FMOD::Sound *sound, *sound3d, *soundToPlay, *soundToPlay3d;
-    FMOD::Channel *channel = 0, *channel3d = 0;
     FMOD_RESULT result;
     unsigned int version;
     int numsubsounds;
@@ -145,11 +145,20 @@ private:
     void StartCars();
     void PauseCars(bool paused);
     void UpdateCars();
+    void UpdateCar(EngineVoice& carSound, Entity* vehicleEntity, bool alive, float volume);
     void StopCars();
     void ReleaseSounds();
-    void CheckMusic();
     void AddSoundToMemory(const char *filepath, FMOD::Sound** sound);
+    void SetRateLimits();
 	void UpdateAttached();
+	void RemoveAttachedSound(size_t index);
+	void OnVoiceFinished(VoiceHandle voice);
+	void OnEntityDestroyed(Entity* entity);
+	static glm::vec3 GetVelocity(Entity* entity);
+
+    void OnDamage(const DamageEvent& event);
+    void OnPowerUpPickup(const PowerUpPickupEvent& event);
+    void OnCollision(const CollisionEvent& event);
 
 
     // No instantiation or copying
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../Time.h"
+#include <glm/glm.hpp>
+
+namespace FMOD {
+    class Sound;
+}
+
+// Channels are whatever the backend hands out, the voice manager only ever passes them back to it
+typedef void* AudioChannel;
+
+// Told about every channel that ends, whether it ran out or was stopped, along with the userData it was played with
+typedef void (*ChannelEndedCallback)(void* context, AudioChannel channel, void* userData);
+
+// The few things the voice manager needs from the mixer. Keeping them behind this interface lets the
+// voice manager run against NullAudioBackend when there is no audio device (e.g. in tests).
+class AudioBackend {
+public:
+    virtual ~AudioBackend() {}
+
+    virtual void SetChannelEndedCallback(ChannelEndedCallback callback, void* context) = 0;
+
+    // Starts the sound paused at offset into it, returns nullptr if no channel could be started
+    virtual AudioChannel Play(FMOD::Sound* sound, Time offset, void* userData) = 0;
+    virtual void Stop(AudioChannel channel) = 0;
+
+    virtual void SetPaused(AudioChannel channel, bool paused) = 0;
+    virtual void SetVolume(AudioChannel channel, float volume) = 0;
+    virtual void Set3DAttributes(AudioChannel channel, glm::vec3 position, glm::vec3 velocity) = 0;
+
+    virtual Time GetPosition(AudioChannel channel) const = 0;
+
+    virtual Time GetLength(FMOD::Sound* sound) const = 0;
+    virtual bool IsLooping(FMOD::Sound* sound) const = 0;
+};
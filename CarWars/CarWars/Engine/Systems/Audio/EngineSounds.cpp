@@ -0,0 +1,169 @@
+#include "EngineSounds.h"
+#include "FmodAudioBackend.h"
+#include "../Content/StartupProfile.h"
+#include "fmod/fmod.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    const char* LAYER_FILES[EngineLayer_Count] = {
+        "Content/Sounds/Truck/idle.mp3",
+        "Content/Sounds/Truck/accelerate.mp3",
+        "Content/Sounds/Truck/reverse.mp3"
+    };
+
+    // How quickly layer volumes and pitch follow the engine, per second
+    constexpr float MIX_RATE = 8.f;
+
+    float SmoothStep(float edge0, float edge1, float x) {
+        const float t = std::min(std::max((x - edge0) / (edge1 - edge0), 0.f), 1.f);
+        return t * t * (3.f - 2.f * t);
+    }
+}
+
+EngineSoundBank::EngineSoundBank() : layers{ nullptr, nullptr, nullptr }, minDistance(0.f), maxDistance(0.f), requested(0.0) {}
+
+bool EngineSoundBank::Load(FMOD::System* system, float _minDistance, float _maxDistance) {
+    minDistance = _minDistance;
+    maxDistance = _maxDistance;
+    requested = StartupProfile::Now();
+
+    bool loaded = true;
+    for (size_t i = 0; i < EngineLayer_Count; ++i) {
+        // Decompress up front so that starting a car never decodes anything
+        const FMOD_MODE mode = FMOD_3D | FMOD_LOOP_NORMAL | FMOD_CREATESAMPLE | FMOD_NONBLOCKING;
+        const FMOD_RESULT result = system->createSound(LAYER_FILES[i], mode, 0, &layers[i]);
+        if (result != FMOD_OK) {
+            std::cout << "Error creating sound " << LAYER_FILES[i] << std::endl;
+            layers[i] = nullptr;
+            loaded = false;
+        }
+    }
+    return loaded;
+}
+
+bool EngineSoundBank::FinishLoading() {
+    bool loaded = true;
+    for (size_t i = 0; i < EngineLayer_Count; ++i) {
+        if (!layers[i]) {
+            loaded = false;
+            continue;
+        }
+        if (!FmodAudioBackend::WaitUntilOpen(layers[i])) {
+            std::cout << "Error creating sound " << LAYER_FILES[i] << std::endl;
+            layers[i]->release();
+            layers[i] = nullptr;
+            loaded = false;
+            continue;
+        }
+        layers[i]->set3DMinMaxDistance(minDistance, maxDistance);
+
+        unsigned int bytes = 0;
+        layers[i]->getLength(&bytes, FMOD_TIMEUNIT_PCMBYTES);
+        StartupProfile::Record(StartupAsset_Sound, LAYER_FILES[i], bytes, StartupProfile::Now() - requested, 0.0);
+    }
+    return loaded;
+}
+
+void EngineSoundBank::Release() {
+    for (FMOD::Sound*& layer : layers) {
+        if (layer) layer->release();
+        layer = nullptr;
+    }
+}
+
+bool EngineSoundBank::IsLoaded() const {
+    for (FMOD::Sound* layer : layers) {
+        if (!layer) return false;
+    }
+    return true;
+}
+
+FMOD::Sound* EngineSoundBank::GetLayer(EngineLayer layer) const {
+    return layers[layer];
+}
+
+EngineMix GetEngineMix(float rpm, bool reversing) {
+    rpm = std::min(std::max(rpm, 0.f), 1.f);
+
+    EngineMix mix;
+    if (reversing) {
+        mix.weights[EngineLayer_Idle] = 0.f;
+        mix.weights[EngineLayer_Accelerate] = 0.f;
+        mix.weights[EngineLayer_Reverse] = 1.f;
+    } else {
+        const float accelerate = SmoothStep(0.15f, 0.55f, rpm);
+        mix.weights[EngineLayer_Idle] = 1.f - accelerate;
+        mix.weights[EngineLayer_Accelerate] = accelerate;
+        mix.weights[EngineLayer_Reverse] = 0.f;
+    }
+    mix.pitch = 0.85f + 0.5f * rpm;
+    return mix;
+}
+
+EngineVoice::EngineVoice() : channels{ nullptr, nullptr, nullptr }, weights{ 1.f, 0.f, 0.f }, pitch(1.f), volume(1.f), started(false), positioned(false) {}
+
+void EngineVoice::Start(FMOD::System* system, const EngineSoundBank& bank, float _volume) {
+    Stop();
+    volume = _volume;
+    weights[EngineLayer_Idle] = 1.f;
+    weights[EngineLayer_Accelerate] = 0.f;
+    weights[EngineLayer_Reverse] = 0.f;
+    pitch = 1.f;
+
+    for (size_t i = 0; i < EngineLayer_Count; ++i) {
+        FMOD::Sound* sound = bank.GetLayer(static_cast<EngineLayer>(i));
+        if (!sound || system->playSound(sound, 0, true, &channels[i]) != FMOD_OK) {
+            channels[i] = nullptr;
+            continue;
+        }
+        channels[i]->setVolume(volume * weights[i]);
+    }
+    started = true;
+
+    // Channels stay paused until the first Update places them, so they don't start at the origin
+    positioned = false;
+}
+
+void EngineVoice::Stop() {
+    for (FMOD::Channel*& channel : channels) {
+        if (channel) channel->stop();
+        channel = nullptr;
+    }
+    started = false;
+}
+
+bool EngineVoice::IsStarted() const {
+    return started;
+}
+
+void EngineVoice::SetPaused(bool paused) {
+    for (FMOD::Channel* channel : channels) {
+        if (channel) channel->setPaused(paused);
+    }
+}
+
+void EngineVoice::SetVolume(float _volume) {
+    volume = _volume;
+}
+
+void EngineVoice::Update(glm::vec3 position, glm::vec3 velocity, float rpm, bool reversing, Time deltaTime) {
+    if (!started) return;
+
+    const EngineMix target = GetEngineMix(rpm, reversing);
+    const float blend = std::min(deltaTime.GetSeconds() * MIX_RATE, 1.f);
+    pitch += (target.pitch - pitch) * blend;
+
+    const FMOD_VECTOR pos = { position.x, position.y, position.z };
+    const FMOD_VECTOR vel = { velocity.x, velocity.y, velocity.z };
+    for (size_t i = 0; i < EngineLayer_Count; ++i) {
+        weights[i] += (target.weights[i] - weights[i]) * blend;
+        if (!channels[i]) continue;
+        channels[i]->set3DAttributes(&pos, &vel);
+        channels[i]->setVolume(volume * weights[i]);
+        channels[i]->setPitch(pitch);
+        if (!positioned) channels[i]->setPaused(false);
+    }
+    positioned = true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../Time.h"
+#include <glm/glm.hpp>
+
+namespace FMOD {
+    class System;
+    class Sound;
+    class Channel;
+}
+
+enum EngineLayer {
+    EngineLayer_Idle = 0,
+    EngineLayer_Accelerate,
+    EngineLayer_Reverse,
+    EngineLayer_Count
+};
+
+// Engine loops decoded into memory once at load time and shared by every car
+class EngineSoundBank {
+public:
+    EngineSoundBank();
+
+    // Starts decoding every layer in the background. FinishLoading waits for them.
+    bool Load(FMOD::System* system, float _minDistance, float _maxDistance);
+    bool FinishLoading();
+    void Release();
+
+    bool IsLoaded() const;
+    FMOD::Sound* GetLayer(EngineLayer layer) const;
+
+private:
+    FMOD::Sound* layers[EngineLayer_Count];
+    float minDistance;
+    float maxDistance;
+    double requested;
+};
+
+// How loud each layer should be and how fast the engine loops play back
+struct EngineMix {
+    float weights[EngineLayer_Count];
+    float pitch;
+};
+
+// rpm is the engine speed as a fraction of its maximum
+EngineMix GetEngineMix(float rpm, bool reversing);
+
+// One car's engine. Every layer loops the whole time the car is alive and only their volumes change,
+// so switching between idling, accelerating and reversing is a crossfade rather than a restart.
+class EngineVoice {
+public:
+    EngineVoice();
+
+    void Start(FMOD::System* system, const EngineSoundBank& bank, float _volume);
+    void Stop();
+    bool IsStarted() const;
+
+    void SetPaused(bool paused);
+    void SetVolume(float _volume);
+
+    void Update(glm::vec3 position, glm::vec3 velocity, float rpm, bool reversing, Time deltaTime);
+
+private:
+    FMOD::Channel* channels[EngineLayer_Count];
+    float weights[EngineLayer_Count];
+    float pitch;
+    float volume;
+    bool started;
+    bool positioned;
+};
@@ -0,0 +1,87 @@
+#include "FmodAudioBackend.h"
+#include "fmod/fmod.hpp"
+#include <chrono>
+#include <thread>
+
+FmodAudioBackend::FmodAudioBackend(FMOD::System* _system) : system(_system), channelEnded(nullptr), channelEndedContext(nullptr) {
+    // Lets the channel callback find its way back here
+    system->setUserData(this);
+}
+
+void FmodAudioBackend::SetChannelEndedCallback(ChannelEndedCallback callback, void* context) {
+    channelEnded = callback;
+    channelEndedContext = context;
+}
+
+AudioChannel FmodAudioBackend::Play(FMOD::Sound* sound, Time offset, void* userData) {
+    FMOD::Channel* channel = nullptr;
+    if (system->playSound(sound, 0, true, &channel) != FMOD_OK) return nullptr;
+    if (offset > 0.0) channel->setPosition(static_cast<unsigned int>(offset.GetMilliseconds()), FMOD_TIMEUNIT_MS);
+    channel->setUserData(userData);
+    channel->setCallback(OnChannelEvent);
+    return channel;
+}
+
+FMOD_RESULT F_CALLBACK FmodAudioBackend::OnChannelEvent(FMOD_CHANNELCONTROL* channelControl, FMOD_CHANNELCONTROL_TYPE controlType,
+    FMOD_CHANNELCONTROL_CALLBACK_TYPE callbackType, void* data1, void* data2) {
+
+    // Called from inside System::update on the main thread
+    if (controlType != FMOD_CHANNELCONTROL_CHANNEL || callbackType != FMOD_CHANNELCONTROL_CALLBACK_END) return FMOD_OK;
+
+    FMOD::Channel* channel = reinterpret_cast<FMOD::Channel*>(channelControl);
+    FMOD::System* system = nullptr;
+    void* backend = nullptr;
+    void* userData = nullptr;
+    channel->getSystemObject(&system);
+    system->getUserData(&backend);
+    channel->getUserData(&userData);
+
+    FmodAudioBackend* self = static_cast<FmodAudioBackend*>(backend);
+    if (self && self->channelEnded) self->channelEnded(self->channelEndedContext, channel, userData);
+    return FMOD_OK;
+}
+
+void FmodAudioBackend::Stop(AudioChannel channel) {
+    static_cast<FMOD::Channel*>(channel)->stop();
+}
+
+void FmodAudioBackend::SetPaused(AudioChannel channel, bool paused) {
+    static_cast<FMOD::Channel*>(channel)->setPaused(paused);
+}
+
+void FmodAudioBackend::SetVolume(AudioChannel channel, float volume) {
+    static_cast<FMOD::Channel*>(channel)->setVolume(volume);
+}
+
+void FmodAudioBackend::Set3DAttributes(AudioChannel channel, glm::vec3 position, glm::vec3 velocity) {
+    FMOD_VECTOR pos = { position.x, position.y, position.z };
+    FMOD_VECTOR vel = { velocity.x, velocity.y, velocity.z };
+    static_cast<FMOD::Channel*>(channel)->set3DAttributes(&pos, &vel);
+}
+
+Time FmodAudioBackend::GetPosition(AudioChannel channel) const {
+    unsigned int position = 0;
+    static_cast<FMOD::Channel*>(channel)->getPosition(&position, FMOD_TIMEUNIT_MS);
+    return Time::FromMilliseconds(position);
+}
+
+Time FmodAudioBackend::GetLength(FMOD::Sound* sound) const {
+    unsigned int length = 0;
+    sound->getLength(&length, FMOD_TIMEUNIT_MS);
+    return Time::FromMilliseconds(length);
+}
+
+bool FmodAudioBackend::IsLooping(FMOD::Sound* sound) const {
+    FMOD_MODE mode = 0;
+    sound->getMode(&mode);
+    return (mode & FMOD_LOOP_NORMAL) != 0;
+}
+
+bool FmodAudioBackend::WaitUntilOpen(FMOD::Sound* sound) {
+    FMOD_OPENSTATE state;
+    do {
+        if (sound->getOpenState(&state, nullptr, nullptr, nullptr) != FMOD_OK) return false;
+        if (state == FMOD_OPENSTATE_LOADING) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    } while (state == FMOD_OPENSTATE_LOADING);
+    return state == FMOD_OPENSTATE_READY;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "AudioBackend.h"
+#include "fmod/fmod_common.h"
+
+namespace FMOD {
+    class System;
+}
+
+class FmodAudioBackend : public AudioBackend {
+public:
+    explicit FmodAudioBackend(FMOD::System* _system);
+
+    void SetChannelEndedCallback(ChannelEndedCallback callback, void* context) override;
+
+    AudioChannel Play(FMOD::Sound* sound, Time offset, void* userData) override;
+    void Stop(AudioChannel channel) override;
+
+    void SetPaused(AudioChannel channel, bool paused) override;
+    void SetVolume(AudioChannel channel, float volume) override;
+    void Set3DAttributes(AudioChannel channel, glm::vec3 position, glm::vec3 velocity) override;
+
+    Time GetPosition(AudioChannel channel) const override;
+
+    Time GetLength(FMOD::Sound* sound) const override;
+    bool IsLooping(FMOD::Sound* sound) const override;
+
+    // Blocks until a sound opened with FMOD_NONBLOCKING is ready. False if it failed to open.
+    static bool WaitUntilOpen(FMOD::Sound* sound);
+
+private:
+    static FMOD_RESULT F_CALLBACK OnChannelEvent(FMOD_CHANNELCONTROL* channelControl, FMOD_CHANNELCONTROL_TYPE controlType,
+        FMOD_CHANNELCONTROL_CALLBACK_TYPE callbackType, void* data1, void* data2);
+
+    FMOD::System* system;
+
+    ChannelEndedCallback channelEnded;
+    void* channelEndedContext;
+};
@@ -0,0 +1,209 @@
+#include "MusicPlayer.h"
+#include "fmod/fmod.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <experimental/filesystem>
+#include <iostream>
+
+namespace {
+    // Seconds to crossfade between tracks, also how long before the end of a track the next one starts
+    constexpr float CROSSFADE_TIME = 2.f;
+
+    bool IsMusicFile(const std::string& extension) {
+        std::string lower = extension;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        return lower == ".mp3" || lower == ".ogg" || lower == ".wav" || lower == ".flac";
+    }
+}
+
+MusicPlayer::MusicPlayer() : system(nullptr), volume(1.f), lastTrack(0), playingPlaylist(false), current(0), nextSound(nullptr), startWhenReady(false) {}
+
+void MusicPlayer::Initialize(FMOD::System* _system, const std::string& directory, float _volume, const std::string& skip) {
+    namespace fs = std::experimental::filesystem;
+
+    system = _system;
+    volume = _volume;
+
+    playlist.clear();
+    std::error_code error;
+    for (fs::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        const fs::path& path = it->path();
+        if (fs::is_regular_file(path, error) && IsMusicFile(path.extension().string()) && path.generic_string() != skip) {
+            playlist.push_back(path.generic_string());
+        }
+    }
+    std::sort(playlist.begin(), playlist.end());
+
+    if (playlist.empty()) std::cout << "No music found in " << directory << std::endl;
+    lastTrack = playlist.empty() ? 0 : rand() % playlist.size();
+}
+
+void MusicPlayer::Release() {
+    for (Deck& deck : decks) {
+        StopDeck(deck);
+    }
+    ReleaseWhenOpen(nextSound);
+    nextSound = nullptr;
+    startWhenReady = false;
+
+    // Shutting down, so waiting for streams still opening is fine now
+    for (FMOD::Sound* sound : pendingRelease) {
+        sound->release();
+    }
+    pendingRelease.clear();
+}
+
+void MusicPlayer::PlayTrack(const std::string& path) {
+    playingPlaylist = false;
+    ReleaseWhenOpen(nextSound);
+    nextSound = Open(path, true);
+    startWhenReady = true;
+    StartIncoming();
+}
+
+void MusicPlayer::PlayPlaylist() {
+    if (playlist.empty()) return;
+    playingPlaylist = true;
+    ReleaseWhenOpen(nextSound);
+    nextSound = Open(PickTrack(), false);
+    startWhenReady = true;
+    StartIncoming();
+}
+
+void MusicPlayer::SetVolume(float _volume) {
+    volume = _volume;
+}
+
+const std::vector<std::string>& MusicPlayer::GetPlaylist() const {
+    return playlist;
+}
+
+void MusicPlayer::Update(Time deltaTime) {
+    if (!system) return;
+
+    if (startWhenReady) StartIncoming();
+
+    // Fades
+    const float step = deltaTime.GetSeconds() / CROSSFADE_TIME;
+    for (Deck& deck : decks) {
+        if (!deck.channel) continue;
+        if (deck.fade < deck.fadeTarget) deck.fade = std::min(deck.fade + step, deck.fadeTarget);
+        else if (deck.fade > deck.fadeTarget) deck.fade = std::max(deck.fade - step, deck.fadeTarget);
+        deck.channel->setVolume(deck.fade * volume);
+
+        bool playing = false;
+        deck.channel->isPlaying(&playing);
+        if ((deck.fade <= 0.f && deck.fadeTarget <= 0.f) || !playing) StopDeck(deck);
+    }
+
+    if (playingPlaylist) {
+        // Open the next track while this one plays
+        const Deck& active = decks[current];
+        if (!nextSound) nextSound = Open(PickTrack(), false);
+
+        // and start it shortly before this one ends
+        bool ending = !active.channel;
+        if (active.channel) {
+            unsigned int position = 0;
+            unsigned int length = 0;
+            active.channel->getPosition(&position, FMOD_TIMEUNIT_MS);
+            active.sound->getLength(&length, FMOD_TIMEUNIT_MS);
+            ending = length > 0 && position + static_cast<unsigned int>(CROSSFADE_TIME * 1000.f) >= length;
+        }
+        if (ending && !startWhenReady) {
+            startWhenReady = true;
+            StartIncoming();
+        }
+    }
+
+    // Finish releasing streams that were still opening
+    for (size_t i = 0; i < pendingRelease.size();) {
+        bool failed = false;
+        if (IsReady(pendingRelease[i], failed) || failed) {
+            pendingRelease[i]->release();
+            pendingRelease[i] = pendingRelease.back();
+            pendingRelease.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+FMOD::Sound* MusicPlayer::Open(const std::string& path, bool loop) {
+    FMOD::Sound* sound = nullptr;
+    const FMOD_MODE mode = FMOD_CREATESTREAM | FMOD_NONBLOCKING | FMOD_2D | (loop ? FMOD_LOOP_NORMAL : FMOD_LOOP_OFF);
+    if (system->createStream(path.c_str(), mode, 0, &sound) != FMOD_OK) {
+        std::cout << "Error opening music " << path << std::endl;
+        return nullptr;
+    }
+    return sound;
+}
+
+bool MusicPlayer::IsReady(FMOD::Sound* sound, bool& failed) const {
+    FMOD_OPENSTATE state;
+    if (sound->getOpenState(&state, nullptr, nullptr, nullptr) != FMOD_OK) {
+        failed = true;
+        return false;
+    }
+    failed = state == FMOD_OPENSTATE_ERROR;
+    return state == FMOD_OPENSTATE_READY;
+}
+
+void MusicPlayer::StartIncoming() {
+    if (!nextSound) return;
+
+    bool failed = false;
+    if (!IsReady(nextSound, failed)) {
+        if (failed) {
+            // Try another track rather than going silent
+            ReleaseWhenOpen(nextSound);
+            nextSound = playingPlaylist ? Open(PickTrack(), false) : nullptr;
+            startWhenReady = nextSound != nullptr;
+        }
+        return;
+    }
+
+    // Cut short anything still fading out to make room
+    Deck& incoming = decks[1 - current];
+    StopDeck(incoming);
+
+    startWhenReady = false;
+    if (system->playSound(nextSound, 0, true, &incoming.channel) != FMOD_OK) {
+        ReleaseWhenOpen(nextSound);
+        nextSound = nullptr;
+        incoming.channel = nullptr;
+        return;
+    }
+    incoming.sound = nextSound;
+    incoming.fade = decks[current].channel ? 0.f : 1.f;
+    incoming.fadeTarget = 1.f;
+    incoming.channel->setVolume(incoming.fade * volume);
+    incoming.channel->setPaused(false);
+    nextSound = nullptr;
+
+    decks[current].fadeTarget = 0.f;
+    current = 1 - current;
+}
+
+void MusicPlayer::StopDeck(Deck& deck) {
+    if (deck.channel) deck.channel->stop();
+    ReleaseWhenOpen(deck.sound);
+    deck = Deck();
+}
+
+void MusicPlayer::ReleaseWhenOpen(FMOD::Sound* sound) {
+    if (!sound) return;
+    bool failed = false;
+    if (IsReady(sound, failed) || failed) sound->release();
+    else pendingRelease.push_back(sound);
+}
+
+const std::string& MusicPlayer::PickTrack() {
+    // Random, but never the same track twice in a row
+    if (playlist.size() > 1) {
+        const size_t next = rand() % (playlist.size() - 1);
+        lastTrack = next >= lastTrack ? next + 1 : next;
+    }
+    return playlist[lastTrack];
+}
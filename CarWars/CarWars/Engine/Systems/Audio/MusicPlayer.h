@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../Time.h"
+#include <string>
+#include <vector>
+
+namespace FMOD {
+    class System;
+    class Sound;
+    class Channel;
+}
+
+// Streams music without ever waiting on the disk. Streams are opened in the background (FMOD_NONBLOCKING) and only
+// start once they're ready, so a track that's still opening keeps the previous one playing rather than stalling the frame.
+// While a playlist track plays the next one is already being opened, and tracks crossfade into each other.
+class MusicPlayer {
+public:
+    MusicPlayer();
+
+    // Scans directory for tracks to make up the playlist, leaving out skip
+    void Initialize(FMOD::System* _system, const std::string& directory, float _volume, const std::string& skip = "");
+    void Release();
+
+    // Crossfades to a single track that loops until something else is played
+    void PlayTrack(const std::string& path);
+
+    // Crossfades to a random track from the playlist and keeps playing random tracks after it
+    void PlayPlaylist();
+
+    void SetVolume(float _volume);
+
+    const std::vector<std::string>& GetPlaylist() const;
+
+    void Update(Time deltaTime);
+
+private:
+    struct Deck {
+        Deck() : sound(nullptr), channel(nullptr), fade(0.f), fadeTarget(0.f) {}
+
+        FMOD::Sound* sound;
+        FMOD::Channel* channel;
+        float fade;
+        float fadeTarget;
+    };
+
+    FMOD::Sound* Open(const std::string& path, bool loop);
+    bool IsReady(FMOD::Sound* sound, bool& failed) const;
+
+    // Crossfades to nextSound if it has finished opening
+    void StartIncoming();
+    void StopDeck(Deck& deck);
+    void ReleaseWhenOpen(FMOD::Sound* sound);
+    const std::string& PickTrack();
+
+    FMOD::System* system;
+    float volume;
+
+    std::vector<std::string> playlist;
+    size_t lastTrack;
+    bool playingPlaylist;
+
+    Deck decks[2];
+    size_t current;
+
+    // Track to play next. Playlist tracks are opened ahead of time and only started once the current one is ending.
+    FMOD::Sound* nextSound;
+    bool startWhenReady;
+
+    // Releasing a stream that is still opening would block, so those wait here until they're done
+    std::vector<FMOD::Sound*> pendingRelease;
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "AudioBackend.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Backend that plays nothing but keeps track of channels as if it did. Channels only advance when Advance is
+// called, so whoever drives it decides how time passes.
+class NullAudioBackend : public AudioBackend {
+public:
+    NullAudioBackend() : channelEnded(nullptr), channelEndedContext(nullptr) {}
+
+    struct Channel {
+        FMOD::Sound* sound;
+        void* userData;
+        Time position;
+        float volume;
+        glm::vec3 position3D;
+        bool paused;
+        bool playing;
+    };
+
+    // Sounds that haven't been described play for one second without looping
+    void SetSound(FMOD::Sound* sound, Time length, bool looping) {
+        sounds[sound] = SoundInfo{ length, looping };
+    }
+
+    void Advance(Time deltaTime) {
+        for (const std::unique_ptr<Channel>& channel : channels) {
+            if (!channel->playing || channel->paused) continue;
+            channel->position += deltaTime;
+            if (channel->position >= GetLength(channel->sound)) {
+                if (IsLooping(channel->sound)) channel->position = 0.0;
+                else End(channel.get());
+            }
+        }
+    }
+
+    size_t GetPlayingCount() const {
+        size_t count = 0;
+        for (const std::unique_ptr<Channel>& channel : channels) {
+            if (channel->playing) ++count;
+        }
+        return count;
+    }
+
+    void SetChannelEndedCallback(ChannelEndedCallback callback, void* context) override {
+        channelEnded = callback;
+        channelEndedContext = context;
+    }
+
+    AudioChannel Play(FMOD::Sound* sound, Time offset, void* userData) override {
+        // Reuse a stopped channel so that the channel list stays as long as the most ever played at once
+        Channel* channel = nullptr;
+        for (const std::unique_ptr<Channel>& existing : channels) {
+            if (!existing->playing) {
+                channel = existing.get();
+                break;
+            }
+        }
+        if (!channel) {
+            channels.push_back(std::unique_ptr<Channel>(new Channel()));
+            channel = channels.back().get();
+        }
+        *channel = Channel{ sound, userData, offset, 1.f, glm::vec3(0.f), true, true };
+        return channel;
+    }
+
+    void Stop(AudioChannel channel) override {
+        End(static_cast<Channel*>(channel));
+    }
+
+    void SetPaused(AudioChannel channel, bool paused) override {
+        static_cast<Channel*>(channel)->paused = paused;
+    }
+
+    void SetVolume(AudioChannel channel, float volume) override {
+        static_cast<Channel*>(channel)->volume = volume;
+    }
+
+    void Set3DAttributes(AudioChannel channel, glm::vec3 position, glm::vec3 velocity) override {
+        static_cast<Channel*>(channel)->position3D = position;
+    }
+
+    Time GetPosition(AudioChannel channel) const override {
+        return static_cast<Channel*>(channel)->position;
+    }
+
+    Time GetLength(FMOD::Sound* sound) const override {
+        const auto it = sounds.find(sound);
+        return it != sounds.end() ? it->second.length : Time(1.0);
+    }
+
+    bool IsLooping(FMOD::Sound* sound) const override {
+        const auto it = sounds.find(sound);
+        return it != sounds.end() && it->second.looping;
+    }
+
+private:
+    void End(Channel* channel) {
+        if (!channel->playing) return;
+        channel->playing = false;
+        if (channelEnded) channelEnded(channelEndedContext, channel, channel->userData);
+    }
+
+    struct SoundInfo {
+        Time length;
+        bool looping;
+    };
+
+    std::vector<std::unique_ptr<Channel>> channels;
+    std::unordered_map<FMOD::Sound*, SoundInfo> sounds;
+
+    ChannelEndedCallback channelEnded;
+    void* channelEndedContext;
+};
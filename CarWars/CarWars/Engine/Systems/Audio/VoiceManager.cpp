@@ -0,0 +1,318 @@
+#include "VoiceManager.h"
+#include "../Memory/FrameAllocator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // How much louder a virtual voice has to be before it takes a real voice's channel
+    constexpr float REAL_VOICE_BONUS = 1.25f;
+}
+
+VoiceManager::VoiceManager(AudioBackend& _backend, size_t _maxRealVoices, size_t maxVoices) : backend(_backend),
+    maxRealVoices(_maxRealVoices), realVoiceCount(0), rejectedCount(0), paused(false), listenerCount(0), minDistance(1.f),
+    rolloffScale(1.f), audibilityThreshold(0.001f), clock(0.0) {
+
+    // Every slot exists up front so that starting a voice never allocates
+    voices.resize(maxVoices);
+    freeVoices.reserve(maxVoices);
+    active.reserve(maxVoices);
+    for (size_t i = maxVoices; i > 0; --i) {
+        Voice& voice = voices[i - 1];
+        voice.generation = 1;
+        voice.alive = false;
+        voice.channel = nullptr;
+        freeVoices.push_back(static_cast<uint32_t>(i - 1));
+    }
+
+    backend.SetChannelEndedCallback(OnChannelEnded, this);
+}
+
+VoiceManager::~VoiceManager() {
+    backend.SetChannelEndedCallback(nullptr, nullptr);
+}
+
+VoiceHandle VoiceManager::Play(FMOD::Sound* sound, const VoiceParams& params) {
+    RateLimit* limit = nullptr;
+    const auto it = rateLimits.find(sound);
+    if (it != rateLimits.end()) {
+        limit = &it->second;
+        if (limit->instances >= limit->maxInstances || clock - limit->lastStart < limit->minInterval) {
+            rejectedCount++;
+            return VoiceHandle();
+        }
+    }
+
+    if (freeVoices.empty()) {
+        rejectedCount++;
+        return VoiceHandle();
+    }
+
+    const uint32_t index = freeVoices.back();
+    freeVoices.pop_back();
+
+    Voice& voice = voices[index];
+    voice.activeIndex = static_cast<uint32_t>(active.size());
+    voice.alive = true;
+    voice.paused = paused && params.pausable;
+    voice.selected = false;
+    voice.sound = sound;
+    voice.channel = nullptr;
+    voice.limit = limit;
+    voice.params = params;
+    voice.position = 0.0;
+    voice.length = backend.GetLength(sound);
+    voice.looping = backend.IsLooping(sound);
+    voice.audibility = GetAudibility(voice);
+    voice.score = voice.audibility;
+    active.push_back(index);
+
+    if (limit) {
+        limit->instances++;
+        limit->lastStart = clock;
+    }
+
+    // Start straight away if there's room, otherwise wait for the next Update to rank it against the others
+    if (realVoiceCount < maxRealVoices && voice.audibility >= audibilityThreshold) MakeReal(voice);
+
+    VoiceHandle handle;
+    handle.index = index;
+    handle.generation = voice.generation;
+    return handle;
+}
+
+void VoiceManager::Stop(VoiceHandle handle) {
+    Voice* voice = Get(handle);
+    if (!voice) return;
+    if (voice->channel) MakeVirtual(*voice);
+    Free(handle.index);
+}
+
+void VoiceManager::StopAll() {
+    while (!active.empty()) {
+        Voice& voice = voices[active.back()];
+        if (voice.channel) MakeVirtual(voice);
+        Free(active.back());
+    }
+    rejectedCount = 0;
+}
+
+bool VoiceManager::IsPlaying(VoiceHandle voice) const {
+    return Get(voice) != nullptr;
+}
+
+bool VoiceManager::IsReal(VoiceHandle handle) const {
+    const Voice* voice = Get(handle);
+    return voice && voice->channel;
+}
+
+void VoiceManager::SetPosition(VoiceHandle handle, glm::vec3 position, glm::vec3 velocity) {
+    Voice* voice = Get(handle);
+    if (!voice) return;
+    voice->params.position = position;
+    voice->params.velocity = velocity;
+    if (voice->channel) backend.Set3DAttributes(voice->channel, position, velocity);
+}
+
+void VoiceManager::SetVolume(VoiceHandle handle, float volume) {
+    Voice* voice = Get(handle);
+    if (!voice) return;
+    voice->params.volume = volume;
+    if (voice->channel) backend.SetVolume(voice->channel, volume);
+}
+
+void VoiceManager::SetPaused(bool _paused) {
+    paused = _paused;
+    for (uint32_t index : active) {
+        Voice& voice = voices[index];
+        if (!voice.params.pausable) continue;
+        voice.paused = paused;
+        if (voice.channel) backend.SetPaused(voice.channel, paused);
+    }
+}
+
+void VoiceManager::SetRateLimit(FMOD::Sound* sound, Time minInterval, size_t maxInstances) {
+    const auto inserted = rateLimits.insert(std::make_pair(sound, RateLimit()));
+    RateLimit& limit = inserted.first->second;
+    if (inserted.second) {
+        // Voices already playing this sound don't know about the limit, so they aren't counted against it
+        limit.instances = 0;
+    }
+    limit.minInterval = minInterval;
+    limit.maxInstances = maxInstances;
+    limit.lastStart = clock - minInterval;
+}
+
+void VoiceManager::SetListeners(const glm::vec3* positions, size_t count) {
+    listenerCount = count < MAX_LISTENERS ? count : MAX_LISTENERS;
+    std::copy(positions, positions + listenerCount, listeners);
+}
+
+void VoiceManager::SetRolloff(float _minDistance, float _rolloffScale) {
+    minDistance = _minDistance;
+    rolloffScale = _rolloffScale;
+}
+
+void VoiceManager::SetAudibilityThreshold(float threshold) {
+    audibilityThreshold = threshold;
+}
+
+void VoiceManager::SetFinishedCallback(std::function<void(VoiceHandle)> callback) {
+    finishedCallback = callback;
+}
+
+void VoiceManager::Update(Time deltaTime) {
+    clock += deltaTime;
+
+    // End virtual voices that ran out and score the rest
+    FrameVector<uint32_t> audible;
+    audible.reserve(active.size());
+    for (size_t i = 0; i < active.size();) {
+        const uint32_t index = active[i];
+        Voice& voice = voices[index];
+
+        bool finished = false;
+        if (!voice.channel) {
+            if (!voice.paused) voice.position += deltaTime;
+            if (voice.looping) {
+                while (voice.length > 0.0 && voice.position >= voice.length) voice.position -= voice.length;
+            } else {
+                finished = voice.position >= voice.length;
+            }
+        }
+
+        if (finished) {
+            // Free swaps the last active voice into this spot, so look at i again
+            Free(index);
+            continue;
+        }
+
+        voice.audibility = GetAudibility(voice);
+        voice.score = voice.channel ? voice.audibility * REAL_VOICE_BONUS : voice.audibility;
+        voice.selected = false;
+        if (voice.audibility >= audibilityThreshold) audible.push_back(index);
+        ++i;
+    }
+
+    // Pick the voices that get real channels, which doesn't need a full sort
+    if (audible.size() > maxRealVoices) {
+        std::nth_element(audible.begin(), audible.begin() + maxRealVoices, audible.end(), [this](uint32_t a, uint32_t b) {
+            const Voice& voiceA = voices[a];
+            const Voice& voiceB = voices[b];
+            if (voiceA.params.priority != voiceB.params.priority) return voiceA.params.priority > voiceB.params.priority;
+            return voiceA.score > voiceB.score;
+        });
+        audible.resize(maxRealVoices);
+    }
+    for (uint32_t index : audible) {
+        voices[index].selected = true;
+    }
+
+    // Give up channels first so that they're free for the voices promoted after
+    for (uint32_t index : active) {
+        Voice& voice = voices[index];
+        if (voice.channel && !voice.selected) MakeVirtual(voice);
+    }
+    for (uint32_t index : audible) {
+        Voice& voice = voices[index];
+        if (!voice.channel) MakeReal(voice);
+    }
+}
+
+size_t VoiceManager::GetVoiceCount() const {
+    return active.size();
+}
+
+size_t VoiceManager::GetRealVoiceCount() const {
+    return realVoiceCount;
+}
+
+size_t VoiceManager::GetMaxRealVoices() const {
+    return maxRealVoices;
+}
+
+size_t VoiceManager::GetRejectedCount() const {
+    return rejectedCount;
+}
+
+VoiceManager::Voice* VoiceManager::Get(VoiceHandle handle) {
+    if (handle.index >= voices.size()) return nullptr;
+    Voice& voice = voices[handle.index];
+    return voice.alive && voice.generation == handle.generation ? &voice : nullptr;
+}
+
+const VoiceManager::Voice* VoiceManager::Get(VoiceHandle handle) const {
+    return const_cast<VoiceManager*>(this)->Get(handle);
+}
+
+float VoiceManager::GetAudibility(const Voice& voice) const {
+    // Without listeners there's nothing to be far away from
+    if (!voice.params.is3D || listenerCount == 0) return voice.params.volume;
+
+    float closest = INFINITY;
+    for (size_t i = 0; i < listenerCount; ++i) {
+        closest = std::min(closest, glm::length(voice.params.position - listeners[i]));
+    }
+
+    if (closest <= minDistance) return voice.params.volume;
+    return voice.params.volume * minDistance / (minDistance + rolloffScale * (closest - minDistance));
+}
+
+void VoiceManager::OnChannelEnded(void* context, AudioChannel channel, void* userData) {
+    VoiceManager* self = static_cast<VoiceManager*>(context);
+    const uint32_t index = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(userData));
+    if (index >= self->voices.size()) return;
+
+    // Channels given up by MakeVirtual, or that ended after their voice was stopped, no longer belong to the voice
+    Voice& voice = self->voices[index];
+    if (!voice.alive || voice.channel != channel) return;
+
+    voice.channel = nullptr;
+    self->realVoiceCount--;
+    self->Free(index);
+}
+
+bool VoiceManager::MakeReal(Voice& voice) {
+    const uint32_t index = static_cast<uint32_t>(&voice - voices.data());
+    AudioChannel channel = backend.Play(voice.sound, voice.position, reinterpret_cast<void*>(static_cast<uintptr_t>(index)));
+    if (!channel) return false;
+
+    voice.channel = channel;
+    realVoiceCount++;
+    backend.SetVolume(channel, voice.params.volume);
+    if (voice.params.is3D) backend.Set3DAttributes(channel, voice.params.position, voice.params.velocity);
+    backend.SetPaused(channel, voice.paused);
+    return true;
+}
+
+void VoiceManager::MakeVirtual(Voice& voice) {
+    // Let go of the channel before stopping it, so that its ended callback is ignored
+    AudioChannel channel = voice.channel;
+    voice.position = backend.GetPosition(channel);
+    voice.channel = nullptr;
+    realVoiceCount--;
+    backend.Stop(channel);
+}
+
+void VoiceManager::Free(uint32_t index) {
+    Voice& voice = voices[index];
+
+    if (voice.limit && voice.limit->instances > 0) voice.limit->instances--;
+
+    // Swap remove from the active list
+    const uint32_t last = active.back();
+    active[voice.activeIndex] = last;
+    voices[last].activeIndex = voice.activeIndex;
+    active.pop_back();
+
+    VoiceHandle handle;
+    handle.index = index;
+    handle.generation = voice.generation;
+
+    voice.alive = false;
+    voice.limit = nullptr;
+    if (++voice.generation == 0) voice.generation = 1;
+    freeVoices.push_back(index);
+
+    if (finishedCallback) finishedCallback(handle);
+}
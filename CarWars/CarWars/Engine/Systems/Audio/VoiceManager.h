@@ -0,0 +1,149 @@
+#pragma once
+
+#include "AudioBackend.h"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// Higher priorities keep their channels over lower ones no matter how loud the lower ones are
+enum VoicePriority {
+    VoicePriority_Low = 64,
+    VoicePriority_Normal = 128,
+    VoicePriority_High = 192,
+    VoicePriority_Critical = 255
+};
+
+struct VoiceParams {
+    VoiceParams() : volume(1.f), priority(VoicePriority_Normal), is3D(true), pausable(true), position(0.f), velocity(0.f) {}
+
+    float volume;
+    int priority;
+    bool is3D;              // 2D voices ignore position and are as audible as their volume
+    bool pausable;          // Voices that aren't (e.g. menu sounds) keep playing while the manager is paused
+    glm::vec3 position;
+    glm::vec3 velocity;
+};
+
+// Handle to a playing voice. It goes stale (IsPlaying returns false) once the voice ends, even if its slot is reused.
+struct VoiceHandle {
+    VoiceHandle() : index(0), generation(0) {}
+
+    bool IsValid() const { return generation != 0; }
+
+    bool operator== (const VoiceHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!= (const VoiceHandle& other) const { return !(*this == other); }
+
+    uint32_t index;
+    uint32_t generation;
+};
+
+// Decides which sounds get one of a fixed number of real backend channels. Every voice is ranked by priority, then by how
+// loud it is at the closest listener. Voices that don't make the cut, or can't be heard at all, keep playing virtually
+// (only their position in the sound advances) and are given a channel again, at the right offset, once they rank high enough.
+class VoiceManager {
+public:
+    static const size_t MAX_LISTENERS = 4;
+
+    VoiceManager(AudioBackend& _backend, size_t _maxRealVoices, size_t maxVoices);
+    ~VoiceManager();
+
+    // Returns an invalid handle if the sound is rate limited or every voice slot is taken
+    VoiceHandle Play(FMOD::Sound* sound, const VoiceParams& params);
+    void Stop(VoiceHandle voice);
+    void StopAll();
+
+    bool IsPlaying(VoiceHandle voice) const;
+    bool IsReal(VoiceHandle voice) const;
+
+    void SetPosition(VoiceHandle voice, glm::vec3 position, glm::vec3 velocity);
+    void SetVolume(VoiceHandle voice, float volume);
+
+    // Pauses or resumes every pausable voice, including ones started while paused
+    void SetPaused(bool _paused);
+
+    // Stops sound from starting more often than once every minInterval, or while maxInstances of it are playing
+    void SetRateLimit(FMOD::Sound* sound, Time minInterval, size_t maxInstances);
+
+    void SetListeners(const glm::vec3* positions, size_t count);
+
+    // Matches the backend's inverse rolloff so that audibility agrees with what is actually heard
+    void SetRolloff(float _minDistance, float _rolloffScale);
+
+    // Voices quieter than this never get a real channel
+    void SetAudibilityThreshold(float threshold);
+
+    // Called whenever a voice ends, however it ended. Must not start or stop voices.
+    void SetFinishedCallback(std::function<void(VoiceHandle)> callback);
+
+    // Ends virtual voices that ran out and hands out real channels, call once per frame.
+    // Real voices end as soon as the backend reports their channel ended.
+    void Update(Time deltaTime);
+
+    size_t GetVoiceCount() const;
+    size_t GetRealVoiceCount() const;
+    size_t GetMaxRealVoices() const;
+    size_t GetRejectedCount() const;    // Voices refused since the last StopAll, by rate limits or for lack of slots
+
+private:
+    struct RateLimit {
+        Time minInterval;
+        size_t maxInstances;
+        Time lastStart;
+        size_t instances;
+    };
+
+    struct Voice {
+        uint32_t generation;
+        uint32_t activeIndex;
+        bool alive;
+        bool paused;
+        bool selected;
+
+        FMOD::Sound* sound;
+        AudioChannel channel;       // nullptr while virtual
+        RateLimit* limit;
+
+        VoiceParams params;
+        Time position;
+        Time length;
+        bool looping;
+        float audibility;
+        float score;                // Audibility with a bonus for already being real, so voices near the cut don't flip every frame
+    };
+
+    Voice* Get(VoiceHandle voice);
+    const Voice* Get(VoiceHandle voice) const;
+
+    float GetAudibility(const Voice& voice) const;
+
+    static void OnChannelEnded(void* context, AudioChannel channel, void* userData);
+
+    bool MakeReal(Voice& voice);
+    void MakeVirtual(Voice& voice);
+    void Free(uint32_t index);
+
+    AudioBackend& backend;
+    size_t maxRealVoices;
+    size_t realVoiceCount;
+    size_t rejectedCount;
+    bool paused;
+
+    std::vector<Voice> voices;
+    std::vector<uint32_t> freeVoices;
+    std::vector<uint32_t> active;
+
+    std::unordered_map<FMOD::Sound*, RateLimit> rateLimits;
+
+    std::function<void(VoiceHandle)> finishedCallback;
+
+    glm::vec3 listeners[MAX_LISTENERS];
+    size_t listenerCount;
+
+    float minDistance;
+    float rolloffScale;
+    float audibilityThreshold;
+
+    // Only advances in Update, used for rate limits
+    Time clock;
+};
@@ -0,0 +1,66 @@
+#include "BakedContent.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <experimental/filesystem>
+
+using namespace std;
+namespace fs = std::experimental::filesystem;
+
+string BakedContent::GetPath(const string& sourcePath, const string& extension) {
+    const size_t dot = sourcePath.find_last_of('.');
+    const size_t directory = sourcePath.find_last_of("/\\");
+    if (dot == string::npos || (directory != string::npos && dot < directory)) {
+        return sourcePath + extension;
+    }
+    return sourcePath.substr(0, dot) + extension;
+}
+
+bool BakedContent::IsOutOfDate(const string& sourcePath, const string& bakedPath) {
+    error_code error;
+    const auto bakedTime = fs::last_write_time(bakedPath, error);
+    if (error) return true;
+    const auto sourceTime = fs::last_write_time(sourcePath, error);
+    if (error) return false;        // Shipped without its source
+    return sourceTime > bakedTime;
+}
+
+bool BakedContent::BakeDirectory(const string& dirPath, const vector<string>& sourceExtensions,
+    const string& bakedExtension, BakeFunction bake, CheckFunction isCurrent) {
+
+    size_t bakedCount = 0;
+    size_t upToDateCount = 0;
+    size_t failedCount = 0;
+
+    error_code error;
+    for (const fs::directory_entry& entry : fs::recursive_directory_iterator(dirPath, error)) {
+        if (!fs::is_regular_file(entry.status())) continue;
+
+        string extension = entry.path().extension().string();
+        transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(tolower(c)); });
+        if (find(sourceExtensions.begin(), sourceExtensions.end(), extension) == sourceExtensions.end()) continue;
+
+        const string sourcePath = entry.path().string();
+        const string bakedPath = GetPath(sourcePath, bakedExtension);
+        if (!IsOutOfDate(sourcePath, bakedPath) && (!isCurrent || isCurrent(bakedPath))) {
+            upToDateCount++;
+            continue;
+        }
+
+        if (bake(sourcePath, bakedPath)) {
+            bakedCount++;
+        } else {
+            cerr << "ERROR: Failed to bake: " << sourcePath << endl;
+            failedCount++;
+        }
+    }
+
+    if (error) {
+        cerr << "ERROR: Failed to read content directory: " << dirPath << endl;
+        return false;
+    }
+
+    cout << dirPath << ": " << bakedCount << " baked, " << upToDateCount << " up to date, " << failedCount << " failed" << endl;
+    return failedCount == 0;
+}
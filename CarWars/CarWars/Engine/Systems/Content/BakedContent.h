@@ -0,0 +1,29 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Shared by the offline content tools (CarWars.exe --convert-meshes, --bake-textures) and the loaders that prefer
+// their output over the source files.
+class BakedContent {
+public:
+    typedef std::function<bool(const std::string& sourcePath, const std::string& bakedPath)> BakeFunction;
+    typedef std::function<bool(const std::string& bakedPath)> CheckFunction;
+
+    // Path of the baked file for a source file, e.g. Cube.obj -> Cube.mesh
+    static std::string GetPath(const std::string& sourcePath, const std::string& extension);
+
+    // True if the source was changed after the baked file was written, or there is no baked file
+    static bool IsOutOfDate(const std::string& sourcePath, const std::string& bakedPath);
+
+    // Bakes every file under dirPath with one of the source extensions that doesn't have an up to date baked file.
+    // isCurrent, if given, also rebakes files that are newer than their source but no longer readable (e.g. an older
+    // format version). Returns false if any of them failed.
+    static bool BakeDirectory(const std::string& dirPath, const std::vector<std::string>& sourceExtensions,
+        const std::string& bakedExtension, BakeFunction bake, CheckFunction isCurrent=nullptr);
+
+private:
+    // No instantiation
+    BakedContent() = delete;
+};
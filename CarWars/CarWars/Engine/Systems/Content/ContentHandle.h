@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+
+enum ContentState {
+    ContentState_Loading = 0,
+    ContentState_Loaded,
+    ContentState_Failed
+};
+
+// Refers to an asset that may still be streaming in. Handles are cheap to copy and every copy sees the asset arrive.
+// Handles are only resolved on the main thread (by ContentStreamer), so they must only be read there too.
+template <typename T>
+class ContentHandle {
+public:
+    // No asset at all
+    ContentHandle() {}
+
+    // An asset that is already loaded (or failed to, if asset is null)
+    explicit ContentHandle(T* asset) : slot(std::make_shared<Slot>(asset ? ContentState_Loaded : ContentState_Failed, asset)) {}
+
+    bool IsValid() const { return slot != nullptr; }
+    bool IsLoaded() const { return slot && slot->state == ContentState_Loaded; }
+    ContentState GetState() const { return slot ? slot->state : ContentState_Failed; }
+
+    // The asset once it has loaded and placeholder until then (or if it failed). Null if the handle is empty.
+    T* Get(T* placeholder = nullptr) const {
+        if (!slot) return nullptr;
+        return slot->state == ContentState_Loaded ? slot->asset : placeholder;
+    }
+
+private:
+    friend class ContentStreamer;
+
+    struct Slot {
+        Slot(ContentState _state, T* _asset) : state(_state), asset(_asset) {}
+
+        ContentState state;
+        T* asset;
+    };
+
+    static ContentHandle Loading() {
+        ContentHandle handle;
+        handle.slot = std::make_shared<Slot>(ContentState_Loading, nullptr);
+        return handle;
+    }
+
+    void Resolve(T* asset) {
+        slot->asset = asset;
+        slot->state = asset ? ContentState_Loaded : ContentState_Failed;
+    }
+
+    std::shared_ptr<Slot> slot;
+};
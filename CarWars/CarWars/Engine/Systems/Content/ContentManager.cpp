@@ -5,12 +5,17 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
-#include "assimp/Importer.hpp"
-#include "assimp/scene.h"
-#include "assimp/postprocess.h"
+#include "MeshImporter.h"
+#include "BakedContent.h"
+#include "MappedFile.h"
+#include "MapPackage.h"
+#include "StartupProfile.h"
+#include "../Jobs/JobSystem.h"
+#include "TextureCompression.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb/stb_image.h"
+#include <sstream>
 #include "../../Entities/EntityManager.h"
 #include "../../Components/MeshComponent.h"
 #include <glm/gtx/string_cast.hpp>
@@ -39,16 +44,56 @@ using namespace nlohmann;
 using namespace physx;
 using namespace std;
 
+#define SHADER_MAX_INCLUDE_DEPTH 4
+
+namespace {
+    // Reads a shader, replacing each #include "file" line with that file from the shader directory, so the cameras and
+    // anything else the shaders share are written once. #line directives keep compile errors pointing at the right line.
+    bool ReadShaderSource(const string& filePath, string& source, int depth) {
+        ifstream input(filePath.c_str());
+        if (!input) return false;
+
+        const string directive = "#include \"";
+        string line;
+        int lineNumber = 0;
+        while (getline(input, line)) {
+            lineNumber++;
+            if (line.compare(0, directive.size(), directive) != 0) {
+                source += line + "\n";
+                continue;
+            }
+
+            const size_t end = line.find('"', directive.size());
+            if (end == string::npos || depth >= SHADER_MAX_INCLUDE_DEPTH) {
+                cerr << "ERROR: Bad shader include in " << filePath << ": " << line << endl;
+                continue;
+            }
+            const string includePath = ContentManager::SHADERS_DIR_PATH + line.substr(directive.size(), end - directive.size());
+
+            source += "#line 1\n";
+            if (!ReadShaderSource(includePath, source, depth + 1)) {
+                cerr << "ERROR: Could not load shader include " << includePath << " from " << filePath << endl;
+            }
+            ostringstream resume;
+            resume << "#line " << lineNumber + 1 << "\n";
+            source += resume.str();
+        }
+        return true;
+    }
+}
+
 map<string, json> ContentManager::scenePrefabs;
 map<string, json> ContentManager::entityPrefabs;
 map<string, json> ContentManager::componentPrefabs;
 
 map<string, Mesh*> ContentManager::meshes;
 map<string, Texture*> ContentManager::textures;
+size_t ContentManager::textureMemory = 0;
 map<string, Material*> ContentManager::materials;
 map<string, PxMaterial*> ContentManager::pxMaterials;
 map<string, HeightMap*> ContentManager::heightMaps;
 std::map<string, NavigationMesh*> ContentManager::navigationMeshes;
+std::map<string, MapPackage*> ContentManager::mapPackages;
 GLuint ContentManager::skyboxCubemap;
 
 const glm::vec4 ContentManager::COLOR_WHITE = glm::vec4(1.f, 1.f, 1.f, 1.f);
@@ -84,57 +129,33 @@ const string ContentManager::COLLISION_GROUPS_DIR_PATH = CONTENT_DIR_PATH + "Col
 
 const string ContentManager::SHADERS_DIR_PATH = CONTENT_DIR_PATH + "Shaders/";
 
-glm::vec3 AssimpVectorToGlm(aiVector3D v) {
-	return glm::vec3(v.x, v.y, v.z);
-}
-
-glm::vec2 AssimpVectorToGlm(aiVector2D v) {
-	return glm::vec2(v.x, v.y);
-}
-
 Mesh* ContentManager::GetMesh(const string filePath, unsigned pFlags) {
 	Mesh* mesh = meshes[filePath];
 	if (mesh != nullptr) return mesh;
 
-	Assimp::Importer importer;
-
-	const aiScene *scene = importer.ReadFile(MESH_DIR_PATH + filePath,
-        pFlags
-		| aiProcess_CalcTangentSpace
-		| aiProcess_Triangulate
-//		| aiProcess_SortByPType             // What does this do?
-        | aiProcess_GenSmoothNormals
-//        | aiProcess_FlipUVs               // We probably want this!
-//        | aiProcess_JoinIdenticalVertices
-    );
-
-	if (scene == nullptr) {
-		cerr << "WARNING: Failed to load mesh: " << filePath << endl;
-		return nullptr;
-	}
-
-    // TODO: Load all meshes
-	aiMesh *aiMesh = scene->mMeshes[0];
+    const string sourcePath = MESH_DIR_PATH + filePath;
+    const string binaryPath = BakedContent::GetPath(sourcePath, MESH_FILE_EXTENSION);
 
-    const size_t triangleCount = aiMesh->mNumFaces;
-    Triangle *triangles = new Triangle[triangleCount];
-    for (size_t i = 0; i < triangleCount; ++i) {
-        const aiFace &triangle = aiMesh->mFaces[i];
-        triangles[i] = Triangle(triangle.mIndices[0], triangle.mIndices[1], triangle.mIndices[2]);
+    // Converted meshes are mapped and uploaded as they are. Custom import flags only apply to the source mesh.
+    if (pFlags == 0 && !BakedContent::IsOutOfDate(sourcePath, binaryPath)) {
+        MappedFile file;
+        MeshView view;
+        if (file.Open(binaryPath) && MeshFile::Read(file.GetData(), file.GetSize(), view)) {
+            mesh = new Mesh(view);
+        } else {
+            cerr << "WARNING: Failed to read binary mesh: " << binaryPath << endl;
+        }
     }
 
-    const size_t vertexCount = aiMesh->mNumVertices;
-	glm::vec3 *vertices = new glm::vec3[vertexCount];
-	glm::vec2 *uvs = new glm::vec2[vertexCount];
-	glm::vec3 *normals = new glm::vec3[vertexCount];
-
-	for (size_t i = 0; i < vertexCount; ++i) {
-		vertices[i] = AssimpVectorToGlm(aiMesh->mVertices[i]);
-		uvs[i] = AssimpVectorToGlm(aiMesh->mTextureCoords[0][i]);
-		normals[i] = AssimpVectorToGlm(aiMesh->mNormals[i]);
-	}
-
-	mesh = new Mesh(triangleCount, vertexCount, triangles, vertices, uvs, normals);
+    // Fall back to importing the source mesh (run CarWars.exe --convert-meshes to skip this)
+    if (!mesh) {
+        MeshData data;
+        if (!MeshImporter::Import(sourcePath, data, pFlags)) {
+            cerr << "WARNING: Failed to load mesh: " << filePath << endl;
+            return nullptr;
+        }
+        mesh = new Mesh(data.GetView());
+    }
 
     // TODO: Load materials/textures
 
@@ -146,11 +167,27 @@ Texture* ContentManager::GetTexture(const string filePath) {
 	Texture* texture = textures[filePath];
 	if (texture != nullptr) return texture;
 
+    const string sourcePath = TEXTURE_DIR_PATH + filePath;
+    const string bakedPath = BakedContent::GetPath(sourcePath, TEXTURE_FILE_EXTENSION);
+
+    // Baked textures are mapped and their mips uploaded as they are
+    if (!BakedContent::IsOutOfDate(sourcePath, bakedPath)) {
+        MappedFile file;
+        TextureView view;
+        if (file.Open(bakedPath) && TextureFile::Read(file.GetData(), file.GetSize(), view)) {
+            texture = UploadTexture(view);
+            textures[filePath] = texture;
+            return texture;
+        }
+        cerr << "WARNING: Failed to read baked texture: " << bakedPath << endl;
+    }
+
+    // Fall back to decoding the source image (run CarWars.exe --bake-textures to skip this)
 	int components;
 	GLuint texId;
 	int tWidth, tHeight;
 
-	const auto data = stbi_load((TEXTURE_DIR_PATH + filePath).c_str(), &tWidth, &tHeight, &components, 0);
+	const auto data = stbi_load(sourcePath.c_str(), &tWidth, &tHeight, &components, 0);
 
 	if (data != nullptr) {
 		glGenTextures(1, &texId);
@@ -170,13 +207,73 @@ Texture* ContentManager::GetTexture(const string filePath) {
 		glBindTexture(GL_TEXTURE_2D, 0);
 		stbi_image_free(data);
 
-		texture = new Texture(texId, tWidth, tHeight);
+		texture = new Texture(texId, tWidth, tHeight, tWidth * tHeight * components);
 		textures[filePath] = texture;
+        textureMemory += texture->byteCount;
 	}
 
 	return texture;
 }
 
+size_t ContentManager::GetTextureMemory() {
+    return textureMemory;
+}
+
+Texture* ContentManager::UploadTexture(const TextureView& view) {
+    GLenum internalFormat = GL_RGBA8;
+    bool supported = true;
+    switch (view.format) {
+    case TextureFormat_BC1:
+        internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        supported = GLEW_EXT_texture_compression_s3tc != 0;
+        break;
+    case TextureFormat_BC3:
+        internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        supported = GLEW_EXT_texture_compression_s3tc != 0;
+        break;
+    case TextureFormat_BC5:
+        internalFormat = GL_COMPRESSED_RG_RGTC2;
+        supported = GLEW_ARB_texture_compression_rgtc != 0;
+        break;
+    default:
+        break;
+    }
+
+    GLuint texId;
+    glGenTextures(1, &texId);
+    glBindTexture(GL_TEXTURE_2D, texId);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    size_t byteCount = 0;
+    for (size_t level = 0; level < view.mipCount; ++level) {
+        const TextureMip& mip = view.mips[level];
+        const GLint mipLevel = static_cast<GLint>(level);
+        if (view.format == TextureFormat_RGBA8) {
+            glTexImage2D(GL_TEXTURE_2D, mipLevel, GL_RGBA8, mip.width, mip.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, view.GetMipData(level));
+            byteCount += mip.size;
+        } else if (supported) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, mipLevel, internalFormat, mip.width, mip.height, 0, mip.size, view.GetMipData(level));
+            byteCount += mip.size;
+        } else {
+            const vector<uint8_t> rgba = TextureCompression::Decompress(view.format,
+                static_cast<const uint8_t*>(view.GetMipData(level)), mip.width, mip.height);
+            glTexImage2D(GL_TEXTURE_2D, mipLevel, GL_RGBA8, mip.width, mip.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+            byteCount += rgba.size();
+        }
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(view.mipCount - 1));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    textureMemory += byteCount;
+    return new Texture(texId, view.width, view.height, byteCount);
+}
+
 Material* ContentManager::GetMaterial(json data) {
 	Material *material;
 	
@@ -240,6 +337,26 @@ NavigationMesh* ContentManager::GetNavigationMesh(std::string dirPath) {
     return navMesh;
 }
 
+MapPackage* ContentManager::GetMapPackage(std::string dirPath) {
+    const auto it = mapPackages.find(dirPath);
+    if (it != mapPackages.end()) return it->second;
+
+    MapPackage* package = new MapPackage();
+    if (!package->Open(dirPath)) {
+        delete package;
+        package = nullptr;
+    } else {
+        // The map loads its scene right after its height map, so seed the scene cache while the package is at hand
+        const string scene = package->GetHeader().scene;
+        if (scenePrefabs.find(scene) == scenePrefabs.end()) {
+            scenePrefabs[scene] = package->GetScene();
+        }
+    }
+
+    mapPackages[dirPath] = package;
+    return package;
+}
+
 std::string ContentManager::GetTextureName(Texture* texture) {
     std::string name;
 
@@ -293,20 +410,7 @@ Component* ContentManager::LoadComponent(json data) {
 
     // If we couldn't find the data in the map, construct it
     if (!dataComplete) {
-        // While we are given file path strings, load the next file
-        while (data.is_string()) {
-            data = LoadJson(COMPONENT_PREFAB_DIR_PATH + filePath);
-        }
-
-        // While there is a nested prefab, load it
-        json prefab = data["Prefab"];
-        while (!prefab.is_null()) {
-            json prefabData = LoadJson(COMPONENT_PREFAB_DIR_PATH + prefab.get<string>());
-            prefab = json(prefabData["Prefab"]);
-            MergeJson(prefabData, data);
-            data = prefabData;
-        }
-
+        data = ResolvePrefab(data, COMPONENT_PREFAB_DIR_PATH);
         if (fromFile) {
             componentPrefabs[filePath] = data;
         }
@@ -361,18 +465,7 @@ Entity* ContentManager::LoadEntity(json data, Entity *parent) {
     }
 
     if (!dataComplete) {
-        while (data.is_string()) {
-            data = LoadJson(ENTITY_PREFAB_DIR_PATH + data.get<string>());
-        }
-
-        json prefab = data["Prefab"];
-        while (!prefab.is_null()) {
-            json prefabData = LoadJson(ENTITY_PREFAB_DIR_PATH + prefab.get<string>());
-            prefab = json(prefabData["Prefab"]);
-            MergeJson(prefabData, data);
-            data = prefabData;
-        }
-
+        data = ResolvePrefab(data, ENTITY_PREFAB_DIR_PATH);
         if (fromFile) {
             entityPrefabs[filePath] = data;
         }
@@ -403,6 +496,24 @@ Entity* ContentManager::LoadEntity(json data, Entity *parent) {
 	return entity;
 }
 
+json ContentManager::ResolvePrefab(json data, const string& dirPath) {
+    // While we are given file path strings, load the next file
+    while (data.is_string()) {
+        data = LoadJson(dirPath + data.get<string>());
+    }
+
+    // While there is a nested prefab, load it
+    json prefab = data["Prefab"];
+    while (!prefab.is_null()) {
+        json prefabData = LoadJson(dirPath + prefab.get<string>());
+        prefab = json(prefabData["Prefab"]);
+        MergeJson(prefabData, data);
+        data = prefabData;
+    }
+
+    return data;
+}
+
 json ContentManager::LoadJson(const string filePath) {
 	ifstream file(filePath);		// TODO: Error check?
 	json object;
@@ -509,19 +620,37 @@ void ContentManager::LoadCollisionGroups(string filePath) {
 }
 
 void ContentManager::LoadSkybox(string directoryPath) {
+    struct Face {
+        string filePath;
+        unsigned char *data;
+        int width, height, nrChannels;
+        double parseSeconds;
+    };
+
+    // Decode the faces side by side on the workers, then upload them here
+    Face faces[6];
+    JobSystem::Instance().ParallelForEach(6, 1, [&faces, &directoryPath](size_t i) {
+        const double start = StartupProfile::Now();
+        Face& face = faces[i];
+        face.filePath = SKYBOX_DIR_PATH + directoryPath + SKYBOX_FACE_NAMES[i] + ".png";
+        face.data = stbi_load(face.filePath.c_str(), &face.width, &face.height, &face.nrChannels, 0);
+        face.parseSeconds = StartupProfile::Now() - start;
+    });
+
     glGenTextures(1, &skyboxCubemap);
     glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxCubemap);
 
-    int width, height, nrChannels;
     for (size_t i = 0; i < 6; i++) {
-        const string filePath = SKYBOX_DIR_PATH + directoryPath + SKYBOX_FACE_NAMES[i] + ".png";
-        unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-        if (data) {
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+        const Face& face = faces[i];
+        if (face.data) {
+            const double start = StartupProfile::Now();
+            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, face.width, face.height, 0, GL_RGB, GL_UNSIGNED_BYTE, face.data);
+            StartupProfile::Record(StartupAsset_Texture, face.filePath, face.width * face.height * face.nrChannels,
+                face.parseSeconds, StartupProfile::Now() - start);
         } else {
-            cerr << "ERROR: Failed to load cubemap texture: " << filePath << endl;
+            cerr << "ERROR: Failed to load cubemap texture: " << face.filePath << endl;
         }
-        stbi_image_free(data);
+        stbi_image_free(face.data);
     }
 
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -536,37 +665,25 @@ GLuint ContentManager::GetSkybox() {
 }
 
 GLuint ContentManager::LoadShader(string filePath, const GLenum shaderType) {
+    const double start = StartupProfile::Now();
 	filePath = SHADERS_DIR_PATH + filePath;
 
 	string source;
-	ifstream input(filePath.c_str());
-	if (input) {
-		copy(istreambuf_iterator<char>(input),
-			istreambuf_iterator<char>(),
-			back_inserter(source));
-		input.close();
-	} else {
+	if (!ReadShaderSource(filePath, source, 0)) {
 		cerr << "ERROR: Could not load shader source from file " << filePath << endl;
 	}
+    const double read = StartupProfile::Now();
 
 	// Create a shader and get it's ID
 	const GLuint shaderId = glCreateShader(shaderType);
 
-	// Compile the shader
+	// Compile the shader. Its status isn't checked until its program is (see Graphics::CheckShaderPrograms), so that
+	// the driver can keep compiling in the background.
 	const GLchar *sourcePointer = source.c_str();
 	glShaderSource(shaderId, 1, &sourcePointer, nullptr);
 	glCompileShader(shaderId);
 
-	// Check compile status and print compilation errors
-	GLint status;
-	glGetShaderiv(shaderId, GL_COMPILE_STATUS, &status);
-	if (status == GL_FALSE) {
-		GLint length;
-		glGetShaderiv(shaderId, GL_INFO_LOG_LENGTH, &length);
-		string info(length, ' ');
-		glGetShaderInfoLog(shaderId, info.length(), &length, &info[0]);
-		cerr << "ERROR Compiling Shader:" << endl << endl << source << endl << info << endl;
-	}
+    StartupProfile::Record(StartupAsset_Shader, filePath, source.size(), read - start, StartupProfile::Now() - read);
 
 	// Return the shader's ID
 	return shaderId;
@@ -4,6 +4,7 @@
 #include "Mesh.h"
 #include <map>
 #include "Texture.h"
+#include "TextureFile.h"
 #include "Material.h"
 #include "json/json.hpp"
 #include "../../Entities/Entity.h"
@@ -11,6 +12,7 @@
 #include "NavigationMesh.h"
 
 struct Texture;
+class MapPackage;
 
 class ContentManager {
 public:
@@ -49,12 +51,16 @@ public:
 
 	static Mesh* GetMesh(std::string filePath, unsigned pFlags=0);
 	static Texture* GetTexture(std::string filePath);
+    static size_t GetTextureMemory();
 	static Material* GetMaterial(nlohmann::json data);
 	static physx::PxMaterial* GetPxMaterial(std::string filePath);
 
     static HeightMap* GetHeightMap(std::string dirPath);
     static NavigationMesh* GetNavigationMesh(std::string dirPath);
 
+    // The map's baked package, or nullptr if it has none or it is older than its sources
+    static MapPackage* GetMapPackage(std::string dirPath);
+
     static std::string GetTextureName(Texture* texture);
 
 	static std::vector<Entity*> LoadScene(std::string filePath, Entity *parent=nullptr);
@@ -63,6 +69,10 @@ public:
 	template <typename T>
 	static T GetFromJson(nlohmann::json json, T defaultValue);
 	static nlohmann::json LoadJson(std::string filePath);
+
+    // Follows file paths and nested prefabs until data is complete. Touches no caches, so loader threads can use it.
+    static nlohmann::json ResolvePrefab(nlohmann::json data, const std::string& dirPath);
+
 	static void MergeJson(nlohmann::json &obj0, nlohmann::json &obj1, bool overwrite=true);
 	static glm::vec4 JsonToVec4(nlohmann::json data, glm::vec4 defaultValue);
 	static glm::vec4 JsonToVec4(nlohmann::json data);
@@ -88,15 +98,23 @@ public:
 	static Entity* LoadEntity(nlohmann::json data, Entity *parent=nullptr);
 
 private:
+    // Fills the caches in with the loader threads' results
+    friend class ContentStreamer;
+
     static std::map<std::string, nlohmann::json> scenePrefabs;
     static std::map<std::string, nlohmann::json> entityPrefabs;
     static std::map<std::string, nlohmann::json> componentPrefabs;
 
+    // Uploads every mip of a baked texture, decompressing in software if the driver can't sample its format
+    static Texture* UploadTexture(const TextureView& view);
+
     static std::map<std::string, HeightMap*> heightMaps;
     static std::map<std::string, NavigationMesh*> navigationMeshes;
+    static std::map<std::string, MapPackage*> mapPackages;
 
 	static std::map<std::string, Mesh*> meshes;
 	static std::map<std::string, Texture*> textures;
+    static size_t textureMemory;
 	static std::map<std::string, Material*> materials;
 	static std::map<std::string, physx::PxMaterial*> pxMaterials;
     static GLuint skyboxCubemap;
@@ -0,0 +1,471 @@
+#include "ContentStreamer.h"
+
+#include "ContentManager.h"
+#include "BakedContent.h"
+#include "MappedFile.h"
+#include "MeshFile.h"
+#include "MeshImporter.h"
+#include "TextureFile.h"
+#include "StartupProfile.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <experimental/filesystem>
+#include <GLFW/glfw3.h>
+#include "stb/stb_image.h"
+
+using namespace std;
+using json = nlohmann::json;
+namespace fs = std::experimental::filesystem;
+
+namespace {
+    // Touches every page of a mapped file so that the reads happen here rather than during the upload
+    void PrefetchPages(const char* data, size_t size) {
+        volatile char sink = 0;
+        for (size_t i = 0; i < size; i += 4096) {
+            sink += data[i];
+        }
+    }
+
+    string GetString(const json& data, const char* key) {
+        const auto it = data.find(key);
+        return it != data.end() && it->is_string() ? it->get<string>() : string();
+    }
+
+    size_t GetFileSize(const string& filePath) {
+        error_code error;
+        const uintmax_t size = fs::file_size(filePath, error);
+        return error ? 0 : static_cast<size_t>(size);
+    }
+}
+
+struct ContentStreamer::MeshLoad {
+    MeshLoad() : succeeded(false), parseSeconds(0.0) {}
+
+    MappedFile file;
+    MeshData data;
+    MeshView view;
+    bool succeeded;
+    double parseSeconds;
+};
+
+struct ContentStreamer::TextureLoad {
+    TextureLoad() : succeeded(false), parseSeconds(0.0) {}
+
+    MappedFile file;
+    vector<uint8_t> pixels;         // Unbaked images only
+    TextureMip mip;
+    TextureView view;
+    bool succeeded;
+    double parseSeconds;
+};
+
+struct ContentStreamer::PrefabLoad {
+    PrefabLoad(const string& _filePath) : filePath(_filePath), bytes(0), parseSeconds(0.0) {}
+
+    string filePath;
+    size_t bytes;
+    double parseSeconds;
+
+    vector<pair<string, json>> entities;
+    vector<pair<string, json>> components;
+    vector<pair<string, json>> scenes;
+    vector<string> meshes;
+    vector<string> textures;
+
+    void AddEntity(const json& data);
+    void AddComponent(const json& data);
+    void AddScene(const string& scenePath);
+};
+
+void ContentStreamer::PrefabLoad::AddEntity(const json& data) {
+    const auto componentList = data.find("Components");
+    if (componentList != data.end()) {
+        for (const json& componentData : *componentList) {
+            const json resolved = ContentManager::ResolvePrefab(componentData, ContentManager::COMPONENT_PREFAB_DIR_PATH);
+            if (componentData.is_string()) components.push_back(make_pair(componentData.get<string>(), resolved));
+            AddComponent(resolved);
+        }
+    }
+
+    const auto children = data.find("Children");
+    if (children == data.end()) return;
+    if (children->is_array()) {
+        for (const json& childData : *children) {
+            const json resolved = ContentManager::ResolvePrefab(childData, ContentManager::ENTITY_PREFAB_DIR_PATH);
+            if (childData.is_string()) entities.push_back(make_pair(childData.get<string>(), resolved));
+            AddEntity(resolved);
+        }
+    } else if (children->is_string()) {
+        AddScene(children->get<string>());
+    }
+}
+
+void ContentStreamer::PrefabLoad::AddScene(const string& scenePath) {
+    const json scene = ContentManager::LoadJson(ContentManager::SCENE_DIR_PATH + scenePath);
+    scenes.push_back(make_pair(scenePath, scene));
+    for (const json& entityData : scene) {
+        const json resolved = ContentManager::ResolvePrefab(entityData, ContentManager::ENTITY_PREFAB_DIR_PATH);
+        if (entityData.is_string()) entities.push_back(make_pair(entityData.get<string>(), resolved));
+        AddEntity(resolved);
+    }
+}
+
+void ContentStreamer::PrefabLoad::AddComponent(const json& data) {
+    const string type = GetString(data, "Type");
+    if (type == "Mesh") {
+        const string mesh = GetString(data, "Mesh");
+        if (!mesh.empty()) meshes.push_back(mesh);
+        const string texture = GetString(data, "Texture");
+        if (!texture.empty()) textures.push_back(texture);
+    } else if (type == "Billboard") {
+        const string texture = GetString(data, "Texture");
+        if (!texture.empty()) textures.push_back(texture);
+    }
+}
+
+// Singleton
+ContentStreamer::ContentStreamer() : quit(false), pendingCount(0), placeholderMesh(nullptr), placeholderTexture(nullptr) {}
+
+ContentStreamer& ContentStreamer::Instance() {
+    static ContentStreamer instance;
+    return instance;
+}
+
+ContentStreamer::~ContentStreamer() {
+    {
+        lock_guard<mutex> lock(loadMutex);
+        quit = true;
+    }
+    loadReady.notify_all();
+    for (thread& loader : loaders) {
+        loader.join();
+    }
+}
+
+void ContentStreamer::Initialize() {
+    if (!loaders.empty()) return;
+
+    placeholderMesh = ContentManager::GetMesh("Cube.obj");
+
+    const GLubyte white[4] = { 255, 255, 255, 255 };
+    GLuint textureId;
+    glGenTextures(1, &textureId);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    placeholderTexture = new Texture(textureId, 1, 1, sizeof(white));
+
+    const size_t cores = thread::hardware_concurrency();
+    const size_t loaderCount = max(static_cast<size_t>(CONTENT_MIN_LOADER_THREADS), cores > 1 ? cores - 1 : 0);
+    for (size_t i = 0; i < loaderCount; ++i) {
+        loaders.push_back(thread(&ContentStreamer::LoaderLoop, this));
+    }
+}
+
+void ContentStreamer::PreloadManifest() {
+    shared_ptr<pair<vector<string>, vector<string>>> manifest = make_shared<pair<vector<string>, vector<string>>>();
+    Load([this, manifest]() {
+        // Scenes, as paths relative to the scene directory like LoadScene takes them
+        const fs::path sceneDirPath = ContentManager::SCENE_DIR_PATH;
+        error_code error;
+        for (const fs::directory_entry& entry : fs::recursive_directory_iterator(sceneDirPath, error)) {
+            if (!fs::is_regular_file(entry.status()) || entry.path().extension() != ".json") continue;
+            string scenePath = entry.path().string().substr(sceneDirPath.string().size());
+            replace(scenePath.begin(), scenePath.end(), '\\', '/');
+            manifest->first.push_back(scenePath);
+        }
+
+        // Map terrain textures, which are only named in the map data
+        for (const fs::directory_entry& entry : fs::directory_iterator(ContentManager::MAP_DIR_PATH, error)) {
+            const fs::path dataPath = entry.path() / "Data.json";
+            if (!fs::is_regular_file(dataPath, error)) continue;
+            const json data = ContentManager::LoadJson(dataPath.string());
+            manifest->second.push_back(ContentManager::GetFromJson<string>(data["TerrainTexture"], "Boulder.jpg"));
+        }
+
+        QueueUpload([this, manifest]() {
+            for (const string& scene : manifest->first) {
+                PreloadScene(scene);
+            }
+            for (const string& texture : manifest->second) {
+                LoadTexture(texture);
+            }
+        });
+    });
+}
+
+void ContentStreamer::Flush() {
+    while (true) {
+        function<void()> upload;
+        {
+            // Loads count themselves out when they finish, uploaded or not, so this can't wait on one that never uploads
+            unique_lock<mutex> lock(uploadMutex);
+            uploadReady.wait(lock, [this]() { return !uploads.empty() || pendingCount.load() == 0; });
+            if (uploads.empty()) return;
+            upload = move(uploads.front());
+            uploads.pop_front();
+        }
+
+        upload();
+        pendingCount--;
+    }
+}
+
+ContentHandle<Mesh> ContentStreamer::LoadMesh(const string& filePath) {
+    const auto cached = ContentManager::meshes.find(filePath);
+    if (cached != ContentManager::meshes.end() && cached->second) return ContentHandle<Mesh>(cached->second);
+
+    const auto pending = pendingMeshes.find(filePath);
+    if (pending != pendingMeshes.end()) return pending->second;
+
+    ContentHandle<Mesh> handle = ContentHandle<Mesh>::Loading();
+    pendingMeshes[filePath] = handle;
+
+    shared_ptr<MeshLoad> load = make_shared<MeshLoad>();
+    Load([this, filePath, load]() {
+        const double start = StartupProfile::Now();
+        const string sourcePath = ContentManager::MESH_DIR_PATH + filePath;
+        const string binaryPath = BakedContent::GetPath(sourcePath, MESH_FILE_EXTENSION);
+        if (!BakedContent::IsOutOfDate(sourcePath, binaryPath) && load->file.Open(binaryPath) &&
+            MeshFile::Read(load->file.GetData(), load->file.GetSize(), load->view)) {
+            PrefetchPages(load->file.GetData(), load->file.GetSize());
+            load->succeeded = true;
+        } else if (MeshImporter::Import(sourcePath, load->data)) {
+            load->view = load->data.GetView();
+            load->succeeded = true;
+        }
+
+        load->parseSeconds = StartupProfile::Now() - start;
+        QueueUpload([this, filePath, load]() { FinishMesh(filePath, *load); });
+    });
+
+    return handle;
+}
+
+ContentHandle<Texture> ContentStreamer::LoadTexture(const string& filePath) {
+    const auto cached = ContentManager::textures.find(filePath);
+    if (cached != ContentManager::textures.end() && cached->second) return ContentHandle<Texture>(cached->second);
+
+    const auto pending = pendingTextures.find(filePath);
+    if (pending != pendingTextures.end()) return pending->second;
+
+    ContentHandle<Texture> handle = ContentHandle<Texture>::Loading();
+    pendingTextures[filePath] = handle;
+
+    shared_ptr<TextureLoad> load = make_shared<TextureLoad>();
+    Load([this, filePath, load]() {
+        const double start = StartupProfile::Now();
+        const string sourcePath = ContentManager::TEXTURE_DIR_PATH + filePath;
+        const string bakedPath = BakedContent::GetPath(sourcePath, TEXTURE_FILE_EXTENSION);
+        if (!BakedContent::IsOutOfDate(sourcePath, bakedPath) && load->file.Open(bakedPath) &&
+            TextureFile::Read(load->file.GetData(), load->file.GetSize(), load->view)) {
+            PrefetchPages(load->file.GetData(), load->file.GetSize());
+            load->succeeded = true;
+        } else {
+            // Decode the source image into a single RGBA8 mip
+            int width, height, components;
+            stbi_uc* data = stbi_load(sourcePath.c_str(), &width, &height, &components, 4);
+            if (data) {
+                load->pixels.assign(data, data + width * height * 4);
+                stbi_image_free(data);
+
+                load->mip.width = width;
+                load->mip.height = height;
+                load->mip.offset = 0;
+                load->mip.size = static_cast<uint32_t>(load->pixels.size());
+                load->view.format = TextureFormat_RGBA8;
+                load->view.width = width;
+                load->view.height = height;
+                load->view.mipCount = 1;
+                load->view.mips = &load->mip;
+                load->view.data = reinterpret_cast<const char*>(load->pixels.data());
+                load->succeeded = true;
+            }
+        }
+
+        load->parseSeconds = StartupProfile::Now() - start;
+        QueueUpload([this, filePath, load]() { FinishTexture(filePath, *load); });
+    });
+
+    return handle;
+}
+
+void ContentStreamer::PreloadEntity(const string& filePath) {
+    PreloadPrefab(filePath, true);
+}
+
+void ContentStreamer::PreloadComponent(const string& filePath) {
+    PreloadPrefab(filePath, false);
+}
+
+void ContentStreamer::PreloadPrefab(const string& filePath, bool entity) {
+    if (entity && ContentManager::entityPrefabs.count(filePath) > 0) return;
+    if (!entity && ContentManager::componentPrefabs.count(filePath) > 0) return;
+
+    const string& dirPath = entity ? ContentManager::ENTITY_PREFAB_DIR_PATH : ContentManager::COMPONENT_PREFAB_DIR_PATH;
+    shared_ptr<PrefabLoad> load = make_shared<PrefabLoad>(dirPath + filePath);
+    Load([this, filePath, entity, load]() {
+        const double start = StartupProfile::Now();
+        if (entity) {
+            const json data = ContentManager::ResolvePrefab(filePath, ContentManager::ENTITY_PREFAB_DIR_PATH);
+            load->entities.push_back(make_pair(filePath, data));
+            load->AddEntity(data);
+        } else {
+            const json data = ContentManager::ResolvePrefab(filePath, ContentManager::COMPONENT_PREFAB_DIR_PATH);
+            load->components.push_back(make_pair(filePath, data));
+            load->AddComponent(data);
+        }
+
+        load->bytes = GetFileSize(load->filePath);
+        load->parseSeconds = StartupProfile::Now() - start;
+        QueueUpload([this, load]() { FinishPrefab(*load); });
+    });
+}
+
+void ContentStreamer::PreloadScene(const string& filePath) {
+    if (ContentManager::scenePrefabs.count(filePath) > 0) return;
+
+    shared_ptr<PrefabLoad> load = make_shared<PrefabLoad>(ContentManager::SCENE_DIR_PATH + filePath);
+    Load([this, filePath, load]() {
+        const double start = StartupProfile::Now();
+        load->AddScene(filePath);
+        load->bytes = GetFileSize(load->filePath);
+        load->parseSeconds = StartupProfile::Now() - start;
+        QueueUpload([this, load]() { FinishPrefab(*load); });
+    });
+}
+
+Mesh* ContentStreamer::GetPlaceholderMesh() const {
+    return placeholderMesh;
+}
+
+Texture* ContentStreamer::GetPlaceholderTexture() const {
+    return placeholderTexture;
+}
+
+size_t ContentStreamer::GetPendingCount() const {
+    return pendingCount.load();
+}
+
+void ContentStreamer::Update() {
+    const double start = glfwGetTime();
+    do {
+        function<void()> upload;
+        {
+            lock_guard<mutex> lock(uploadMutex);
+            if (uploads.empty()) break;
+            upload = move(uploads.front());
+            uploads.pop_front();
+        }
+
+        upload();
+        pendingCount--;
+    } while (glfwGetTime() - start < CONTENT_UPLOAD_BUDGET);
+}
+
+SystemAccess ContentStreamer::GetAccess() const {
+    // Only fills in the content caches and handles, but needs the GL context
+    return SystemAccess(SystemResource_Content, SystemResource_Content, true);
+}
+
+void ContentStreamer::Load(function<void()> load) {
+    pendingCount++;
+    {
+        lock_guard<mutex> lock(loadMutex);
+        loads.push_back(move(load));
+    }
+    loadReady.notify_one();
+}
+
+void ContentStreamer::QueueUpload(function<void()> upload) {
+    {
+        lock_guard<mutex> lock(uploadMutex);
+        pendingCount++;
+        uploads.push_back(move(upload));
+    }
+    uploadReady.notify_one();
+}
+
+void ContentStreamer::LoaderLoop() {
+    while (true) {
+        function<void()> load;
+        {
+            unique_lock<mutex> lock(loadMutex);
+            loadReady.wait(lock, [this]() { return quit || !loads.empty(); });
+            if (quit) return;
+            load = move(loads.front());
+            loads.pop_front();
+        }
+
+        load();
+
+        // Its uploads are counted by now, if it queued any. Under the lock so Flush can't miss the last one finishing.
+        {
+            lock_guard<mutex> lock(uploadMutex);
+            pendingCount--;
+        }
+        uploadReady.notify_all();
+    }
+}
+
+void ContentStreamer::FinishMesh(const string& filePath, MeshLoad& load) {
+    ContentHandle<Mesh> handle = pendingMeshes[filePath];
+    pendingMeshes.erase(filePath);
+
+    // Someone may have loaded it synchronously in the meantime
+    Mesh*& mesh = ContentManager::meshes[filePath];
+    if (!mesh && load.succeeded) {
+        const double start = StartupProfile::Now();
+        mesh = new Mesh(load.view);
+        const size_t bytes = sizeof(MeshVertex) * load.view.vertexCount + load.view.indexSize * load.view.indexCount;
+        StartupProfile::Record(StartupAsset_Mesh, filePath, bytes, load.parseSeconds, StartupProfile::Now() - start);
+    }
+    if (!mesh) cerr << "WARNING: Failed to load mesh: " << filePath << endl;
+
+    handle.Resolve(mesh);
+}
+
+void ContentStreamer::FinishTexture(const string& filePath, TextureLoad& load) {
+    ContentHandle<Texture> handle = pendingTextures[filePath];
+    pendingTextures.erase(filePath);
+
+    Texture*& texture = ContentManager::textures[filePath];
+    if (!texture && load.succeeded) {
+        const double start = StartupProfile::Now();
+        texture = ContentManager::UploadTexture(load.view);
+        size_t bytes = 0;
+        for (size_t i = 0; i < load.view.mipCount; ++i) {
+            bytes += load.view.mips[i].size;
+        }
+        StartupProfile::Record(StartupAsset_Texture, filePath, bytes, load.parseSeconds, StartupProfile::Now() - start);
+    }
+    if (!texture) cerr << "WARNING: Failed to load texture: " << filePath << endl;
+
+    handle.Resolve(texture);
+}
+
+void ContentStreamer::FinishPrefab(PrefabLoad& load) {
+    StartupProfile::Record(StartupAsset_Prefab, load.filePath, load.bytes, load.parseSeconds, 0.0);
+
+    // Anything already parsed synchronously wins
+    for (auto& entity : load.entities) {
+        ContentManager::entityPrefabs.insert(entity);
+    }
+    for (auto& component : load.components) {
+        ContentManager::componentPrefabs.insert(component);
+    }
+    for (auto& scene : load.scenes) {
+        ContentManager::scenePrefabs.insert(scene);
+    }
+
+    for (const string& mesh : load.meshes) {
+        LoadMesh(mesh);
+    }
+    for (const string& texture : load.textures) {
+        LoadTexture(texture);
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "../System.h"
+#include "ContentHandle.h"
+#include "Mesh.h"
+#include "Texture.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#define CONTENT_MIN_LOADER_THREADS 2      // One per core beyond the main thread, but never fewer than this
+#define CONTENT_UPLOAD_BUDGET 0.002         // Seconds of GL uploads per frame
+
+// Loads content without stalling the frame. Loader threads do the file reads, decoding and JSON parsing, and
+// hand the results to the main thread, which uploads them to the GPU a few at a time in Update.
+// Assets that are still loading are returned as handles, and users draw a placeholder until they arrive.
+class ContentStreamer : public System {
+public:
+    // Access the singleton instance
+    static ContentStreamer& Instance();
+    ~ContentStreamer();
+
+    // Starts the loader threads and creates the placeholders (MUST come after Graphics, which creates the GL context)
+    void Initialize();
+
+    // Finds every scene under ContentManager::SCENE_DIR_PATH and every map's terrain texture, and preloads them all
+    // across the loader threads. Called at boot so that the menus and maps never wait on the disk.
+    void PreloadManifest();
+
+    // Uploads everything as it arrives, ignoring the frame budget, until no loads are left. For boot only.
+    void Flush();
+
+    // Loads from the same directories and shares the same caches as ContentManager::GetMesh and GetTexture
+    ContentHandle<Mesh> LoadMesh(const std::string& filePath);
+    ContentHandle<Texture> LoadTexture(const std::string& filePath);
+
+    // Parses a prefab and every prefab it refers to, and starts loading the meshes and textures its components use,
+    // so that spawning it later never touches the disk
+    void PreloadEntity(const std::string& filePath);
+    void PreloadComponent(const std::string& filePath);
+    void PreloadScene(const std::string& filePath);
+
+    Mesh* GetPlaceholderMesh() const;
+    Texture* GetPlaceholderTexture() const;
+
+    // Loads that have been requested but not uploaded yet
+    size_t GetPendingCount() const;
+
+    // Uploads finished loads until the frame's budget is used up (always at least one)
+    void Update() override;
+    SystemAccess GetAccess() const override;
+
+private:
+    // No instantiation or copying
+    ContentStreamer();
+    ContentStreamer(const ContentStreamer&) = delete;
+    ContentStreamer& operator= (const ContentStreamer&) = delete;
+
+    struct MeshLoad;
+    struct TextureLoad;
+    struct PrefabLoad;
+
+    // Runs load on a loader thread, which hands its results to the main thread by queueing uploads
+    void Load(std::function<void()> load);
+    void QueueUpload(std::function<void()> upload);
+    void LoaderLoop();
+
+    void PreloadPrefab(const std::string& filePath, bool entity);
+
+    void FinishMesh(const std::string& filePath, MeshLoad& load);
+    void FinishTexture(const std::string& filePath, TextureLoad& load);
+    void FinishPrefab(PrefabLoad& load);
+
+    // Reads block on the disk, so the loaders are kept apart from the job system's workers
+    std::vector<std::thread> loaders;
+    std::mutex loadMutex;
+    std::condition_variable loadReady;
+    std::deque<std::function<void()>> loads;
+    bool quit;
+
+    std::mutex uploadMutex;
+    std::condition_variable uploadReady;
+    std::deque<std::function<void()>> uploads;
+    std::atomic<size_t> pendingCount;      // Loads still running plus uploads still queued
+
+    // Requests that are in flight, so that asking again shares the same handle. Main thread only.
+    std::unordered_map<std::string, ContentHandle<Mesh>> pendingMeshes;
+    std::unordered_map<std::string, ContentHandle<Texture>> pendingTextures;
+
+    Mesh* placeholderMesh;
+    Texture* placeholderTexture;
+};
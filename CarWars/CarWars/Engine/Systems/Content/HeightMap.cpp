@@ -2,12 +2,42 @@
 #include "Picture.h"
 #include "Mesh.h"
 #include "../Engine/Systems/Content/ContentManager.h"
+#include "MapPackage.h"
+#include "TerrainChunks.h"
 #include <cstdlib>
 #include <algorithm>
 
 using namespace glm;
 
 HeightMap::HeightMap(std::string dirPath) {
+    LoadSettings(dirPath);
+
+    MapPackage* package = ContentManager::GetMapPackage(dirPath);
+    if (package) {
+        Initialize(*package);
+    } else {
+        MeshData meshData;
+        Initialize(ContentManager::MAP_DIR_PATH + dirPath + "Map.png", meshData);
+        mesh = new Mesh(meshData.GetView());
+        InitializeChunks(meshData.vertices.data(), rowCount + wallVertices * 2, colCount + wallVertices * 2);
+    }
+}
+
+HeightMap::HeightMap(std::string dirPath, MeshData& meshData) {
+    LoadSettings(dirPath);
+    Initialize(ContentManager::MAP_DIR_PATH + dirPath + "Map.png", meshData);
+}
+
+HeightMap::~HeightMap() {
+    for (size_t i = 0; i < rowCount + wallVertices * 2; ++i) {
+        delete[] heights[i];
+    }
+    delete[] heights;
+    delete mesh;
+    for (Mesh* chunk : chunks) delete chunk;
+}
+
+void HeightMap::LoadSettings(std::string dirPath) {
     nlohmann::json data = ContentManager::LoadJson(ContentManager::MAP_DIR_PATH + dirPath + "Data.json");
     maxHeight = ContentManager::GetFromJson<float>(data["MaxHeight"], 25.f);
     maxWidth = ContentManager::GetFromJson<float>(data["MaxWidth"], 20.f);
@@ -20,14 +50,37 @@ HeightMap::HeightMap(std::string dirPath) {
 	wallMoundMaxVertices = ContentManager::GetFromJson<float>(data["WallMoundMaxVertices"], 0.0);
 	wallMoundMinVertices = ContentManager::GetFromJson<float>(data["WallMoundMinVertices"], 0.0);
 	wallMoundVariation = ContentManager::GetFromJson<float>(data["WallMoundVariation"], 0.0);
-
-
-    const std::string filePath = ContentManager::MAP_DIR_PATH + dirPath + "Map.png";
+}
+
+void HeightMap::Initialize(const MapPackage& package) {
+    const MapPackageHeader& header = package.GetHeader();
+    rowCount = header.heightRowCount - wallVertices * 2;
+    colCount = header.heightColumnCount - wallVertices * 2;
+    xSpacing = header.xSpacing;
+    zSpacing = header.zSpacing;
+
+    const float* packageHeights = package.GetHeights();
+    heights = new float*[header.heightRowCount];
+    for (size_t i = 0; i < header.heightRowCount; ++i) {
+        heights[i] = new float[header.heightColumnCount];
+        std::copy(packageHeights + i * header.heightColumnCount, packageHeights + (i + 1) * header.heightColumnCount, heights[i]);
+    }
+
+    MeshView view;
+    package.GetMesh(view);
+    mesh = new Mesh(view);
+    InitializeChunks(view.vertices, header.heightRowCount, header.heightColumnCount);
+}
 
-    Initialize(filePath);
+void HeightMap::InitializeChunks(const MeshVertex* vertices, size_t rowCount, size_t columnCount) {
+    std::vector<MeshData> chunkData;
+    TerrainChunks::Build(vertices, rowCount, columnCount, chunkData);
+    for (const MeshData& data : chunkData) {
+        chunks.push_back(new Mesh(data.GetView()));
+    }
 }
 
-void HeightMap::Initialize(std::string filePath) {
+void HeightMap::Initialize(std::string filePath, MeshData& meshData) {
 	Picture* image = new Picture(filePath);
 
 	rowCount = image->Height();
@@ -397,8 +450,43 @@ void HeightMap::Initialize(std::string filePath) {
 		r += w;
 	}
 
-	mesh = new Mesh(triangleCount, vertexCount, triangles, vertices, uvs);
+	// Pack the grid into a mesh, with each normal averaged from the faces around its vertex
+	meshData.vertices.resize(vertexCount);
+	meshData.indices.resize(triangleCount * 3);
+	for (size_t i = 0; i < vertexCount; ++i) {
+		MeshVertex& vertex = meshData.vertices[i];
+		vertex.position = vertices[i];
+		vertex.uv = uvs[i];
+		vertex.normal = vec3(0.f);
+		vertex.tangent = vec4(1.f, 0.f, 0.f, 1.f);
+	}
+	for (size_t i = 0; i < triangleCount; ++i) {
+		const Triangle triangle = triangles[i];
+		meshData.indices[i * 3] = triangle.vertexIndex0;
+		meshData.indices[i * 3 + 1] = triangle.vertexIndex1;
+		meshData.indices[i * 3 + 2] = triangle.vertexIndex2;
+
+		const vec3 v0 = vertices[triangle.vertexIndex0];
+		const vec3 triangleNormal = normalize(cross(vertices[triangle.vertexIndex1] - v0, vertices[triangle.vertexIndex2] - v0));
+		meshData.vertices[triangle.vertexIndex0].normal += triangleNormal;
+		meshData.vertices[triangle.vertexIndex1].normal += triangleNormal;
+		meshData.vertices[triangle.vertexIndex2].normal += triangleNormal;
+	}
+
+	meshData.boundsMin = meshData.boundsMax = vertices[0];
+	for (MeshVertex& vertex : meshData.vertices) {
+		vertex.normal = normalize(vertex.normal);
+		meshData.boundsMin = min(meshData.boundsMin, vertex.position);
+		meshData.boundsMax = max(meshData.boundsMax, vertex.position);
+	}
+
+	Submesh submesh = {};
+	submesh.indexCount = static_cast<uint32_t>(meshData.indices.size());
+	meshData.submeshes.assign(1, submesh);
 
+	delete[] vertices;
+	delete[] uvs;
+	delete[] triangles;
 	delete image;
 	//rowCount = totalRowCount;
 	//colCount = totalColCount;
@@ -445,3 +533,7 @@ float HeightMap::GetZSpacing() const {
 Mesh* HeightMap::GetMesh() {
     return mesh;
 }
+
+const std::vector<Mesh*>& HeightMap::GetChunks() const {
+    return chunks;
+}
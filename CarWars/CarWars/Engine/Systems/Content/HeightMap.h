@@ -7,12 +7,20 @@ using std::vector;
 
 class Picture;
 class Mesh;
+class MapPackage;
+struct MeshData;
+struct MeshVertex;
 struct Triangle;
 
 class HeightMap {
 public:
+    // Loads from the map's package when it has an up to date one, and generates from Map.png otherwise
     HeightMap(std::string dirPath);
 
+    // Generates from Map.png without creating the render mesh (so without a GL context), for the map baker
+    HeightMap(std::string dirPath, MeshData& meshData);
+    ~HeightMap();
+
 	float GetHeight(glm::vec3 coords) const;
     float GetWidth() const;
     float GetLength() const;
@@ -21,11 +29,21 @@ public:
 	float GetWallHeight() const;
     float GetXSpacing() const;
     float GetZSpacing() const;
+    // The whole grid in one mesh, for the collider
     Mesh* GetMesh();
+    // The grid split into chunks with levels of detail, for drawing
+    const std::vector<Mesh*>& GetChunks() const;
 private:
-    void Initialize(std::string filePath);
+    friend class MapBaker;
+    friend class OcclusionBenchmark;
+
+    void LoadSettings(std::string dirPath);
+    void Initialize(std::string filePath, MeshData& meshData);
+    void Initialize(const MapPackage& package);
+    void InitializeChunks(const MeshVertex* vertices, size_t rowCount, size_t columnCount);
 
     Mesh* mesh = nullptr;
+    std::vector<Mesh*> chunks;
 
     int rowCount;
     int colCount;
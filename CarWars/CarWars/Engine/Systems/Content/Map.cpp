@@ -4,6 +4,8 @@
 #include "../../Components/RigidbodyComponents/RigidStaticComponent.h"
 #include "../../Components/Colliders/MeshCollider.h"
 #include "../../Components/MeshComponent.h"
+#include "MapPackage.h"
+#include "Picture.h"
 #include <deque>
 #include "../../Components/RigidbodyComponents/PowerUpSpawnerComponent.h"
 #include "../../Components/RigidbodyComponents/RigidDynamicComponent.h"
@@ -33,10 +35,18 @@ Map::Map(std::string dirPath) {
     // Load the map's scene
     ContentManager::DestroySceneAndLoadScene(data["Scene"]);
 
-    // TODO: Initialize powerups and spawners from image
-    Picture* objectsMap = new Picture(ContentManager::MAP_DIR_PATH + dirPath + "Objects.png");
-    if (objectsMap->Pixels()) {
-        LoadObjects(objectsMap);
+    // Initialize powerups and spawners, from the package if there is one and from the image otherwise
+    MapPackage* package = ContentManager::GetMapPackage(dirPath);
+    if (package) {
+        size_t count;
+        const MapObject* objects = package->GetObjects(count);
+        LoadObjects(objects, count);
+    } else {
+        Picture* objectsMap = new Picture(ContentManager::MAP_DIR_PATH + dirPath + "Objects.png");
+        std::vector<MapObject> objects;
+        DecodeObjects(objectsMap, mapWidth, mapLength, objects);
+        LoadObjects(objects.data(), objects.size());
+        delete objectsMap;
     }
 
     if (heightMap) {
@@ -57,19 +67,25 @@ Map::Map(std::string dirPath) {
 		std::string texture = ContentManager::GetFromJson<std::string>(data["TerrainTexture"], "Boulder.jpg");
 		glm::vec2 uvScale = ContentManager::JsonToVec2(data["TerrainUvScale"], glm::vec2(10.f, 10.f));
 
-        // Initialize height map mesh
-        EntityManager::AddComponent(floor, new MeshComponent({
-            { "HeightMap", dirPath },
-            { "Material", "Basic.json" },
-            { "Texture", texture },
-			{ "UvScale", {uvScale.x, uvScale.y} }
-        }));
+        // Initialize height map meshes, a chunk each so they're culled and given a level of detail on their own
+        for (size_t i = 0; i < heightMap->GetChunks().size(); ++i) {
+            EntityManager::AddComponent(floor, new MeshComponent({
+                { "HeightMap", dirPath },
+                { "HeightMapChunk", i },
+                { "Occluder", true },
+                { "Material", "Basic.json" },
+                { "Texture", texture },
+                { "UvScale", {uvScale.x, uvScale.y} }
+            }));
+        }
     }
 
     navigationMesh->UpdateMesh();
 }
 
-void Map::LoadObjects(Picture* objectsMap) {
+void Map::DecodeObjects(Picture* objectsMap, float mapWidth, float mapLength, std::vector<MapObject>& objects) {
+    if (!objectsMap->Pixels()) return;
+
     const glm::vec3 generalPowerUpColor = glm::vec3(1.f, 0.f, 1.f);
     const glm::vec3 healthPowerUpColor = glm::vec3(0.f, 1.f, 0.f);
     const glm::vec3 damagePowerUpColor = glm::vec3(1.f, 0.f, 0.f);
@@ -82,31 +98,50 @@ void Map::LoadObjects(Picture* objectsMap) {
     for (int row = 0; row < objectsMap->Height(); ++row) {
         for (int col = 0; col < objectsMap->Width(); ++col) {
             const glm::vec3 color = glm::vec3(pixels[0], pixels[1], pixels[2]);
-            Entity* object = nullptr;
+            MapObject object;
+            bool found = true;
             if (color == spawnColor) {
-                object = ContentManager::LoadEntity("Game/SpawnLocation.json");
+                object.type = MapObject_SpawnLocation;
             } else if (color == generalPowerUpColor) {
-                object = ContentManager::LoadEntity("Game/PowerUpSpawner.json");
+                object.type = MapObject_PowerUp;
             } else if (color == healthPowerUpColor) {
-                object = ContentManager::LoadEntity("Game/PowerUpSpawner.json");
-                object->GetComponent<PowerUpSpawnerComponent>()->SetPowerUpType(Health);
+                object.type = MapObject_HealthPowerUp;
             } else if (color == damagePowerUpColor) {
-                object = ContentManager::LoadEntity("Game/PowerUpSpawner.json");
-                object->GetComponent<PowerUpSpawnerComponent>()->SetPowerUpType(Damage);
+                object.type = MapObject_DamagePowerUp;
             } else if (color == defencePowerUpColor) {
-                object = ContentManager::LoadEntity("Game/PowerUpSpawner.json");
-                object->GetComponent<PowerUpSpawnerComponent>()->SetPowerUpType(Defence);
+                object.type = MapObject_DefencePowerUp;
+            } else {
+                found = false;
             }
             
-            if (object) {
-                const glm::vec3 position = offset + glm::vec3(
+            if (found) {
+                object.position = offset + glm::vec3(
                     static_cast<float>(col) / static_cast<float>(objectsMap->Width()) * mapLength,
                     2.f,
                     static_cast<float>(row) / static_cast<float>(objectsMap->Height()) * mapWidth);
-                SetPosition(object, position);
+                objects.push_back(object);
             }
             
             pixels += objectsMap->Channels();
         }
     }
 }
+
+void Map::LoadObjects(const MapObject* objects, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        Entity* object;
+        if (objects[i].type == MapObject_SpawnLocation) {
+            object = ContentManager::LoadEntity("Game/SpawnLocation.json");
+        } else {
+            object = ContentManager::LoadEntity("Game/PowerUpSpawner.json");
+            if (objects[i].type == MapObject_HealthPowerUp) {
+                object->GetComponent<PowerUpSpawnerComponent>()->SetPowerUpType(Health);
+            } else if (objects[i].type == MapObject_DamagePowerUp) {
+                object->GetComponent<PowerUpSpawnerComponent>()->SetPowerUpType(Damage);
+            } else if (objects[i].type == MapObject_DefencePowerUp) {
+                object->GetComponent<PowerUpSpawnerComponent>()->SetPowerUpType(Defence);
+            }
+        }
+        SetPosition(object, objects[i].position);
+    }
+}
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 class Picture;
+struct MapObject;
 class NavigationMesh;
 class HeightMap;
 
@@ -13,8 +15,11 @@ public:
     NavigationMesh* navigationMesh;
     HeightMap* heightMap;
 
+    // Decodes the spawn locations and power-ups marked in a map's Objects.png
+    static void DecodeObjects(Picture* objectsMap, float mapWidth, float mapLength, std::vector<MapObject>& objects);
+
 private:
-    void LoadObjects(Picture* objectsMap);
+    void LoadObjects(const MapObject* objects, size_t count);
 
     float mapWidth;
     float mapLength;
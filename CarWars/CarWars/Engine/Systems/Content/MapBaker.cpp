@@ -0,0 +1,122 @@
+#include "MapBaker.h"
+
+#include "ContentManager.h"
+#include "HeightMap.h"
+#include "NavigationMesh.h"
+#include "Map.h"
+#include "Picture.h"
+#include "Mesh.h"
+#include "../../Components/Colliders/MeshCollider.h"
+#include "../Physics.h"
+#include <cstring>
+#include <iostream>
+#include <experimental/filesystem>
+
+using namespace std;
+using namespace nlohmann;
+namespace fs = std::experimental::filesystem;
+
+bool MapBaker::Bake(const string& dirPath, MapPackageData& package) {
+    const string mapPath = ContentManager::MAP_DIR_PATH + dirPath;
+    json data = ContentManager::LoadJson(mapPath + "Data.json");
+    if (!data["Scene"].is_string()) return false;
+    const string scene = data["Scene"];
+    if (scene.size() >= MAP_PACKAGE_NAME_LENGTH) return false;
+    const float mapWidth = ContentManager::GetFromJson<float>(data["MaxWidth"], 100.f);
+    const float mapLength = ContentManager::GetFromJson<float>(data["MaxLength"], 100.f);
+
+    MapPackageHeader& header = package.header;
+    memset(&header, 0, sizeof(header));
+    strncpy(header.scene, scene.c_str(), MAP_PACKAGE_NAME_LENGTH - 1);
+
+    // Height map and its render mesh
+    HeightMap heightMap(dirPath, package.mesh);
+    if (package.mesh.vertices.empty()) return false;
+
+    header.heightRowCount = heightMap.rowCount + heightMap.wallVertices * 2;
+    header.heightColumnCount = heightMap.colCount + heightMap.wallVertices * 2;
+    header.xSpacing = heightMap.xSpacing;
+    header.zSpacing = heightMap.zSpacing;
+    package.heights.reserve(header.heightRowCount * header.heightColumnCount);
+    for (size_t row = 0; row < header.heightRowCount; ++row) {
+        package.heights.insert(package.heights.end(), heightMap.heights[row], heightMap.heights[row] + header.heightColumnCount);
+    }
+
+    // Collision mesh, cooked the same way MeshCollider cooks a height map at load time
+    vector<glm::vec3> vertices;
+    vertices.reserve(package.mesh.vertices.size());
+    for (const MeshVertex& vertex : package.mesh.vertices) {
+        vertices.push_back(vertex.position);
+    }
+
+    vector<Triangle> triangles;
+    triangles.reserve(package.mesh.indices.size() / 3);
+    for (size_t i = 0; i + 2 < package.mesh.indices.size(); i += 3) {
+        triangles.push_back(Triangle(package.mesh.indices[i], package.mesh.indices[i + 1], package.mesh.indices[i + 2]));
+    }
+
+    physx::PxDefaultMemoryOutputStream cooked;
+    if (!MeshCollider::Cook(vertices, triangles, true, cooked)) return false;
+    package.collision.assign(cooked.getData(), cooked.getData() + cooked.getSize());
+
+    // Navigation defaults
+    size_t navigationRowCount, navigationColumnCount;
+    NavigationMesh::GetGridSize(heightMap, navigationRowCount, navigationColumnCount);
+    header.navigationRowCount = static_cast<uint32_t>(navigationRowCount);
+    header.navigationColumnCount = static_cast<uint32_t>(navigationColumnCount);
+    header.navigationSpacing = NAVIGATION_MAP_SPACING;
+    package.navigationDefaults.resize(navigationRowCount * navigationColumnCount);
+    NavigationMesh::SampleDefaults(dirPath, navigationRowCount, navigationColumnCount, package.navigationDefaults.data());
+
+    // Spawn locations and power-ups
+    Picture objectsMap(mapPath + "Objects.png");
+    Map::DecodeObjects(&objectsMap, mapWidth, mapLength, package.objects);
+
+    // Scene
+    package.scene = ContentManager::LoadJson(ContentManager::SCENE_DIR_PATH + scene);
+
+    return true;
+}
+
+bool MapBaker::BakeAll() {
+    const string& dirPath = ContentManager::MAP_DIR_PATH;
+
+    size_t bakedCount = 0;
+    size_t upToDateCount = 0;
+    size_t failedCount = 0;
+
+    error_code error;
+    for (const fs::directory_entry& entry : fs::directory_iterator(dirPath, error)) {
+        if (!fs::is_directory(entry.status())) continue;
+
+        const string mapDirPath = entry.path().filename().string() + "/";
+        if (!fs::exists(dirPath + mapDirPath + "Data.json")) continue;
+
+        json data = ContentManager::LoadJson(dirPath + mapDirPath + "Data.json");
+        const string scene = ContentManager::GetFromJson<string>(data["Scene"], "");
+        if (!MapPackage::IsOutOfDate(mapDirPath, scene)) {
+            // Packages holding an older mesh format are baked again. Closed before the package is rewritten.
+            MapPackage existing;
+            if (existing.Open(mapDirPath)) {
+                upToDateCount++;
+                continue;
+            }
+        }
+
+        MapPackageData package;
+        if (Bake(mapDirPath, package) && MapPackage::Write(MapPackage::GetPath(mapDirPath), package)) {
+            bakedCount++;
+        } else {
+            cerr << "ERROR: Failed to bake map: " << mapDirPath << endl;
+            failedCount++;
+        }
+    }
+
+    if (error) {
+        cerr << "ERROR: Failed to read map directory: " << dirPath << endl;
+        return false;
+    }
+
+    cout << dirPath << ": " << bakedCount << " baked, " << upToDateCount << " up to date, " << failedCount << " failed" << endl;
+    return failedCount == 0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "MapPackage.h"
+#include <string>
+
+// Offline map baker (CarWars.exe --bake-maps). Generates a map's height map, cooks its collision mesh, samples its
+// navigation defaults and decodes its objects so that loading the map in game is mapping a single package.
+// Cooking needs Physics to be initialized.
+class MapBaker {
+public:
+    // Bakes the map in dirPath (relative to ContentManager::MAP_DIR_PATH)
+    static bool Bake(const std::string& dirPath, MapPackageData& package);
+
+    // Writes a package into every map directory that doesn't have an up to date one.
+    // Returns false if any map failed to bake.
+    static bool BakeAll();
+
+private:
+    // No instantiation
+    MapBaker() = delete;
+};
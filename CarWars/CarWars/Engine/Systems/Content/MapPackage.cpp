@@ -0,0 +1,147 @@
+#include "MapPackage.h"
+
+#include "BakedContent.h"
+#include "ContentManager.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+bool MapPackage::Open(const string& dirPath) {
+    file.Close();
+    if (!file.Open(GetPath(dirPath))) return false;
+
+    if (!Validate() || IsOutOfDate(dirPath, GetHeader().scene)) {
+        file.Close();
+        return false;
+    }
+    return true;
+}
+
+bool MapPackage::IsOpen() const {
+    return file.IsOpen();
+}
+
+const MapPackageHeader& MapPackage::GetHeader() const {
+    return *reinterpret_cast<const MapPackageHeader*>(file.GetData());
+}
+
+const float* MapPackage::GetHeights() const {
+    size_t size;
+    return reinterpret_cast<const float*>(GetSection(MapSection_Heights, size));
+}
+
+bool MapPackage::GetMesh(MeshView& view) const {
+    size_t size;
+    const char* data = GetSection(MapSection_Mesh, size);
+    return MeshFile::Read(data, size, view);
+}
+
+const void* MapPackage::GetCollision(size_t& size) const {
+    return GetSection(MapSection_Collision, size);
+}
+
+const float* MapPackage::GetNavigationDefaults() const {
+    size_t size;
+    return reinterpret_cast<const float*>(GetSection(MapSection_NavigationDefaults, size));
+}
+
+const MapObject* MapPackage::GetObjects(size_t& count) const {
+    size_t size;
+    const char* data = GetSection(MapSection_Objects, size);
+    count = size / sizeof(MapObject);
+    return reinterpret_cast<const MapObject*>(data);
+}
+
+nlohmann::json MapPackage::GetScene() const {
+    size_t size;
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(GetSection(MapSection_Scene, size));
+    return nlohmann::json::from_cbor(vector<uint8_t>(data, data + size));
+}
+
+string MapPackage::GetPath(const string& dirPath) {
+    return ContentManager::MAP_DIR_PATH + dirPath + MAP_PACKAGE_FILE_NAME;
+}
+
+bool MapPackage::IsOutOfDate(const string& dirPath, const string& scene) {
+    const string packagePath = GetPath(dirPath);
+    const string mapPath = ContentManager::MAP_DIR_PATH + dirPath;
+    return BakedContent::IsOutOfDate(mapPath + "Data.json", packagePath) ||
+        BakedContent::IsOutOfDate(mapPath + "Map.png", packagePath) ||
+        BakedContent::IsOutOfDate(mapPath + "Nav.png", packagePath) ||
+        BakedContent::IsOutOfDate(mapPath + "Objects.png", packagePath) ||
+        BakedContent::IsOutOfDate(ContentManager::SCENE_DIR_PATH + scene, packagePath);
+}
+
+bool MapPackage::Write(const string& filePath, MapPackageData& package) {
+    ostringstream mesh;
+    if (!MeshFile::Write(mesh, package.mesh)) return false;
+    const string meshBytes = mesh.str();
+    const vector<uint8_t> sceneBytes = nlohmann::json::to_cbor(package.scene);
+
+    const pair<const void*, size_t> sections[MapSection_Count] = {
+        { package.heights.data(), sizeof(float) * package.heights.size() },
+        { meshBytes.data(), meshBytes.size() },
+        { package.collision.data(), package.collision.size() },
+        { package.navigationDefaults.data(), sizeof(float) * package.navigationDefaults.size() },
+        { package.objects.data(), sizeof(MapObject) * package.objects.size() },
+        { sceneBytes.data(), sceneBytes.size() }
+    };
+
+    MapPackageHeader& header = package.header;
+    header.magic = MAP_PACKAGE_MAGIC;
+    header.version = MAP_PACKAGE_VERSION;
+    size_t offset = sizeof(MapPackageHeader);
+    for (size_t i = 0; i < MapSection_Count; ++i) {
+        offset = (offset + MAP_PACKAGE_ALIGNMENT - 1) / MAP_PACKAGE_ALIGNMENT * MAP_PACKAGE_ALIGNMENT;
+        header.sections[i].offset = static_cast<uint32_t>(offset);
+        header.sections[i].size = static_cast<uint32_t>(sections[i].second);
+        offset += sections[i].second;
+    }
+
+    ofstream file(filePath, ios::binary | ios::trunc);
+    if (!file) return false;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    size_t written = sizeof(header);
+    const char padding[MAP_PACKAGE_ALIGNMENT] = {};
+    for (size_t i = 0; i < MapSection_Count; ++i) {
+        file.write(padding, header.sections[i].offset - written);
+        file.write(static_cast<const char*>(sections[i].first), sections[i].second);
+        written = header.sections[i].offset + sections[i].second;
+    }
+
+    return static_cast<bool>(file);
+}
+
+bool MapPackage::Validate() const {
+    const char* data = file.GetData();
+    const size_t size = file.GetSize();
+    if (!data || size < sizeof(MapPackageHeader)) return false;
+
+    const MapPackageHeader& header = GetHeader();
+    if (header.magic != MAP_PACKAGE_MAGIC || header.version != MAP_PACKAGE_VERSION) return false;
+    if (!memchr(header.scene, '\0', MAP_PACKAGE_NAME_LENGTH)) return false;
+
+    for (size_t i = 0; i < MapSection_Count; ++i) {
+        const MapPackageSection& section = header.sections[i];
+        if (section.offset % MAP_PACKAGE_ALIGNMENT != 0) return false;
+        if (static_cast<size_t>(section.offset) + section.size > size) return false;
+    }
+
+    const size_t heightCount = static_cast<size_t>(header.heightRowCount) * header.heightColumnCount;
+    const size_t navigationCount = static_cast<size_t>(header.navigationRowCount) * header.navigationColumnCount;
+    if (header.sections[MapSection_Heights].size != sizeof(float) * heightCount) return false;
+    if (header.sections[MapSection_NavigationDefaults].size != sizeof(float) * navigationCount) return false;
+    if (header.sections[MapSection_Objects].size % sizeof(MapObject) != 0) return false;
+
+    MeshView mesh;
+    return GetMesh(mesh);
+}
+
+const char* MapPackage::GetSection(MapSection section, size_t& size) const {
+    const MapPackageSection& entry = GetHeader().sections[section];
+    size = entry.size;
+    return file.GetData() + entry.offset;
+}
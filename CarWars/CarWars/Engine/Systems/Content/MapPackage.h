@@ -0,0 +1,116 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "MeshFile.h"
+#include <glm/glm.hpp>
+#include <json/json.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Everything a map needs at match start, baked ahead of time by the map baker (CarWars.exe --bake-maps) so that
+// loading a map is mapping one file instead of decoding its images and generating its geometry. A package is laid
+// out as:
+//   MapPackageHeader
+//   each section at its offset from the start of the file (16 byte aligned)
+
+#define MAP_PACKAGE_MAGIC 0x50414D43        // "CMAP"
+#define MAP_PACKAGE_VERSION 1
+#define MAP_PACKAGE_FILE_NAME "Map.pkg"
+#define MAP_PACKAGE_ALIGNMENT 16
+#define MAP_PACKAGE_NAME_LENGTH 64
+
+enum MapSection {
+    MapSection_Heights = 0,             // float[heightRowCount * heightColumnCount], walls included, row by row
+    MapSection_Mesh,                    // The height map's render mesh as a whole mesh file (see MeshFile.h)
+    MapSection_Collision,               // The height map's cooked PhysX triangle mesh
+    MapSection_NavigationDefaults,      // float[navigationRowCount * navigationColumnCount]
+    MapSection_Objects,                 // MapObject[]
+    MapSection_Scene,                   // The map's scene as CBOR
+    MapSection_Count
+};
+
+enum MapObjectType {
+    MapObject_SpawnLocation = 0,
+    MapObject_PowerUp,
+    MapObject_HealthPowerUp,
+    MapObject_DamagePowerUp,
+    MapObject_DefencePowerUp
+};
+
+// A spawn location or power-up decoded from the map's Objects.png
+struct MapObject {
+    uint32_t type;
+    glm::vec3 position;
+};
+
+struct MapPackageSection {
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct MapPackageHeader {
+    uint32_t magic;
+    uint32_t version;
+
+    // Height map grid, walls included
+    uint32_t heightRowCount;
+    uint32_t heightColumnCount;
+    float xSpacing;
+    float zSpacing;
+
+    // Navigation grid
+    uint32_t navigationRowCount;
+    uint32_t navigationColumnCount;
+    float navigationSpacing;
+
+    // Scene file the map loads (relative to ContentManager::SCENE_DIR_PATH)
+    char scene[MAP_PACKAGE_NAME_LENGTH];
+
+    MapPackageSection sections[MapSection_Count];
+};
+
+static_assert(sizeof(MapObject) == 16, "MapObject must match the file layout");
+static_assert(sizeof(MapPackageHeader) == 36 + MAP_PACKAGE_NAME_LENGTH + 8 * MapSection_Count, "MapPackageHeader must match the file layout");
+
+// Package contents that own their data, e.g. fresh from the baker. The header's sections are filled in by Write.
+struct MapPackageData {
+    MapPackageHeader header;
+    std::vector<float> heights;
+    MeshData mesh;
+    std::vector<uint8_t> collision;
+    std::vector<float> navigationDefaults;
+    std::vector<MapObject> objects;
+    nlohmann::json scene;
+};
+
+// A mapped package. Sections point straight into the mapping, so they are only valid while it stays open.
+class MapPackage {
+public:
+    // Maps dirPath's package if it is up to date with all of its sources
+    bool Open(const std::string& dirPath);
+    bool IsOpen() const;
+
+    const MapPackageHeader& GetHeader() const;
+
+    const float* GetHeights() const;
+    bool GetMesh(MeshView& view) const;
+    const void* GetCollision(size_t& size) const;
+    const float* GetNavigationDefaults() const;
+    const MapObject* GetObjects(size_t& count) const;
+    nlohmann::json GetScene() const;
+
+    static std::string GetPath(const std::string& dirPath);
+
+    // Whether the package is missing or older than any of the files it was baked from
+    static bool IsOutOfDate(const std::string& dirPath, const std::string& scene);
+
+    static bool Write(const std::string& filePath, MapPackageData& package);
+
+private:
+    // Checks that data holds a whole package of the current version with sections of the expected sizes
+    bool Validate() const;
+    const char* GetSection(MapSection section, size_t& size) const;
+
+    MappedFile file;
+};
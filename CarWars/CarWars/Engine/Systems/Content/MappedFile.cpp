@@ -0,0 +1,103 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : data(nullptr), size(0), file(nullptr), mapping(nullptr) {}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& filePath) {
+    Close();
+
+    HANDLE fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) return false;
+    file = fileHandle;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        Close();
+        return false;
+    }
+
+    HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle) {
+        Close();
+        return false;
+    }
+    mapping = mappingHandle;
+
+    data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!data) {
+        Close();
+        return false;
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) UnmapViewOfFile(data);
+    if (mapping) CloseHandle(static_cast<HANDLE>(mapping));
+    if (file) CloseHandle(static_cast<HANDLE>(file));
+    data = nullptr;
+    size = 0;
+    mapping = nullptr;
+    file = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& filePath) {
+    Close();
+
+    const int descriptor = open(filePath.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+        close(descriptor);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (view == MAP_FAILED) return false;
+
+    data = static_cast<const char*>(view);
+    size = static_cast<size_t>(status.st_size);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) munmap(const_cast<char*>(data), size);
+    data = nullptr;
+    size = 0;
+}
+
+#endif
+
+bool MappedFile::IsOpen() const {
+    return data != nullptr;
+}
+
+const char* MappedFile::GetData() const {
+    return data;
+}
+
+size_t MappedFile::GetSize() const {
+    return size;
+}
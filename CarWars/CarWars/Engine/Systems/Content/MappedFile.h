@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+// Read-only view of a whole file mapped into memory. Nothing is copied up front; the OS pages the file in as it
+// is read, e.g. while OpenGL copies it into a buffer.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool Open(const std::string& filePath);
+    void Close();
+
+    bool IsOpen() const;
+    const char* GetData() const;
+    size_t GetSize() const;
+
+private:
+    // No copying
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+
+    const char* data;
+    size_t size;
+
+    void* file;
+    void* mapping;
+};
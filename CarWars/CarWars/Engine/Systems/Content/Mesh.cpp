@@ -1,5 +1,8 @@
 #include "Mesh.h"
 #include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <unordered_set>
 #include <glm/gtx/string_cast.hpp>
 #include "../../Entities/Transform.h"
 
@@ -7,7 +10,8 @@ Triangle::Triangle() : vertexIndex0(0), vertexIndex1(0), vertexIndex2(0) {}
 Triangle::Triangle(unsigned int _v0, unsigned int _v1, unsigned int _v2) : vertexIndex0(_v0), vertexIndex1(_v1), vertexIndex2(_v2) { }
 
 Mesh::Mesh(size_t _triangleCount, size_t _vertexCount, Triangle* _triangles, glm::vec3* _vertices, glm::vec2* _uvs,
-    glm::vec3* _normals) : triangleCount(_triangleCount), vertexCount(_vertexCount) {
+    glm::vec3* _normals) : triangleCount(_triangleCount), vertexCount(_vertexCount), indexType(GL_UNSIGNED_INT), vertexStride(0),
+    indexCount(_triangleCount * 3) {
     
 	// Generate normals if they were not provided
     if (!_normals) {
@@ -16,12 +20,36 @@ Mesh::Mesh(size_t _triangleCount, size_t _vertexCount, Triangle* _triangles, glm
     }
 
 	// Compute the radius in case this mesh is later attached to the cylinder (?)
-	CalculateRadius(_vertices);
+	CalculateBounds(_vertices);
+
+    Submesh submesh = {};
+    submesh.indexCount = static_cast<uint32_t>(triangleCount * 3);
+    submeshes.push_back(submesh);
+
+    MeshLod lod = { 0, static_cast<uint32_t>(triangleCount * 3), 0.f };
+    lods.push_back(lod);
 
 	// Initialize OpenGL buffers for the provided data
     InitializeBuffers(_triangles, _vertices, _uvs, _normals);
 }
 
+Mesh::Mesh(const MeshView& view) : triangleCount((view.lodCount ? view.lods[0].indexCount : view.indexCount) / 3),
+    vertexCount(view.vertexCount), boundsMin(view.boundsMin), boundsMax(view.boundsMax),
+    indexType(view.indexSize == sizeof(uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT), vertexStride(sizeof(MeshVertex)),
+    indexCount(view.indexCount), submeshes(view.submeshes, view.submeshes + view.submeshCount),
+    lods(view.lods, view.lods + std::min<size_t>(view.lodCount, MESH_MAX_LOD_COUNT)) {
+
+    if (lods.empty()) {
+        MeshLod lod = { 0, static_cast<uint32_t>(view.indexCount), 0.f };
+        lods.push_back(lod);
+    }
+
+    radius = (boundsMax.x - boundsMin.x) / 2.f;
+
+    InitializeInterleavedBuffers(view);
+    InitializeInterleavedVaos();
+}
+
 Mesh::~Mesh() {
     glDeleteBuffers(EABs::Count, eabs);
     glDeleteBuffers(VBOs::Count, vbos);
@@ -53,14 +81,108 @@ float Mesh::GetRadius() const {
 	return radius;
 }
 
-void Mesh::CalculateRadius(glm::vec3 *vertices) {
-	float maxX = vertices[0].x;
-	float minX = vertices[0].x;
-	for (size_t i = 1; i < vertexCount; ++i) {
-		maxX = std::max(maxX, vertices[i].x);
-		minX = std::min(minX, vertices[i].x);
-	}
-	radius = (maxX - minX) / 2.f;
+glm::vec3 Mesh::GetBoundsMin() const {
+    return boundsMin;
+}
+
+glm::vec3 Mesh::GetBoundsMax() const {
+    return boundsMax;
+}
+
+GLenum Mesh::GetIndexType() const {
+    return indexType;
+}
+
+const std::vector<Submesh>& Mesh::GetSubmeshes() const {
+    return submeshes;
+}
+
+const std::vector<MeshLod>& Mesh::GetLods() const {
+    return lods;
+}
+
+const OccluderProxy& Mesh::GetOccluder() const {
+    if (!occluder.lods.empty() || indexCount == 0) return occluder;
+
+    ReadVertices(occluder.vertices);
+    ReadIndices(indexCount, occluder.indices);
+    occluder.lods = lods;
+    occluder.boundsMin = boundsMin;
+    occluder.boundsMax = boundsMax;
+    return occluder;
+}
+
+void Mesh::CalculateBounds(glm::vec3 *vertices) {
+	boundsMin = vertexCount ? vertices[0] : glm::vec3(0.f);
+	boundsMax = boundsMin;
+	for (size_t i = 1; i < vertexCount; ++i) {
+		boundsMin = glm::min(boundsMin, vertices[i]);
+		boundsMax = glm::max(boundsMax, vertices[i]);
+	}
+	radius = (boundsMax.x - boundsMin.x) / 2.f;
+}
+
+void Mesh::ReadBuffer(GLuint buffer, size_t size, void* data) {
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, size, data);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
+
+void Mesh::ReadIndices(size_t count, std::vector<uint32_t>& indices) const {
+    indices.resize(count);
+    if (indexType == GL_UNSIGNED_INT) {
+        ReadBuffer(eabs[EABs::Triangles], sizeof(uint32_t) * count, indices.data());
+    } else {
+        std::vector<uint16_t> shortIndices(count);
+        ReadBuffer(eabs[EABs::Triangles], sizeof(uint16_t) * count, shortIndices.data());
+        indices.assign(shortIndices.begin(), shortIndices.end());
+    }
+}
+
+void Mesh::ReadVertices(std::vector<glm::vec3>& vertices) const {
+    vertices.resize(vertexCount);
+    if (vertexStride == 0) {
+        ReadBuffer(vbos[VBOs::Vertices], sizeof(glm::vec3) * vertexCount, vertices.data());
+    } else {
+        std::vector<MeshVertex> interleaved(vertexCount);
+        ReadBuffer(vbos[VBOs::Vertices], sizeof(MeshVertex) * vertexCount, interleaved.data());
+        for (size_t i = 0; i < vertexCount; ++i) {
+            vertices[i] = interleaved[i].position;
+        }
+    }
+}
+
+void Mesh::ReadTriangles(std::vector<Triangle>& triangles) const {
+    std::vector<uint32_t> indices;
+    ReadIndices(triangleCount * 3, indices);
+    triangles.resize(triangleCount);
+    for (size_t i = 0; i < triangleCount; ++i) {
+        triangles[i] = Triangle(indices[i * 3], indices[i * 3 + 1], indices[i * 3 + 2]);
+    }
+}
+
+const std::vector<glm::vec3>& Mesh::GetEdges() const {
+    if (!edges.empty() || triangleCount == 0) return edges;
+
+    std::vector<glm::vec3> vertices;
+    ReadVertices(vertices);
+    std::vector<Triangle> triangles;
+    ReadTriangles(triangles);
+
+    // Neighbouring triangles share their edges, so each is keyed by its vertices, lowest first
+    std::unordered_set<uint64_t> visited;
+    visited.reserve(triangleCount * 2);
+    for (const Triangle& triangle : triangles) {
+        const unsigned int corners[3] = { triangle.vertexIndex0, triangle.vertexIndex1, triangle.vertexIndex2 };
+        for (int i = 0; i < 3; ++i) {
+            const uint64_t from = std::min(corners[i], corners[(i + 1) % 3]);
+            const uint64_t to = std::max(corners[i], corners[(i + 1) % 3]);
+            if (!visited.insert(from << 32 | to).second) continue;
+            edges.push_back(vertices[from]);
+            edges.push_back(vertices[to]);
+        }
+    }
+    return edges;
 }
 
 void Mesh::InitializeBuffers(Triangle *triangles, glm::vec3 *vertices, glm::vec2 *uvs, glm::vec3 *normals) {
@@ -140,4 +262,45 @@ void Mesh::InitializeUvsVao() {
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
-}
\ No newline at end of file
+}
+
+void Mesh::InitializeInterleavedBuffers(const MeshView& view) {
+    // Only the first vertex buffer is used; it holds every attribute
+    std::fill(vbos, vbos + VBOs::Count, 0);
+    glGenBuffers(1, &vbos[VBOs::Vertices]);
+    glBindBuffer(GL_ARRAY_BUFFER, vbos[VBOs::Vertices]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(MeshVertex) * view.vertexCount, view.vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenBuffers(EABs::Count, eabs);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eabs[EABs::Triangles]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, view.indexSize * view.indexCount, view.indices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void Mesh::InitializeInterleavedVaos() {
+    glGenVertexArrays(VAOs::Count, vaos);
+    glBindBuffer(GL_ARRAY_BUFFER, vbos[VBOs::Vertices]);
+
+    // Same attribute locations as the separate buffer VAOs, plus tangents
+    glBindVertexArray(vaos[VAOs::Geometry]);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertexStride, reinterpret_cast<void*>(offsetof(MeshVertex, position)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, vertexStride, reinterpret_cast<void*>(offsetof(MeshVertex, uv)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, vertexStride, reinterpret_cast<void*>(offsetof(MeshVertex, normal)));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, vertexStride, reinterpret_cast<void*>(offsetof(MeshVertex, tangent)));
+
+    glBindVertexArray(vaos[VAOs::Vertices]);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertexStride, reinterpret_cast<void*>(offsetof(MeshVertex, position)));
+
+    glBindVertexArray(vaos[VAOs::UVs]);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, vertexStride, reinterpret_cast<void*>(offsetof(MeshVertex, uv)));
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
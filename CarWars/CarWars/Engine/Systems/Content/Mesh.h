@@ -3,6 +3,9 @@
 #include <glm/glm.hpp>
 #include <GL/glew.h>
 #include "../Graphics.h"
+#include "MeshFile.h"
+#include "../Graphics/OcclusionBuffer.h"
+#include <vector>
 
 
 class Transform;
@@ -18,6 +21,9 @@ struct Triangle {
 class Mesh {
 public:
     Mesh(size_t _triangleCount, size_t _vertexCount, Triangle *_triangles, glm::vec3 *_vertices, glm::vec2 *_uvs = nullptr, glm::vec3 *_normals = nullptr);
+
+    // Uploads interleaved vertices and 16 or 32 bit indices straight from view (e.g. a mapped mesh file)
+    explicit Mesh(const MeshView& view);
     ~Mesh();
 
     GLuint eabs[EABs::Count];
@@ -28,11 +34,43 @@ public:
 	const size_t vertexCount;
 
 	float GetRadius() const;
+    glm::vec3 GetBoundsMin() const;
+    glm::vec3 GetBoundsMax() const;
+
+    // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, for glDrawElements
+    GLenum GetIndexType() const;
+    const std::vector<Submesh>& GetSubmeshes() const;
+    // Index ranges of each level of detail, finest first. triangleCount and the submeshes describe level 0.
+    const std::vector<MeshLod>& GetLods() const;
+    // Triangles to rasterize when a MeshComponent marks this mesh as an occluder. Read back from the GPU the first time
+    // it's asked for, so only meshes used as occluders keep a CPU copy.
+    const OccluderProxy& GetOccluder() const;
+
+    // Copy the geometry back from the GPU whatever layout it was uploaded in, e.g. to cook a collider
+    void ReadVertices(std::vector<glm::vec3>& vertices) const;
+    void ReadTriangles(std::vector<Triangle>& triangles) const;
+
+    // Each edge once, as pairs of model space points for wireframes. Read back from the GPU the first time it's asked for.
+    const std::vector<glm::vec3>& GetEdges() const;
 private:
 	float radius;
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+
+    GLenum indexType;
+    GLsizei vertexStride;           // 0 when each attribute has a buffer of its own
+    size_t indexCount;              // Every level's indices
+    std::vector<Submesh> submeshes;
+    std::vector<MeshLod> lods;
+    mutable OccluderProxy occluder;
+    mutable std::vector<glm::vec3> edges;
 
 	void GenerateNormals(Triangle* triangles, glm::vec3* vertices, glm::vec3* normals);
-	void CalculateRadius(glm::vec3 *vertices);
+	void CalculateBounds(glm::vec3 *vertices);
+
+    // Reads through the copy binding, so the vertex array that's bound mid-frame keeps its own index buffer
+    static void ReadBuffer(GLuint buffer, size_t size, void* data);
+    void ReadIndices(size_t count, std::vector<uint32_t>& indices) const;
     
 	void InitializeBuffers(Triangle *triangles, glm::vec3 *vertices, glm::vec2 *uvs, glm::vec3 *normals);
 
@@ -42,4 +80,7 @@ private:
     void InitializeGeometryVao();
     void InitializeVerticesVao();
     void InitializeUvsVao();
+
+    void InitializeInterleavedBuffers(const MeshView& view);
+    void InitializeInterleavedVaos();
 };
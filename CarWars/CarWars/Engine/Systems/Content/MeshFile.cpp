@@ -0,0 +1,120 @@
+#include "MeshFile.h"
+
+#include <fstream>
+#include <limits>
+
+using namespace std;
+
+MeshView MeshData::GetView() const {
+    MeshView view;
+    view.vertices = vertices.data();
+    view.vertexCount = vertices.size();
+    view.indices = indices.data();
+    view.indexCount = indices.size();
+    view.indexSize = sizeof(uint32_t);
+    view.submeshes = submeshes.data();
+    view.submeshCount = submeshes.size();
+    view.lods = lods.data();
+    view.lodCount = lods.size();
+    view.boundsMin = boundsMin;
+    view.boundsMax = boundsMax;
+    return view;
+}
+
+bool MeshFile::Read(const char* data, size_t size, MeshView& view) {
+    if (!data || size < sizeof(MeshFileHeader)) return false;
+
+    const MeshFileHeader* header = reinterpret_cast<const MeshFileHeader*>(data);
+    if (header->magic != MESH_FILE_MAGIC || header->version != MESH_FILE_VERSION) return false;
+    if (header->indexSize != sizeof(uint16_t) && header->indexSize != sizeof(uint32_t)) return false;
+    if (header->lodCount == 0 || header->lodCount > MESH_MAX_LOD_COUNT) return false;
+
+    // In 64 bits, so that counts near the 32 bit limits can't wrap a 32 bit size_t back inside the file
+    const uint64_t submeshesOffset = sizeof(MeshFileHeader);
+    const uint64_t lodsOffset = submeshesOffset + sizeof(Submesh) * static_cast<uint64_t>(header->submeshCount);
+    const uint64_t verticesOffset = lodsOffset + sizeof(MeshLod) * static_cast<uint64_t>(header->lodCount);
+    const uint64_t indicesOffset = verticesOffset + sizeof(MeshVertex) * static_cast<uint64_t>(header->vertexCount);
+    const uint64_t endOffset = indicesOffset + static_cast<uint64_t>(header->indexSize) * header->indexCount;
+    if (endOffset > size) return false;
+
+    const Submesh* submeshes = reinterpret_cast<const Submesh*>(data + submeshesOffset);
+    for (size_t i = 0; i < header->submeshCount; ++i) {
+        if (static_cast<uint64_t>(submeshes[i].indexOffset) + submeshes[i].indexCount > header->indexCount) return false;
+    }
+
+    const MeshLod* lods = reinterpret_cast<const MeshLod*>(data + lodsOffset);
+    for (size_t i = 0; i < header->lodCount; ++i) {
+        if (static_cast<uint64_t>(lods[i].indexOffset) + lods[i].indexCount > header->indexCount) return false;
+    }
+
+    // Every index has to name a vertex, or drawing and reading the mesh back would go past the vertex buffer
+    if (header->indexSize == sizeof(uint16_t)) {
+        const uint16_t* indices = reinterpret_cast<const uint16_t*>(data + indicesOffset);
+        for (size_t i = 0; i < header->indexCount; ++i) {
+            if (indices[i] >= header->vertexCount) return false;
+        }
+    } else {
+        const uint32_t* indices = reinterpret_cast<const uint32_t*>(data + indicesOffset);
+        for (size_t i = 0; i < header->indexCount; ++i) {
+            if (indices[i] >= header->vertexCount) return false;
+        }
+    }
+
+    view.submeshes = submeshes;
+    view.submeshCount = header->submeshCount;
+    view.lods = lods;
+    view.lodCount = header->lodCount;
+    view.vertices = reinterpret_cast<const MeshVertex*>(data + verticesOffset);
+    view.vertexCount = header->vertexCount;
+    view.indices = data + indicesOffset;
+    view.indexCount = header->indexCount;
+    view.indexSize = header->indexSize;
+    view.boundsMin = header->boundsMin;
+    view.boundsMax = header->boundsMax;
+    return true;
+}
+
+bool MeshFile::Write(const string& filePath, const MeshData& mesh) {
+    ofstream file(filePath, ios::binary | ios::trunc);
+    if (!file) return false;
+    return Write(file, mesh);
+}
+
+bool MeshFile::Write(ostream& stream, const MeshData& mesh) {
+    // Meshes without generated levels are written with the whole index buffer as level 0
+    vector<MeshLod> lods = mesh.lods;
+    if (lods.empty()) {
+        MeshLod lod;
+        lod.indexOffset = 0;
+        lod.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        lod.error = 0.f;
+        lods.push_back(lod);
+    }
+
+    MeshFileHeader header;
+    header.magic = MESH_FILE_MAGIC;
+    header.version = MESH_FILE_VERSION;
+    header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    header.submeshCount = static_cast<uint32_t>(mesh.submeshes.size());
+    header.boundsMin = mesh.boundsMin;
+    header.boundsMax = mesh.boundsMax;
+    header.lodCount = static_cast<uint32_t>(lods.size());
+
+    // Most of our meshes are small enough for 16 bit indices, which halves the index buffer
+    const bool shortIndices = mesh.vertices.size() <= numeric_limits<uint16_t>::max() + size_t(1);
+    header.indexSize = shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(mesh.submeshes.data()), sizeof(Submesh) * mesh.submeshes.size());
+    stream.write(reinterpret_cast<const char*>(lods.data()), sizeof(MeshLod) * lods.size());
+    stream.write(reinterpret_cast<const char*>(mesh.vertices.data()), sizeof(MeshVertex) * mesh.vertices.size());
+    if (shortIndices) {
+        vector<uint16_t> indices(mesh.indices.begin(), mesh.indices.end());
+        stream.write(reinterpret_cast<const char*>(indices.data()), sizeof(uint16_t) * indices.size());
+    } else {
+        stream.write(reinterpret_cast<const char*>(mesh.indices.data()), sizeof(uint32_t) * mesh.indices.size());
+    }
+
+    return static_cast<bool>(stream);
+}
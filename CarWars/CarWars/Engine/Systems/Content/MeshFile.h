@@ -0,0 +1,105 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Binary mesh format written by the mesh converter (CarWars.exe --convert-meshes) and loaded by ContentManager::GetMesh.
+// A file is laid out as:
+//   MeshFileHeader
+//   Submesh[submeshCount]
+//   MeshLod[lodCount]
+//   MeshVertex[vertexCount]
+//   uint16_t or uint32_t[indexCount]   (indexSize bytes each, every level of detail one after another)
+// so that it can be memory-mapped and handed to OpenGL without any parsing.
+
+#define MESH_FILE_MAGIC 0x4853454D     // "MESH"
+#define MESH_FILE_VERSION 2
+#define MESH_FILE_EXTENSION ".mesh"
+#define MESH_MAX_LOD_COUNT 4
+
+struct MeshVertex {
+    glm::vec3 position;
+    glm::vec2 uv;
+    glm::vec3 normal;
+    glm::vec4 tangent;      // w is the handedness of the bitangent
+};
+
+struct Submesh {
+    static constexpr size_t MATERIAL_NAME_LENGTH = 32;
+
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    char material[MATERIAL_NAME_LENGTH];
+};
+
+// A range of the index buffer that draws the whole mesh over the same vertices, with fewer triangles the higher the
+// level. Submeshes only index into level 0.
+struct MeshLod {
+    uint32_t indexOffset;
+    uint32_t indexCount;
+    float error;            // Furthest the surface moved from level 0, as a fraction of the bounding radius
+};
+
+struct MeshFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t indexSize;
+    uint32_t submeshCount;
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+    uint32_t lodCount;
+};
+
+static_assert(sizeof(MeshVertex) == 48, "MeshVertex must match the file layout");
+static_assert(sizeof(Submesh) == 40, "Submesh must match the file layout");
+static_assert(sizeof(MeshLod) == 12, "MeshLod must match the file layout");
+static_assert(sizeof(MeshFileHeader) == 52, "MeshFileHeader must match the file layout");
+
+// Mesh data that doesn't own its arrays, e.g. pointing into a mapped file
+struct MeshView {
+    MeshView() : vertices(nullptr), vertexCount(0), indices(nullptr), indexCount(0), indexSize(0),
+        submeshes(nullptr), submeshCount(0), lods(nullptr), lodCount(0), boundsMin(0.f), boundsMax(0.f) {}
+
+    const MeshVertex* vertices;
+    size_t vertexCount;
+    const void* indices;
+    size_t indexCount;
+    size_t indexSize;
+    const Submesh* submeshes;
+    size_t submeshCount;
+    const MeshLod* lods;            // None means all the indices are level 0
+    size_t lodCount;
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+};
+
+// Mesh data that owns its arrays, e.g. fresh from the importer
+struct MeshData {
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<Submesh> submeshes;
+    std::vector<MeshLod> lods;      // Filled in by MeshSimplifier::GenerateLods, otherwise all indices are level 0
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+
+    // Indices stay 32 bit here; Write narrows them to 16 bit when they fit
+    MeshView GetView() const;
+};
+
+class MeshFile {
+public:
+    // Points view into data after checking that it holds a whole mesh file of the current version, with every range
+    // and index inside the buffers it refers to
+    static bool Read(const char* data, size_t size, MeshView& view);
+    static bool Write(const std::string& filePath, const MeshData& mesh);
+    static bool Write(std::ostream& stream, const MeshData& mesh);
+
+private:
+    // No instantiation
+    MeshFile() = delete;
+};
@@ -0,0 +1,129 @@
+#include "MeshImporter.h"
+#include "BakedContent.h"
+#include "MappedFile.h"
+#include "MeshSimplifier.h"
+
+#include <iostream>
+#include <cmath>
+#include <cstring>
+
+#include "assimp/Importer.hpp"
+#include "assimp/scene.h"
+#include "assimp/postprocess.h"
+
+using namespace std;
+
+namespace {
+    // Source formats that get converted; the .blend files next to them are only for editing
+    const string SOURCE_EXTENSION = ".obj";
+
+    glm::vec3 ToGlm(const aiVector3D& v) {
+        return glm::vec3(v.x, v.y, v.z);
+    }
+}
+
+bool MeshImporter::Import(const string& filePath, MeshData& mesh, unsigned pFlags) {
+    Assimp::Importer importer;
+
+    const aiScene *scene = importer.ReadFile(filePath,
+        pFlags
+        | aiProcess_CalcTangentSpace
+        | aiProcess_Triangulate
+        | aiProcess_GenSmoothNormals
+        | aiProcess_JoinIdenticalVertices
+        | aiProcess_ImproveCacheLocality
+    );
+
+    if (scene == nullptr || scene->mNumMeshes == 0) {
+        cerr << "WARNING: Failed to import mesh: " << filePath << endl;
+        return false;
+    }
+
+    mesh.vertices.clear();
+    mesh.indices.clear();
+    mesh.submeshes.clear();
+    mesh.boundsMin = glm::vec3(INFINITY);
+    mesh.boundsMax = glm::vec3(-INFINITY);
+
+    for (unsigned int m = 0; m < scene->mNumMeshes; ++m) {
+        const aiMesh *aiMesh = scene->mMeshes[m];
+        const uint32_t baseVertex = static_cast<uint32_t>(mesh.vertices.size());
+
+        Submesh submesh;
+        memset(&submesh, 0, sizeof(submesh));
+        submesh.indexOffset = static_cast<uint32_t>(mesh.indices.size());
+        if (aiMesh->mMaterialIndex < scene->mNumMaterials) {
+            aiString name;
+            if (scene->mMaterials[aiMesh->mMaterialIndex]->Get(AI_MATKEY_NAME, name) == AI_SUCCESS) {
+                strncpy(submesh.material, name.C_Str(), Submesh::MATERIAL_NAME_LENGTH - 1);
+            }
+        }
+
+        for (unsigned int i = 0; i < aiMesh->mNumVertices; ++i) {
+            MeshVertex vertex;
+            vertex.position = ToGlm(aiMesh->mVertices[i]);
+            vertex.uv = aiMesh->HasTextureCoords(0) ? glm::vec2(aiMesh->mTextureCoords[0][i].x, aiMesh->mTextureCoords[0][i].y) : glm::vec2(0.f);
+            vertex.normal = aiMesh->HasNormals() ? ToGlm(aiMesh->mNormals[i]) : glm::vec3(0.f, 1.f, 0.f);
+            if (aiMesh->HasTangentsAndBitangents()) {
+                const glm::vec3 tangent = ToGlm(aiMesh->mTangents[i]);
+                const glm::vec3 bitangent = ToGlm(aiMesh->mBitangents[i]);
+                const float handedness = glm::dot(glm::cross(vertex.normal, tangent), bitangent) < 0.f ? -1.f : 1.f;
+                vertex.tangent = glm::vec4(tangent, handedness);
+            } else {
+                vertex.tangent = glm::vec4(1.f, 0.f, 0.f, 1.f);
+            }
+
+            mesh.boundsMin = glm::min(mesh.boundsMin, vertex.position);
+            mesh.boundsMax = glm::max(mesh.boundsMax, vertex.position);
+            mesh.vertices.push_back(vertex);
+        }
+
+        for (unsigned int i = 0; i < aiMesh->mNumFaces; ++i) {
+            const aiFace &face = aiMesh->mFaces[i];
+            if (face.mNumIndices != 3) continue;        // Stray points and lines
+            mesh.indices.push_back(baseVertex + face.mIndices[0]);
+            mesh.indices.push_back(baseVertex + face.mIndices[1]);
+            mesh.indices.push_back(baseVertex + face.mIndices[2]);
+        }
+
+        submesh.indexCount = static_cast<uint32_t>(mesh.indices.size()) - submesh.indexOffset;
+        mesh.submeshes.push_back(submesh);
+    }
+
+    if (mesh.vertices.empty()) {
+        mesh.boundsMin = mesh.boundsMax = glm::vec3(0.f);
+    }
+
+    MeshSimplifier::GenerateLods(mesh);
+    return true;
+}
+
+bool MeshImporter::ConvertDirectory(const string& dirPath) {
+    return BakedContent::BakeDirectory(dirPath, { SOURCE_EXTENSION }, MESH_FILE_EXTENSION, [](const string& sourcePath, const string& binaryPath) {
+        MeshData mesh;
+        if (!Import(sourcePath, mesh)) return false;
+
+        // A broken level would only show up as holes or stray triangles in the distance, so it fails the conversion
+        string problem;
+        if (!MeshSimplifier::CheckLods(mesh.GetView(), problem)) {
+            cerr << "ERROR: Bad levels of detail in " << sourcePath << ": " << problem << endl;
+            return false;
+        }
+        if (!MeshFile::Write(binaryPath, mesh)) return false;
+
+        cout << "Converted " << sourcePath << " (" << mesh.vertices.size() << " vertices, "
+            << mesh.lods[0].indexCount / 3 << " triangles, " << mesh.submeshes.size() << " submeshes, LODs ";
+        for (size_t i = 0; i < mesh.lods.size(); ++i) {
+            cout << (i > 0 ? "/" : "") << mesh.lods[i].indexCount / 3;
+        }
+        cout << ")" << endl;
+        return true;
+    }, [](const string& binaryPath) {
+        // Meshes converted before the current format version, or whose levels fail the check, are converted again
+        MappedFile file;
+        MeshView view;
+        string problem;
+        return file.Open(binaryPath) && MeshFile::Read(file.GetData(), file.GetSize(), view) &&
+            MeshSimplifier::CheckLods(view, problem);
+    });
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "MeshFile.h"
+#include <string>
+
+// Reads source meshes (.obj etc.) through Assimp. At runtime this is only the fallback for meshes that haven't been
+// converted to the binary format yet.
+class MeshImporter {
+public:
+    // Triangulates, generates smooth normals and tangents and merges every mesh in the file into submeshes
+    static bool Import(const std::string& filePath, MeshData& mesh, unsigned pFlags=0);
+
+    // Writes a binary mesh next to every source mesh under dirPath that doesn't have an up to date one.
+    // Returns false if any mesh failed to convert.
+    static bool ConvertDirectory(const std::string& dirPath);
+
+private:
+    // No instantiation
+    MeshImporter() = delete;
+};
@@ -0,0 +1,405 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+    // Sum of weighted squared distances to a set of planes, kept as the upper half of a symmetric 4x4 matrix
+    struct Quadric {
+        Quadric() : a00(0.0), a01(0.0), a02(0.0), a11(0.0), a12(0.0), a22(0.0), b0(0.0), b1(0.0), b2(0.0), c(0.0),
+            weight(0.0) {}
+
+        // The plane is every point p with dot(normal, p) + distance = 0
+        void AddPlane(const glm::dvec3& normal, double distance, double planeWeight) {
+            a00 += planeWeight * normal.x * normal.x;
+            a01 += planeWeight * normal.x * normal.y;
+            a02 += planeWeight * normal.x * normal.z;
+            a11 += planeWeight * normal.y * normal.y;
+            a12 += planeWeight * normal.y * normal.z;
+            a22 += planeWeight * normal.z * normal.z;
+            b0 += planeWeight * normal.x * distance;
+            b1 += planeWeight * normal.y * distance;
+            b2 += planeWeight * normal.z * distance;
+            c += planeWeight * distance * distance;
+            weight += planeWeight;
+        }
+
+        void Add(const Quadric& other) {
+            a00 += other.a00;
+            a01 += other.a01;
+            a02 += other.a02;
+            a11 += other.a11;
+            a12 += other.a12;
+            a22 += other.a22;
+            b0 += other.b0;
+            b1 += other.b1;
+            b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+        }
+
+        double Evaluate(const glm::vec3& point) const {
+            const double x = point.x;
+            const double y = point.y;
+            const double z = point.z;
+            return a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + a11 * y * y + 2.0 * a12 * y * z + a22 * z * z +
+                2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        }
+
+        double a00, a01, a02, a11, a12, a22;
+        double b0, b1, b2;
+        double c;
+        double weight;
+    };
+
+    const uint32_t NO_VERTEX = 0xFFFFFFFF;
+
+    enum VertexKind {
+        VertexKind_Interior = 0,
+        VertexKind_Seam,            // Other vertices share its position, with different UVs or normals
+        VertexKind_Border           // On an open edge
+    };
+
+    struct Collapse {
+        uint32_t from;
+        uint32_t to;
+        double error;
+    };
+
+    struct PositionHash {
+        size_t operator()(const glm::vec3& position) const {
+            const hash<float> hasher;
+            return hasher(position.x) ^ (hasher(position.y) << 1) ^ (hasher(position.z) << 2);
+        }
+    };
+
+    uint64_t GetEdgeKey(uint32_t a, uint32_t b) {
+        return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+    }
+
+    // Average distance the surface under both quadrics moves when their vertices meet at the point
+    double GetError(const Quadric& a, const Quadric& b, const glm::vec3& point) {
+        const double weight = a.weight + b.weight;
+        if (weight <= 0.0) return 0.0;
+        return sqrt(max(a.Evaluate(point) + b.Evaluate(point), 0.0) / weight);
+    }
+
+    // Border vertices only slide along their border and seam vertices only along their seam, so neither changes shape
+    bool CanCollapse(VertexKind from, VertexKind to, bool borderEdge) {
+        switch (from) {
+        case VertexKind_Interior:
+            return true;
+        case VertexKind_Seam:
+            return to != VertexKind_Interior;
+        default:
+            return borderEdge;
+        }
+    }
+
+    // The vertex at welded's position with the most similar normal and UV to the vertex
+    uint32_t FindClosestVertex(const MeshVertex* vertices, const vector<uint32_t>& nextAtPosition, uint32_t welded,
+        uint32_t vertex) {
+
+        uint32_t closest = welded;
+        float closestScore = -numeric_limits<float>::infinity();
+        for (uint32_t candidate = welded; candidate != NO_VERTEX; candidate = nextAtPosition[candidate]) {
+            if (candidate == vertex) return vertex;
+
+            const float score = glm::dot(vertices[candidate].normal, vertices[vertex].normal) -
+                glm::length(vertices[candidate].uv - vertices[vertex].uv);
+            if (score > closestScore) {
+                closest = candidate;
+                closestScore = score;
+            }
+        }
+        return closest;
+    }
+
+    // True if moving from onto to would turn any of from's other triangles over
+    bool FlipsTriangle(const MeshVertex* vertices, const vector<uint32_t>& indices, const vector<uint32_t>& triangleList,
+        const vector<uint32_t>& triangleOffsets, uint32_t from, uint32_t to) {
+
+        for (uint32_t t = triangleOffsets[from]; t < triangleOffsets[from + 1]; ++t) {
+            const uint32_t* triangle = &indices[triangleList[t] * 3];
+            if (triangle[0] == to || triangle[1] == to || triangle[2] == to) continue;     // Collapses away
+
+            glm::vec3 before[3];
+            glm::vec3 after[3];
+            for (size_t i = 0; i < 3; ++i) {
+                before[i] = vertices[triangle[i]].position;
+                after[i] = triangle[i] == from ? vertices[to].position : before[i];
+            }
+
+            const glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+            const glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+            if (glm::dot(normalBefore, normalAfter) <= 0.f) return true;
+        }
+        return false;
+    }
+}
+
+float MeshSimplifier::Simplify(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+    size_t targetIndexCount, float maxError, float radius, vector<uint32_t>& result) {
+
+    result.assign(indices, indices + indexCount);
+    if (radius <= 0.f || indexCount <= targetIndexCount) return 0.f;
+
+    // The shape is simplified with every vertex at a position welded to the first one there, so UV and normal seams
+    // don't stop it. The rest at each position are linked through nextAtPosition.
+    vector<uint32_t> welded(vertexCount);
+    vector<uint32_t> nextAtPosition(vertexCount, NO_VERTEX);
+    vector<VertexKind> kinds(vertexCount, VertexKind_Interior);
+    unordered_map<glm::vec3, uint32_t, PositionHash> firstAtPosition;
+    for (size_t i = 0; i < vertexCount; ++i) welded[i] = static_cast<uint32_t>(i);
+    for (size_t i = 0; i < indexCount; ++i) {
+        const uint32_t vertex = indices[i];
+        const auto inserted = firstAtPosition.insert(make_pair(vertices[vertex].position, vertex));
+        const uint32_t first = inserted.first->second;
+        if (inserted.second || first == vertex || welded[vertex] == first) continue;
+
+        welded[vertex] = first;
+        nextAtPosition[vertex] = nextAtPosition[first];
+        nextAtPosition[first] = vertex;
+        kinds[first] = VertexKind_Seam;
+    }
+    for (uint32_t& index : result) index = welded[index];
+
+    // Edges with only one triangle are open
+    unordered_map<uint64_t, uint32_t> edgeTriangleCounts;
+    for (size_t i = 0; i < indexCount; i += 3) {
+        for (size_t j = 0; j < 3; ++j) {
+            edgeTriangleCounts[GetEdgeKey(result[i + j], result[i + (j + 1) % 3])]++;
+        }
+    }
+
+    // Every vertex starts out with the planes of its triangles, weighted by area, and planes standing up along any
+    // open edges so that they keep their outline
+    vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i < indexCount; i += 3) {
+        const glm::dvec3 p0 = glm::dvec3(vertices[result[i]].position);
+        const glm::dvec3 p1 = glm::dvec3(vertices[result[i + 1]].position);
+        const glm::dvec3 p2 = glm::dvec3(vertices[result[i + 2]].position);
+        const glm::dvec3 cross = glm::cross(p1 - p0, p2 - p0);
+        const double doubleArea = glm::length(cross);
+        if (doubleArea <= 0.0) continue;
+
+        const glm::dvec3 normal = cross / doubleArea;
+        const double distance = -glm::dot(normal, p0);
+        for (size_t j = 0; j < 3; ++j) {
+            quadrics[result[i + j]].AddPlane(normal, distance, doubleArea * 0.5);
+        }
+
+        for (size_t j = 0; j < 3; ++j) {
+            const uint32_t a = result[i + j];
+            const uint32_t b = result[i + (j + 1) % 3];
+            if (edgeTriangleCounts[GetEdgeKey(a, b)] != 1) continue;
+
+            kinds[a] = VertexKind_Border;
+            kinds[b] = VertexKind_Border;
+
+            const glm::dvec3 pa = glm::dvec3(vertices[a].position);
+            const glm::dvec3 edge = glm::dvec3(vertices[b].position) - pa;
+            const double edgeLength = glm::length(edge);
+            if (edgeLength <= 0.0) continue;
+
+            const glm::dvec3 borderNormal = glm::normalize(glm::cross(edge, normal));
+            const double borderDistance = -glm::dot(borderNormal, pa);
+            const double borderWeight = edgeLength * edgeLength * MESH_LOD_BORDER_WEIGHT;
+            quadrics[a].AddPlane(borderNormal, borderDistance, borderWeight);
+            quadrics[b].AddPlane(borderNormal, borderDistance, borderWeight);
+        }
+    }
+
+    // Collapse the welded shape, remembering which vertex each one ended up at
+    const double maxDistance = static_cast<double>(maxError) * radius;
+    double reached = 0.0;
+
+    vector<uint32_t> collapsedTo(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i) collapsedTo[i] = static_cast<uint32_t>(i);
+
+    vector<uint32_t> remap(vertexCount);
+    vector<char> touched(vertexCount);
+    vector<uint32_t> triangleOffsets(vertexCount + 1);
+    vector<uint32_t> triangleList;
+    vector<Collapse> collapses;
+    while (result.size() > targetIndexCount) {
+        // Count the triangles on each edge of what's left
+        edgeTriangleCounts.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (size_t j = 0; j < 3; ++j) {
+                edgeTriangleCounts[GetEdgeKey(result[i + j], result[i + (j + 1) % 3])]++;
+            }
+        }
+
+        // The cheapest way to collapse every edge that can be
+        collapses.clear();
+        for (const auto& edge : edgeTriangleCounts) {
+            const uint32_t a = static_cast<uint32_t>(edge.first >> 32);
+            const uint32_t b = static_cast<uint32_t>(edge.first & 0xFFFFFFFF);
+            const bool borderEdge = edge.second == 1;
+
+            Collapse best;
+            best.error = numeric_limits<double>::infinity();
+            for (size_t direction = 0; direction < 2; ++direction) {
+                const uint32_t from = direction == 0 ? a : b;
+                const uint32_t to = direction == 0 ? b : a;
+                if (!CanCollapse(kinds[from], kinds[to], borderEdge)) continue;
+
+                const double error = GetError(quadrics[from], quadrics[to], vertices[to].position);
+                if (error < best.error) {
+                    best.from = from;
+                    best.to = to;
+                    best.error = error;
+                }
+            }
+            if (best.error <= maxDistance) collapses.push_back(best);
+        }
+        if (collapses.empty()) break;
+
+        sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) {
+            return lhs.error < rhs.error;
+        });
+
+        // The triangles around every vertex, to check collapses against
+        fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+        for (uint32_t vertex : result) triangleOffsets[vertex + 1]++;
+        for (size_t i = 0; i < vertexCount; ++i) triangleOffsets[i + 1] += triangleOffsets[i];
+        triangleList.resize(result.size());
+        vector<uint32_t> cursors(triangleOffsets.begin(), triangleOffsets.end() - 1);
+        for (size_t i = 0; i < result.size(); ++i) {
+            triangleList[cursors[result[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        // Each collapse removes about two triangles. The vertices around one are left alone for the rest of the pass,
+        // since its collapse changes their triangles.
+        const size_t wantedCount = (result.size() - targetIndexCount) / 6 + 1;
+        size_t collapsedCount = 0;
+        for (size_t i = 0; i < vertexCount; ++i) remap[i] = static_cast<uint32_t>(i);
+        fill(touched.begin(), touched.end(), 0);
+        for (const Collapse& collapse : collapses) {
+            if (collapsedCount >= wantedCount) break;
+            if (touched[collapse.from] || touched[collapse.to]) continue;
+            if (FlipsTriangle(vertices, result, triangleList, triangleOffsets, collapse.from, collapse.to)) continue;
+
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to].Add(quadrics[collapse.from]);
+            reached = max(reached, collapse.error);
+            collapsedCount++;
+
+            for (uint32_t t = triangleOffsets[collapse.from]; t < triangleOffsets[collapse.from + 1]; ++t) {
+                const uint32_t triangle = triangleList[t];
+                for (size_t j = 0; j < 3; ++j) touched[result[triangle * 3 + j]] = 1;
+            }
+        }
+        if (collapsedCount == 0) break;
+
+        // Drop the triangles that collapsed into lines
+        size_t writeCount = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            const uint32_t a = remap[result[i]];
+            const uint32_t b = remap[result[i + 1]];
+            const uint32_t c = remap[result[i + 2]];
+            if (a == b || b == c || c == a) continue;
+
+            result[writeCount++] = a;
+            result[writeCount++] = b;
+            result[writeCount++] = c;
+        }
+        result.resize(writeCount);
+
+        for (size_t i = 0; i < vertexCount; ++i) collapsedTo[i] = remap[collapsedTo[i]];
+    }
+
+    // Put the seams back: each corner takes the vertex at its collapsed position with the closest attributes to the
+    // one it had, e.g. the copy of a UV seam on its own side, or the facet normal nearest its own
+    const uint32_t* original = indices;
+    vector<uint32_t> remaining;
+    remaining.reserve(result.size());
+    for (size_t i = 0; i < indexCount; i += 3) {
+        uint32_t corners[3];
+        for (size_t j = 0; j < 3; ++j) corners[j] = collapsedTo[welded[original[i + j]]];
+        if (corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0]) continue;
+
+        for (size_t j = 0; j < 3; ++j) {
+            remaining.push_back(FindClosestVertex(vertices, nextAtPosition, corners[j], original[i + j]));
+        }
+    }
+    result.swap(remaining);
+
+    return static_cast<float>(reached / radius);
+}
+
+void MeshSimplifier::GenerateLods(MeshData& mesh) {
+    mesh.lods.clear();
+
+    MeshLod full;
+    full.indexOffset = 0;
+    full.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    full.error = 0.f;
+    mesh.lods.push_back(full);
+
+    const float radius = GetBoundingRadius(mesh.boundsMin, mesh.boundsMax);
+    vector<uint32_t> level;
+    while (mesh.lods.size() < MESH_MAX_LOD_COUNT) {
+        const MeshLod previous = mesh.lods.back();
+        const size_t targetIndexCount = previous.indexCount / 6 * 3;
+        if (targetIndexCount < MESH_LOD_MIN_INDEX_COUNT) break;
+
+        // Errors add up level after level, so each gets what the ones before it left
+        const float maxError = MESH_LOD_MAX_ERROR - previous.error;
+        if (maxError <= 0.f) break;
+
+        const float error = Simplify(mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data() + previous.indexOffset,
+            previous.indexCount, targetIndexCount, maxError, radius, level);
+
+        // Not worth a level of its own, e.g. what's left is mostly seams that can't move
+        if (level.size() > previous.indexCount * 3 / 4) break;
+
+        MeshLod lod;
+        lod.indexOffset = static_cast<uint32_t>(mesh.indices.size());
+        lod.indexCount = static_cast<uint32_t>(level.size());
+        lod.error = min(previous.error + error, MESH_LOD_MAX_ERROR);
+        mesh.indices.insert(mesh.indices.end(), level.begin(), level.end());
+        mesh.lods.push_back(lod);
+    }
+}
+
+bool MeshSimplifier::CheckLods(const MeshView& mesh, string& problem) {
+    for (size_t i = 0; i < mesh.lodCount; ++i) {
+        const MeshLod& lod = mesh.lods[i];
+        const string name = "LOD " + to_string(i);
+        if (static_cast<uint64_t>(lod.indexOffset) + lod.indexCount > mesh.indexCount) {
+            problem = name + " is outside the index buffer";
+            return false;
+        }
+        if (i > 0 && lod.indexCount >= mesh.lods[i - 1].indexCount) {
+            problem = name + " has " + to_string(lod.indexCount / 3) + " triangles, no fewer than the level before";
+            return false;
+        }
+        if (!(lod.error >= 0.f && lod.error <= MESH_LOD_MAX_ERROR)) {
+            problem = name + " moves the surface by " + to_string(lod.error) + " of the radius, over " +
+                to_string(MESH_LOD_MAX_ERROR);
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < mesh.indexCount; ++i) {
+        const uint32_t index = mesh.indexSize == sizeof(uint16_t) ?
+            static_cast<const uint16_t*>(mesh.indices)[i] : static_cast<const uint32_t*>(mesh.indices)[i];
+        if (index >= mesh.vertexCount) {
+            problem = "index " + to_string(i) + " is " + to_string(index) + ", past the " + to_string(mesh.vertexCount) +
+                " vertices";
+            return false;
+        }
+    }
+    return true;
+}
+
+float MeshSimplifier::GetBoundingRadius(const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    return 0.5f * glm::length(boundsMax - boundsMin);
+}
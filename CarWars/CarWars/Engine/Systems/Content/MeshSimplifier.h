@@ -0,0 +1,39 @@
+#pragma once
+
+#include "MeshFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define MESH_LOD_MIN_INDEX_COUNT 96         // Levels stop once they would have fewer than 32 triangles
+#define MESH_LOD_MAX_ERROR 0.25f            // Furthest a level may move the surface, as a fraction of the bounding radius
+#define MESH_LOD_BORDER_WEIGHT 10.0         // How strongly open edges hold their shape compared to the surface
+
+// Builds the levels of detail for the mesh converter and the importer, with no GL so it can run on its own.
+// Edges are collapsed cheapest first by quadric error (Garland & Heckbert), always onto one of their own vertices so
+// every level indexes the same vertex buffer. Vertices are welded by position first, so vertices on a UV or normal seam
+// only slide along the seam and each corner is then pointed back at the copy whose attributes match it. Open edges only
+// collapse along themselves, so levels don't crack apart along seams or shrink away from their borders.
+class MeshSimplifier {
+public:
+    // Reduces a triangle list to about targetIndexCount indices, or as close as it gets without moving the surface
+    // more than maxError. Returns the error reached, as a fraction of radius.
+    static float Simplify(const MeshVertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+        size_t targetIndexCount, float maxError, float radius, std::vector<uint32_t>& result);
+
+    // Appends up to MESH_MAX_LOD_COUNT - 1 levels to the mesh's indices, each about half the triangles of the one
+    // before and none moving the surface more than MESH_LOD_MAX_ERROR in all, and describes them all (level 0
+    // included) in mesh.lods
+    static void GenerateLods(MeshData& mesh);
+
+    // Checks that every level has fewer triangles than the one before, stays within MESH_LOD_MAX_ERROR and only
+    // indexes vertices the mesh has. Returns false with what's wrong in problem otherwise.
+    static bool CheckLods(const MeshView& mesh, std::string& problem);
+
+    // Radius the LOD errors are relative to, i.e. half the bounds' diagonal
+    static float GetBoundingRadius(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+private:
+    // No instantiation
+    MeshSimplifier() = delete;
+};
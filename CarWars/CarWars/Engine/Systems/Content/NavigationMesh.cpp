@@ -6,6 +6,9 @@
 #include "../../Components/RigidbodyComponents/RigidbodyComponent.h"
 #include "../Game.h"
 #include "Picture.h"
+#include "MapPackage.h"
+#include "HeightMap.h"
+#include "../Jobs/JobSystem.h"
 #include <glm/gtx/string_cast.hpp>
 
 NavigationMesh::NavigationMesh(nlohmann::json data) : heightMap(nullptr), defaults(nullptr) {
@@ -17,16 +20,34 @@ NavigationMesh::NavigationMesh(nlohmann::json data) : heightMap(nullptr), defaul
 }
 
 NavigationMesh::NavigationMesh(std::string dirPath) {
-    // Load spacing and columns/rows from height map
     heightMap = ContentManager::GetHeightMap(dirPath);
-    spacing = 5.f;
-    columnCount = heightMap->GetLength() / spacing;
-    rowCount = heightMap->GetWidth() / spacing;
 
-    // Load defaults from image
+    MapPackage* package = ContentManager::GetMapPackage(dirPath);
+    if (package) {
+        const MapPackageHeader& header = package->GetHeader();
+        spacing = header.navigationSpacing;
+        rowCount = header.navigationRowCount;
+        columnCount = header.navigationColumnCount;
+        defaults = new float[GetVertexCount()];
+        std::copy(package->GetNavigationDefaults(), package->GetNavigationDefaults() + GetVertexCount(), defaults);
+    } else {
+        // Load spacing and columns/rows from height map, and defaults from image
+        spacing = NAVIGATION_MAP_SPACING;
+        GetGridSize(*heightMap, rowCount, columnCount);
+        defaults = new float[GetVertexCount()];
+        SampleDefaults(dirPath, rowCount, columnCount, defaults);
+    }
+
+    Initialize();
+}
+
+void NavigationMesh::GetGridSize(const HeightMap& heightMap, size_t& rowCount, size_t& columnCount) {
+    columnCount = heightMap.GetLength() / NAVIGATION_MAP_SPACING;
+    rowCount = heightMap.GetWidth() / NAVIGATION_MAP_SPACING;
+}
+
+void NavigationMesh::SampleDefaults(const std::string& dirPath, size_t rowCount, size_t columnCount, float* defaults) {
     Picture* image = new Picture(ContentManager::MAP_DIR_PATH + dirPath + "Nav.png");
-    
-    defaults = new float[GetVertexCount()];
 
     size_t index = 0;
     for (unsigned int row = 0; row < rowCount; ++row) {
@@ -37,10 +58,6 @@ NavigationMesh::NavigationMesh(std::string dirPath) {
     }
 
     delete image;
-
-
-
-    Initialize();
 }
 
 size_t NavigationMesh::GetVertexCount() const {
@@ -51,6 +68,10 @@ float NavigationMesh::GetSpacing() const {
     return spacing;
 }
 
+const NavigationVertex* NavigationMesh::GetVertices() const {
+    return vertices;
+}
+
 void NavigationMesh::Initialize() {
     vertices = new NavigationVertex[GetVertexCount()];
     coveringBodies = new std::unordered_set<RigidbodyComponent*>[GetVertexCount()];
@@ -71,8 +92,6 @@ void NavigationMesh::Initialize() {
             vertices[index].score = GetDefault(index);
 		}
 	}
-
-    InitializeRenderBuffers();
 }
 
 void NavigationMesh::UpdateMesh() {
@@ -81,7 +100,7 @@ void NavigationMesh::UpdateMesh() {
 //    UpdateMesh(EntityManager::GetComponents(ComponentType_Vehicle));
 }
 
-void NavigationMesh::UpdateMesh(vector<Component*> rigidbodies) {
+void NavigationMesh::UpdateMesh(const FrameVector<Component*>& rigidbodies) {
     // Check if covered vertices became uncovered
     for (auto it = coveredVertices.begin(); it != coveredVertices.end(); ) {
         const size_t index = *it;
@@ -108,16 +127,22 @@ void NavigationMesh::UpdateMesh(vector<Component*> rigidbodies) {
     }
 
     // Check if any of the bodies that were updated this frame are covering new vertices
-    for (Component* component : rigidbodies) {
-        RigidbodyComponent *rigidbody = static_cast<RigidbodyComponent*>(component);
-        if (!rigidbody->enabled || !rigidbody->DoesBlockNavigationMesh()) continue;
+    // Finding the covered vertices only reads the mesh, so each body is searched on the job system
+    FrameVector<FrameVector<size_t>> containedByBody(rigidbodies.size());
+    JobSystem::Instance().ParallelForEach(rigidbodies.size(), 16, [&](size_t i) {
+        RigidbodyComponent *rigidbody = static_cast<RigidbodyComponent*>(rigidbodies[i]);
+        if (!rigidbody->enabled || !rigidbody->DoesBlockNavigationMesh()) return;
 
         // Find all the vertices this body covers
         const physx::PxBounds3 bounds = rigidbody->pxRigid->getWorldBounds(1.f);
-        vector<size_t> contained = FindAllContainedBy(bounds);
+        containedByBody[i] = FindAllContainedBy(bounds);
+    });
+
+    for (size_t i = 0; i < rigidbodies.size(); ++i) {
+        RigidbodyComponent *rigidbody = static_cast<RigidbodyComponent*>(rigidbodies[i]);
 
         // Add this body to any vertices that it covers and mark them as covered
-        for (size_t index : contained) {
+        for (size_t index : containedByBody[i]) {
             NavigationVertex &vertex = vertices[index];
             auto &vertexCoveringBodies = coveringBodies[index];
             if (vertexCoveringBodies.empty()) {
@@ -127,8 +152,6 @@ void NavigationMesh::UpdateMesh(vector<Component*> rigidbodies) {
             vertexCoveringBodies.insert(rigidbody);
         }
     }
-
-    UpdateRenderBuffers();
 }
 
 void NavigationMesh::ResetMesh() {
@@ -206,8 +229,9 @@ NavigationVertex NavigationMesh::GetVertex(size_t index) const {
     return vertices[index];
 }
 
-std::vector<size_t> NavigationMesh::GetNeighbours(size_t index) {
-    std::vector<size_t> neighbours;
+FrameVector<size_t> NavigationMesh::GetNeighbours(size_t index) {
+    FrameVector<size_t> neighbours;
+    neighbours.reserve(8);
     
     const int left = GetLeft(index);
     if (left != -1) neighbours.push_back(left);
@@ -237,8 +261,8 @@ std::vector<size_t> NavigationMesh::GetNeighbours(size_t index) {
 }
 
 // TODO: Make less ugly (split into sub-functions)
-std::vector<size_t> NavigationMesh::FindAllContainedBy(physx::PxBounds3 bounds) {
-    std::vector<size_t> contained;
+FrameVector<size_t> NavigationMesh::FindAllContainedBy(physx::PxBounds3 bounds) {
+    FrameVector<size_t> contained;
 
     const physx::PxVec3 offset = physx::PxVec3(spacing) + bounds.getDimensions()*0.5f;
     bounds = physx::PxBounds3(bounds.getCenter() - offset, bounds.getCenter() + offset);
@@ -289,30 +313,6 @@ float NavigationMesh::GetDefault(size_t index) const {
     return defaults[index];
 }
 
-void NavigationMesh::InitializeRenderBuffers() {
-    glGenBuffers(1, &vbo);
-    UpdateRenderBuffers();
-
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 1, GL_FLOAT, GL_FALSE, sizeof(NavigationVertex), reinterpret_cast<void*>(0));        // score
-
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(NavigationVertex), reinterpret_cast<void*>(4));        // position
-    
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-}
-
-void NavigationMesh::UpdateRenderBuffers() const {
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * rowCount * columnCount, vertices, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-}
-
 bool NavigationMesh::IsContainedBy(size_t index, physx::PxBounds3 bounds) {
     const physx::PxVec3 offset = physx::PxVec3(spacing) + bounds.getDimensions()*0.5f;
     bounds = physx::PxBounds3(bounds.getCenter() - offset, bounds.getCenter() + offset);
@@ -4,6 +4,9 @@
 #include "../../Components/RigidbodyComponents/RigidbodyComponent.h"
 #include <unordered_set>
 #include "Picture.h"
+#include "../Memory/FrameAllocator.h"
+
+#define NAVIGATION_MAP_SPACING 5.f
 
 class HeightMap;
 
@@ -17,16 +20,22 @@ struct NavigationVertex {
 class NavigationMesh {
 public:
     explicit NavigationMesh(nlohmann::json data);
+
+    // Takes the default scores from the map's package when it has an up to date one, and samples Nav.png otherwise
 	explicit NavigationMesh(std::string dirPath);
+
+    // Grid size covering a height map, and its default scores sampled from the map's Nav.png
+    static void GetGridSize(const HeightMap& heightMap, size_t& rowCount, size_t& columnCount);
+    static void SampleDefaults(const std::string& dirPath, size_t rowCount, size_t columnCount, float* defaults);
     
     size_t GetVertexCount() const;
     float GetSpacing() const;
 
-    GLuint vbo;
-    GLuint vao;
+    // Every vertex, row by row, for drawing
+    const NavigationVertex* GetVertices() const;
 
     void UpdateMesh();
-    void UpdateMesh(std::vector<Component*> rigidbodies);
+    void UpdateMesh(const FrameVector<Component*>& rigidbodies);
 
     void ResetMesh();
 
@@ -42,7 +51,7 @@ public:
     glm::vec3 GetPosition(size_t row, size_t col) const;
     float GetScore(size_t row, size_t col) const;
 
-    std::vector<size_t> GetNeighbours(size_t index);
+    FrameVector<size_t> GetNeighbours(size_t index);
 
     int GetForward(size_t index) const;
     int GetBackward(size_t index) const;
@@ -53,12 +62,9 @@ public:
 
 private:
 	void Initialize();
-    void InitializeRenderBuffers();
-
-    void UpdateRenderBuffers() const;
 
     bool IsContainedBy(size_t index, physx::PxBounds3 bounds);
-    std::vector<size_t> FindAllContainedBy(physx::PxBounds3 bounds);
+    FrameVector<size_t> FindAllContainedBy(physx::PxBounds3 bounds);
 
     HeightMap* heightMap;
     float* defaults;
@@ -26,6 +26,7 @@ const char* UniformName::DepthBiasModelViewProjectionMatrix = "depthBiasModelVie
 const char* UniformName::SkyboxTexture = "skybox";
 const char* UniformName::SkyboxColor = "colorAdjust";
 const char* UniformName::ViewProjectionMatrix = "viewProjectionMatrix";
+const char* UniformName::CameraMask = "cameraMask";
 
 const char* UniformName::SunTexture = "sun";
 const char* UniformName::SunSizeRadians = "sunSizeRadians";
@@ -33,10 +34,18 @@ const char* UniformName::SunDirection = "sunDirection";
 const char* UniformName::Time = "time";
 
 const char* UniformName::ScreenTexture = "screen";
+const char* UniformName::ScreenTexelSize = "screenTexelSize";
+const char* UniformName::ScreenScaled = "screenScaled";
+const char* UniformName::ScreenUvScale = "screenUvScale";
 const char* UniformName::ImageTexture = "image";
-const char* UniformName::BlurOffset = "offset";
+const char* UniformName::TexelSize = "texelSize";
+const char* UniformName::ImageUvScale = "imageUvScale";
+const char* UniformName::TargetSize = "targetSize";
 
 const char* UniformName::BloomScale = "bloomScale";
+const char* UniformName::BloomTexture = "bloom";
+const char* UniformName::BloomIntensity = "bloomIntensity";
+const char* UniformName::BloomUvScale = "bloomUvScale";
 
 const char* UniformName::IsSprite = "isSprite";
 const char* UniformName::SpriteSize = "spriteSize";
@@ -48,47 +57,73 @@ const char* UniformName::BillboardScale = "billboardScale";
 const char* UniformName::CameraRight = "cameraRight_world";
 const char* UniformName::CameraUp = "cameraUp_world";
 
-ShaderProgram::ShaderProgram() {}
-ShaderProgram::ShaderProgram(GLuint id) : programId(id) {}
+namespace {
+    // FNV-1a over the name's characters
+    uint64_t HashName(const char* name) {
+        uint64_t hash = 14695981039346656037ull;
+        for (; *name; ++name) {
+            hash ^= static_cast<unsigned char>(*name);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+ShaderProgram::ShaderProgram() : programId(0), renderState(nullptr) {}
+ShaderProgram::ShaderProgram(GLuint id, RenderState* _renderState) : programId(id), renderState(_renderState) {}
 
 GLuint ShaderProgram::GetId() const {
 	return programId;
 }
 
 GLuint ShaderProgram::GetUniformLocation(const char* name) {
-	const auto it = uniforms.find(name);
+	return GetUniform(name).location;
+}
+
+ShaderProgram::Uniform& ShaderProgram::GetUniform(const char* name) {
+    const uint64_t hash = HashName(name);
+    const auto cached = uniformsByHash.find(hash);
+    if (cached != uniformsByHash.end() && cached->second->first == name) return cached->second->second;
+
+	auto it = uniforms.find(name);
 	if (it == uniforms.end()) {
-        GLuint location = glGetUniformLocation(programId, name);
-        uniforms[name] = location;
-        return location;
+        it = uniforms.insert(std::make_pair(std::string(name), Uniform())).first;
+        it->second.location = glGetUniformLocation(programId, name);
 	}
+    if (cached == uniformsByHash.end()) uniformsByHash[hash] = it;
 	return it->second;
 }
 
+void ShaderProgram::LoadUniformData(const char* name, GLenum type, const void* data, size_t size) {
+    Uniform& uniform = GetUniform(name);
+    renderState->LoadUniform(uniform.location, type, data, size, uniform.value);
+}
+
 void ShaderProgram::LoadUniform(const char* name, bool v) {
-    glUniform1ui(GetUniformLocation(name), v);
+    const GLuint value = v;
+    LoadUniformData(name, GL_BOOL, &value, sizeof(value));
 }
 
 void ShaderProgram::LoadUniform(const char* name, int v) {
-    glUniform1i(GetUniformLocation(name), v);
+    LoadUniformData(name, GL_INT, &v, sizeof(v));
 }
 
 void ShaderProgram::LoadUniform(const char* name, float v) {
-    glUniform1f(GetUniformLocation(name), v);
+    LoadUniformData(name, GL_FLOAT, &v, sizeof(v));
 }
 
 void ShaderProgram::LoadUniform(const char* name, glm::vec2 v) {
-    glUniform2f(GetUniformLocation(name), v.x, v.y);
+    LoadUniformData(name, GL_FLOAT_VEC2, &v[0], sizeof(v));
 }
 
 void ShaderProgram::LoadUniform(const char* name, glm::vec3 v) {
-    glUniform3f(GetUniformLocation(name), v.x, v.y, v.z);
+    LoadUniformData(name, GL_FLOAT_VEC3, &v[0], sizeof(v));
 }
 
 void ShaderProgram::LoadUniform(const char* name, glm::vec4 v) {
-    glUniform4f(GetUniformLocation(name), v.x, v.y, v.z, v.w);
+    LoadUniformData(name, GL_FLOAT_VEC4, &v[0], sizeof(v));
 }
 
 void ShaderProgram::LoadUniform(const char* name, glm::mat4 v) {
-    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &v[0][0]);
+    LoadUniformData(name, GL_FLOAT_MAT4, &v[0][0], sizeof(v));
 }
@@ -3,7 +3,11 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <map>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
 #include <glm/glm.hpp>
+#include "../Graphics/RenderState.h"
 
 const struct UniformName {
 	static const char* AmbientColor;
@@ -31,6 +35,7 @@ const struct UniformName {
 	static const char* SkyboxTexture;
 	static const char* SkyboxColor;
     static const char* ViewProjectionMatrix;
+    static const char* CameraMask;
     
     static const char* SunTexture;
     static const char* SunSizeRadians;
@@ -38,10 +43,18 @@ const struct UniformName {
     static const char* Time;
     
     static const char* ScreenTexture;
+    static const char* ScreenTexelSize;
+    static const char* ScreenScaled;
+    static const char* ScreenUvScale;
     static const char* ImageTexture;
-    static const char* BlurOffset;
+    static const char* TexelSize;
+    static const char* ImageUvScale;
+    static const char* TargetSize;
     
     static const char* BloomScale;
+    static const char* BloomTexture;
+    static const char* BloomIntensity;
+    static const char* BloomUvScale;
     
     static const char* IsSprite;
     static const char* SpriteSize;
@@ -54,10 +67,11 @@ const struct UniformName {
     static const char* CameraUp;
 };
 
+// Uniforms are uploaded through the render state, which skips values the program already holds
 class ShaderProgram {
 public:
 	ShaderProgram();
-	ShaderProgram(GLuint id);
+	ShaderProgram(GLuint id, RenderState* renderState);
 
 	GLuint GetId() const;
 
@@ -72,6 +86,18 @@ public:
     void LoadUniform(const char* name, glm::mat4 v);
 
 private:
+    struct Uniform {
+        GLuint location;
+        UniformValue value;             // What the program holds, as far as the render state is concerned
+    };
+
 	GLuint programId;
-	std::map<std::string, GLuint> uniforms;
+	RenderState* renderState;
+	std::map<std::string, Uniform> uniforms;
+    // The same uniforms by a hash of their name's characters, so a lookup doesn't build a string and doesn't depend on
+    // where the name lives. Names whose hash is taken by another name are only found through uniforms.
+    std::unordered_map<uint64_t, std::map<std::string, Uniform>::iterator> uniformsByHash;
+
+    Uniform& GetUniform(const char* name);
+    void LoadUniformData(const char* name, GLenum type, const void* data, size_t size);
 };
@@ -0,0 +1,104 @@
+#include "StartupProfile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace {
+    const char* TYPE_NAMES[StartupAsset_Count] = { "Mesh", "Texture", "Prefab", "Sound", "Shader" };
+
+    struct AssetRecord {
+        StartupAssetType type;
+        string filePath;
+        size_t bytes;
+        double parseSeconds;
+        double uploadSeconds;
+    };
+
+    struct PhaseRecord {
+        string name;
+        double seconds;
+    };
+
+    const chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+
+    mutex recordMutex;
+    vector<AssetRecord> assets;
+    vector<PhaseRecord> phases;
+    double phaseStart = 0.0;
+    bool finished = false;
+}
+
+double StartupProfile::Now() {
+    return chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+}
+
+void StartupProfile::Record(StartupAssetType type, const string& filePath, size_t bytes, double parseSeconds, double uploadSeconds) {
+    lock_guard<mutex> lock(recordMutex);
+    if (finished) return;
+    assets.push_back({ type, filePath, bytes, parseSeconds, uploadSeconds });
+}
+
+void StartupProfile::EndPhase(const string& name) {
+    const double now = Now();
+    lock_guard<mutex> lock(recordMutex);
+    if (finished) return;
+    phases.push_back({ name, now - phaseStart });
+    phaseStart = now;
+}
+
+void StartupProfile::Finish(const string& reportPath) {
+    const double total = Now();
+
+    lock_guard<mutex> lock(recordMutex);
+    if (finished) return;
+    finished = true;
+
+    size_t counts[StartupAsset_Count] = {};
+    size_t bytes = 0;
+    double parseSeconds = 0.0;
+    double uploadSeconds = 0.0;
+    for (const AssetRecord& asset : assets) {
+        counts[asset.type]++;
+        bytes += asset.bytes;
+        parseSeconds += asset.parseSeconds;
+        uploadSeconds += asset.uploadSeconds;
+    }
+
+    // Parse time is summed over every loader thread, so it exceeds the wall time when they run side by side
+    cout << "Startup: " << total * 1000.0 << " ms to main menu, " << assets.size() << " assets (" << bytes / (1024.0 * 1024.0) << " MB), "
+        << parseSeconds * 1000.0 << " ms parsing, " << uploadSeconds * 1000.0 << " ms uploading" << endl;
+    for (const PhaseRecord& phase : phases) {
+        cout << "    " << phase.name << ": " << phase.seconds * 1000.0 << " ms" << endl;
+    }
+    for (size_t i = 0; i < StartupAsset_Count; ++i) {
+        if (counts[i] > 0) cout << "    " << TYPE_NAMES[i] << " assets: " << counts[i] << endl;
+    }
+
+    if (reportPath.empty()) return;
+
+    ofstream report(reportPath, ios::trunc);
+    if (!report) {
+        cerr << "ERROR: Failed to write startup report: " << reportPath << endl;
+        return;
+    }
+
+    sort(assets.begin(), assets.end(), [](const AssetRecord& lhs, const AssetRecord& rhs) {
+        return lhs.parseSeconds + lhs.uploadSeconds > rhs.parseSeconds + rhs.uploadSeconds;
+    });
+
+    report << "Type,Name,Bytes,Parse (ms),Upload (ms),Wall (ms)" << endl;
+    report << "Total,Startup," << bytes << "," << parseSeconds * 1000.0 << "," << uploadSeconds * 1000.0 << "," << total * 1000.0 << endl;
+    for (const PhaseRecord& phase : phases) {
+        report << "Phase," << phase.name << ",,,," << phase.seconds * 1000.0 << endl;
+    }
+    for (const AssetRecord& asset : assets) {
+        report << TYPE_NAMES[asset.type] << "," << asset.filePath << "," << asset.bytes << "," << asset.parseSeconds * 1000.0 << ","
+            << asset.uploadSeconds * 1000.0 << "," << endl;
+    }
+}
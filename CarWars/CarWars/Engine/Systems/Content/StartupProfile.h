@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+enum StartupAssetType {
+    StartupAsset_Mesh = 0,
+    StartupAsset_Texture,
+    StartupAsset_Prefab,
+    StartupAsset_Sound,
+    StartupAsset_Shader,
+    StartupAsset_Count
+};
+
+// Times the boot sequence, from the start of main to the first frame of the main menu, so that startup regressions
+// show up as numbers. Loaders record every asset they finish (parse time on whichever thread decoded it, upload time
+// on the main thread) and main marks the end of each boot phase. Safe to call from any thread.
+// Recording stops once Finish is called, so loads later in the session don't end up in the report.
+class StartupProfile {
+public:
+    // Seconds since the process started
+    static double Now();
+
+    static void Record(StartupAssetType type, const std::string& filePath, size_t bytes, double parseSeconds, double uploadSeconds);
+
+    // Ends the phase that started when the previous one ended (or at startup)
+    static void EndPhase(const std::string& name);
+
+    // Stops recording and prints a summary. With a report path, also writes every phase and asset to it as CSV,
+    // slowest first.
+    static void Finish(const std::string& reportPath = "");
+
+private:
+    // No instantiation
+    StartupProfile() = delete;
+};
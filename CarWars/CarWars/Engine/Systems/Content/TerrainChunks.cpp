@@ -0,0 +1,155 @@
+#include "TerrainChunks.h"
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+    // Rows or columns a level keeps out of 0..quadCount
+    vector<size_t> GetSamples(size_t quadCount, size_t stride) {
+        vector<size_t> samples;
+        for (size_t i = 0; i < quadCount; i += stride) samples.push_back(i);
+        samples.push_back(quadCount);
+        return samples;
+    }
+
+    // Index of the sample at or before i
+    size_t FindCell(const vector<size_t>& samples, size_t i) {
+        const size_t cell = upper_bound(samples.begin(), samples.end(), i) - samples.begin() - 1;
+        return min(cell, samples.size() - 2);
+    }
+}
+
+void TerrainChunks::Build(const MeshVertex* vertices, size_t rowCount, size_t columnCount, vector<MeshData>& chunks) {
+    chunks.clear();
+    if (rowCount < 2 || columnCount < 2) return;
+
+    for (size_t row = 0; row + 1 < rowCount; row += TERRAIN_CHUNK_SIZE) {
+        for (size_t column = 0; column + 1 < columnCount; column += TERRAIN_CHUNK_SIZE) {
+            const size_t quadRows = min<size_t>(TERRAIN_CHUNK_SIZE, rowCount - 1 - row);
+            const size_t quadColumns = min<size_t>(TERRAIN_CHUNK_SIZE, columnCount - 1 - column);
+
+            chunks.push_back(MeshData());
+            BuildChunk(vertices, columnCount, row, column, quadRows, quadColumns, chunks.back());
+        }
+    }
+}
+
+void TerrainChunks::BuildChunk(const MeshVertex* vertices, size_t columnCount, size_t firstRow, size_t firstColumn,
+    size_t quadRows, size_t quadColumns, MeshData& chunk) {
+
+    const size_t width = quadColumns + 1;
+    const size_t height = quadRows + 1;
+    auto local = [width](size_t row, size_t column) { return static_cast<uint32_t>(row * width + column); };
+
+    chunk.vertices.clear();
+    chunk.indices.clear();
+    chunk.lods.clear();
+    for (size_t row = 0; row < height; ++row) {
+        const MeshVertex* source = vertices + (firstRow + row) * columnCount + firstColumn;
+        chunk.vertices.insert(chunk.vertices.end(), source, source + width);
+    }
+
+    chunk.boundsMin = chunk.boundsMax = chunk.vertices[0].position;
+    for (const MeshVertex& vertex : chunk.vertices) {
+        chunk.boundsMin = glm::min(chunk.boundsMin, vertex.position);
+        chunk.boundsMax = glm::max(chunk.boundsMax, vertex.position);
+    }
+
+    // Each level keeps every stride-th row and column, until a level would be a single quad
+    vector<vector<size_t>> rowSamples;
+    vector<vector<size_t>> columnSamples;
+    vector<float> errors;
+    float maxError = 0.f;
+    for (size_t stride = 1; rowSamples.size() < MESH_MAX_LOD_COUNT; stride *= 2) {
+        if (stride > 1 && rowSamples.back().size() <= 2 && columnSamples.back().size() <= 2) break;
+        rowSamples.push_back(GetSamples(quadRows, stride));
+        columnSamples.push_back(GetSamples(quadColumns, stride));
+
+        // Furthest any grid height is from the level's surface above or below it
+        const vector<size_t>& rows = rowSamples.back();
+        const vector<size_t>& columns = columnSamples.back();
+        for (size_t row = 0; row < height; ++row) {
+            const size_t r = FindCell(rows, row);
+            const float v = static_cast<float>(row - rows[r]) / (rows[r + 1] - rows[r]);
+            for (size_t column = 0; column < width; ++column) {
+                const size_t c = FindCell(columns, column);
+                const float u = static_cast<float>(column - columns[c]) / (columns[c + 1] - columns[c]);
+
+                // Same split as the grid's triangles, from the top right corner to the bottom left one
+                const float h00 = chunk.vertices[local(rows[r], columns[c])].position.y;
+                const float h01 = chunk.vertices[local(rows[r], columns[c + 1])].position.y;
+                const float h10 = chunk.vertices[local(rows[r + 1], columns[c])].position.y;
+                const float h11 = chunk.vertices[local(rows[r + 1], columns[c + 1])].position.y;
+                const float surface = u + v <= 1.f ?
+                    h00 + u * (h01 - h00) + v * (h10 - h00) :
+                    h11 + (1.f - u) * (h10 - h11) + (1.f - v) * (h01 - h11);
+
+                maxError = max(maxError, abs(chunk.vertices[local(row, column)].position.y - surface));
+            }
+        }
+        errors.push_back(maxError);
+    }
+
+    // Skirts hang from the edges, walked so that their triangles face out of the chunk
+    vector<uint32_t> edge;
+    for (size_t column = 0; column < quadColumns; ++column) edge.push_back(local(0, column));
+    for (size_t row = 0; row < quadRows; ++row) edge.push_back(local(row, quadColumns));
+    for (size_t column = quadColumns; column > 0; --column) edge.push_back(local(quadRows, column));
+    for (size_t row = quadRows; row > 0; --row) edge.push_back(local(row, 0));
+
+    const size_t gridVertexCount = chunk.vertices.size();
+    const float skirtDepth = maxError + TERRAIN_SKIRT_MIN_DEPTH;
+    vector<uint32_t> skirtOf(gridVertexCount, 0);
+    for (uint32_t index : edge) {
+        MeshVertex skirt = chunk.vertices[index];
+        skirt.position.y -= skirtDepth;
+        skirtOf[index] = static_cast<uint32_t>(chunk.vertices.size());
+        chunk.vertices.push_back(skirt);
+    }
+    chunk.boundsMin.y -= skirtDepth;
+
+    const float radius = max(MeshSimplifier::GetBoundingRadius(chunk.boundsMin, chunk.boundsMax), 0.0001f);
+    for (size_t level = 0; level < rowSamples.size(); ++level) {
+        const vector<size_t>& rows = rowSamples[level];
+        const vector<size_t>& columns = columnSamples[level];
+
+        MeshLod lod;
+        lod.indexOffset = static_cast<uint32_t>(chunk.indices.size());
+        lod.error = errors[level] / radius;
+
+        for (size_t r = 0; r + 1 < rows.size(); ++r) {
+            for (size_t c = 0; c + 1 < columns.size(); ++c) {
+                const uint32_t v00 = local(rows[r], columns[c]);
+                const uint32_t v01 = local(rows[r], columns[c + 1]);
+                const uint32_t v10 = local(rows[r + 1], columns[c]);
+                const uint32_t v11 = local(rows[r + 1], columns[c + 1]);
+                chunk.indices.insert(chunk.indices.end(), { v00, v10, v01, v01, v10, v11 });
+            }
+        }
+
+        // The level's edge vertices, in the same order as the full edge
+        vector<uint32_t> levelEdge;
+        for (uint32_t index : edge) {
+            const size_t row = index / width;
+            const size_t column = index % width;
+            if (binary_search(rows.begin(), rows.end(), row) && binary_search(columns.begin(), columns.end(), column)) {
+                levelEdge.push_back(index);
+            }
+        }
+        for (size_t i = 0; i < levelEdge.size(); ++i) {
+            const uint32_t a = levelEdge[i];
+            const uint32_t b = levelEdge[(i + 1) % levelEdge.size()];
+            chunk.indices.insert(chunk.indices.end(), { a, b, skirtOf[a], b, skirtOf[b], skirtOf[a] });
+        }
+
+        lod.indexCount = static_cast<uint32_t>(chunk.indices.size()) - lod.indexOffset;
+        chunk.lods.push_back(lod);
+    }
+
+    Submesh submesh = {};
+    submesh.indexCount = chunk.lods[0].indexCount;
+    chunk.submeshes.assign(1, submesh);
+}
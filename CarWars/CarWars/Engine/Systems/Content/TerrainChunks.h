@@ -0,0 +1,26 @@
+#pragma once
+
+#include "MeshFile.h"
+#include <cstddef>
+#include <vector>
+
+#define TERRAIN_CHUNK_SIZE 32               // Quads along each side of a chunk, a multiple of the coarsest level's stride
+#define TERRAIN_SKIRT_MIN_DEPTH 0.1f        // How far skirts hang below the coarsest level's error
+
+// Splits a height map's vertex grid into square chunks with their own bounds, so each can be culled and given a
+// level of detail on its own. Level n of a chunk keeps every 2^n-th row and column of the grid (plus its last ones).
+// Neighbouring chunks at different levels don't share their edge vertices, so every chunk has a skirt hanging down
+// from its edges, deep enough to cover the largest gap its coarsest level can leave. No GL, so the grid can come
+// from Map.png or from a mapped package.
+class TerrainChunks {
+public:
+    // vertices is a rowCount * columnCount grid, row by row
+    static void Build(const MeshVertex* vertices, size_t rowCount, size_t columnCount, std::vector<MeshData>& chunks);
+
+private:
+    // No instantiation
+    TerrainChunks() = delete;
+
+    static void BuildChunk(const MeshVertex* vertices, size_t columnCount, size_t firstRow, size_t firstColumn,
+        size_t quadRows, size_t quadColumns, MeshData& chunk);
+};
@@ -4,10 +4,11 @@
 #include <GLFW/glfw3.h>
 
 struct Texture {
-    Texture(GLuint _textureId, size_t _width, size_t _height) :
-        textureId(_textureId), width(_width), height(_height) {}
+    Texture(GLuint _textureId, size_t _width, size_t _height, size_t _byteCount=0) :
+        textureId(_textureId), width(_width), height(_height), byteCount(_byteCount) {}
 
 	GLuint textureId;
 	size_t width;
     size_t height;
+    size_t byteCount;       // Video memory used by every mip
 };
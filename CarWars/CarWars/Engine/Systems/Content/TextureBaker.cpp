@@ -0,0 +1,110 @@
+#include "TextureBaker.h"
+
+#include "BakedContent.h"
+#include "TextureCompression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iostream>
+#include "stb/stb_image.h"
+
+using namespace std;
+
+namespace {
+    bool IsNormalMap(const string& filePath) {
+        string name = filePath.substr(filePath.find_last_of("/\\") + 1);
+        transform(name.begin(), name.end(), name.begin(), [](char c) { return static_cast<char>(tolower(c)); });
+        return name.find("normal") != string::npos;
+    }
+
+    // Box filters each 2x2 footprint into one texel, repeating the last row or column of odd sized mips
+    vector<uint8_t> Downsample(const vector<uint8_t>& rgba, size_t width, size_t height, bool normalMap) {
+        const size_t mipWidth = max<size_t>(width / 2, 1);
+        const size_t mipHeight = max<size_t>(height / 2, 1);
+        vector<uint8_t> mip(mipWidth * mipHeight * 4);
+
+        for (size_t y = 0; y < mipHeight; ++y) {
+            const size_t y0 = min(y * 2, height - 1);
+            const size_t y1 = min(y * 2 + 1, height - 1);
+            for (size_t x = 0; x < mipWidth; ++x) {
+                const size_t x0 = min(x * 2, width - 1);
+                const size_t x1 = min(x * 2 + 1, width - 1);
+
+                float texel[4];
+                for (size_t c = 0; c < 4; ++c) {
+                    texel[c] = (rgba[(y0 * width + x0) * 4 + c] + rgba[(y0 * width + x1) * 4 + c] +
+                        rgba[(y1 * width + x0) * 4 + c] + rgba[(y1 * width + x1) * 4 + c]) / 4.f;
+                }
+
+                // Averaged normals get shorter, so push them back out to unit length
+                if (normalMap) {
+                    float normal[3];
+                    for (size_t c = 0; c < 3; ++c) normal[c] = texel[c] / 127.5f - 1.f;
+                    const float length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+                    if (length > 0.f) {
+                        for (size_t c = 0; c < 3; ++c) texel[c] = (normal[c] / length + 1.f) * 127.5f;
+                    }
+                }
+
+                for (size_t c = 0; c < 4; ++c) {
+                    mip[(y * mipWidth + x) * 4 + c] = static_cast<uint8_t>(min(texel[c] + 0.5f, 255.f));
+                }
+            }
+        }
+
+        return mip;
+    }
+}
+
+bool TextureBaker::Bake(const string& filePath, TextureData& texture, bool compress) {
+    int width, height, components;
+    stbi_uc* data = stbi_load(filePath.c_str(), &width, &height, &components, 4);
+    if (data == nullptr) return false;
+
+    vector<uint8_t> rgba(data, data + width * height * 4);
+    stbi_image_free(data);
+
+    const bool normalMap = IsNormalMap(filePath);
+    bool hasAlpha = false;
+    for (size_t i = 3; i < rgba.size() && !hasAlpha; i += 4) {
+        hasAlpha = rgba[i] < 255;
+    }
+
+    if (!compress) {
+        texture.format = TextureFormat_RGBA8;
+    } else if (normalMap) {
+        texture.format = TextureFormat_BC5;
+    } else if (hasAlpha) {
+        texture.format = TextureFormat_BC3;
+    } else {
+        texture.format = TextureFormat_BC1;
+    }
+
+    texture.mips.clear();
+    size_t mipWidth = width;
+    size_t mipHeight = height;
+    while (true) {
+        TextureData::Mip mip;
+        mip.width = mipWidth;
+        mip.height = mipHeight;
+        mip.bytes = TextureCompression::Compress(texture.format, rgba.data(), mipWidth, mipHeight);
+        texture.mips.push_back(move(mip));
+
+        if (mipWidth == 1 && mipHeight == 1) break;
+        rgba = Downsample(rgba, mipWidth, mipHeight, normalMap);
+        mipWidth = max<size_t>(mipWidth / 2, 1);
+        mipHeight = max<size_t>(mipHeight / 2, 1);
+    }
+
+    return true;
+}
+
+bool TextureBaker::BakeDirectory(const string& dirPath, bool compress) {
+    return BakedContent::BakeDirectory(dirPath, { ".png", ".jpg", ".jpeg", ".tga" }, TEXTURE_FILE_EXTENSION,
+        [compress](const string& sourcePath, const string& bakedPath) {
+            TextureData texture;
+            if (!Bake(sourcePath, texture, compress)) return false;
+            return TextureFile::Write(bakedPath, texture);
+        });
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "TextureFile.h"
+#include <string>
+
+// Offline texture baker (CarWars.exe --bake-textures). Decodes source images, builds the full mip chain and block
+// compresses it so that the game never has to decode images at load time.
+class TextureBaker {
+public:
+    // Picks BC5 for normal maps (by name), BC3 for anything with transparency and BC1 otherwise.
+    // With compress false every mip is left as RGBA8 instead, for testing.
+    static bool Bake(const std::string& filePath, TextureData& texture, bool compress=true);
+
+    // Writes a baked texture next to every source image under dirPath that doesn't have an up to date one.
+    // Returns false if any texture failed to bake.
+    static bool BakeDirectory(const std::string& dirPath, bool compress=true);
+
+private:
+    // No instantiation
+    TextureBaker() = delete;
+};
@@ -0,0 +1,330 @@
+#include "TextureCompression.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+    uint16_t PackRgb565(const float color[3]) {
+        const int r = static_cast<int>(color[0] * 31.f / 255.f + 0.5f);
+        const int g = static_cast<int>(color[1] * 63.f / 255.f + 0.5f);
+        const int b = static_cast<int>(color[2] * 31.f / 255.f + 0.5f);
+        return static_cast<uint16_t>((min(r, 31) << 11) | (min(g, 63) << 5) | min(b, 31));
+    }
+
+    void UnpackRgb565(uint16_t packed, int color[3]) {
+        const int r = (packed >> 11) & 31;
+        const int g = (packed >> 5) & 63;
+        const int b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    void WriteUint16(uint8_t* bytes, uint16_t value) {
+        bytes[0] = static_cast<uint8_t>(value);
+        bytes[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    uint16_t ReadUint16(const uint8_t* bytes) {
+        return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+    }
+
+    // Colour endpoints are the extremes of the block along its principal axis, which keeps the two in-between
+    // colours on the line that the block's colours actually lie along
+    void CompressColorBlock(const uint8_t* texels, uint8_t* block) {
+        float colors[16][3];
+        float mean[3] = { 0.f, 0.f, 0.f };
+        for (size_t i = 0; i < 16; ++i) {
+            for (size_t c = 0; c < 3; ++c) {
+                colors[i][c] = texels[i * 4 + c];
+                mean[c] += colors[i][c] / 16.f;
+            }
+        }
+
+        float covariance[6] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };      // rr, rg, rb, gg, gb, bb
+        for (size_t i = 0; i < 16; ++i) {
+            const float r = colors[i][0] - mean[0];
+            const float g = colors[i][1] - mean[1];
+            const float b = colors[i][2] - mean[2];
+            covariance[0] += r * r;
+            covariance[1] += r * g;
+            covariance[2] += r * b;
+            covariance[3] += g * g;
+            covariance[4] += g * b;
+            covariance[5] += b * b;
+        }
+
+        // A few rounds of power iteration are plenty for a 3x3 matrix
+        float axis[3] = { 1.f, 1.f, 1.f };
+        for (size_t iteration = 0; iteration < 8; ++iteration) {
+            const float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+            const float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+            const float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+            const float length = max(fabs(x), max(fabs(y), fabs(z)));
+            if (length <= 0.f) break;
+            axis[0] = x / length;
+            axis[1] = y / length;
+            axis[2] = z / length;
+        }
+
+        size_t minIndex = 0;
+        size_t maxIndex = 0;
+        float minProjection = INFINITY;
+        float maxProjection = -INFINITY;
+        for (size_t i = 0; i < 16; ++i) {
+            const float projection = colors[i][0] * axis[0] + colors[i][1] * axis[1] + colors[i][2] * axis[2];
+            if (projection < minProjection) {
+                minProjection = projection;
+                minIndex = i;
+            }
+            if (projection > maxProjection) {
+                maxProjection = projection;
+                maxIndex = i;
+            }
+        }
+
+        uint16_t color0 = PackRgb565(colors[maxIndex]);
+        uint16_t color1 = PackRgb565(colors[minIndex]);
+
+        // color0 > color1 selects the four colour mode (BC3 always uses it anyway)
+        if (color0 < color1) swap(color0, color1);
+        WriteUint16(block, color0);
+        WriteUint16(block + 2, color1);
+
+        uint32_t indices = 0;
+        if (color0 != color1) {
+            int endpoints[2][3];
+            UnpackRgb565(color0, endpoints[0]);
+            UnpackRgb565(color1, endpoints[1]);
+
+            int palette[4][3];
+            for (size_t c = 0; c < 3; ++c) {
+                palette[0][c] = endpoints[0][c];
+                palette[1][c] = endpoints[1][c];
+                palette[2][c] = (2 * endpoints[0][c] + endpoints[1][c]) / 3;
+                palette[3][c] = (endpoints[0][c] + 2 * endpoints[1][c]) / 3;
+            }
+
+            for (size_t i = 0; i < 16; ++i) {
+                uint32_t bestIndex = 0;
+                int bestDistance = INT32_MAX;
+                for (uint32_t p = 0; p < 4; ++p) {
+                    int distance = 0;
+                    for (size_t c = 0; c < 3; ++c) {
+                        const int difference = texels[i * 4 + c] - palette[p][c];
+                        distance += difference * difference;
+                    }
+                    if (distance < bestDistance) {
+                        bestDistance = distance;
+                        bestIndex = p;
+                    }
+                }
+                indices |= bestIndex << (i * 2);
+            }
+        }
+
+        block[4] = static_cast<uint8_t>(indices);
+        block[5] = static_cast<uint8_t>(indices >> 8);
+        block[6] = static_cast<uint8_t>(indices >> 16);
+        block[7] = static_cast<uint8_t>(indices >> 24);
+    }
+
+    // One channel (BC4), as used for BC3 alpha and both BC5 channels. Texels are strided RGBA8.
+    void CompressChannelBlock(const uint8_t* texels, size_t channel, uint8_t* block) {
+        uint8_t values[16];
+        uint8_t maxValue = 0;
+        uint8_t minValue = 255;
+        for (size_t i = 0; i < 16; ++i) {
+            values[i] = texels[i * 4 + channel];
+            maxValue = max(maxValue, values[i]);
+            minValue = min(minValue, values[i]);
+        }
+
+        // value0 > value1 selects the eight value mode; if they're equal every index is 0 anyway
+        block[0] = maxValue;
+        block[1] = minValue;
+
+        uint64_t indices = 0;
+        if (maxValue != minValue) {
+            int palette[8];
+            palette[0] = maxValue;
+            palette[1] = minValue;
+            for (int p = 2; p < 8; ++p) {
+                palette[p] = ((8 - p) * maxValue + (p - 1) * minValue) / 7;
+            }
+
+            for (size_t i = 0; i < 16; ++i) {
+                uint64_t bestIndex = 0;
+                int bestDistance = 256;
+                for (uint64_t p = 0; p < 8; ++p) {
+                    const int distance = abs(values[i] - palette[p]);
+                    if (distance < bestDistance) {
+                        bestDistance = distance;
+                        bestIndex = p;
+                    }
+                }
+                indices |= bestIndex << (i * 3);
+            }
+        }
+
+        for (size_t i = 0; i < 6; ++i) {
+            block[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+        }
+    }
+
+    void DecompressColorBlock(const uint8_t* block, uint8_t* texels, bool allowTransparent) {
+        const uint16_t color0 = ReadUint16(block);
+        const uint16_t color1 = ReadUint16(block + 2);
+
+        int palette[4][4];
+        UnpackRgb565(color0, palette[0]);
+        UnpackRgb565(color1, palette[1]);
+        palette[0][3] = palette[1][3] = 255;
+        if (color0 > color1 || !allowTransparent) {
+            for (size_t c = 0; c < 3; ++c) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            palette[2][3] = palette[3][3] = 255;
+        } else {
+            for (size_t c = 0; c < 3; ++c) {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+            palette[2][3] = 255;
+            palette[3][3] = 0;
+        }
+
+        const uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+        for (size_t i = 0; i < 16; ++i) {
+            const int* color = palette[(indices >> (i * 2)) & 3];
+            for (size_t c = 0; c < 4; ++c) {
+                texels[i * 4 + c] = static_cast<uint8_t>(color[c]);
+            }
+        }
+    }
+
+    void DecompressChannelBlock(const uint8_t* block, uint8_t* texels, size_t channel) {
+        const int value0 = block[0];
+        const int value1 = block[1];
+
+        int palette[8];
+        palette[0] = value0;
+        palette[1] = value1;
+        if (value0 > value1) {
+            for (int p = 2; p < 8; ++p) palette[p] = ((8 - p) * value0 + (p - 1) * value1) / 7;
+        } else {
+            for (int p = 2; p < 6; ++p) palette[p] = ((6 - p) * value0 + (p - 1) * value1) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        uint64_t indices = 0;
+        for (size_t i = 0; i < 6; ++i) {
+            indices |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+        }
+        for (size_t i = 0; i < 16; ++i) {
+            texels[i * 4 + channel] = static_cast<uint8_t>(palette[(indices >> (i * 3)) & 7]);
+        }
+    }
+
+    size_t GetBlockSize(TextureFormat format) {
+        return format == TextureFormat_BC1 ? 8 : 16;
+    }
+}
+
+void TextureCompression::CompressBlockBC1(const uint8_t* texels, uint8_t* block) {
+    CompressColorBlock(texels, block);
+}
+
+void TextureCompression::CompressBlockBC3(const uint8_t* texels, uint8_t* block) {
+    CompressChannelBlock(texels, 3, block);
+    CompressColorBlock(texels, block + 8);
+}
+
+void TextureCompression::CompressBlockBC5(const uint8_t* texels, uint8_t* block) {
+    CompressChannelBlock(texels, 0, block);
+    CompressChannelBlock(texels, 1, block + 8);
+}
+
+void TextureCompression::DecompressBlock(TextureFormat format, const uint8_t* block, uint8_t* texels) {
+    switch (format) {
+    case TextureFormat_BC1:
+        DecompressColorBlock(block, texels, true);
+        break;
+    case TextureFormat_BC3:
+        DecompressColorBlock(block + 8, texels, false);
+        DecompressChannelBlock(block, texels, 3);
+        break;
+    case TextureFormat_BC5:
+        // Sampled like an RG texture
+        DecompressChannelBlock(block, texels, 0);
+        DecompressChannelBlock(block + 8, texels, 1);
+        for (size_t i = 0; i < 16; ++i) {
+            texels[i * 4 + 2] = 0;
+            texels[i * 4 + 3] = 255;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+vector<uint8_t> TextureCompression::Compress(TextureFormat format, const uint8_t* rgba, size_t width, size_t height) {
+    if (format == TextureFormat_RGBA8) return vector<uint8_t>(rgba, rgba + width * height * 4);
+
+    const size_t blockSize = GetBlockSize(format);
+    vector<uint8_t> blocks(TextureFile::GetMipSize(format, width, height));
+    uint8_t* block = blocks.data();
+
+    uint8_t texels[16 * 4];
+    for (size_t blockY = 0; blockY < height; blockY += 4) {
+        for (size_t blockX = 0; blockX < width; blockX += 4) {
+            for (size_t y = 0; y < 4; ++y) {
+                const size_t sourceY = min(blockY + y, height - 1);
+                for (size_t x = 0; x < 4; ++x) {
+                    const size_t sourceX = min(blockX + x, width - 1);
+                    const uint8_t* texel = rgba + (sourceY * width + sourceX) * 4;
+                    copy(texel, texel + 4, texels + (y * 4 + x) * 4);
+                }
+            }
+
+            switch (format) {
+            case TextureFormat_BC1: CompressBlockBC1(texels, block); break;
+            case TextureFormat_BC3: CompressBlockBC3(texels, block); break;
+            case TextureFormat_BC5: CompressBlockBC5(texels, block); break;
+            default: break;
+            }
+            block += blockSize;
+        }
+    }
+
+    return blocks;
+}
+
+vector<uint8_t> TextureCompression::Decompress(TextureFormat format, const uint8_t* blocks, size_t width, size_t height) {
+    if (format == TextureFormat_RGBA8) return vector<uint8_t>(blocks, blocks + width * height * 4);
+
+    const size_t blockSize = GetBlockSize(format);
+    vector<uint8_t> rgba(width * height * 4);
+    const uint8_t* block = blocks;
+
+    uint8_t texels[16 * 4];
+    for (size_t blockY = 0; blockY < height; blockY += 4) {
+        for (size_t blockX = 0; blockX < width; blockX += 4) {
+            DecompressBlock(format, block, texels);
+            block += blockSize;
+
+            for (size_t y = 0; y < 4 && blockY + y < height; ++y) {
+                for (size_t x = 0; x < 4 && blockX + x < width; ++x) {
+                    const uint8_t* texel = texels + (y * 4 + x) * 4;
+                    copy(texel, texel + 4, rgba.data() + ((blockY + y) * width + blockX + x) * 4);
+                }
+            }
+        }
+    }
+
+    return rgba;
+}
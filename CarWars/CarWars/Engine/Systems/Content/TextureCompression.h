@@ -0,0 +1,26 @@
+#pragma once
+
+#include "TextureFile.h"
+#include <cstdint>
+#include <vector>
+
+// Software block compression for the texture baker, and decompression for drivers that can't sample the
+// compressed formats themselves. Images are RGBA8, row by row.
+class TextureCompression {
+public:
+    // Compresses a whole image. Blocks hanging off the right or bottom edge repeat the last column or row.
+    static std::vector<uint8_t> Compress(TextureFormat format, const uint8_t* rgba, size_t width, size_t height);
+
+    // Expands a compressed image back to RGBA8
+    static std::vector<uint8_t> Decompress(TextureFormat format, const uint8_t* blocks, size_t width, size_t height);
+
+    // A single 4x4 block of RGBA8 texels to/from 8 (BC1) or 16 (BC3, BC5) bytes
+    static void CompressBlockBC1(const uint8_t* texels, uint8_t* block);
+    static void CompressBlockBC3(const uint8_t* texels, uint8_t* block);
+    static void CompressBlockBC5(const uint8_t* texels, uint8_t* block);
+    static void DecompressBlock(TextureFormat format, const uint8_t* block, uint8_t* texels);
+
+private:
+    // No instantiation
+    TextureCompression() = delete;
+};
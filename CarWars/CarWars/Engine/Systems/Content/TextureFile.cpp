@@ -0,0 +1,78 @@
+#include "TextureFile.h"
+
+#include <fstream>
+
+using namespace std;
+
+bool TextureFile::Read(const char* data, size_t size, TextureView& view) {
+    if (!data || size < sizeof(TextureFileHeader)) return false;
+
+    const TextureFileHeader* header = reinterpret_cast<const TextureFileHeader*>(data);
+    if (header->magic != TEXTURE_FILE_MAGIC || header->version != TEXTURE_FILE_VERSION) return false;
+    if (header->format >= TextureFormat_Count || header->mipCount == 0) return false;
+    if (sizeof(TextureFileHeader) + sizeof(TextureMip) * header->mipCount > size) return false;
+
+    const TextureFormat format = static_cast<TextureFormat>(header->format);
+    const TextureMip* mips = reinterpret_cast<const TextureMip*>(data + sizeof(TextureFileHeader));
+    for (size_t i = 0; i < header->mipCount; ++i) {
+        const TextureMip& mip = mips[i];
+        if (mip.size != GetMipSize(format, mip.width, mip.height)) return false;
+        if (static_cast<size_t>(mip.offset) + mip.size > size) return false;
+    }
+
+    view.format = format;
+    view.width = header->width;
+    view.height = header->height;
+    view.mipCount = header->mipCount;
+    view.mips = mips;
+    view.data = data;
+    return true;
+}
+
+bool TextureFile::Write(const string& filePath, const TextureData& texture) {
+    if (texture.mips.empty()) return false;
+
+    TextureFileHeader header;
+    header.magic = TEXTURE_FILE_MAGIC;
+    header.version = TEXTURE_FILE_VERSION;
+    header.format = texture.format;
+    header.width = static_cast<uint32_t>(texture.mips[0].width);
+    header.height = static_cast<uint32_t>(texture.mips[0].height);
+    header.mipCount = static_cast<uint32_t>(texture.mips.size());
+
+    vector<TextureMip> mips(texture.mips.size());
+    size_t offset = sizeof(TextureFileHeader) + sizeof(TextureMip) * mips.size();
+    for (size_t i = 0; i < mips.size(); ++i) {
+        mips[i].width = static_cast<uint32_t>(texture.mips[i].width);
+        mips[i].height = static_cast<uint32_t>(texture.mips[i].height);
+        mips[i].offset = static_cast<uint32_t>(offset);
+        mips[i].size = static_cast<uint32_t>(texture.mips[i].bytes.size());
+        offset += mips[i].size;
+    }
+
+    ofstream file(filePath, ios::binary | ios::trunc);
+    if (!file) return false;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(mips.data()), sizeof(TextureMip) * mips.size());
+    for (const TextureData::Mip& mip : texture.mips) {
+        file.write(reinterpret_cast<const char*>(mip.bytes.data()), mip.bytes.size());
+    }
+
+    return static_cast<bool>(file);
+}
+
+size_t TextureFile::GetMipSize(TextureFormat format, size_t width, size_t height) {
+    const size_t blockCount = ((width + 3) / 4) * ((height + 3) / 4);
+    switch (format) {
+    case TextureFormat_RGBA8:
+        return width * height * 4;
+    case TextureFormat_BC1:
+        return blockCount * 8;
+    case TextureFormat_BC3:
+    case TextureFormat_BC5:
+        return blockCount * 16;
+    default:
+        return 0;
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Baked texture container written by the texture baker (CarWars.exe --bake-textures) and loaded by
+// ContentManager::GetTexture. A file is laid out as:
+//   TextureFileHeader
+//   TextureMip[mipCount]       (largest first)
+//   each mip's payload at its offset from the start of the file
+// Every mip is stored ready for glCompressedTexImage2D (or glTexImage2D for RGBA8).
+
+#define TEXTURE_FILE_MAGIC 0x58455443      // "CTEX"
+#define TEXTURE_FILE_VERSION 1
+#define TEXTURE_FILE_EXTENSION ".tex"
+
+enum TextureFormat {
+    TextureFormat_RGBA8 = 0,        // Uncompressed, for testing
+    TextureFormat_BC1,              // Opaque colour, 8 bytes per 4x4 block
+    TextureFormat_BC3,              // Colour with alpha, 16 bytes per 4x4 block
+    TextureFormat_BC5,              // Normal maps (x and y only), 16 bytes per 4x4 block
+    TextureFormat_Count
+};
+
+struct TextureFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipCount;
+};
+
+struct TextureMip {
+    uint32_t width;
+    uint32_t height;
+    uint32_t offset;
+    uint32_t size;
+};
+
+static_assert(sizeof(TextureFileHeader) == 24, "TextureFileHeader must match the file layout");
+static_assert(sizeof(TextureMip) == 16, "TextureMip must match the file layout");
+
+// Texture data that doesn't own its payloads, e.g. pointing into a mapped file
+struct TextureView {
+    TextureView() : format(TextureFormat_RGBA8), width(0), height(0), mipCount(0), mips(nullptr), data(nullptr) {}
+
+    TextureFormat format;
+    size_t width;
+    size_t height;
+    size_t mipCount;
+    const TextureMip* mips;
+    const char* data;           // Mip offsets are relative to this
+
+    const void* GetMipData(size_t level) const { return data + mips[level].offset; }
+};
+
+// Texture data that owns its payloads, e.g. fresh from the baker
+struct TextureData {
+    struct Mip {
+        size_t width;
+        size_t height;
+        std::vector<uint8_t> bytes;
+    };
+
+    TextureFormat format;
+    std::vector<Mip> mips;
+};
+
+class TextureFile {
+public:
+    // Points view into data after checking that it holds a whole texture file of the current version
+    static bool Read(const char* data, size_t size, TextureView& view);
+    static bool Write(const std::string& filePath, const TextureData& texture);
+
+    // Bytes needed for one mip of the given size
+    static size_t GetMipSize(TextureFormat format, size_t width, size_t height);
+
+private:
+    // No instantiation
+    TextureFile() = delete;
+};
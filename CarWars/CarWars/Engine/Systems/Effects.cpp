@@ -6,14 +6,15 @@
 #include "../Entities/EntityManager.h"
 
 // Singleton
-Effects::Effects() : inUpdate(false) {}
+Effects::Effects() : floatTweens(tweenTags), vec2Tweens(tweenTags), vec3Tweens(tweenTags), vec4Tweens(tweenTags),
+    pools{ &floatTweens, &vec2Tweens, &vec3Tweens, &vec4Tweens } {}
 Effects &Effects::Instance() {
     static Effects instance;
     return instance;
 }
 
 Effects::~Effects() {
-    std::vector<Component*> guis = EntityManager::GetComponents(ComponentType_GUI);
+    FrameVector<Component*> guis = EntityManager::GetComponents(ComponentType_GUI);
     for (Component* component : guis) {
         GuiComponent* gui = static_cast<GuiComponent*>(component);
         for (GuiEffect* effect : gui->GetEffects()) {
@@ -23,35 +24,35 @@ Effects::~Effects() {
     }
 }
 
-void Effects::DestroyTween(Tween* tween) {
-    const auto it = std::find(tweens.begin(), tweens.end(), tween);
-    if (it != tweens.end()) tweens.erase(it);
-    tween->Stop(false);
-    delete tween;
+void Effects::DestroyTween(Tween tween) {
+    if (tween.pool) tween.pool->Destroy(tween.index, tween.generation);
 }
 
-void Effects::DestroyTween(std::string tweenTag) {
-    Tween* tween = FindTween(tweenTag);
-    if (tween) DestroyTween(tween);
+void Effects::DestroyTween(TweenTag tag) {
+    DestroyTween(FindTween(tag));
 }
 
 void Effects::DestroyTweens() {
-    while (!tweens.empty()) {
-        DestroyTween(tweens.back());
+    for (TweenPoolBase* pool : pools) {
+        pool->DestroyAll();
     }
+    tweenTags.Clear();
 }
 
-Tween* Effects::FindTween(std::string tag) {
-    for (Tween* tween : tweens) {
-        if (tween->HasTag(tag)) return tween;
+Tween Effects::FindTween(TweenTag tag) const {
+    return tweenTags.Get(tag);
+}
+
+size_t Effects::GetTweenCount() const {
+    size_t count = 0;
+    for (TweenPoolBase* pool : pools) {
+        count += pool->GetActiveCount();
     }
-    return nullptr;
+    return count;
 }
 
 void Effects::Update() {
-    inUpdate = true;
-
-    std::vector<Component*> guis = EntityManager::GetComponents(ComponentType_GUI);
+    FrameVector<Component*> guis = EntityManager::GetComponents(ComponentType_GUI);
     for (Component* component : guis) {
         GuiComponent* gui = static_cast<GuiComponent*>(component);
         for (GuiEffect* effect : gui->GetEffects()) {
@@ -64,23 +65,7 @@ void Effects::Update() {
         }
     }
 
-    for (auto it = tweens.begin(); it != tweens.end();) {
-        Tween* tween = *it;
-        tween->Update();
-        if (tween->IsOwnedByEffectsSystem() && tween->Finished()) {
-            it = tweens.erase(it);
-            delete tween;
-        } else {
-            ++it;
-        }
-    }
-
-    if (!tweensCreatedInUpdate.empty()) {
-        for (Tween* tween : tweensCreatedInUpdate) {
-            tweens.push_back(tween);
-        }
-        tweensCreatedInUpdate.clear();
+    for (TweenPoolBase* pool : pools) {
+        pool->Update();
     }
-
-    inUpdate = false;
 }
@@ -3,7 +3,6 @@
 #include "System.h"
 #include "../Components/Tweens/TTween.h"
 #include <vector>
-#include <functional>
 
 class GuiEffect;
 
@@ -15,25 +14,20 @@ public:
 
     void Update() override;
 
+    // Creates a tween from start to end. It does nothing until it is started.
     template <typename V, float Ease(float t, float b, float c, float d)>
-    TTween<V, Ease>* CreateTween(V& a_value, V a_start, V a_end, const Time a_duration, Time& clock) {
-        auto tween = new TTween<V, Ease>(a_value, a_start, a_end, a_duration, clock);
-        AddTween(tween);
-        return tween;
+    TTween<V> CreateTween(V a_start, V a_end, const Time a_duration, Time& clock) {
+        TweenPool<V>& pool = GetPool<V>();
+        return TTween<V>(&pool, pool.Create(a_start, a_end, a_duration, clock, Ease));
     }
 
-    template <typename V, float Ease(float t, float b, float c, float d)>
-    TTween<V, Ease>* CreateTween(V a_start, V a_end, const Time a_duration, Time& clock) {
-        auto tween = new TTween<V, Ease>(a_start, a_end, a_duration, clock);
-        AddTween(tween);
-        return tween;
-    }
-
-    void DestroyTween(Tween* tween);
-    void DestroyTween(std::string tweenTag);
+    void DestroyTween(Tween tween);
+    void DestroyTween(TweenTag tag);
     void DestroyTweens();
 
-    Tween* FindTween(std::string tag);
+    Tween FindTween(TweenTag tag) const;
+
+    size_t GetTweenCount() const;
 
 private:
     // No instantiation or copying
@@ -41,15 +35,35 @@ private:
     Effects(const Effects&) = delete;
     Effects& operator= (const Effects&) = delete;
 
-    void AddTween(Tween* tween) {
-        if (inUpdate) {
-            tweensCreatedInUpdate.push_back(tween);
-        } else {
-            tweens.push_back(tween);
-        }
-    }
+    template <typename V>
+    TweenPool<V>& GetPool();
 
-    bool inUpdate;
-    std::vector<Tween*> tweensCreatedInUpdate;
-    std::vector<Tween*> tweens;
+    TweenTagIndex tweenTags;
+
+    // One pool per tweened value type
+    TweenPool<float> floatTweens;
+    TweenPool<glm::vec2> vec2Tweens;
+    TweenPool<glm::vec3> vec3Tweens;
+    TweenPool<glm::vec4> vec4Tweens;
+    TweenPoolBase* pools[4];
 };
+
+template <>
+inline TweenPool<float>& Effects::GetPool<float>() {
+    return floatTweens;
+}
+
+template <>
+inline TweenPool<glm::vec2>& Effects::GetPool<glm::vec2>() {
+    return vec2Tweens;
+}
+
+template <>
+inline TweenPool<glm::vec3>& Effects::GetPool<glm::vec3>() {
+    return vec3Tweens;
+}
+
+template <>
+inline TweenPool<glm::vec4>& Effects::GetPool<glm::vec4>() {
+    return vec4Tweens;
+}
@@ -1,6 +1,7 @@
 #include "Game.h"
 
 #include "Content/ContentManager.h"
+#include "Content/ContentStreamer.h"
 #include "../Entities/EntityManager.h"
 #include "../Components/SpotLightComponent.h"
 #include "../Components/MeshComponent.h"
@@ -28,6 +29,10 @@
 #include "PennerEasing/Quint.h"
 #include "../Components/ParticleEmitterComponent.h"
 #include "../Components/PowerUpComponents/HealthPowerUp.h"
+#include "PennerEasing/Linear.h"
+#include "../Events/EventBus.h"
+#include "Jobs/JobSystem.h"
+#include "../Events/GameEvents.h"
 using namespace std;
 
 const string GameModeType::displayNames[Count] = { "Team", "Free for All" };
@@ -65,6 +70,7 @@ const unsigned int Game::MAX_VEHICLE_COUNT = 20;
 GameData Game::gameData;
 HumanData Game::humanPlayers[4];
 vector<AiData> Game::aiPlayers;
+unordered_map<Entity*, PlayerData*> Game::playersByVehicle;
 
 Time gameTime(0);
 
@@ -86,23 +92,39 @@ void Game::Initialize() {
     StateManager::SetState(GameState_Menu);
 
 	suicide = new SuicideWeaponComponent();
+
+    EventBus::Instance().SubscribeBatch<DamageEvent>(&Game::OnDamage);
+    EventBus::Instance().Subscribe<KillEvent>(&Game::OnKill);
+    EntityManager::AddDestroyListener(&Game::OnEntityDestroyed);
+
+    // Parse everything that gets spawned mid-game while the menu is up, so spawning never waits on the disk
+    ContentStreamer& streamer = ContentStreamer::Instance();
+    for (size_t i = 0; i < VehicleType::Count; ++i) {
+        streamer.PreloadEntity(VehicleType::prefabPaths[i]);
+        streamer.LoadTexture(VehicleType::teamTextureNames[i][0]);
+        streamer.LoadTexture(VehicleType::teamTextureNames[i][1]);
+    }
+    for (size_t i = 0; i < WeaponType::Count; ++i) {
+        streamer.PreloadEntity(WeaponType::turretPrefabPaths[i]);
+        streamer.PreloadComponent(WeaponType::prefabPaths[i]);
+    }
+    streamer.PreloadComponent("HealthPowerUpMesh.json");
+    streamer.PreloadComponent("DamagePowerUpMesh.json");
+    streamer.PreloadComponent("DefencePowerUpMesh.json");
 }
 
 void Game::SpawnVehicle(PlayerData& player) const {
-	vector<Entity*> spawns = EntityManager::FindEntities("SpawnLocation");
+	FrameVector<Entity*> spawns = EntityManager::FindEntities("SpawnLocation");
+	SpatialIndex& spatialIndex = Physics::Instance().GetSpatialIndex();
+	SpatialQueryFilter vehicleFilter;
+	vehicleFilter.tag = "Vehicle";
 	Entity* spawn;
 	bool cantSpawn;
 	size_t i = 0;
 	do {
-		cantSpawn = false;
 		spawn = spawns[rand() % spawns.size()];
-		for (Entity* vehicle : EntityManager::FindEntities("Vehicle")) {
-			glm::vec3 vehiclePosition = Transform::FromPx(vehicle->GetComponent<VehicleComponent>()->pxRigid->getGlobalPose().p);
-			if (glm::distance(spawn->transform.GetGlobalPosition(), vehiclePosition) < 10.0f) {
-				cantSpawn = true;
-				i++;
-			}
-		}
+		cantSpawn = !spatialIndex.QueryRadius(spawn->transform.GetGlobalPosition(), 10.0f, vehicleFilter).empty();
+		if (cantSpawn) i++;
 	} while (cantSpawn && i < 5);
 
 	// pick a random point on a sphere for spawn
@@ -118,7 +140,10 @@ void Game::SpawnVehicle(PlayerData& player) const {
 	// Initialize their vehicle
 	player.vehicleEntity = ContentManager::LoadEntity(VehicleType::prefabPaths[player.vehicleType]);
 	VehicleComponent* vehicleComponent = player.vehicleEntity->GetComponent<VehicleComponent>();
+	player.vehicle = vehicleComponent;
 	vehicleComponent->pxRigid->setGlobalPose(transform);
+	spatialIndex.Update(vehicleComponent, position);
+	spatialIndex.SetTeam(vehicleComponent, static_cast<int>(player.teamIndex));
 	switch (player.vehicleType) {
 	case VehicleType::Heavy:
 		vehicleComponent->SetResistance(0.65f);
@@ -136,7 +161,7 @@ void Game::SpawnVehicle(PlayerData& player) const {
 
     if (gameData.gameMode == GameModeType::Team) {
         MeshComponent* mesh = player.vehicleEntity->GetComponent<MeshComponent>();
-        mesh->SetTexture(ContentManager::GetTexture(VehicleType::teamTextureNames[player.vehicleType][player.teamIndex]));
+        mesh->SetTexture(ContentStreamer::Instance().LoadTexture(VehicleType::teamTextureNames[player.vehicleType][player.teamIndex]));
     }
 
 	// Initialize their turret mesh
@@ -146,7 +171,9 @@ void Game::SpawnVehicle(PlayerData& player) const {
 	// Initialize their weapon
 	Component* weapon = ContentManager::LoadComponent(WeaponType::prefabPaths[player.weaponType]);
 	EntityManager::AddComponent(player.vehicleEntity, weapon);
+	player.weapon = static_cast<WeaponComponent*>(weapon);
 
+	RegisterVehicle(player);
 	player.alive = true;
 }
 
@@ -183,6 +210,8 @@ void Game::InitializeGame() {
     }
 
 	// Initialize the AI
+	// The registry and team lists point into aiPlayers, so it must not reallocate
+	aiPlayers.reserve(gameData.aiCount);
 	for (size_t i = 0; i < gameData.aiCount; ++i) {
 		// Create the AI
 		// TODO: Choose vehicle and weapon type somehow
@@ -201,6 +230,7 @@ void Game::InitializeGame() {
 			ai.teamIndex = (gameData.humanCount + i) % 2;
 			gameData.teams[ai.teamIndex].size++;
 		}
+		gameData.teams[ai.teamIndex].members.push_back(&ai);
 
 		SpawnAi(ai);
 	}
@@ -228,6 +258,7 @@ void Game::InitializeGame() {
             player.teamIndex = readyIndex % 2;
 			gameData.teams[player.teamIndex].size++;
         }
+		gameData.teams[player.teamIndex].members.push_back(&player);
 
 		SpawnVehicle(player);
 
@@ -263,10 +294,16 @@ void Game::ResetGame() {
         player.killCount = 0;
         player.deathCount = 0;
 		player.activePowerUp = nullptr;
+        player.vehicle = nullptr;
+        player.weapon = nullptr;
     }
 
+    // Drop queued events that still point at the old players
+    EventBus::Instance().Clear();
+
     // Reset ais
     aiPlayers.clear();
+    playersByVehicle.clear();
 
     // Reset game
     gameData.humanCount = 0;
@@ -283,12 +320,14 @@ void Game::FinishGame() {
 
 void Game::Update() {
     if (StateManager::GetState() != GameState_Paused) {
-        std::vector<Component*> particleEmitterComponents = EntityManager::GetComponents(ComponentType_ParticleEmitter);
-        for (Component* component : particleEmitterComponents) {
-            if (!component->enabled) continue;
+        // Emitters only touch their own particles, so they are simulated in parallel
+        FrameVector<Component*> particleEmitterComponents = EntityManager::GetComponents(ComponentType_ParticleEmitter);
+        JobSystem::Instance().ParallelForEach(particleEmitterComponents.size(), 4, [&particleEmitterComponents](size_t i) {
+            Component* component = particleEmitterComponents[i];
+            if (!component->enabled) return;
             ParticleEmitterComponent* emitter = static_cast<ParticleEmitterComponent*>(component);
             emitter->Update();
-        }
+        });
     }
 
     if (StateManager::GetState() < __GameState_Menu_End) {
@@ -328,7 +367,7 @@ void Game::Update() {
 			PxRaycastBuffer hit;
 			glm::vec3 direction = glm::normalize(player.camera->GetPosition() - player.camera->GetTarget());
 			PxQueryFilterData filterData;
-			filterData.data.word0 = -1 ^ player.vehicleEntity->GetComponent<VehicleComponent>()->GetRaycastGroup();
+			filterData.data.word0 = -1 ^ player.vehicle->GetRaycastGroup();
 			
 			//Raycast
 			if (scene->raycast(Transform::ToPx(player.camera->GetTarget()), Transform::ToPx(direction), CameraComponent::MAX_DISTANCE + 3, hit, PxHitFlag::eDEFAULT, filterData)) {
@@ -350,11 +389,11 @@ void Game::Update() {
                 const glm::vec3 start = mask.GetLocalScale();
                 const glm::vec3 end = gui->transform.GetLocalScale();
                 auto tween = Effects::Instance().CreateTween<glm::vec3, easing::Quint::easeOut>(start, end, 0.25, StateManager::gameTime);
-                tween->SetTag("HealthBar" + std::to_string(player.id));
-                tween->SetUpdateCallback([&mask](glm::vec3& value) mutable {
+                tween.SetTag(TweenTag("HealthBar", player.id));
+                tween.SetUpdateCallback([&mask](glm::vec3& value) mutable {
                     mask.SetScale(value);
                 });
-                tween->Start();
+                tween.Start();
 			}
 
 			if (player.alive && player.vehicleEntity->transform.GetGlobalPosition().y < -20.f) {
@@ -392,7 +431,7 @@ void Game::Update() {
 		}
 
         // Respawn powerups + rotate and oscillate
-        std::vector<Component*> powerUpSpawners = EntityManager::GetComponents(ComponentType_PowerUpSpawner);
+        FrameVector<Component*> powerUpSpawners = EntityManager::GetComponents(ComponentType_PowerUpSpawner);
         for (Component* component : powerUpSpawners) {
             glm::vec3 currPos = component->GetEntity()->transform.GetGlobalPosition();
             PowerUpSpawnerComponent* spawner = static_cast<PowerUpSpawnerComponent*>(component);
@@ -463,20 +502,188 @@ HeightMap* Game::GetHeightMap() const {
 }
 
 PlayerData* Game::GetPlayerFromEntity(Entity* vehicle) {
-    HumanData* player = GetHumanFromEntity(vehicle);
-    if (player) return player;
+    const auto it = playersByVehicle.find(vehicle);
+    return it != playersByVehicle.end() ? it->second : nullptr;
+}
+
+void Game::RegisterVehicle(PlayerData& player) {
+    playersByVehicle[player.vehicleEntity] = &player;
+}
 
-    for (AiData& ai : aiPlayers) {
-        if (ai.vehicleEntity == vehicle) return &ai;
+void Game::OnEntityDestroyed(Entity* entity) {
+    const auto it = playersByVehicle.find(entity);
+    if (it == playersByVehicle.end()) return;
+
+    PlayerData* player = it->second;
+    playersByVehicle.erase(it);
+
+    // The player may already be driving a new vehicle
+    if (player->vehicleEntity == entity) {
+        player->vehicle = nullptr;
+        player->weapon = nullptr;
     }
-    return nullptr;
 }
 
-HumanData* Game::GetHumanFromEntity(Entity* vehicle) {
+void Game::OnDamage(const DamageEvent* events, size_t count) {
+    // A player can be hit many times in one frame, but the HUD only needs to show the latest hit
+    bool showHitIndicator[4] = { false, false, false, false };
+    const DamageEvent* lastHit[4] = { nullptr, nullptr, nullptr, nullptr };
+    const DamageEvent* lastHitByPlayer[4] = { nullptr, nullptr, nullptr, nullptr };
+    for (size_t i = 0; i < count; ++i) {
+        const DamageEvent& event = events[i];
+        if (event.damage <= 0.f) continue;
+
+        HumanData* attackerPlayer = GetHumanFromPlayer(event.attacker);
+        if (attackerPlayer) showHitIndicator[attackerPlayer - humanPlayers] = true;
+
+        HumanData* myPlayer = GetHumanFromPlayer(event.victim);
+        if (myPlayer) {
+            lastHit[myPlayer - humanPlayers] = &event;
+            if (event.attacker) lastHitByPlayer[myPlayer - humanPlayers] = &event;
+        }
+    }
+
+    for (size_t i = 0; i < 4; ++i) {
+        HumanData* myPlayer = &humanPlayers[i];
+        if (!myPlayer->ready) continue;
+
+        if (showHitIndicator[i]) {
+            Entity* entity = EntityManager::FindFirstChild(myPlayer->camera->GetGuiRoot(), "HitIndicator");
+            GuiComponent* gui = entity->GetComponent<GuiComponent>();
+            GuiHelper::OpacityEffect(gui, 0.5, 0.8f, 0.1, 0.1);
+        }
+
+        if (lastHitByPlayer[i]) {
+            PlayerData* attacker = lastHitByPlayer[i]->attacker;
+            Entity* entity = EntityManager::FindFirstChild(myPlayer->camera->GetGuiRoot(), "DamageIndicator");
+            GuiComponent* gui = entity->GetComponent<GuiComponent>();
+
+            GuiHelper::OpacityEffect(gui, 1.0, 0.8f, 0.25, 0.25);
+
+            // NOTE: This isn't really a tween... but it's a nice hacky use for the tween system
+            // We should probably make a special version of the tween for exactly this case
+            const TweenTag tweenTag("DamageIndicator", myPlayer->id);
+            Tween oldTween = Effects::Instance().FindTween(tweenTag);
+            if (oldTween) Effects::Instance().DestroyTween(oldTween);
+            auto tween = Effects::Instance().CreateTween<float, easing::Linear::easeIn>(0.f, 1.f, 1.0, StateManager::gameTime);
+            tween.SetTag(tweenTag);
+            tween.SetUpdateCallback([gui, myPlayer, attacker](float& value) mutable {
+                if (!myPlayer->alive || !attacker->alive) return;
+                const glm::vec3 cameraPos = myPlayer->camera->GetPosition();
+                const glm::vec3 cameraForward = normalize(Transform::ProjectVectorOnPlane(myPlayer->camera->GetForward(), Transform::UP));
+                const glm::vec3 cameraRight = normalize(Transform::ProjectVectorOnPlane(myPlayer->camera->GetRight(), Transform::UP));
+                const glm::vec3 direction = normalize(Transform::ProjectVectorOnPlane(cameraPos - attacker->vehicleEntity->transform.GetGlobalPosition(), Transform::UP));
+                const float sign = dot(cameraRight, direction) < 0.f ? 1.f : -1.f;
+                const float theta = sign * acos(dot(cameraForward, direction));
+                gui->transform.SetRotationAxisAngles(-Transform::FORWARD, theta);
+            });
+            tween.Start();
+        }
+
+        if (lastHit[i]) {
+            const float healthPercent = glm::max(0.f, lastHit[i]->health) / 1000.f;
+            Entity* entity = EntityManager::FindFirstChild(myPlayer->camera->GetGuiRoot(), "HealthBar");
+            GuiComponent* gui = GuiHelper::GetSecondGui(entity);
+
+            const TweenTag tweenTag("HealthBar", myPlayer->id);
+            Effects::Instance().DestroyTween(tweenTag);
+
+            Transform& mask = gui->GetMask();
+            const glm::vec3 start = mask.GetLocalScale();
+            const glm::vec3 end = gui->transform.GetLocalScale() * glm::vec3(healthPercent, 1.f, 1.f);
+            auto tween = Effects::Instance().CreateTween<glm::vec3, easing::Quint::easeOut>(start, end, 0.1, StateManager::gameTime);
+            tween.SetTag(tweenTag);
+            tween.SetUpdateCallback([&mask](glm::vec3& value) mutable {
+                mask.SetScale(value);
+            });
+            tween.Start();
+        }
+    }
+}
+
+void Game::OnKill(const KillEvent& event) {
+    PlayerData* victim = event.victim;
+    PlayerData* attacker = event.attacker;
+
     for (size_t i = 0; i < 4; ++i) {
         HumanData& player = humanPlayers[i];
         if (!player.ready) continue;
-        if (player.vehicleEntity == vehicle) return &player;
+        Entity* killFeed = EntityManager::FindFirstChild(player.camera->GetGuiRoot(), "KillFeed");
+
+        Entity* row = ContentManager::LoadEntity("Menu/KillFeedRow.json", killFeed);
+        FrameVector<GuiComponent*> guis = row->GetComponents<GuiComponent>();
+        GuiComponent* player0Gui = guis[0];
+        GuiComponent* player1Gui = guis[1];
+        GuiComponent* weaponGui = guis[2];
+        
+        vector<Entity*> rows = EntityManager::GetChildren(killFeed);
+
+        player1Gui->SetText(victim->name);
+        if (gameData.gameMode == GameModeType::Team) player1Gui->SetFontColor(victim->teamIndex ? ContentManager::COLOR_LIGHT_RED : ContentManager::COLOR_LIGHT_GREEN);
+        const glm::vec2 fontDims = player1Gui->GetFontDimensions();
+        
+        Texture* weaponTexture;
+        if (attacker) weaponTexture = ContentManager::GetTexture(WeaponType::texturePaths[attacker->weaponType]);
+        else weaponTexture = ContentManager::GetTexture("HUD/skull.png");
+        
+        weaponGui->SetTexture(weaponTexture);
+        weaponGui->transform.Translate(-glm::vec3(fontDims.x + 10.f, 0.f, 0.f));
+        
+        if (attacker) {
+            player0Gui->SetText(attacker->name);
+            if (gameData.gameMode == GameModeType::Team) player0Gui->SetFontColor(attacker->teamIndex ? ContentManager::COLOR_LIGHT_RED : ContentManager::COLOR_LIGHT_GREEN);
+        }
+        player0Gui->transform.Translate(-glm::vec3(fontDims.x + 50.f, 0.f, 0.f));
+
+        constexpr size_t maxCount = 5;
+
+        const TweenTag tweenTag("KillFeed", player.id);
+        Tween oldTween = Effects::Instance().FindTween(tweenTag);
+        if (oldTween) Effects::Instance().DestroyTween(oldTween);
+
+        auto tween = Effects::Instance().CreateTween<float, easing::Quint::easeOut>(0.f, 1.f, 0.5, StateManager::gameTime);
+        tween.SetTag(tweenTag);
+        tween.SetUpdateCallback([rows, maxCount](float& value) mutable {
+            for (int j = 0; j < rows.size(); ++j) {
+                Entity* row = rows[j];
+
+                // Tween in position
+                float start = 30.f * (static_cast<int>(rows.size()) - 2 - j);
+                float end = 30.f * (static_cast<int>(rows.size()) - 1 - j);
+                GuiHelper::SetGuiYPositions(row, 20.f + glm::mix(start, end, value));
+
+                // Tween in/out opacity
+                for (GuiComponent* gui : row->GetComponents<GuiComponent>()) {
+                    if (rows.size() >= maxCount && j < rows.size() - maxCount) {
+                        gui->SetOpacity(1.f - value);
+                    } else if (gui->GetTextureOpacity() < 1.f || gui->GetFontOpacity() < 1.f) {
+                        gui->SetOpacity(value);
+                    }
+                }
+            }
+        });
+
+        if (rows.size() >= maxCount) {
+            tween.SetFinishedCallback([rows, maxCount](float& value) mutable {
+                for (size_t i = 0; i < rows.size() - maxCount; ++i) {
+                    EntityManager::DestroyEntity(rows[i]);
+                }
+            });
+        }
+
+        tween.Start();
+    }
+}
+
+HumanData* Game::GetHumanFromEntity(Entity* vehicle) {
+    HumanData* player = GetHumanFromPlayer(GetPlayerFromEntity(vehicle));
+    if (!player || !player->ready) return nullptr;
+    return player;
+}
+
+HumanData* Game::GetHumanFromPlayer(PlayerData* player) {
+    for (size_t i = 0; i < 4; ++i) {
+        if (player == &humanPlayers[i]) return &humanPlayers[i];
     }
     return nullptr;
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "System.h"
 #include <vector>
+#include <unordered_map>
 #include "Content/NavigationMesh.h"
 #include "../Components/PowerUpComponents/PowerUp.h"
 #include "Content/HeightMap.h"
@@ -11,7 +12,11 @@
 
 class CameraComponent;
 class AiComponent;
+class VehicleComponent;
+class WeaponComponent;
 class SuicideWeaponComponent;
+class DamageEvent;
+class KillEvent;
 
 struct GameModeType {
     enum { Team = 0, FreeForAll, Count };
@@ -47,6 +52,8 @@ struct WeaponType {
     static const std::string texturePaths[Count];
 };
 
+struct PlayerData;
+
 struct TeamData {
     TeamData() : killCount(0), deathCount(0), size(0) {}
 
@@ -55,12 +62,15 @@ struct TeamData {
 	size_t size;
     std::string name;
     size_t index;
+
+    // Everyone on the team, so that enemies can be walked team by team without checking each pair
+    std::vector<PlayerData*> members;
 };
 
 struct PlayerData {
     PlayerData(int _vehicleType = VehicleType::Heavy, int _weaponType = WeaponType::MachineGun) :
         name(""), vehicleType(_vehicleType), weaponType(_weaponType),
-        alive(false), vehicleEntity(nullptr),
+        alive(false), vehicleEntity(nullptr), vehicle(nullptr), weapon(nullptr),
         teamIndex(0), killCount(0), deathCount(0), activePowerUp(nullptr) {
 	
 		static int nextId = 0;
@@ -78,6 +88,11 @@ struct PlayerData {
     bool alive;
     Entity* vehicleEntity;
 
+    // Components of vehicleEntity, cached on spawn so hot paths don't search the entity for them.
+    // The vehicle is also the rigidbody. Both are cleared when the vehicle entity is destroyed.
+    VehicleComponent* vehicle;
+    WeaponComponent* weapon;
+
     // Gamemode state
 	std::string name;
     size_t teamIndex;
@@ -171,14 +186,29 @@ public:
     NavigationMesh *GetNavigationMesh() const;
     HeightMap* GetHeightMap() const;
 
+    // Constant time lookups through the registry of spawned vehicles
     static PlayerData* GetPlayerFromEntity(Entity* vehicle);
     static HumanData* GetHumanFromEntity(Entity* vehicle);
+    static HumanData* GetHumanFromPlayer(PlayerData* player);
+
 private:
 	// No instantiation or copying
 	Game();
 	Game(const Game&) = delete;
 	Game& operator= (const Game&) = delete;
 
+    static void OnDamage(const DamageEvent* events, size_t count);
+    static void OnKill(const KillEvent& event);
+    static void OnEntityDestroyed(Entity* entity);
+
+    static void RegisterVehicle(PlayerData& player);
+
+    // Spawned vehicle entities to their players. Keyed on the entity rather than its id so that stale target pointers
+    // held by the AI can still be looked up after their vehicle is gone. That's only correct because OnEntityDestroyed
+    // erases the entry before the entity is deleted: a new entity can be allocated at the same address, and a
+    // leftover entry would hand its lookups the old vehicle's player.
+    static std::unordered_map<Entity*, PlayerData*> playersByVehicle;
+
     Map* map;
 
 	SuicideWeaponComponent* suicide;
@@ -8,7 +8,10 @@
 #include "FTGL/ftgl.h"
 
 #include <iostream>
+#include <cstddef>
 #include "Content/ContentManager.h"
+#include "Content/ContentStreamer.h"
+#include "Content/StartupProfile.h"
 #include <glm/gtx/string_cast.hpp>
 #include "../Entities/EntityManager.h"
 #include "../Components/GuiComponents/GuiComponent.h"
@@ -19,6 +22,8 @@
 #include "../Components/RigidbodyComponents/RigidbodyComponent.h"
 #include "../Components/Colliders/BoxCollider.h"
 #include "Game.h"
+#include "Effects.h"
+#include "Audio.h"
 #include "../Components/AiComponent.h"
 #include "../Components/LineComponent.h"
 #include "../Components/BillboardComponent.h"
@@ -38,15 +43,13 @@ const std::string Graphics::SKYBOX_VERTEX_SHADER = "skybox.vert";
 const std::string Graphics::SKYBOX_FRAGMENT_SHADER = "skybox.frag";
 const std::string Graphics::SCREEN_VERTEX_SHADER = "screen.vert";
 const std::string Graphics::SCREEN_FRAGMENT_SHADER = "screen.frag";
-const std::string Graphics::BLUR_VERTEX_SHADER = SCREEN_VERTEX_SHADER;
-const std::string Graphics::BLUR_FRAGMENT_SHADER = "blur.frag";
-const std::string Graphics::COPY_VERTEX_SHADER = SCREEN_VERTEX_SHADER;
-const std::string Graphics::COPY_FRAGMENT_SHADER = SCREEN_FRAGMENT_SHADER;
-const std::string Graphics::NAV_VERTEX_SHADER = "navMesh.vert";
-const std::string Graphics::NAV_FRAGMENT_SHADER = "navMesh.frag";
-const std::string Graphics::NAV_GEOMETRY_SHADER = "navMesh.geom";
-const std::string Graphics::PATH_VERTEX_SHADER = "path.vert";
-const std::string Graphics::PATH_FRAGMENT_SHADER = "path.frag";
+const std::string Graphics::BLOOM_VERTEX_SHADER = SCREEN_VERTEX_SHADER;
+const std::string Graphics::BLOOM_DOWNSAMPLE_FRAGMENT_SHADER = "bloomDownsample.frag";
+const std::string Graphics::BLOOM_UPSAMPLE_FRAGMENT_SHADER = "bloomUpsample.frag";
+const std::string Graphics::BLOOM_DOWNSAMPLE_COMPUTE_SHADER = "bloomDownsample.comp";
+const std::string Graphics::BLOOM_UPSAMPLE_COMPUTE_SHADER = "bloomUpsample.comp";
+const std::string Graphics::DEBUG_DRAW_VERTEX_SHADER = "debugDraw.vert";
+const std::string Graphics::DEBUG_DRAW_FRAGMENT_SHADER = "debugDraw.frag";
 const std::string Graphics::GUI_VERTEX_SHADER = SCREEN_VERTEX_SHADER;
 const std::string Graphics::GUI_FRAGMENT_SHADER = "gui.frag";
 const std::string Graphics::BILLBOARD_VERTEX_SHADER = "billboard.vert";
@@ -73,7 +76,16 @@ Graphics::Graphics() : framesPerSecond(0.0), lastTime(0.0), frameCount(0), scene
                        renderMeshes(true),
                        renderGuis(true), renderPhysicsColliders(false), renderPhysicsBoundingBoxes(false),
                        renderNavigationMesh(false), renderNavigationPaths(false), bloomEnabled(true),
-                       bloomScale(0.1f) { }
+                       bloomComputeEnabled(false), bloomScale(0.1f), bloomIntensity(1.f),
+                       bloomLevelCount(BLOOM_DEFAULT_LEVEL_COUNT), layeredViewportsSupported(false),
+                       layeredViewportsEnabled(false), lodEnabled(true), lodPixelError(LOD_DEFAULT_PIXEL_ERROR),
+                       drawnTriangleCount(0), occlusionCullingEnabled(true), occlusionTestedCount(0),
+                       occlusionCulledCount(0), occlusionTime(0.0), depthPrepassEnabled(true),
+                       fragmentQueriesSupported(false), fragmentQueryIndex(0), litFragmentCount(0), debugFont(nullptr),
+                       dynamicResolutionEnabled(false), renderScale(1.f), renderWidth(SCREEN_WIDTH), renderHeight(SCREEN_HEIGHT),
+                       targetWidth(SCREEN_WIDTH), targetHeight(SCREEN_HEIGHT),
+                       frameTimerIndex(0), gpuFrameTime(0.0), cpuFrameTime(0.0), lastSwapTime(0.0),
+                       persistentMappingEnabled(false), renderState(RenderStateBackend::GetGl()) { }
 
 Graphics &Graphics::Instance() {
 	static Graphics instance;
@@ -151,6 +163,9 @@ bool Graphics::Initialize(char* windowTitle) {
 	glfwGetWindowSize(window, &width, &height); //check resize
 	windowWidth = width;
 	windowHeight = height;
+    renderWidth = targetWidth = std::max(windowWidth, static_cast<size_t>(1));
+    renderHeight = targetHeight = std::max(windowHeight, static_cast<size_t>(1));
+    lastSwapTime = glfwGetTime();
 
 	// Sets the sky color
 	glClearColor(SKY_COLOR.r, SKY_COLOR.g, SKY_COLOR.b, 1.0f);
@@ -176,30 +191,61 @@ bool Graphics::Initialize(char* windowTitle) {
     skyboxCube = ContentManager::GetMesh("Cube.obj");
     sunTexture = ContentManager::GetTexture("SunStrip.png");
 
+    debugFont = new FTGLPixmapFont("./Content/Fonts/arial.ttf");
+    debugFont->FaceSize(DEBUG_TEXT_SIZE);
+
 	return true;
 }
 
+size_t CountCameras(unsigned int cameraMask) {
+    size_t count = 0;
+    for (; cameraMask != 0; cameraMask &= cameraMask - 1) count++;
+    return count;
+}
+
+const void* GetIndexOffset(GLenum indexType, size_t firstIndex) {
+    const size_t indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    return reinterpret_cast<const void*>(firstIndex * indexSize);
+}
+
 bool IsMoreOpaque(const Component* lhs, const Component* rhs) {
     const MeshComponent* lhsMesh = static_cast<const MeshComponent*>(lhs);
     const MeshComponent* rhsMesh = static_cast<const MeshComponent*>(rhs);
     return lhsMesh->GetMaterial()->diffuseColor.a > rhsMesh->GetMaterial()->diffuseColor.a;
 }
 
-void Graphics::Update() {
-	glfwPollEvents();			// Should this be here or in InputManager?
+bool IsOpaque(const MeshComponent* model) {
+    return model->GetMaterial()->diffuseColor.a >= 1.f;
+}
+
+SystemAccess Graphics::GetAccess() const {
+    // The scene graph window can edit any entity
+    if (sceneGraphShown) return SystemAccess();
 
+    // Otherwise draws the scene, which needs the GL context. Drawing still changes entities, sorting each emitter's
+    // particles and fitting each camera's aspect ratio to its viewport, so systems that read them (e.g. Audio, off the
+    // main thread) mustn't run alongside.
+    unsigned int reads = SystemResource_GameState | SystemResource_Physics | SystemResource_Navigation | SystemResource_Content;
+
+    // The debug window shows the voice counts, which Audio writes as it updates
+    if (debugGuiShown) reads |= SystemResource_Audio;
+
+    return SystemAccess(reads, SystemResource_Render | SystemResource_Entities, true);
+}
+
+void Graphics::Update() {
 	// Get components
-	const vector<Component*> pointLights = EntityManager::GetComponents(ComponentType_PointLight);
-	const vector<Component*> directionLights = EntityManager::GetComponents(ComponentType_DirectionLight);
-	const vector<Component*> spotLights = EntityManager::GetComponents(ComponentType_SpotLight);
-	vector<Component*> meshes = EntityManager::GetComponents(ComponentType_Mesh);
-	const vector<Component*> lines = EntityManager::GetComponents(ComponentType_Line);
-	const vector<Component*> cameraComponents = EntityManager::GetComponents(ComponentType_Camera);
-	const vector<Component*> aiComponents = EntityManager::GetComponents(ComponentType_AI);
-	const vector<Component*> guiComponents = EntityManager::GetComponents(ComponentType_GUI);
-	const vector<Component*> billboardComponents = EntityManager::GetComponents(ComponentType_Billboard);
-	vector<Component*> particleEmitterComponents = EntityManager::GetComponents(ComponentType_ParticleEmitter);
-    const vector<Component*> rigidbodyComponents = EntityManager::GetComponents({
+	const FrameVector<Component*> pointLights = EntityManager::GetComponents(ComponentType_PointLight);
+	const FrameVector<Component*> directionLights = EntityManager::GetComponents(ComponentType_DirectionLight);
+	const FrameVector<Component*> spotLights = EntityManager::GetComponents(ComponentType_SpotLight);
+	FrameVector<Component*> meshes = EntityManager::GetComponents(ComponentType_Mesh);
+	const FrameVector<Component*> lines = EntityManager::GetComponents(ComponentType_Line);
+	const FrameVector<Component*> cameraComponents = EntityManager::GetComponents(ComponentType_Camera);
+	const FrameVector<Component*> aiComponents = EntityManager::GetComponents(ComponentType_AI);
+	const FrameVector<Component*> guiComponents = EntityManager::GetComponents(ComponentType_GUI);
+	const FrameVector<Component*> billboardComponents = EntityManager::GetComponents(ComponentType_Billboard);
+	FrameVector<Component*> particleEmitterComponents = EntityManager::GetComponents(ComponentType_ParticleEmitter);
+    const FrameVector<Component*> rigidbodyComponents = EntityManager::GetComponents({
         ComponentType_RigidDynamic,
         ComponentType_RigidStatic,
         ComponentType_Vehicle,
@@ -208,6 +254,33 @@ void Graphics::Update() {
 
     sort(meshes.begin(), meshes.end(), IsMoreOpaque);
 
+    // Start writing this frame's lights, cameras and dynamic vertices
+    dynamicBuffer.BeginFrame();
+    drawnTriangleCount = 0;
+
+    // Time the whole frame on the GPU, and pick this frame's scale from the last frame time that's come back
+    frameTimerIndex = (frameTimerIndex + 1) % FRAME_TIMER_QUERY_COUNT;
+    const GLuint frameTimer = frameTimerIds[frameTimerIndex];
+    if (frameTimersPending[frameTimerIndex]) {
+        GLuint available = 0;
+        glGetQueryObjectuiv(frameTimer, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(frameTimer, GL_QUERY_RESULT, &elapsed);
+            gpuFrameTime = elapsed * 1e-9;
+            if (dynamicResolutionEnabled) {
+                resolutionScaler.Update(cpuFrameTime, gpuFrameTime, frameTimerScales[frameTimerIndex]);
+            }
+        }
+    }
+    UpdateRenderTargets();
+    glBeginQuery(GL_TIME_ELAPSED, frameTimer);
+    frameTimersPending[frameTimerIndex] = true;
+    frameTimerScales[frameTimerIndex] = renderScale;
+
+    // Uploads and ImGui have set GL state since the last frame, so nothing cached can be trusted
+    renderState.BeginFrame();
+
     // Get the active cameras and setup their viewports
     LoadCameras(cameraComponents);
 
@@ -243,27 +316,36 @@ void Graphics::Update() {
 
 		// Use the shadow program
 		ShaderProgram *shadowProgram = shaders[Shaders::ShadowMap];
-		glUseProgram(shadowProgram->GetId());
+		renderState.UseProgram(shadowProgram->GetId());
 
 		// Draw the scene
-		glViewport(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+		renderState.Viewport(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
+        const Frustum shadowFrustum(depthProjectionMatrix * depthViewMatrix);
 		for (size_t j = 0; j < meshes.size(); j++) {
 			// Get enabled models
 			MeshComponent* model = static_cast<MeshComponent*>(meshes[j]);
 			if (!model->enabled) continue;
 
-			// Load the depth model view projection matrix into the GPU
+            // Skip models outside the shadow map, e.g. terrain chunks off the edge of it
+            Mesh *mesh = model->GetMesh();
 			const glm::mat4 depthModelMatrix = model->transform.GetTransformationMatrix();
+            if (!shadowFrustum.Intersects(mesh->GetBoundsMin(), mesh->GetBoundsMax(), depthModelMatrix)) continue;
+
+			// Load the depth model view projection matrix into the GPU
 			const glm::mat4 depthModelViewProjectionMatrix = depthProjectionMatrix * depthViewMatrix * depthModelMatrix;
             shadowProgram->LoadUniform(UniformName::DepthModelViewProjectionMatrix, depthModelViewProjectionMatrix);
 
             // Load the mesh's triangles and vertices into the GPU
-            Mesh *mesh = model->GetMesh();
-            glBindVertexArray(mesh->vaos[VAOs::Vertices]);
+            renderState.BindVertexArray(mesh->vaos[VAOs::Vertices]);
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->eabs[EABs::Triangles]);
 
-			// Render the model
-            glDrawElements(GL_TRIANGLES, mesh->triangleCount * 3, GL_UNSIGNED_INT, nullptr);
+			// Render the model at the level of detail it covers in the shadow map
+            const size_t level = SelectLod(mesh, depthModelMatrix, depthProjectionMatrix, static_cast<float>(SHADOW_MAP_SIZE),
+                glm::vec3(0.f), model->lod.shadowLevel);
+            model->lod.shadowLevel = static_cast<uint8_t>(level);
+            const MeshLod& lod = mesh->GetLods()[level];
+            glDrawElements(GL_TRIANGLES, lod.indexCount, mesh->GetIndexType(), GetIndexOffset(mesh->GetIndexType(), lod.indexOffset));
+            drawnTriangleCount += lod.indexCount / 3;
 		}
 	}
 
@@ -277,14 +359,16 @@ void Graphics::Update() {
     // Clear the buffer and enable back-face culling
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // Every camera's viewport at once, for draws to pick from by camera index
+    LoadCameraViewports();
+
 	// Use the geometry shader program
 	ShaderProgram *geometryProgram = shaders[Shaders::Geometry];
-	glUseProgram(geometryProgram->GetId());
+	renderState.UseProgram(geometryProgram->GetId());
 
 	// Load shader map into GPU
 	if (shadowCaster != nullptr) {
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, textureIds[Textures::ShadowMap]);
+		renderState.BindTexture(1, GL_TEXTURE_2D, textureIds[Textures::ShadowMap]);
         geometryProgram->LoadUniform(UniformName::ShadowMap, 1);
         geometryProgram->LoadUniform(UniformName::ShadowsEnabled, true);
     } else {
@@ -300,264 +384,144 @@ void Graphics::Update() {
 
 	// Draw the scene
     if (renderMeshes) {
+        // Find the cameras that can see each model: those whose frustum it's in, less those it's hidden from
+        FrameVector<glm::mat4> modelMatrices(meshes.size());
+        FrameVector<unsigned int> cameraMasks(meshes.size(), 0);
         for (size_t j = 0; j < meshes.size(); j++) {
-            // Get enabled models
             MeshComponent* model = static_cast<MeshComponent*>(meshes[j]);
             if (!model->enabled) continue;
+            modelMatrices[j] = model->transform.GetTransformationMatrix();
+            cameraMasks[j] = GetCameraMask(model->GetMesh(), modelMatrices[j]);
+        }
+        if (occlusionCullingEnabled) CullOccluded(meshes, modelMatrices, cameraMasks);
+
+        // Meshes are sorted most opaque first, so the opaque ones lead. They're ordered front to back by the nearest
+        // camera that sees them, and the transparent ones keep their order after them.
+        const size_t cameraCount = cameras.size();
+        FrameVector<float> viewDepths(meshes.size() * cameraCount, 0.f);
+        FrameVector<float> nearestDepths(meshes.size(), 0.f);
+        FrameVector<size_t> order(meshes.size());
+        size_t opaqueCount = 0;
+        for (size_t j = 0; j < meshes.size(); j++) {
+            order[j] = j;
+            const MeshComponent* model = static_cast<MeshComponent*>(meshes[j]);
+            if (IsOpaque(model)) opaqueCount = j + 1;
+            if (cameraMasks[j] == 0) continue;
+
+            nearestDepths[j] = INFINITY;
+            for (size_t i = 0; i < cameraCount; ++i) {
+                if ((cameraMasks[j] & (1 << i)) == 0) continue;
+                const float depth = GetViewDepth(cameras[i], model->GetMesh(), modelMatrices[j]);
+                viewDepths[j * cameraCount + i] = depth;
+                nearestDepths[j] = std::min(nearestDepths[j], depth);
+            }
+        }
+        sort(order.begin(), order.begin() + opaqueCount, [&nearestDepths](size_t lhs, size_t rhs) {
+            return nearestDepths[lhs] < nearestDepths[rhs];
+        });
+
+        if (depthPrepassEnabled) {
+            DrawDepthPrepass(meshes, order, opaqueCount, modelMatrices, cameraMasks, viewDepths);
+
+            // The opaque models' depths are all in, so they're only lit where they're in front
+            renderState.UseProgram(geometryProgram->GetId());
+            renderState.DepthFunc(GL_EQUAL);
+            renderState.DepthMask(false);
+        }
+
+        // Count how many fragments lighting is run for, reading back a count from a few frames ago
+        GLuint fragmentQuery = 0;
+        if (fragmentQueriesSupported) {
+            fragmentQueryIndex = (fragmentQueryIndex + 1) % FRAGMENT_QUERY_COUNT;
+            fragmentQuery = fragmentQueryIds[fragmentQueryIndex];
+            if (fragmentQueriesPending[fragmentQueryIndex]) {
+                GLuint available = GL_FALSE;
+                glGetQueryObjectuiv(fragmentQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (available) glGetQueryObjectui64v(fragmentQuery, GL_QUERY_RESULT, &litFragmentCount);
+            }
+            glBeginQuery(GL_FRAGMENT_SHADER_INVOCATIONS_ARB, fragmentQuery);
+            fragmentQueriesPending[fragmentQueryIndex] = true;
+        }
+
+        for (size_t k = 0; k < meshes.size(); k++) {
+            // Transparent models blend over what's behind them, so they test and write depth as usual
+            if (k == opaqueCount && depthPrepassEnabled) {
+                renderState.DepthFunc(GL_LEQUAL);
+                renderState.DepthMask(true);
+            }
+
+            // Skip models no camera can see before loading anything for them
+            const size_t j = order[k];
+            MeshComponent* model = static_cast<MeshComponent*>(meshes[j]);
+            const glm::mat4& modelMatrix = modelMatrices[j];
+            const unsigned int cameraMask = cameraMasks[j];
+            if (cameraMask == 0) continue;
 
             // Load the model's triangles, vertices, uvs, normals, materials, and textures into the GPU
             LoadModel(geometryProgram, model);
 
             if (shadowCaster != nullptr) {
                 // Load the depth bias model view projection matrix into the GPU
-                const glm::mat4 depthModelMatrix = model->transform.GetTransformationMatrix();
+                const glm::mat4 depthModelMatrix = modelMatrix;
                 const glm::mat4 depthModelViewProjectionMatrix = depthProjectionMatrix * depthViewMatrix * depthModelMatrix;
                 const glm::mat4 depthBiasMVP = BIAS_MATRIX*depthModelViewProjectionMatrix;
                 geometryProgram->LoadUniform(UniformName::DepthBiasModelViewProjectionMatrix, depthBiasMVP);
             }
 
-            for (Camera camera : cameras) {
-                // Setup the viewport for each camera (split-screen)
-                glViewport(camera.viewportPosition.x, camera.viewportPosition.y, camera.viewportSize.x, camera.viewportSize.y);
-
-                // Load the model view projection matrix into the GPU
-                const glm::mat4 modelViewProjectionMatrix = camera.projectionMatrix * camera.viewMatrix * model->transform.GetTransformationMatrix();
-                geometryProgram->LoadUniform(UniformName::ViewMatrix, camera.viewMatrix);
-                geometryProgram->LoadUniform(UniformName::ModelViewProjectionMatrix, modelViewProjectionMatrix);
-
-                // Render the model
-                glDrawElements(GL_TRIANGLES, model->GetMesh()->triangleCount * 3, GL_UNSIGNED_INT, nullptr);
-            }
+            // Render the model for every camera that can see it, at the level of detail each one needs
+            DrawMesh(geometryProgram, cameraMask, model->GetMesh(), modelMatrix, model->lod);
         }
 
-        ShaderProgram *pathProgram = shaders[Shaders::Path];
-        glUseProgram(pathProgram->GetId());
+        if (fragmentQuery != 0) glEndQuery(GL_FRAGMENT_SHADER_INVOCATIONS_ARB);
+        if (depthPrepassEnabled) {
+            renderState.DepthFunc(GL_LEQUAL);
+            renderState.DepthMask(true);
+        }
 
+        // Lines (e.g. bullet trails) are drawn with the debug lines, in the same draw
         for (size_t j = 0; j < lines.size(); ++j) {
             LineComponent* line = static_cast<LineComponent*>(lines[j]);
             if (!line->enabled) continue;
-
-            pathProgram->LoadUniform(UniformName::DiffuseColor, line->GetColor());
-            pathProgram->LoadUniform(UniformName::MaterialEmissiveness, 1.f);
-
-            // Load the vertices to the GPU
-            glBindVertexArray(line->GetVaoId());
-
-            for (Camera camera : cameras) {
-                // Setup the viewport for each camera (split-screen)
-                glViewport(camera.viewportPosition.x, camera.viewportPosition.y, camera.viewportSize.x, camera.viewportSize.y);
-
-                // Load the model view projection matrix into the GPU
-                const glm::mat4 viewProjectionMatrix = camera.projectionMatrix * camera.viewMatrix;
-                pathProgram->LoadUniform(UniformName::ViewProjectionMatrix, viewProjectionMatrix);
-
-                // Draw the nav mesh's points
-                glDrawArrays(GL_LINE_STRIP, 0, line->GetPointCount());
-            }
-        }
-
-        glUseProgram(geometryProgram->GetId());
-    }
-
-    // -------------------------------------------------------------------------------------------------------------- //
-    // RENDER PHYSICS COLLIDERS
-    // -------------------------------------------------------------------------------------------------------------- //
-
-    if (renderPhysicsColliders || renderPhysicsBoundingBoxes) {
-        // Use wireframe polygon mode
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-
-        for (size_t j = 0; j < rigidbodyComponents.size(); j++) {
-            // Get enabled models
-            RigidbodyComponent* rigidbody = static_cast<RigidbodyComponent*>(rigidbodyComponents[j]);
-            if (!rigidbody->enabled) continue;
-
-            if (renderPhysicsColliders) {
-                for (Collider *collider : rigidbody->colliders) {
-                    // Check if the collider has a render mesh
-                    Mesh *renderMesh = collider->GetRenderMesh();
-                    if (!renderMesh) continue;
-
-                    // Get the global transformation matrix of the collider
-                    const glm::mat4 modelMatrix = collider->GetGlobalTransform().GetTransformationMatrix();
-
-                    // Load the model's triangles, vertices, uvs, normals, and textures into the GPU
-                    LoadModel(
-                        geometryProgram,
-                        modelMatrix,
-                        ContentManager::GetMaterial("PhysicsCollider.json"),
-                        renderMesh
-                    );
-
-                    if (shadowCaster != nullptr) {
-                        // Load the depth bias model view projection matrix into the GPU
-                        const glm::mat4 depthModelMatrix = modelMatrix;
-                        const glm::mat4 depthModelViewProjectionMatrix = depthProjectionMatrix * depthViewMatrix * depthModelMatrix;
-                        const glm::mat4 depthBiasMVP = BIAS_MATRIX*depthModelViewProjectionMatrix;
-                        geometryProgram->LoadUniform(UniformName::DepthBiasModelViewProjectionMatrix, depthBiasMVP);
-                    }
-
-                    for (Camera camera : cameras) {
-                        // Setup the viewport for each camera (split-screen)
-                        glViewport(camera.viewportPosition.x, camera.viewportPosition.y, camera.viewportSize.x, camera.viewportSize.y);
-
-                        // Load the model view projection matrix into the GPU
-                        const glm::mat4 modelViewProjectionMatrix = camera.projectionMatrix * camera.viewMatrix * modelMatrix;
-                        geometryProgram->LoadUniform(UniformName::ViewMatrix, camera.viewMatrix);
-                        geometryProgram->LoadUniform(UniformName::ModelViewProjectionMatrix, modelViewProjectionMatrix);
-
-                        // Render the model
-                        glDrawElements(GL_TRIANGLES, renderMesh->triangleCount * 3, GL_UNSIGNED_INT, static_cast<void*>(nullptr));
-                    }
-                }
-            }
-
-            if (renderPhysicsBoundingBoxes) {
-                Mesh *cubeMesh = skyboxCube;
-                
-                PxBounds3 bounds = rigidbody->pxRigid->getWorldBounds(0.5f);
-                Transform transform = Transform(nullptr,
-                    Transform::FromPx(bounds.getCenter()),
-                    Transform::FromPx(bounds.getDimensions()), glm::vec3(0.f));
-                
-                const glm::mat4 modelMatrix = transform.GetTransformationMatrix();
-                
-                LoadModel(
-                    geometryProgram,
-                    modelMatrix,
-                    ContentManager::GetMaterial("PhysicsBoundingBox.json"),
-                    cubeMesh
-                );
-
-                if (shadowCaster != nullptr) {
-                    // Load the depth bias model view projection matrix into the GPU
-                    const glm::mat4 depthModelMatrix = modelMatrix;
-                    const glm::mat4 depthModelViewProjectionMatrix = depthProjectionMatrix * depthViewMatrix * depthModelMatrix;
-                    const glm::mat4 depthBiasMVP = BIAS_MATRIX*depthModelViewProjectionMatrix;
-                    geometryProgram->LoadUniform(UniformName::DepthBiasModelViewProjectionMatrix, depthBiasMVP);
-                }
-
-                for (Camera camera : cameras) {
-                    // Setup the viewport for each camera (split-screen)
-                    glViewport(camera.viewportPosition.x, camera.viewportPosition.y, camera.viewportSize.x, camera.viewportSize.y);
-
-                    // Load the model view projection matrix into the GPU
-                    const glm::mat4 modelViewProjectionMatrix = camera.projectionMatrix * camera.viewMatrix * modelMatrix;
-                    geometryProgram->LoadUniform(UniformName::ViewMatrix, camera.viewMatrix);
-                    geometryProgram->LoadUniform(UniformName::ModelViewProjectionMatrix, modelViewProjectionMatrix);
-
-                    // Render the model
-                    glDrawElements(GL_TRIANGLES, cubeMesh->triangleCount * 3, GL_UNSIGNED_INT, static_cast<void*>(nullptr));
-                }
-            }
+            debugDraw.LineStrip(line->GetPoints().data(), line->GetPointCount(), line->GetColor());
         }
-
-        // Reset polygon mode
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     }
 
     // -------------------------------------------------------------------------------------------------------------- //
-    // RENDER NAVIGATION MESH
+    // RENDER DEBUG DRAWING
     // -------------------------------------------------------------------------------------------------------------- //
 
-
-    if (renderNavigationMesh) {
-        glDisable(GL_CULL_FACE);
-        Game &game = Game::Instance();
-        NavigationMesh *mesh = game.GetNavigationMesh();
-        if (mesh) {
-            // Use the geometry shader program
-            ShaderProgram *navProgram = shaders[Shaders::NavMesh];
-            glUseProgram(navProgram->GetId());
-
-            // Load the vertices to the GPU
-            glBindVertexArray(mesh->vao);
-
-            // Load the texture to the GPU
-            Texture *texture = ContentManager::GetTexture("NavMeshStrip.png");
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, texture->textureId);
-            navProgram->LoadUniform(UniformName::DiffuseTexture, 0);
-
-            for (Camera camera : cameras) {
-                // Setup the viewport for each camera (split-screen)
-                glViewport(camera.viewportPosition.x, camera.viewportPosition.y, camera.viewportSize.x, camera.viewportSize.y);
-
-                // Load the model view projection matrix into the GPU
-                const glm::mat4 viewProjectionMatrix = camera.projectionMatrix * camera.viewMatrix;
-                navProgram->LoadUniform(UniformName::ViewProjectionMatrix, viewProjectionMatrix);
-
-                // Draw the nav mesh's points
-                glDrawArrays(GL_POINTS, 0, mesh->GetVertexCount());
-            }
-        }
-        glEnable(GL_CULL_FACE);
-    }
-
-    
-    // -------------------------------------------------------------------------------------------------------------- //
-    // RENDER NAVIGATION PATHS
-    // -------------------------------------------------------------------------------------------------------------- //
-
-    if (renderNavigationPaths) {
-        for (Component *component : aiComponents) {
-            if (!component->enabled) continue;
-            AiComponent *ai = static_cast<AiComponent*>(component);
-
-            // Use the geometry shader program
-            ShaderProgram *pathProgram = shaders[Shaders::Path];
-            glUseProgram(pathProgram->GetId());
-
-            // Load the vertices to the GPU
-            glBindVertexArray(ai->pathVao);
-
-            pathProgram->LoadUniform(UniformName::DiffuseColor, glm::vec3(1.f, 0.5f, 0.f));
-            pathProgram->LoadUniform(UniformName::MaterialEmissiveness, 1.f);
-
-            for (Camera camera : cameras) {
-                // Setup the viewport for each camera (split-screen)
-                glViewport(camera.viewportPosition.x, camera.viewportPosition.y, camera.viewportSize.x, camera.viewportSize.y);
-
-                // Load the model view projection matrix into the GPU
-                const glm::mat4 viewProjectionMatrix = camera.projectionMatrix * camera.viewMatrix;
-                pathProgram->LoadUniform(UniformName::ViewProjectionMatrix, viewProjectionMatrix);
-
-                // Draw the nav mesh's points
-                glDrawArrays(GL_LINE_STRIP, 0, ai->GetPathLength());
-            }
-        }
-    }
+    // Colliders, bounds, the nav mesh and AI paths, along with anything else drawn this frame. Overlays come last.
+    AddDebugViews(rigidbodyComponents, aiComponents);
+    DrawDebug(false);
 
     // -------------------------------------------------------------------------------------------------------------- //
     // RENDER SKYBOX
     // -------------------------------------------------------------------------------------------------------------- //
 
     // Disable face culling for billboards and the skybox
-    glDisable(GL_CULL_FACE);
+    renderState.SetEnabled(GL_CULL_FACE, false);
 
     // Render to the default framebuffer
     glBindFramebuffer(GL_FRAMEBUFFER, fboIds[FBOs::Screen]);
 
     // Use the skybox shader program
     ShaderProgram *skyboxProgram = shaders[Shaders::Skybox];
-    glUseProgram(skyboxProgram->GetId());
+    renderState.UseProgram(skyboxProgram->GetId());
 
     // Load the skybox texture to the GPU
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, ContentManager::GetSkybox());
+    renderState.BindTexture(0, GL_TEXTURE_CUBE_MAP, ContentManager::GetSkybox());
     skyboxProgram->LoadUniform(UniformName::SkyboxTexture, 0);
 
     // Load the color adjustment to the GPU
     skyboxProgram->LoadUniform(UniformName::SkyboxColor, glm::vec3(1.5f, 1.2f, 1.2f));
 
     // Load the skybox geometry into the GPU
-    glBindVertexArray(skyboxCube->vaos[VAOs::Vertices]);
+    renderState.BindVertexArray(skyboxCube->vaos[VAOs::Vertices]);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, skyboxCube->eabs[EABs::Triangles]);
 
     // Load the sun data into the GPU
     if (shadowCaster != nullptr) {
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, sunTexture->textureId);
+        renderState.BindTexture(1, GL_TEXTURE_2D, sunTexture->textureId);
         skyboxProgram->LoadUniform(UniformName::SunTexture, 1);
         skyboxProgram->LoadUniform(UniformName::SunSizeRadians, glm::radians(10.f));
         skyboxProgram->LoadUniform(UniformName::SunDirection, shadowCaster->GetDirection());
@@ -565,20 +529,11 @@ void Graphics::Update() {
 
     skyboxProgram->LoadUniform(UniformName::Time, StateManager::globalTime.GetSeconds());
 
-    for (Camera camera : cameras) {
-        // Setup the viewport for each camera (split-screen)
-        glViewport(camera.viewportPosition.x, camera.viewportPosition.y, camera.viewportSize.x, camera.viewportSize.y);
-
-        // Load the view projection matrix into the GPU
-        const glm::mat4 viewProjectionMatrix = camera.projectionMatrix * glm::mat4(glm::mat3(camera.viewMatrix));
-        skyboxProgram->LoadUniform(UniformName::ViewProjectionMatrix, viewProjectionMatrix);
-
-        // Render the skybox
-        glDrawElements(GL_TRIANGLES, skyboxCube->triangleCount * 3, GL_UNSIGNED_INT, nullptr);
-    }
+    // Render the skybox for every camera
+    DrawElements(skyboxProgram, GetAllCamerasMask(), GL_TRIANGLES, skyboxCube->triangleCount * 3, skyboxCube->GetIndexType());
 
     // Re-enable face culling
-    glEnable(GL_CULL_FACE);
+    renderState.SetEnabled(GL_CULL_FACE, true);
 
     // -------------------------------------------------------------------------------------------------------------- //
     // RENDER BILLBOARDS
@@ -586,7 +541,7 @@ void Graphics::Update() {
 
     // Use the billboard shader program
     ShaderProgram *billboardProgram = shaders[Shaders::Billboard];
-    glUseProgram(billboardProgram->GetId());
+    renderState.UseProgram(billboardProgram->GetId());
 
     // Load the billboard geometry
     /*glBindVertexArray(billboardVao);
@@ -610,7 +565,7 @@ void Graphics::Update() {
 
     for (Camera camera : cameras) {
     // Setup the viewport for each camera (split-screen)
-    glViewport(camera.viewportPosition.x, camera.viewportPosition.y, camera.viewportSize.x, camera.viewportSize.y);
+    glViewport(camera.renderViewportPosition.x, camera.renderViewportPosition.y, camera.renderViewportSize.x, camera.renderViewportSize.y);
 
     // Load the view projection matrix and camera right and up vectors into the GPU
     const glm::mat4 viewProjectionMatrix = camera.projectionMatrix * camera.viewMatrix;
@@ -625,39 +580,40 @@ void Graphics::Update() {
     }
     }*/
 
-    glDepthMask(GL_FALSE);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    for (Camera camera : cameras) {
-        // Setup the viewport for each camera (split-screen)
-        glViewport(camera.viewportPosition.x, camera.viewportPosition.y, camera.viewportSize.x, camera.viewportSize.y);
-
-        // Load the view projection matrix and camera right and up vectors into the GPU
-        const glm::mat4 viewProjectionMatrix = camera.projectionMatrix * camera.viewMatrix;
-        const glm::vec3 cameraRight = normalize(glm::vec3(viewProjectionMatrix[0][0], viewProjectionMatrix[1][0], viewProjectionMatrix[2][0]));
-        const glm::vec3 cameraUp = normalize(glm::vec3(viewProjectionMatrix[0][1], viewProjectionMatrix[1][1], viewProjectionMatrix[2][1]));
-        billboardProgram->LoadUniform(UniformName::ViewProjectionMatrix, viewProjectionMatrix);
-        billboardProgram->LoadUniform(UniformName::CameraRight, cameraRight);
-        billboardProgram->LoadUniform(UniformName::CameraUp, cameraUp);
+    renderState.DepthMask(false);
+    renderState.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Layered viewports draw each emitter once for every camera, so emitters and their particles are sorted once from
+    // the cameras' average position. Otherwise each camera sorts and draws for itself.
+    const size_t sortCount = layeredViewportsEnabled ? std::min(cameras.size(), static_cast<size_t>(1)) : cameras.size();
+    for (size_t i = 0; i < sortCount; ++i) {
+        glm::vec3 sortPosition = cameras[i].position;
+        unsigned int cameraMask = 1 << i;
+        if (layeredViewportsEnabled) {
+            sortPosition = glm::vec3(0.f);
+            for (const Camera& camera : cameras) {
+                sortPosition += camera.position / static_cast<float>(cameras.size());
+            }
+            cameraMask = GetAllCamerasMask();
+        }
 
-        sort(particleEmitterComponents.begin(), particleEmitterComponents.end(), [&camera](const Component* lhs, const Component* rhs) -> bool {
+        sort(particleEmitterComponents.begin(), particleEmitterComponents.end(), [&sortPosition](const Component* lhs, const Component* rhs) -> bool {
             const ParticleEmitterComponent* lhsEmitter = static_cast<const ParticleEmitterComponent*>(lhs);
             const ParticleEmitterComponent* rhsEmitter = static_cast<const ParticleEmitterComponent*>(rhs);
             const glm::vec3 lhsPosition = lhsEmitter->transform.parent->GetGlobalPosition() + lhsEmitter->transform.GetLocalPosition();
             const glm::vec3 rhsPosition = rhsEmitter->transform.parent->GetGlobalPosition() + rhsEmitter->transform.GetLocalPosition();
-            return length(lhsPosition - camera.position) > length(rhsPosition - camera.position);
+            return length(lhsPosition - sortPosition) > length(rhsPosition - sortPosition);
         });
 
         for (Component* component : particleEmitterComponents) {
             if (!component->enabled) continue;
             ParticleEmitterComponent* emitter = static_cast<ParticleEmitterComponent*>(component);
 
-            emitter->Sort(camera.position);
+            emitter->Sort(sortPosition);
 
             // Load the billboard's texture to the GPU
             Texture* texture = emitter->GetTexture();
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, texture->textureId);
+            renderState.BindTexture(0, GL_TEXTURE_2D, texture->textureId);
             billboardProgram->LoadUniform(UniformName::DiffuseTexture, 0);
 
             // Load the billboard's UV scale to the GPU
@@ -689,328 +645,98 @@ void Graphics::Update() {
                 billboardProgram->LoadUniform("animationCycles", emitter->GetAnimationCycles());
             }
 
-            glBindVertexArray(emitter->GetVao());
+            // Load the sorted particles to the GPU
+            const std::vector<Particle>& particles = emitter->GetParticles();
+            if (!LoadDynamicVertices(dynamicVaoIds[DynamicVAOs::Particles], particles.data(), sizeof(Particle) * particles.size(), sizeof(Particle))) continue;
 
             // Render the billboard
-            glDrawArrays(GL_POINTS, 0, emitter->GetParticleCount());
+            DrawArrays(billboardProgram, cameraMask, GL_POINTS, emitter->GetParticleCount());
         }
     }
 
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDepthMask(GL_TRUE);
+    renderState.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    renderState.DepthMask(true);
 
-    // Load the screen geometry (this will be used by all subsequent draw calls)
-    glBindVertexArray(screenVao);
+    // Debug overlays go over the whole scene, under the GUI
+    DrawDebug(true);
 
     // -------------------------------------------------------------------------------------------------------------- //
     // RENDER GAME GUI
     // -------------------------------------------------------------------------------------------------------------- //
 
-    // Get the GUI program
-    ShaderProgram *guiProgram = shaders[Shaders::GUI];
-
-    if (renderGuis) {
-        glDisable(GL_DEPTH_TEST);
-        glDepthMask(GL_FALSE);
-
-        glClear(GL_DEPTH_BUFFER_BIT);
-
-        for (Camera camera : cameras) {
-            // Setup the viewport for each camera (split-screen)
-            glViewport(camera.viewportPosition.x, camera.viewportPosition.y, camera.viewportSize.x, camera.viewportSize.y);
-
-            for (Component *component : guiComponents) {
-                if (!component->enabled) continue;
-                GuiComponent *gui = static_cast<GuiComponent*>(component);
-
-                // Get a GUI for this camera
-                Entity *guiRoot = gui->GetGuiRoot();
-                if (!guiRoot || guiRoot != camera.guiRoot) continue;
-
-                if (gui->IsMaskEnabled() || gui->IsClipEnabled()) {
-                    // Enable stencil test and writing to stencil buffer and clear the stencil buffer
-                    glEnable(GL_STENCIL_TEST);
-                    glStencilMask(0xFF);
-                    glClear(GL_STENCIL_BUFFER_BIT);
-
-                    // Write a 1 at every pixel we write to
-                    glStencilFunc(GL_ALWAYS, 1, 0xFF);
-                    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-
-                    // Only write to stencil buffer
-                    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-                    glDepthMask(GL_FALSE);
-
-                    // Don't write pixels when they are transparent
-                    glEnable(GL_ALPHA_TEST);
-                    glAlphaFunc(GL_GREATER, 0.f);
-
-                    // Use the GUI program
-                    glUseProgram(guiProgram->GetId());
-
-                    // Set the viewport
-                    glViewport(0, 0, windowWidth, windowHeight);
-
-                    // Load the color to the GPU
-                    guiProgram->LoadUniform(UniformName::DiffuseColor, glm::vec4(1.f));
-                    guiProgram->LoadUniform(UniformName::IsSprite, false);
-
-                    if (gui->IsClipEnabled()) {
-                        // Send the UV scale and texture color to the GPU
-                        guiProgram->LoadUniform(UniformName::DiffuseTextureEnabled, false);
+    // Drawn into the scene so it glows with it, unless the scene may be scaled. Then it goes over the composite instead,
+    // at native resolution.
+    if (!dynamicResolutionEnabled) {
+        DrawDebugText();
+        if (renderGuis) RenderGuis(guiComponents);
+    }
 
-                        // Send the transform to the GPU
-                        const glm::mat4 modelMatrix = gui->transform.GetGuiTransformationMatrix(
-                            gui->GetAnchorPoint(),
-                            gui->GetScaledPosition(),
-                            gui->GetScaledScale(),
-                            camera.viewportPosition,
-                            camera.viewportSize,
-                            glm::vec2(windowWidth, windowHeight));
-                        guiProgram->LoadUniform(UniformName::ModelMatrix, modelMatrix);
-
-                        // Render it
-                        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-                    }
-                    else if (gui->IsMaskEnabled()) {
-                        // Send the UV scale and texture color to the GPU
-                        Texture* maskTexture = gui->GetMaskTexture();
-                        if (maskTexture) {
-                            guiProgram->LoadUniform(UniformName::DiffuseTexture, maskTexture);
-                            guiProgram->LoadUniform(UniformName::DiffuseTextureEnabled, true);
-                        }
-                        else {
-                            guiProgram->LoadUniform(UniformName::DiffuseTextureEnabled, false);
-                        }
-
-                        // Send the transform to the GPU
-                        Transform mask = Transform(
-                            gui->transform.GetLocalPosition() + gui->GetMask().GetLocalPosition(),
-                            gui->GetMask().GetLocalScale(),
-                            gui->GetMask().GetLocalRotation());
-                        const glm::mat4 modelMatrix = mask.GetGuiTransformationMatrix(
-                            gui->GetAnchorPoint(),
-                            gui->GetScaledPosition(),
-                            gui->GetScaledScale(),
-                            camera.viewportPosition,
-                            camera.viewportSize,
-                            glm::vec2(windowWidth, windowHeight));
-                        guiProgram->LoadUniform(UniformName::ModelMatrix, modelMatrix);
-
-                        // Render it
-                        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-                    }
+    // Load the screen geometry (this will be used by all subsequent draw calls)
+    renderState.BindVertexArray(screenVao);
 
-                    // Only write with correct stencil value
-                    if (gui->IsMaskEnabled() && gui->IsMaskInverted()) {
-                        glStencilFunc(GL_EQUAL, 0, 0xFF);
-                    }
-                    else {
-                        glStencilFunc(GL_EQUAL, 1, 0xFF);
-                    }
+    // -------------------------------------------------------------------------------------------------------------- //
+    // RENDER POST-PROCESSING EFFECTS (BLOOM)
+    // -------------------------------------------------------------------------------------------------------------- //
 
-                    // No more alpha testing
-                    glDisable(GL_ALPHA_TEST);
+    if (bloomEnabled) {
+        // The compute path needs GL 4.3, and falls back to the fragment path without it
+        const bool useCompute = bloomComputeEnabled && shaders[Shaders::BloomDownsampleCompute];
 
-                    // Write to all buffers except stencil
-                    glStencilMask(0x00);
-                    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-                    glDepthMask(GL_TRUE);
-                }
+        // Render to the glow framebuffer, one level at a time
+        glBindFramebuffer(GL_FRAMEBUFFER, fboIds[FBOs::GlowEffect]);
 
-                // RENDER THE FRAME
-                Texture *frameTexture = gui->GetTexture();
-                if (frameTexture) {
-                    // Use the GUI program
-                    glUseProgram(guiProgram->GetId());
+        for (const BloomPass& pass : bloomPasses) {
+            // The composite happens with the screen below
+            if (pass.type == BloomPass_Composite) continue;
 
-                    // Send the screen to the GPU
-                    glActiveTexture(GL_TEXTURE0);
-                    glBindTexture(GL_TEXTURE_2D, frameTexture->textureId);
-                    guiProgram->LoadUniform(UniformName::DiffuseTexture, 0);
+            const bool downsample = pass.type == BloomPass_Downsample;
+            const GLuint source = pass.source == BLOOM_SOURCE_LEVEL ? textureIds[Textures::ScreenGlow] : bloomLevelIds[pass.source];
+            const GLuint target = bloomLevelIds[pass.target];
 
-                    // Send the UV scale and texture color to the GPU
-                    guiProgram->LoadUniform(UniformName::UvScale, gui->GetUvScale());
-                    guiProgram->LoadUniform(UniformName::DiffuseColor, gui->GetTextureColor());
-                    guiProgram->LoadUniform(UniformName::DiffuseTextureEnabled, true);
-                    guiProgram->LoadUniform(UniformName::MaterialEmissiveness, gui->GetEmissiveness());
-
-                    guiProgram->LoadUniform(UniformName::IsSprite, gui->IsSprite());
-                    if (gui->IsSprite()) {
-                        guiProgram->LoadUniform(UniformName::TextureSize, glm::vec2(frameTexture->width, frameTexture->height));
-                        guiProgram->LoadUniform(UniformName::SpriteSize, gui->GetSpriteSize());
-                        guiProgram->LoadUniform(UniformName::SpriteOffset, gui->GetSpriteOffset());
-                    }
+            // Both levels are only used up to the render size, so the source's UVs are scaled down to that part
+            glm::vec2 uvScale, texelSize;
+            GetTargetUvs(pass.source, uvScale, texelSize);
 
-                    // Send the transform to the GPU
-                    const glm::mat4 modelMatrix = gui->transform.GetGuiTransformationMatrix(
-                        gui->GetAnchorPoint(),
-                        gui->GetScaledPosition(),
-                        gui->GetScaledScale(),
-                        camera.viewportPosition,
-                        camera.viewportSize,
-                        glm::vec2(windowWidth, windowHeight));
-                    guiProgram->LoadUniform(UniformName::ModelMatrix, modelMatrix);
+            renderState.BindTexture(0, GL_TEXTURE_2D, source);
 
-                    // Render it
-                    glViewport(0, 0, windowWidth, windowHeight);
-                    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-                }
+            if (useCompute) {
+                ShaderProgram *program = shaders[downsample ? Shaders::BloomDownsampleCompute : Shaders::BloomUpsampleCompute];
+                renderState.UseProgram(program->GetId());
+                program->LoadUniform(UniformName::ImageTexture, 0);
+                program->LoadUniform(UniformName::ImageUvScale, uvScale);
+                program->LoadUniform(UniformName::TexelSize, texelSize);
+                program->LoadUniform(UniformName::TargetSize, glm::vec2(pass.width, pass.height));
 
-                // RENDER THE FONT
-
-                // Get the font
-                FTFont *font = gui->GetFont();
-
-                // Font dimensions
-                const glm::vec2 fontDims = gui->GetFontDimensions();
-
-                // Get the scale and position of the GUI
-                const glm::vec2 anchorPoint = gui->GetAnchorPoint();
-                const glm::vec3 scale = gui->transform.GetGlobalScale() +
-                    glm::vec3(camera.viewportSize * gui->GetScaledScale(), 0.f);
-                const glm::vec3 position = gui->transform.GetGlobalPosition() +
-                    glm::vec3(camera.viewportSize * gui->GetScaledPosition(), 0.f);
-
-                const glm::vec3 fontPosition = position;
-                glm::vec2 fontScreenPosition = camera.viewportPosition +
-                    glm::vec2(fontPosition.x, camera.viewportSize.y - fontPosition.y - fontDims.y);
-
-                glm::vec2 alignmentXOffset = glm::vec2(scale.x - fontDims.x, 0.f);
-                switch (gui->GetTextXAlignment()) {
-                case TextXAlignment::Left:
-                    alignmentXOffset *= 0.f;
-                    break;
-                case TextXAlignment::Centre:
-                    alignmentXOffset *= 0.5f;
-                    break;
-                case TextXAlignment::Right:
-                    alignmentXOffset *= 1.f;
-                    break;
-                }
+                glBindImageTexture(0, target, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R11F_G11F_B10F);
+                glDispatchCompute((pass.width + BLOOM_WORK_GROUP_SIZE - 1) / BLOOM_WORK_GROUP_SIZE,
+                    (pass.height + BLOOM_WORK_GROUP_SIZE - 1) / BLOOM_WORK_GROUP_SIZE, 1);
 
-                glm::vec2 alignmentYOffset = -glm::vec2(0.f, scale.y - fontDims.y);
-                switch (gui->GetTextYAlignment()) {
-                case TextYAlignment::Top:
-                    alignmentYOffset *= 0.f;
-                    break;
-                case TextYAlignment::Centre:
-                    alignmentYOffset *= 0.5f;
-                    break;
-                case TextYAlignment::Bottom:
-                    alignmentYOffset *= 1.f;
-                    break;
+                // The next pass samples what this one wrote
+                glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+            } else {
+                ShaderProgram *program = shaders[downsample ? Shaders::BloomDownsample : Shaders::BloomUpsample];
+                renderState.UseProgram(program->GetId());
+                program->LoadUniform(UniformName::ModelMatrix, glm::mat4(1.f));
+                program->LoadUniform(UniformName::ImageTexture, 0);
+                program->LoadUniform(UniformName::ImageUvScale, uvScale);
+                program->LoadUniform(UniformName::TexelSize, texelSize);
+
+                // Downsamples overwrite their level, upsamples add onto it
+                if (downsample) {
+                    renderState.SetEnabled(GL_BLEND, false);
+                } else {
+                    renderState.SetEnabled(GL_BLEND, true);
+                    renderState.BlendFunc(GL_ONE, GL_ONE);
                 }
 
-                fontScreenPosition += alignmentXOffset + alignmentYOffset - glm::vec2(scale.x, -scale.y) * anchorPoint;
-
-                // Unbind shader program
-                glUseProgram(0);
-
-                // Set stuff
-                glPushAttrib(GL_ALL_ATTRIB_BITS);
-
-                // Write to the color buffer
-                glColorMaski(1, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-                const glm::vec4 color = gui->GetFontColor();
-
-                // Set the color
-                glPixelTransferf(GL_RED_BIAS, color.r - 1.f);
-                glPixelTransferf(GL_GREEN_BIAS, color.g - 1.f);
-                glPixelTransferf(GL_BLUE_BIAS, color.b - 1.f);
-                glPixelTransferf(GL_ALPHA_BIAS, color.a - 1.f);
-                font->Render(gui->GetText().c_str(), -1, FTPoint(fontScreenPosition.x, fontScreenPosition.y));
-
-                glColorMaski(1, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-                glColorMaski(0, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-
-                // Set the color
-                const glm::vec4 emissiveColor = color * gui->GetEmissiveness() * 1.5f;
-                glPixelTransferf(GL_RED_BIAS, emissiveColor.r - 1.f);
-                glPixelTransferf(GL_GREEN_BIAS, emissiveColor.g - 1.f);
-                glPixelTransferf(GL_BLUE_BIAS, emissiveColor.b - 1.f);
-                glPixelTransferf(GL_ALPHA_BIAS, emissiveColor.a - 1.f);
-                font->Render(gui->GetText().c_str(), -1, FTPoint(fontScreenPosition.x, fontScreenPosition.y));
-
-                glColorMaski(0, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-
-                // Reset stuff
-                glPopAttrib();
-
-                if (gui->IsMaskEnabled() || gui->IsClipEnabled()) {
-                    glDisable(GL_STENCIL_TEST);
-                }
+                renderState.Viewport(0, 0, pass.width, pass.height);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target, 0);
+                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
             }
         }
 
-        glDepthMask(GL_TRUE);
-        glDisable(GL_STENCIL_TEST);
-        glEnable(GL_DEPTH_TEST);
-    }
-
-    // -------------------------------------------------------------------------------------------------------------- //
-    // RENDER POST-PROCESSING EFFECTS (BLOOM)
-    // -------------------------------------------------------------------------------------------------------------- //
-
-    if (bloomEnabled) {
-        // Render to the glow framebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, fboIds[FBOs::GlowEffect]);
-
-        // Use the copy shader program
-        ShaderProgram *copyProgram = shaders[Shaders::Copy];
-        glUseProgram(copyProgram->GetId());
-
-        // Load the identity matrix as the model matrix to the GPU
-        copyProgram->LoadUniform(UniformName::ModelMatrix, glm::mat4(1.f));
-
-        // Load the glow buffer into the GPU
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureIds[Textures::ScreenGlow]);
-        copyProgram->LoadUniform(UniformName::ScreenTexture, 0);
-
-        // Copy the glow buffer to each of the level buffers
-        for (size_t i = 0; i < BLUR_LEVEL_COUNT; ++i) {
-            const float factor = 1.f / pow(2, i);
-            glViewport(0, 0, windowWidth * factor, windowHeight * factor);
-
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, blurLevelIds[i], 0);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        }
-
-        // Use the blur shader program
-        ShaderProgram *blurProgram = shaders[Shaders::Blur];
-        glUseProgram(blurProgram->GetId());
-
-        // Use the first texture location
-        glActiveTexture(GL_TEXTURE0);
-        blurProgram->LoadUniform(UniformName::ImageTexture, 0);
-
-        // Blur each of the level buffers
-        for (size_t i = 0; i < BLUR_LEVEL_COUNT; ++i) {
-            // Get the relevant buffers
-            const GLuint buffer = blurLevelIds[i];
-            const GLuint blurBuffer = blurTempLevelIds[i];
-
-            // Set the right viewport
-            const float factor = 1.f / pow(2, i);
-            glViewport(0, 0, windowWidth * factor, windowHeight * factor);
-
-            // Calculate the blur offsets
-            const float xOffset = 1.2f / (windowWidth * factor);
-            const float yOffset = 1.2f / (windowHeight * factor);
-
-            // Blur on the x-axis
-            glBindTexture(GL_TEXTURE_2D, buffer);
-            blurProgram->LoadUniform(UniformName::BlurOffset, glm::vec2(xOffset, 0.f));
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, blurBuffer, 0);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-            // Blur on the y-axis
-            glBindTexture(GL_TEXTURE_2D, blurBuffer);
-            blurProgram->LoadUniform(UniformName::BlurOffset, glm::vec2(0.f, yOffset));
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, buffer, 0);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        }
+        renderState.SetEnabled(GL_BLEND, true);
+        renderState.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     }
 
     // -------------------------------------------------------------------------------------------------------------- //
@@ -1025,37 +751,49 @@ void Graphics::Update() {
 
     // Use the screen shader program
     ShaderProgram *screenProgram = shaders[Shaders::Screen];
-    glUseProgram(screenProgram->GetId());
+    renderState.UseProgram(screenProgram->GetId());
 
     // Send the screen to the GPU
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textureIds[Textures::Screen]);
+    renderState.BindTexture(0, GL_TEXTURE_2D, textureIds[Textures::Screen]);
     screenProgram->LoadUniform(UniformName::ScreenTexture, 0);
 
+    // A scaled screen only fills the corner of its target, and is upsampled with a sharper filter than bilinear
+    glm::vec2 screenUvScale, screenTexelSize;
+    GetTargetUvs(BLOOM_SOURCE_LEVEL, screenUvScale, screenTexelSize);
+    screenProgram->LoadUniform(UniformName::ScreenScaled, renderWidth != targetWidth || renderHeight != targetHeight);
+    screenProgram->LoadUniform(UniformName::ScreenUvScale, screenUvScale);
+    screenProgram->LoadUniform(UniformName::ScreenTexelSize, screenTexelSize);
+
+    // Send the top bloom level to the GPU, which the upsamples have added the rest of the chain into
+    const bool bloomComposited = bloomEnabled && !bloomPasses.empty();
+    renderState.BindTexture(1, GL_TEXTURE_2D, bloomLevelIds[0]);
+    screenProgram->LoadUniform(UniformName::BloomTexture, 1);
+    screenProgram->LoadUniform(UniformName::BloomIntensity, bloomComposited ? bloomIntensity : 0.f);
+    if (bloomComposited) {
+        glm::vec2 bloomUvScale, bloomTexelSize;
+        GetTargetUvs(bloomPasses.back().source, bloomUvScale, bloomTexelSize);
+        screenProgram->LoadUniform(UniformName::BloomUvScale, bloomUvScale);
+        screenProgram->LoadUniform(UniformName::TexelSize, bloomTexelSize);
+    }
+
 	// Use the identity model matrix
 	screenProgram->LoadUniform(UniformName::ModelMatrix, glm::mat4(1.f));
 
-    // Render it
-    glViewport(0, 0, windowWidth, windowHeight);
+    // Render it, with the bloom added in the same pass
+    renderState.Viewport(0, 0, windowWidth, windowHeight);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-    if (bloomEnabled) {
-        glDepthMask(GL_FALSE);
-        // Disable the depth mask and enable additive blending
-        glBlendFunc(GL_ONE, GL_ONE);
-
-        // Render each blur level
-        for (size_t i = 0; i < BLUR_LEVEL_COUNT; ++i) {
-            glBindTexture(GL_TEXTURE_2D, blurLevelIds[i]);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        }
+    renderState.BindTexture(1, GL_TEXTURE_2D, 0);
+    renderState.ActiveTexture(0);
 
-        // Disable blending and re-enable the depth mask
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDepthMask(GL_TRUE);
+    // The GUI at the window's resolution, however the scene was scaled
+    if (dynamicResolutionEnabled) {
+        DrawDebugText();
+        if (renderGuis) RenderGuis(guiComponents);
     }
+    debugDraw.Clear();
 
-    
+    glEndQuery(GL_TIME_ELAPSED);
 
     // -------------------------------------------------------------------------------------------------------------- //
     // RENDER DEBUG GUI
@@ -1063,8 +801,15 @@ void Graphics::Update() {
 
     RenderDebugGui();
 
+    // Fence this frame's dynamic data so it isn't overwritten before the GPU is done with it
+    dynamicBuffer.EndFrame();
+
+    // Everything but waiting on the swap
+    cpuFrameTime = glfwGetTime() - lastSwapTime;
+
 	//Swap Buffers to Display New Frame
 	glfwSwapBuffers(window);
+    lastSwapTime = glfwGetTime();
 }
 
 void Graphics::SceneChanged() {
@@ -1102,6 +847,39 @@ void Graphics::RenderDebugGui() {
         ImGui::LabelText("Vehicle Count", "%d", EntityManager::GetComponentCount(ComponentType_Vehicle));
         ImGui::LabelText("Rigid Dynamic Count", "%d", EntityManager::GetComponentCount(ComponentType_RigidDynamic));
         ImGui::LabelText("Rigid Static Count", "%d", EntityManager::GetComponentCount(ComponentType_RigidStatic));
+        ImGui::LabelText("Tween Count", "%d", Effects::Instance().GetTweenCount());
+
+        const VoiceManager& voices = Audio::Instance().GetVoices();
+        ImGui::LabelText("Voices (Real / Total)", "%d / %d", voices.GetRealVoiceCount(), voices.GetVoiceCount());
+        ImGui::LabelText("Voices Rejected", "%d", voices.GetRejectedCount());
+
+        const FrameAllocator& frameAllocator = FrameAllocator::Instance();
+        const FrameArena& frameArena = frameAllocator.GetArena();
+        ImGui::LabelText("Heap Allocations", "%d", frameAllocator.GetHeapAllocationCount());
+        ImGui::LabelText("Frame Allocations", "%d", frameArena.GetAllocationCount());
+        ImGui::LabelText("Frame Memory (KB)", "%.1f / %.1f", frameArena.GetLastUsed() / 1024.f, frameArena.GetCapacity() / 1024.f);
+        ImGui::LabelText("Frame Peak (KB)", "%.1f", frameArena.GetPeakUsed() / 1024.f);
+        ImGui::LabelText("Two-Frame Peak (KB)", "%.1f", frameAllocator.GetTwoFrameArena().GetPeakUsed() / 1024.f);
+        ImGui::LabelText("Dynamic Buffer (KB)", "%.1f / %.1f", dynamicBuffer.GetLastUsed() / 1024.f, DYNAMIC_BUFFER_REGION_SIZE / 1024.f);
+        ImGui::LabelText("Dynamic Peak (KB)", "%.1f", dynamicBuffer.GetPeakUsed() / 1024.f);
+        ImGui::LabelText("Texture Memory (MB)", "%.1f", ContentManager::GetTextureMemory() / (1024.f * 1024.f));
+        ImGui::LabelText("Pending Loads", "%d", ContentStreamer::Instance().GetPendingCount());
+        ImGui::LabelText("Triangles Drawn", "%d", drawnTriangleCount);
+        ImGui::LabelText("Debug Vertices", "%d / %d", debugDraw.GetLastVertexCount(), DEBUG_DRAW_MAX_VERTICES);
+        ImGui::LabelText("Occlusion Culled", "%d / %d", occlusionCulledCount, occlusionTestedCount);
+        ImGui::LabelText("Occlusion Time (ms)", "%.2f", occlusionTime * 1000.0);
+        ImGui::LabelText("GL Calls Issued", "%d", renderState.GetIssuedCount());
+        ImGui::LabelText("GL Calls Filtered", "%d", renderState.GetFilteredCount());
+        if (fragmentQueriesSupported) {
+            ImGui::LabelText("Lit Fragments", "%llu", static_cast<unsigned long long>(litFragmentCount));
+            ImGui::LabelText("Overdraw", "%.2fx", static_cast<double>(litFragmentCount) / (renderWidth * renderHeight));
+        } else {
+            ImGui::LabelText("Lit Fragments", "n/a");
+        }
+        ImGui::LabelText("GPU Frame (ms)", "%.2f", gpuFrameTime * 1000.0);
+        ImGui::LabelText("CPU Frame (ms)", "%.2f", cpuFrameTime * 1000.0);
+        ImGui::LabelText("Render Resolution", "%d x %d (%.0f%%)", renderWidth, renderHeight,
+            100.0 * renderWidth / std::max(windowWidth, static_cast<size_t>(1)));
 
         ImGui::Checkbox("Render Meshes", &renderMeshes);
         ImGui::Checkbox("Render GUIs", &renderGuis);
@@ -1111,6 +889,42 @@ void Graphics::RenderDebugGui() {
         ImGui::Checkbox("Render Nav Paths", &renderNavigationPaths);
         ImGui::Checkbox("Bloom Enabled", &bloomEnabled);
         ImGui::DragFloat("Bloom Scale", &bloomScale, 0.01f);
+        ImGui::DragFloat("Bloom Intensity", &bloomIntensity, 0.01f, 0.f, 10.f);
+        if (ImGui::SliderInt("Bloom Levels", &bloomLevelCount, 1, BLOOM_MAX_LEVEL_COUNT)) {
+            BloomChain::BuildPasses(renderWidth, renderHeight, bloomLevelCount, bloomPasses);
+        }
+        if (shaders[Shaders::BloomDownsampleCompute]) {
+            ImGui::Checkbox("Bloom Compute", &bloomComputeEnabled);
+        }
+        if (layeredViewportsSupported) {
+            ImGui::Checkbox("Layered Split-Screen", &layeredViewportsEnabled);
+        }
+        ImGui::Checkbox("Mesh LOD", &lodEnabled);
+        ImGui::Checkbox("Occlusion Culling", &occlusionCullingEnabled);
+        ImGui::Checkbox("Depth Pre-Pass", &depthPrepassEnabled);
+        if (ImGui::Checkbox("Dynamic Resolution", &dynamicResolutionEnabled) && dynamicResolutionEnabled) {
+            resolutionScaler.Reset();
+        }
+        if (dynamicResolutionEnabled) {
+            // Kept here rather than read back, since the scaler rounds them to whole steps
+            static float minScale = RESOLUTION_DEFAULT_MIN_SCALE;
+            static float maxScale = RESOLUTION_DEFAULT_MAX_SCALE;
+            const bool minChanged = ImGui::DragFloat("Min Render Scale", &minScale, 0.01f, RESOLUTION_STEP, 1.f);
+            const bool maxChanged = ImGui::DragFloat("Max Render Scale", &maxScale, 0.01f, RESOLUTION_STEP, 1.f);
+            if (minChanged || maxChanged) resolutionScaler.SetBounds(minScale, maxScale);
+
+            float targetTime = static_cast<float>(resolutionScaler.GetTargetTime() * 1000.0);
+            if (ImGui::DragFloat("Target Frame (ms)", &targetTime, 0.1f, 1.f, 100.f)) {
+                resolutionScaler.SetTargetTime(targetTime / 1000.0);
+            }
+            ImGui::LabelText("Bound By", "%s", resolutionScaler.IsCpuBound() ? "CPU" : "GPU");
+        }
+        ImGui::DragFloat("LOD Pixel Error", &lodPixelError, 0.05f, 0.1f, 16.f);
+        if (GLEW_ARB_buffer_storage && ImGui::Checkbox("Persistent Mapping", &persistentMappingEnabled)) {
+            // The GPU keeps the old buffer alive for anything already drawn from it
+            dynamicBuffer.Destroy();
+            dynamicBuffer.Initialize(persistentMappingEnabled);
+        }
 
         ImGui::End();
     }
@@ -1150,15 +964,14 @@ void Graphics::LoadModel(ShaderProgram *shaderProgram, glm::mat4 modelMatrix, Ma
     shaderProgram->LoadUniform(UniformName::MaterialEmissiveness, material->emissiveness);
 
     // Load the mesh into the GPU
-    glBindVertexArray(mesh->vaos[VAOs::Geometry]);
+    renderState.BindVertexArray(mesh->vaos[VAOs::Geometry]);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->eabs[EABs::Triangles]);
 
     // Load the texture into the GPU
     if (texture != nullptr) {
         shaderProgram->LoadUniform(UniformName::DiffuseTextureEnabled, true);
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture->textureId);
+        renderState.BindTexture(0, GL_TEXTURE_2D, texture->textureId);
         shaderProgram->LoadUniform(UniformName::DiffuseTexture, 0);
 
         shaderProgram->LoadUniform(UniformName::UvScale, uvScale);
@@ -1167,7 +980,7 @@ void Graphics::LoadModel(ShaderProgram *shaderProgram, glm::mat4 modelMatrix, Ma
     }
 }
 
-void Graphics::LoadCameras(std::vector<Component*> cameraComponents) {
+void Graphics::LoadCameras(const FrameVector<Component*>& cameraComponents) {
 	// Find up to MAX_CAMERAS enabled cameras
 	const size_t lastCount = cameras.size();
 	cameras.clear();
@@ -1184,7 +997,8 @@ void Graphics::LoadCameras(std::vector<Component*> cameraComponents) {
 	const size_t count = cameras.size();
 
 	// Update the camera's viewports based on the number of cameras
-	const glm::vec2 windowSize = glm::vec2(windowWidth, windowHeight);
+	const glm::vec2 windowSize = glm::max(glm::vec2(windowWidth, windowHeight), glm::vec2(1.f));
+    const glm::vec2 renderSize = glm::vec2(renderWidth, renderHeight);
 	for (size_t i = 0; i < count; ++i) {
         const glm::vec2 viewportSize = GetViewportSize(i);
 
@@ -1199,42 +1013,660 @@ void Graphics::LoadCameras(std::vector<Component*> cameraComponents) {
 
 		cameras[i].viewportPosition = scale * windowSize;
 		cameras[i].viewportSize = viewportSize;
+
+        // The same split of the scene framebuffer, which may be smaller than the window
+        cameras[i].renderViewportPosition = glm::round(cameras[i].viewportPosition * renderSize / windowSize);
+        cameras[i].renderViewportSize = glm::round((cameras[i].viewportPosition + viewportSize) * renderSize / windowSize) -
+            cameras[i].renderViewportPosition;
 	}
 
+    // Upload every camera's matrices once, for draws to index by camera
+    FrameVector<CameraData> cameraData;
+    for (const Camera& camera : cameras) {
+        CameraData data;
+        data.viewMatrix = camera.viewMatrix;
+        data.projectionMatrix = camera.projectionMatrix;
+        data.viewProjectionMatrix = camera.viewProjectionMatrix;
+        cameraData.push_back(data);
+    }
+    LoadStorageBuffer(SSBOs::Cameras, cameraData.data(), cameraData.size() * sizeof(CameraData));
+
 	UpdateViewports();
 }
 
+void Graphics::LoadCameraViewports() {
+    if (!layeredViewportsEnabled || cameras.empty()) return;
+
+    // glViewport sets every index, so it goes first and the render state knows what index 0 holds
+    const Camera& first = cameras[0];
+    renderState.Viewport(first.renderViewportPosition.x, first.renderViewportPosition.y, first.renderViewportSize.x,
+        first.renderViewportSize.y);
+    for (size_t i = 1; i < cameras.size(); ++i) {
+        const Camera& camera = cameras[i];
+        glViewportIndexedf(i, camera.renderViewportPosition.x, camera.renderViewportPosition.y, camera.renderViewportSize.x,
+            camera.renderViewportSize.y);
+    }
+}
+
+unsigned int Graphics::GetCameraMask(const Mesh* mesh, const glm::mat4& modelMatrix) const {
+    unsigned int cameraMask = 0;
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        if (cameras[i].frustum.Intersects(mesh->GetBoundsMin(), mesh->GetBoundsMax(), modelMatrix)) {
+            cameraMask |= 1 << i;
+        }
+    }
+    return cameraMask;
+}
+
+unsigned int Graphics::GetAllCamerasMask() const {
+    return (1u << cameras.size()) - 1;
+}
+
+size_t Graphics::SelectLod(const Mesh* mesh, const glm::mat4& modelMatrix, const glm::mat4& projectionMatrix,
+    float viewportHeight, const glm::vec3& viewPosition, size_t current) const {
+
+    const std::vector<MeshLod>& lods = mesh->GetLods();
+    if (!lodEnabled || lods.size() < 2) return 0;
+
+    const float screenRadius = LodSelection::GetScreenRadius(projectionMatrix, viewportHeight, mesh->GetBoundsMin(),
+        mesh->GetBoundsMax(), modelMatrix, viewPosition);
+    return LodSelection::Select(lods.data(), lods.size(), screenRadius, lodPixelError, current);
+}
+
+void Graphics::DrawMesh(ShaderProgram* shaderProgram, unsigned int cameraMask, const Mesh* mesh, const glm::mat4& modelMatrix, LodState& lod) {
+    const std::vector<MeshLod>& lods = mesh->GetLods();
+
+    // Cameras that picked the same level still share a draw
+    unsigned int levelMasks[MESH_MAX_LOD_COUNT] = {};
+    for (size_t i = 0; i < cameras.size() && i < LOD_MAX_CAMERAS; ++i) {
+        if ((cameraMask & (1 << i)) == 0) continue;
+
+        const Camera& camera = cameras[i];
+        const size_t level = SelectLod(mesh, modelMatrix, camera.projectionMatrix, static_cast<float>(camera.renderViewportSize.y),
+            camera.position, lod.cameraLevels[i]);
+        lod.cameraLevels[i] = static_cast<uint8_t>(level);
+        levelMasks[level] |= 1 << i;
+    }
+
+    for (size_t level = 0; level < lods.size(); ++level) {
+        DrawElements(shaderProgram, levelMasks[level], GL_TRIANGLES, lods[level].indexCount, mesh->GetIndexType(), lods[level].indexOffset);
+    }
+}
+
+void Graphics::CullOccluded(const FrameVector<Component*>& meshes, const FrameVector<glm::mat4>& modelMatrices,
+    FrameVector<unsigned int>& cameraMasks) {
+
+    const double start = glfwGetTime();
+    occlusionTestedCount = 0;
+    occlusionCulledCount = 0;
+
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        const unsigned int cameraBit = 1 << i;
+        occlusionBuffer.Clear(cameras[i].projectionMatrix, cameras[i].viewMatrix, cameras[i].position);
+        for (size_t j = 0; j < meshes.size(); ++j) {
+            const MeshComponent* model = static_cast<MeshComponent*>(meshes[j]);
+            if ((cameraMasks[j] & cameraBit) == 0 || !model->IsOccluder()) continue;
+            occlusionBuffer.RasterizeOccluder(model->GetMesh()->GetOccluder(), modelMatrices[j]);
+        }
+        if (occlusionBuffer.GetTriangleCount() == 0) continue;
+
+        // Occluders are tested too, so terrain chunks behind hills and walls behind walls are skipped as well
+        for (size_t j = 0; j < meshes.size(); ++j) {
+            if ((cameraMasks[j] & cameraBit) == 0) continue;
+            const Mesh* mesh = static_cast<MeshComponent*>(meshes[j])->GetMesh();
+            occlusionTestedCount++;
+            if (!occlusionBuffer.IsVisible(mesh->GetBoundsMin(), mesh->GetBoundsMax(), modelMatrices[j])) {
+                cameraMasks[j] &= ~cameraBit;
+                occlusionCulledCount++;
+            }
+        }
+    }
+
+    occlusionTime = glfwGetTime() - start;
+}
+
+float Graphics::GetViewDepth(const Camera& camera, const Mesh* mesh, const glm::mat4& modelMatrix) const {
+    const glm::vec3 boundsMin = mesh->GetBoundsMin();
+    const glm::vec3 boundsMax = mesh->GetBoundsMax();
+    const glm::vec4 center = modelMatrix * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.f);
+    const float scale = std::max(glm::length(glm::vec3(modelMatrix[0])),
+        std::max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+    const float radius = glm::length(boundsMax - boundsMin) * 0.5f * scale;
+
+    // The camera looks down -z
+    return -(camera.viewMatrix * center).z - radius;
+}
+
+void Graphics::DrawDepthPrepass(const FrameVector<Component*>& meshes, const FrameVector<size_t>& order, size_t opaqueCount,
+    const FrameVector<glm::mat4>& modelMatrices, const FrameVector<unsigned int>& cameraMasks,
+    const FrameVector<float>& viewDepths) {
+
+    ShaderProgram* depthProgram = shaders[Shaders::DepthPrepass];
+    renderState.UseProgram(depthProgram->GetId());
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+    // Layered draws cover every camera at once, so they go in the shared order. Otherwise each camera draws on its own,
+    // in its own front to back order.
+    const size_t cameraCount = cameras.size();
+    const size_t passCount = layeredViewportsEnabled ? 1 : cameraCount;
+    FrameVector<size_t> cameraOrder(order.begin(), order.begin() + opaqueCount);
+    for (size_t i = 0; i < passCount; ++i) {
+        const unsigned int passMask = layeredViewportsEnabled ? ~0u : 1u << i;
+        if (!layeredViewportsEnabled) {
+            sort(cameraOrder.begin(), cameraOrder.end(), [&viewDepths, cameraCount, i](size_t lhs, size_t rhs) {
+                return viewDepths[lhs * cameraCount + i] < viewDepths[rhs * cameraCount + i];
+            });
+        }
+
+        for (size_t j : cameraOrder) {
+            const unsigned int cameraMask = cameraMasks[j] & passMask;
+            if (cameraMask == 0) continue;
+
+            const MeshComponent* model = static_cast<MeshComponent*>(meshes[j]);
+            const Mesh* mesh = model->GetMesh();
+            depthProgram->LoadUniform(UniformName::ModelMatrix, modelMatrices[j]);
+            renderState.BindVertexArray(mesh->vaos[VAOs::Geometry]);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->eabs[EABs::Triangles]);
+
+            // A copy, so the lit pass makes the same choice and the depths it tests against match exactly
+            LodState lod = model->lod;
+            DrawMesh(depthProgram, cameraMask, mesh, modelMatrices[j], lod);
+        }
+    }
+
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+void Graphics::DrawElements(ShaderProgram* shaderProgram, unsigned int cameraMask, GLenum mode, GLsizei count, GLenum indexType,
+    size_t firstIndex) {
+
+    if (cameraMask == 0) return;
+
+    const void* offset = GetIndexOffset(indexType, firstIndex);
+    drawnTriangleCount += count / 3 * CountCameras(cameraMask);
+
+    // One draw with an instance per camera, each sent to its camera's viewport by the shaders
+    if (layeredViewportsEnabled) {
+        shaderProgram->LoadUniform(UniformName::CameraMask, static_cast<int>(cameraMask));
+        glDrawElementsInstanced(mode, count, indexType, offset, CountCameras(cameraMask));
+        return;
+    }
+
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        if ((cameraMask & (1 << i)) == 0) continue;
+
+        // Setup the viewport for each camera (split-screen)
+        const Camera& camera = cameras[i];
+        renderState.Viewport(camera.renderViewportPosition.x, camera.renderViewportPosition.y, camera.renderViewportSize.x,
+            camera.renderViewportSize.y);
+
+        shaderProgram->LoadUniform(UniformName::CameraMask, 1 << i);
+        glDrawElements(mode, count, indexType, offset);
+    }
+}
+
+void Graphics::DrawArrays(ShaderProgram* shaderProgram, unsigned int cameraMask, GLenum mode, GLsizei count) {
+    if (cameraMask == 0) return;
+
+    // One draw with an instance per camera, each sent to its camera's viewport by the shaders
+    if (layeredViewportsEnabled) {
+        shaderProgram->LoadUniform(UniformName::CameraMask, static_cast<int>(cameraMask));
+        glDrawArraysInstanced(mode, 0, count, CountCameras(cameraMask));
+        return;
+    }
+
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        if ((cameraMask & (1 << i)) == 0) continue;
+
+        // Setup the viewport for each camera (split-screen)
+        const Camera& camera = cameras[i];
+        renderState.Viewport(camera.renderViewportPosition.x, camera.renderViewportPosition.y, camera.renderViewportSize.x,
+            camera.renderViewportSize.y);
+
+        shaderProgram->LoadUniform(UniformName::CameraMask, 1 << i);
+        glDrawArrays(mode, 0, count);
+    }
+}
+
+DebugDraw& Graphics::GetDebugDraw() {
+    return debugDraw;
+}
+
+void Graphics::AddDebugViews(const FrameVector<Component*>& rigidbodyComponents, const FrameVector<Component*>& aiComponents) {
+    if (renderPhysicsColliders || renderPhysicsBoundingBoxes) {
+        const glm::vec4 colliderColor = glm::vec4(0.f, 1.f, 0.f, 1.f);
+        const glm::vec4 boundsColor = glm::vec4(0.f, 1.f, 1.f, 1.f);
+
+        for (Component* component : rigidbodyComponents) {
+            if (!component->enabled) continue;
+            RigidbodyComponent* rigidbody = static_cast<RigidbodyComponent*>(component);
+
+            if (renderPhysicsColliders) {
+                for (Collider *collider : rigidbody->colliders) {
+                    Mesh *renderMesh = collider->GetRenderMesh();
+                    if (!renderMesh) continue;
+
+                    // Boxes and spheres are drawn as such, not as their render meshes' triangles
+                    const glm::mat4 modelMatrix = collider->GetGlobalTransform().GetTransformationMatrix();
+                    switch (collider->GetType()) {
+                    case Collider_Box:
+                        debugDraw.Box(modelMatrix, renderMesh->GetBoundsMin(), renderMesh->GetBoundsMax(), colliderColor);
+                        break;
+                    case Collider_Sphere:
+                        debugDraw.Sphere(modelMatrix, renderMesh->GetRadius(), colliderColor);
+                        break;
+                    default:
+                        debugDraw.WireMesh(renderMesh, modelMatrix, colliderColor);
+                        break;
+                    }
+                }
+            }
+
+            if (renderPhysicsBoundingBoxes) {
+                const PxBounds3 bounds = rigidbody->pxRigid->getWorldBounds(0.5f);
+                debugDraw.Box(Transform::FromPx(bounds.minimum), Transform::FromPx(bounds.maximum), boundsColor);
+            }
+        }
+    }
+
+    NavigationMesh *navigationMesh = Game::Instance().GetNavigationMesh();
+    if (renderNavigationMesh && navigationMesh) {
+        // An upright tick at each vertex, red where it's covered through yellow to green where it's clear
+        const glm::vec3 tick = glm::vec3(0.f, navigationMesh->GetSpacing() * 0.5f, 0.f);
+        const NavigationVertex* vertices = navigationMesh->GetVertices();
+        for (size_t i = 0; i < navigationMesh->GetVertexCount(); ++i) {
+            const float score = vertices[i].score;
+            const glm::vec4 color = glm::vec4(std::min(2.f - 2.f * score, 1.f), std::min(2.f * score, 1.f), 0.f, 1.f);
+            debugDraw.Line(vertices[i].position, vertices[i].position + tick, color);
+        }
+    }
+
+    if (renderNavigationPaths) {
+        const glm::vec4 pathColor = glm::vec4(1.f, 0.5f, 0.f, 1.f);
+        for (Component *component : aiComponents) {
+            if (!component->enabled) continue;
+            AiComponent *ai = static_cast<AiComponent*>(component);
+
+            const std::vector<glm::vec3>& path = ai->GetPath();
+            debugDraw.LineStrip(path.data(), ai->GetPathLength(), pathColor);
+
+            // Where it's headed and what for show through walls
+            if (!ai->FinishedPath()) debugDraw.Sphere(ai->NodeInPath(), 1.f, pathColor, true);
+            const glm::vec3 position = ai->GetEntity()->transform.GetGlobalPosition() + glm::vec3(0.f, 2.f, 0.f);
+            debugDraw.Text(position, ai->GetMode() == AiMode_Attack ? "Attack" : "Powerup", pathColor);
+        }
+    }
+}
+
+void Graphics::DrawDebug(bool overlay) {
+    const std::vector<DebugVertex>& vertices = debugDraw.GetVertices(overlay);
+    const std::vector<DebugMesh>& debugMeshes = debugDraw.GetMeshes(overlay);
+    if (vertices.empty() && debugMeshes.empty()) return;
+
+    ShaderProgram *debugProgram = shaders[Shaders::DebugDraw];
+    renderState.UseProgram(debugProgram->GetId());
+    debugProgram->LoadUniform(UniformName::MaterialEmissiveness, 1.f);
+
+    // Overlays show through everything, and leave the depth buffer as it was
+    if (overlay) {
+        renderState.SetEnabled(GL_DEPTH_TEST, false);
+        renderState.DepthMask(false);
+    }
+
+    // Every line in one draw for every camera
+    debugProgram->LoadUniform(UniformName::ModelMatrix, glm::mat4());
+    if (LoadDynamicVertices(dynamicVaoIds[DynamicVAOs::DebugVertices], vertices.data(), sizeof(DebugVertex) * vertices.size(), sizeof(DebugVertex))) {
+        DrawArrays(debugProgram, GetAllCamerasMask(), GL_LINES, static_cast<GLsizei>(vertices.size()));
+    }
+
+    // Meshes too big to copy (e.g. the terrain's collider) are drawn from their own buffers, their color set as a constant
+    // attribute since their vertex arrays don't have one
+    renderState.PolygonMode(GL_LINE);
+    for (const DebugMesh& debugMesh : debugMeshes) {
+        const Mesh* mesh = debugMesh.mesh;
+        const unsigned int cameraMask = GetCameraMask(mesh, debugMesh.modelMatrix);
+        if (cameraMask == 0) continue;
+
+        debugProgram->LoadUniform(UniformName::ModelMatrix, debugMesh.modelMatrix);
+        renderState.BindVertexArray(mesh->vaos[VAOs::Geometry]);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->eabs[EABs::Triangles]);
+        glVertexAttrib4Nubv(3, reinterpret_cast<const GLubyte*>(&debugMesh.color));
+        DrawElements(debugProgram, cameraMask, GL_TRIANGLES, mesh->triangleCount * 3, mesh->GetIndexType());
+    }
+    renderState.PolygonMode(GL_FILL);
+
+    if (overlay) {
+        renderState.SetEnabled(GL_DEPTH_TEST, true);
+        renderState.DepthMask(true);
+    }
+}
+
+void Graphics::DrawDebugText() {
+    const std::vector<DebugText>& texts = debugDraw.GetTexts();
+    if (texts.empty()) return;
+
+    // Drawn the way GUI text is, with the fixed function pipeline
+    renderState.UseProgram(0);
+    renderState.Viewport(0, 0, windowWidth, windowHeight);
+    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    glColorMaski(1, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+    for (const Camera& camera : cameras) {
+        for (const DebugText& text : texts) {
+            // Skip text behind the camera or off its viewport
+            const glm::vec4 clipPosition = camera.viewProjectionMatrix * glm::vec4(text.position, 1.f);
+            if (clipPosition.w <= 0.f) continue;
+            const glm::vec2 ndcPosition = glm::vec2(clipPosition) / clipPosition.w;
+            if (glm::any(glm::greaterThan(glm::abs(ndcPosition), glm::vec2(1.f)))) continue;
+
+            const FTBBox box = debugFont->BBox(text.text.c_str());
+            const glm::vec2 size = glm::vec2(box.Upper().Xf() - box.Lower().Xf(), box.Upper().Yf() - box.Lower().Yf());
+            const glm::vec2 screenPosition = camera.viewportPosition + (ndcPosition * 0.5f + 0.5f) * camera.viewportSize - size * 0.5f;
+
+            glPixelTransferf(GL_RED_BIAS, text.color.r - 1.f);
+            glPixelTransferf(GL_GREEN_BIAS, text.color.g - 1.f);
+            glPixelTransferf(GL_BLUE_BIAS, text.color.b - 1.f);
+            glPixelTransferf(GL_ALPHA_BIAS, text.color.a - 1.f);
+            debugFont->Render(text.text.c_str(), -1, FTPoint(screenPosition.x, screenPosition.y));
+        }
+    }
+
+    glColorMaski(1, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glPopAttrib();
+}
+
 GLFWwindow* Graphics::GetWindow() const {
 	return window;
 }
 
+void Graphics::RenderGuis(const FrameVector<Component*>& guiComponents) {
+    ShaderProgram *guiProgram = shaders[Shaders::GUI];
+    renderState.BindVertexArray(screenVao);
+
+    renderState.SetEnabled(GL_DEPTH_TEST, false);
+    renderState.DepthMask(false);
+
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    for (Camera camera : cameras) {
+        // Setup the viewport for each camera (split-screen)
+        renderState.Viewport(camera.viewportPosition.x, camera.viewportPosition.y, camera.viewportSize.x, camera.viewportSize.y);
+
+        for (Component *component : guiComponents) {
+            if (!component->enabled) continue;
+            GuiComponent *gui = static_cast<GuiComponent*>(component);
+
+            // Get a GUI for this camera
+            Entity *guiRoot = gui->GetGuiRoot();
+            if (!guiRoot || guiRoot != camera.guiRoot) continue;
+
+            if (gui->IsMaskEnabled() || gui->IsClipEnabled()) {
+                // Enable stencil test and writing to stencil buffer and clear the stencil buffer
+                renderState.SetEnabled(GL_STENCIL_TEST, true);
+                renderState.StencilMask(0xFF);
+                glClear(GL_STENCIL_BUFFER_BIT);
+
+                // Write a 1 at every pixel we write to
+                renderState.StencilFunc(GL_ALWAYS, 1, 0xFF);
+                renderState.StencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+
+                // Only write to stencil buffer
+                glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                renderState.DepthMask(false);
+
+                // Don't write pixels when they are transparent
+                renderState.SetEnabled(GL_ALPHA_TEST, true);
+                glAlphaFunc(GL_GREATER, 0.f);
+
+                // Use the GUI program
+                renderState.UseProgram(guiProgram->GetId());
+
+                // Set the viewport
+                renderState.Viewport(0, 0, windowWidth, windowHeight);
+
+                // Load the color to the GPU
+                guiProgram->LoadUniform(UniformName::DiffuseColor, glm::vec4(1.f));
+                guiProgram->LoadUniform(UniformName::IsSprite, false);
+
+                if (gui->IsClipEnabled()) {
+                    // Send the UV scale and texture color to the GPU
+                    guiProgram->LoadUniform(UniformName::DiffuseTextureEnabled, false);
+
+                    // Send the transform to the GPU
+                    const glm::mat4 modelMatrix = gui->transform.GetGuiTransformationMatrix(
+                        gui->GetAnchorPoint(),
+                        gui->GetScaledPosition(),
+                        gui->GetScaledScale(),
+                        camera.viewportPosition,
+                        camera.viewportSize,
+                        glm::vec2(windowWidth, windowHeight));
+                    guiProgram->LoadUniform(UniformName::ModelMatrix, modelMatrix);
+
+                    // Render it
+                    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+                }
+                else if (gui->IsMaskEnabled()) {
+                    // Send the UV scale and texture color to the GPU
+                    Texture* maskTexture = gui->GetMaskTexture();
+                    if (maskTexture) {
+                        guiProgram->LoadUniform(UniformName::DiffuseTexture, maskTexture);
+                        guiProgram->LoadUniform(UniformName::DiffuseTextureEnabled, true);
+                    }
+                    else {
+                        guiProgram->LoadUniform(UniformName::DiffuseTextureEnabled, false);
+                    }
+
+                    // Send the transform to the GPU
+                    Transform mask = Transform(
+                        gui->transform.GetLocalPosition() + gui->GetMask().GetLocalPosition(),
+                        gui->GetMask().GetLocalScale(),
+                        gui->GetMask().GetLocalRotation());
+                    const glm::mat4 modelMatrix = mask.GetGuiTransformationMatrix(
+                        gui->GetAnchorPoint(),
+                        gui->GetScaledPosition(),
+                        gui->GetScaledScale(),
+                        camera.viewportPosition,
+                        camera.viewportSize,
+                        glm::vec2(windowWidth, windowHeight));
+                    guiProgram->LoadUniform(UniformName::ModelMatrix, modelMatrix);
+
+                    // Render it
+                    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+                }
+
+                // Only write with correct stencil value
+                if (gui->IsMaskEnabled() && gui->IsMaskInverted()) {
+                    renderState.StencilFunc(GL_EQUAL, 0, 0xFF);
+                }
+                else {
+                    renderState.StencilFunc(GL_EQUAL, 1, 0xFF);
+                }
+
+                // No more alpha testing
+                renderState.SetEnabled(GL_ALPHA_TEST, false);
+
+                // Write to all buffers except stencil
+                renderState.StencilMask(0x00);
+                glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                renderState.DepthMask(true);
+            }
+
+            // RENDER THE FRAME
+            Texture *frameTexture = gui->GetTexture();
+            if (frameTexture) {
+                // Use the GUI program
+                renderState.UseProgram(guiProgram->GetId());
+
+                // Send the screen to the GPU
+                renderState.BindTexture(0, GL_TEXTURE_2D, frameTexture->textureId);
+                guiProgram->LoadUniform(UniformName::DiffuseTexture, 0);
+
+                // Send the UV scale and texture color to the GPU
+                guiProgram->LoadUniform(UniformName::UvScale, gui->GetUvScale());
+                guiProgram->LoadUniform(UniformName::DiffuseColor, gui->GetTextureColor());
+                guiProgram->LoadUniform(UniformName::DiffuseTextureEnabled, true);
+                guiProgram->LoadUniform(UniformName::MaterialEmissiveness, gui->GetEmissiveness());
+
+                guiProgram->LoadUniform(UniformName::IsSprite, gui->IsSprite());
+                if (gui->IsSprite()) {
+                    guiProgram->LoadUniform(UniformName::TextureSize, glm::vec2(frameTexture->width, frameTexture->height));
+                    guiProgram->LoadUniform(UniformName::SpriteSize, gui->GetSpriteSize());
+                    guiProgram->LoadUniform(UniformName::SpriteOffset, gui->GetSpriteOffset());
+                }
+
+                // Send the transform to the GPU
+                const glm::mat4 modelMatrix = gui->transform.GetGuiTransformationMatrix(
+                    gui->GetAnchorPoint(),
+                    gui->GetScaledPosition(),
+                    gui->GetScaledScale(),
+                    camera.viewportPosition,
+                    camera.viewportSize,
+                    glm::vec2(windowWidth, windowHeight));
+                guiProgram->LoadUniform(UniformName::ModelMatrix, modelMatrix);
+
+                // Render it
+                renderState.Viewport(0, 0, windowWidth, windowHeight);
+                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            }
+
+            // RENDER THE FONT
+
+            // Get the font
+            FTFont *font = gui->GetFont();
+
+            // Font dimensions
+            const glm::vec2 fontDims = gui->GetFontDimensions();
+
+            // Get the scale and position of the GUI
+            const glm::vec2 anchorPoint = gui->GetAnchorPoint();
+            const glm::vec3 scale = gui->transform.GetGlobalScale() +
+                glm::vec3(camera.viewportSize * gui->GetScaledScale(), 0.f);
+            const glm::vec3 position = gui->transform.GetGlobalPosition() +
+                glm::vec3(camera.viewportSize * gui->GetScaledPosition(), 0.f);
+
+            const glm::vec3 fontPosition = position;
+            glm::vec2 fontScreenPosition = camera.viewportPosition +
+                glm::vec2(fontPosition.x, camera.viewportSize.y - fontPosition.y - fontDims.y);
+
+            glm::vec2 alignmentXOffset = glm::vec2(scale.x - fontDims.x, 0.f);
+            switch (gui->GetTextXAlignment()) {
+            case TextXAlignment::Left:
+                alignmentXOffset *= 0.f;
+                break;
+            case TextXAlignment::Centre:
+                alignmentXOffset *= 0.5f;
+                break;
+            case TextXAlignment::Right:
+                alignmentXOffset *= 1.f;
+                break;
+            }
+
+            glm::vec2 alignmentYOffset = -glm::vec2(0.f, scale.y - fontDims.y);
+            switch (gui->GetTextYAlignment()) {
+            case TextYAlignment::Top:
+                alignmentYOffset *= 0.f;
+                break;
+            case TextYAlignment::Centre:
+                alignmentYOffset *= 0.5f;
+                break;
+            case TextYAlignment::Bottom:
+                alignmentYOffset *= 1.f;
+                break;
+            }
+
+            fontScreenPosition += alignmentXOffset + alignmentYOffset - glm::vec2(scale.x, -scale.y) * anchorPoint;
+
+            // Unbind shader program
+            renderState.UseProgram(0);
+
+            // Set stuff
+            glPushAttrib(GL_ALL_ATTRIB_BITS);
+
+            // Write to the color buffer
+            glColorMaski(1, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            const glm::vec4 color = gui->GetFontColor();
+
+            // Set the color
+            glPixelTransferf(GL_RED_BIAS, color.r - 1.f);
+            glPixelTransferf(GL_GREEN_BIAS, color.g - 1.f);
+            glPixelTransferf(GL_BLUE_BIAS, color.b - 1.f);
+            glPixelTransferf(GL_ALPHA_BIAS, color.a - 1.f);
+            font->Render(gui->GetText().c_str(), -1, FTPoint(fontScreenPosition.x, fontScreenPosition.y));
+
+            glColorMaski(1, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            glColorMaski(0, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+            // Set the color
+            const glm::vec4 emissiveColor = color * gui->GetEmissiveness() * 1.5f;
+            glPixelTransferf(GL_RED_BIAS, emissiveColor.r - 1.f);
+            glPixelTransferf(GL_GREEN_BIAS, emissiveColor.g - 1.f);
+            glPixelTransferf(GL_BLUE_BIAS, emissiveColor.b - 1.f);
+            glPixelTransferf(GL_ALPHA_BIAS, emissiveColor.a - 1.f);
+            font->Render(gui->GetText().c_str(), -1, FTPoint(fontScreenPosition.x, fontScreenPosition.y));
+
+            glColorMaski(0, GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+            // Reset stuff
+            glPopAttrib();
+
+            if (gui->IsMaskEnabled() || gui->IsClipEnabled()) {
+                renderState.SetEnabled(GL_STENCIL_TEST, false);
+            }
+        }
+    }
+
+    renderState.DepthMask(true);
+    renderState.SetEnabled(GL_STENCIL_TEST, false);
+    renderState.SetEnabled(GL_DEPTH_TEST, true);
+}
+
 void Graphics::SetWindowDimensions(size_t width, size_t height) {
 	windowWidth = width;
 	windowHeight = height;
 
+    ResizeRenderTargets();
+    UpdateRenderTargets();
+
+	UpdateViewports();
+}
+
+void Graphics::UpdateRenderTargets() {
+    renderScale = dynamicResolutionEnabled ? resolutionScaler.GetScale() : 1.f;
+    const size_t width = std::max(static_cast<size_t>(std::round(targetWidth * renderScale)), static_cast<size_t>(1));
+    const size_t height = std::max(static_cast<size_t>(std::round(targetHeight * renderScale)), static_cast<size_t>(1));
+    if (width == renderWidth && height == renderHeight) return;
+
+    // Never past the targets, since a scaled frame only draws into part of them
+    renderWidth = std::min(width, targetWidth);
+    renderHeight = std::min(height, targetHeight);
+    BloomChain::BuildPasses(renderWidth, renderHeight, bloomLevelCount, bloomPasses);
+}
+
+void Graphics::ResizeRenderTargets() {
+    targetWidth = std::max(windowWidth, static_cast<size_t>(1));
+    targetHeight = std::max(windowHeight, static_cast<size_t>(1));
+
     glBindTexture(GL_TEXTURE_2D, textureIds[Textures::Screen]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, windowWidth, windowHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, targetWidth, targetHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
 
     glBindTexture(GL_TEXTURE_2D, textureIds[Textures::ScreenGlow]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, windowWidth, windowHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, targetWidth, targetHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
 
     glBindRenderbuffer(GL_RENDERBUFFER, rboIds[RBOs::DepthStencil]);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, windowWidth, windowHeight);
-
-    for (size_t i = 0; i < BLUR_LEVEL_COUNT; ++i) {
-        const float factor = 1.f / pow(2, i);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, targetWidth, targetHeight);
 
-        glBindTexture(GL_TEXTURE_2D, blurLevelIds[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, windowWidth * factor, windowHeight * factor, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-
-        glBindTexture(GL_TEXTURE_2D, blurTempLevelIds[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, windowWidth * factor, windowHeight * factor, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-    }
+    ResizeBloomLevels();
 
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindRenderbuffer(GL_RENDERBUFFER, 0);
+}
 
-	UpdateViewports();
+void Graphics::GetTargetUvs(int level, glm::vec2& uvScale, glm::vec2& texelSize) const {
+    size_t usedWidth, usedHeight, allocatedWidth, allocatedHeight;
+    BloomChain::GetLevelSize(renderWidth, renderHeight, level, usedWidth, usedHeight);
+    BloomChain::GetLevelSize(targetWidth, targetHeight, level, allocatedWidth, allocatedHeight);
+    uvScale = glm::vec2(usedWidth, usedHeight) / glm::vec2(allocatedWidth, allocatedHeight);
+    texelSize = 1.f / glm::vec2(allocatedWidth, allocatedHeight);
 }
 
 void Graphics::UpdateViewports() const {
@@ -1264,25 +1696,25 @@ glm::vec2 Graphics::GetViewportSize(int index) const {
     return windowSize * scale;
 }
 
-void Graphics::LoadLights(std::vector<Component*> _pointLights,
-	std::vector<Component*> _directionLights, std::vector<Component*> _spotLights) {
+void Graphics::LoadLights(const FrameVector<Component*>& _pointLights,
+	const FrameVector<Component*>& _directionLights, const FrameVector<Component*>& _spotLights) {
 
 	// Get the point light data which can be directly passed to the shader	
-	std::vector<PointLight> pointLights;
+	FrameVector<PointLight> pointLights;
 	for (Component *component : _pointLights) {
 		if (component->enabled)
 			pointLights.push_back(static_cast<PointLightComponent*>(component)->GetData());
 	}
 
 	// Get the direction light data which can be directly passed to the shader
-	std::vector<DirectionLight> directionLights;
+	FrameVector<DirectionLight> directionLights;
 	for (Component *component : _directionLights) {
 		if (component->enabled)
 			directionLights.push_back(static_cast<DirectionLightComponent*>(component)->GetData());
 	}
 
 	// Get the spot light data which can be directly passed to the shader
-	std::vector<SpotLight> spotLights;
+	FrameVector<SpotLight> spotLights;
 	for (Component *component : _spotLights) {
 		if (component->enabled)
 			spotLights.push_back(static_cast<SpotLightComponent*>(component)->GetData());
@@ -1291,45 +1723,79 @@ void Graphics::LoadLights(std::vector<Component*> _pointLights,
 	LoadLights(pointLights, directionLights, spotLights);
 }
 
-void Graphics::LoadLights(std::vector<PointLight> pointLights, std::vector<DirectionLight> directionLights, std::vector<SpotLight> spotLights) {
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboIds[SSBOs::PointLights]);
-	glBufferData(GL_SHADER_STORAGE_BUFFER, pointLights.size() * sizeof(PointLight), pointLights.data(), GL_DYNAMIC_COPY);
+void Graphics::LoadLights(const FrameVector<PointLight>& pointLights, const FrameVector<DirectionLight>& directionLights, const FrameVector<SpotLight>& spotLights) {
+	LoadStorageBuffer(SSBOs::PointLights, pointLights.data(), pointLights.size() * sizeof(PointLight));
+	LoadStorageBuffer(SSBOs::DirectionLights, directionLights.data(), directionLights.size() * sizeof(DirectionLight));
+	LoadStorageBuffer(SSBOs::SpotLights, spotLights.data(), spotLights.size() * sizeof(SpotLight));
+}
+
+bool Graphics::LoadDynamicVertices(GLuint vao, const void* data, size_t size, GLsizei stride) {
+    if (size == 0) return false;
 
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboIds[SSBOs::DirectionLights]);
-	glBufferData(GL_SHADER_STORAGE_BUFFER, directionLights.size() * sizeof(DirectionLight), directionLights.data(), GL_DYNAMIC_COPY);
+    DynamicAllocation allocation;
+    if (!dynamicBuffer.Upload(data, size, sizeof(float), allocation)) return false;
 
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboIds[SSBOs::SpotLights]);
-	glBufferData(GL_SHADER_STORAGE_BUFFER, spotLights.size() * sizeof(SpotLight), spotLights.data(), GL_DYNAMIC_COPY);
+    renderState.BindVertexArray(vao);
+    glBindVertexBuffer(0, allocation.buffer, allocation.offset, stride);
+    return true;
+}
+
+void Graphics::LoadStorageBuffer(GLuint index, const void* data, size_t size) {
+    // A range can't be empty, but one shorter than an element reads as an empty array
+    static const GLuint empty = 0;
+    if (size == 0) {
+        data = &empty;
+        size = sizeof(empty);
+    }
 
-	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    DynamicAllocation allocation;
+    if (!dynamicBuffer.Upload(data, size, dynamicBuffer.GetStorageAlignment(), allocation)) return;
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, index, allocation.buffer, allocation.offset, allocation.size);
 }
 
 void Graphics::DestroyIds() {
     glDeleteVertexArrays(2, &screenVao);
     glDeleteBuffers(2, &screenVbo);
-    glDeleteBuffers(SSBOs::Count, ssboIds);
+    glDeleteVertexArrays(DynamicVAOs::Count, dynamicVaoIds);
+    dynamicBuffer.Destroy();
     glDeleteFramebuffers(FBOs::Count, fboIds);
     glDeleteRenderbuffers(RBOs::Count, rboIds);
     glDeleteTextures(Textures::Count, textureIds);
-    glDeleteTextures(BLUR_LEVEL_COUNT, blurLevelIds);
-    glDeleteTextures(BLUR_LEVEL_COUNT, blurTempLevelIds);
+    glDeleteTextures(BLOOM_MAX_LEVEL_COUNT, bloomLevelIds);
+    if (fragmentQueriesSupported) glDeleteQueries(FRAGMENT_QUERY_COUNT, fragmentQueryIds);
+    glDeleteQueries(FRAME_TIMER_QUERY_COUNT, frameTimerIds);
     for (int i = 0; i < Shaders::Count; i++) {
-        glDeleteProgram(shaders[i]->GetId());
+        if (shaders[i]) glDeleteProgram(shaders[i]->GetId());
     }
 }
 
 void Graphics::GenerateIds() {
     glGenVertexArrays(2, &screenVao);
     glGenBuffers(2, &screenVbo);
-	glGenBuffers(SSBOs::Count, ssboIds);
-	for (size_t i = 0; i < SSBOs::Count; i++) {
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, ssboIds[i]);
-	}
+    glGenVertexArrays(DynamicVAOs::Count, dynamicVaoIds);
+
+    // Mapped once where the driver can, otherwise (e.g. on software GL) written with glBufferSubData
+    persistentMappingEnabled = GLEW_ARB_buffer_storage != 0;
+    dynamicBuffer.Initialize(persistentMappingEnabled);
 	glGenFramebuffers(FBOs::Count, fboIds);
 	glGenRenderbuffers(RBOs::Count, rboIds);
     glGenTextures(Textures::Count, textureIds);
-    glGenTextures(BLUR_LEVEL_COUNT, blurLevelIds);
-    glGenTextures(BLUR_LEVEL_COUNT, blurTempLevelIds);
+    glGenTextures(BLOOM_MAX_LEVEL_COUNT, bloomLevelIds);
+
+    // Let the driver compile on as many threads as it likes. Nothing waits on a shader until CheckShaderPrograms.
+    if (GLEW_ARB_parallel_shader_compile) glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+
+    // Vertex shaders can only pick a viewport with this, otherwise split-screen draws once per camera
+    layeredViewportsSupported = GLEW_ARB_shader_viewport_layer_array != 0;
+    layeredViewportsEnabled = layeredViewportsSupported;
+
+    // Without these the overdraw stats just aren't shown
+    fragmentQueriesSupported = GLEW_ARB_pipeline_statistics_query != 0;
+    if (fragmentQueriesSupported) glGenQueries(FRAGMENT_QUERY_COUNT, fragmentQueryIds);
+    for (bool& pending : fragmentQueriesPending) pending = false;
+
+    glGenQueries(FRAME_TIMER_QUERY_COUNT, frameTimerIds);
+    for (bool& pending : frameTimersPending) pending = false;
 	
     shaders[Shaders::Geometry] = LoadShaderProgram(GEOMETRY_VERTEX_SHADER, GEOMETRY_FRAGMENT_SHADER);
     shaders[Shaders::GUI] = LoadShaderProgram(GUI_VERTEX_SHADER, GUI_FRAGMENT_SHADER);
@@ -1337,10 +1803,13 @@ void Graphics::GenerateIds() {
 	shaders[Shaders::ShadowMap] = LoadShaderProgram(SHADOW_MAP_VERTEX_SHADER, SHADOW_MAP_FRAGMENT_SHADER);
 	shaders[Shaders::Skybox] = LoadShaderProgram(SKYBOX_VERTEX_SHADER, SKYBOX_FRAGMENT_SHADER);
 	shaders[Shaders::Screen] = LoadShaderProgram(SCREEN_VERTEX_SHADER, SCREEN_FRAGMENT_SHADER);
-	shaders[Shaders::Blur] = LoadShaderProgram(BLUR_VERTEX_SHADER, BLUR_FRAGMENT_SHADER);
-	shaders[Shaders::Copy] = LoadShaderProgram(COPY_VERTEX_SHADER, COPY_FRAGMENT_SHADER);
-	shaders[Shaders::NavMesh] = LoadShaderProgram(NAV_VERTEX_SHADER, NAV_FRAGMENT_SHADER, NAV_GEOMETRY_SHADER);
-	shaders[Shaders::Path] = LoadShaderProgram(PATH_VERTEX_SHADER, PATH_FRAGMENT_SHADER);
+	shaders[Shaders::BloomDownsample] = LoadShaderProgram(BLOOM_VERTEX_SHADER, BLOOM_DOWNSAMPLE_FRAGMENT_SHADER);
+	shaders[Shaders::BloomUpsample] = LoadShaderProgram(BLOOM_VERTEX_SHADER, BLOOM_UPSAMPLE_FRAGMENT_SHADER);
+    shaders[Shaders::BloomDownsampleCompute] = GLEW_ARB_compute_shader ? LoadComputeProgram(BLOOM_DOWNSAMPLE_COMPUTE_SHADER) : nullptr;
+    shaders[Shaders::BloomUpsampleCompute] = GLEW_ARB_compute_shader ? LoadComputeProgram(BLOOM_UPSAMPLE_COMPUTE_SHADER) : nullptr;
+    shaders[Shaders::DebugDraw] = LoadShaderProgram(DEBUG_DRAW_VERTEX_SHADER, DEBUG_DRAW_FRAGMENT_SHADER);
+    // The geometry vertex shader rather than the shadow map's, so its depths match the lit pass's exactly
+    shaders[Shaders::DepthPrepass] = LoadShaderProgram(GEOMETRY_VERTEX_SHADER, SHADOW_MAP_FRAGMENT_SHADER);
 
     InitializeScreenVao();
     InitializeScreenVbo();
@@ -1348,9 +1817,13 @@ void Graphics::GenerateIds() {
     InitializeBillboardVao();
     InitializeBillboardVbo();
 
+    InitializeDynamicVaos();
+
     InitializeGlowFramebuffer();
     InitializeScreenFramebuffer();
 	InitializeShadowMapFramebuffer();
+
+    CheckShaderPrograms();
 }
 
 void Graphics::InitializeScreenVbo() {
@@ -1402,36 +1875,62 @@ void Graphics::InitializeBillboardVao() {
     glBindVertexArray(0);
 }
 
+void Graphics::InitializeDynamicVaos() {
+    // Particles
+    glBindVertexArray(dynamicVaoIds[DynamicVAOs::Particles]);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribFormat(0, 3, GL_FLOAT, GL_FALSE, offsetof(Particle, position));                  // position
+    glVertexAttribFormat(1, 1, GL_FLOAT, GL_FALSE, offsetof(Particle, lifetimeSeconds));           // lifetime
+    glVertexAttribBinding(0, 0);
+    glVertexAttribBinding(1, 0);
+
+    // Debug lines
+    glBindVertexArray(dynamicVaoIds[DynamicVAOs::DebugVertices]);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(3);
+    glVertexAttribFormat(0, 3, GL_FLOAT, GL_FALSE, offsetof(DebugVertex, position));               // position
+    glVertexAttribFormat(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(DebugVertex, color));           // color
+    glVertexAttribBinding(0, 0);
+    glVertexAttribBinding(3, 0);
+
+    glBindVertexArray(0);
+}
+
 void Graphics::InitializeGlowFramebuffer() {
     glBindFramebuffer(GL_FRAMEBUFFER, fboIds[FBOs::GlowEffect]);
 
     GLenum fboBuffers[] = { GL_COLOR_ATTACHMENT0 };
     glDrawBuffers(1, fboBuffers);
 
-    for (size_t i = 0; i < BLUR_LEVEL_COUNT; ++i) {
-        const float factor = 1.f / pow(2, i);
-        
-        glBindTexture(GL_TEXTURE_2D, blurLevelIds[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, SCREEN_WIDTH * factor, SCREEN_HEIGHT * factor, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    for (size_t i = 0; i < BLOOM_MAX_LEVEL_COUNT; ++i) {
+        glBindTexture(GL_TEXTURE_2D, bloomLevelIds[i]);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-        glBindTexture(GL_TEXTURE_2D, blurTempLevelIds[i]);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, SCREEN_WIDTH * factor, SCREEN_HEIGHT * factor, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-        //glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, blurLevelIds[i], 0);
     }
 
+    ResizeBloomLevels();
+
     glBindTexture(GL_TEXTURE_2D, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
+void Graphics::ResizeBloomLevels() {
+    // Float levels, so the upsamples can add up past 1 before the composite. Allocated for the whole target, while
+    // the passes only cover what the render size uses of it.
+    for (size_t i = 0; i < BLOOM_MAX_LEVEL_COUNT; ++i) {
+        size_t levelWidth, levelHeight;
+        BloomChain::GetLevelSize(targetWidth, targetHeight, static_cast<int>(i), levelWidth, levelHeight);
+
+        glBindTexture(GL_TEXTURE_2D, bloomLevelIds[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, levelWidth, levelHeight, 0, GL_RGB, GL_FLOAT, nullptr);
+    }
+
+    BloomChain::BuildPasses(renderWidth, renderHeight, bloomLevelCount, bloomPasses);
+}
+
 void Graphics::InitializeScreenFramebuffer() {
     glBindFramebuffer(GL_FRAMEBUFFER, fboIds[FBOs::Screen]);
 
@@ -1440,7 +1939,7 @@ void Graphics::InitializeScreenFramebuffer() {
 
     // Normal colour buffer
     glBindTexture(GL_TEXTURE_2D, textureIds[Textures::Screen]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, SCREEN_WIDTH, SCREEN_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, targetWidth, targetHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -1449,7 +1948,7 @@ void Graphics::InitializeScreenFramebuffer() {
     
     // Highlights colour buffer
     glBindTexture(GL_TEXTURE_2D, textureIds[Textures::ScreenGlow]);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, SCREEN_WIDTH, SCREEN_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, targetWidth, targetHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -1458,7 +1957,7 @@ void Graphics::InitializeScreenFramebuffer() {
 
     // Depth buffer
     glBindRenderbuffer(GL_RENDERBUFFER, rboIds[RBOs::DepthStencil]);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, SCREEN_WIDTH, SCREEN_HEIGHT);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, targetWidth, targetHeight);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rboIds[RBOs::DepthStencil]);
 
 //    glBindRenderbuffer(GL_RENDERBUFFER, rboIds[RBOs::Stencil]);
@@ -1496,65 +1995,92 @@ void Graphics::InitializeShadowMapFramebuffer() {
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-ShaderProgram* Graphics::LoadShaderProgram(std::string vertexShaderFile, std::string fragmentShaderFile) const {
+ShaderProgram* Graphics::LoadShaderProgram(std::string vertexShaderFile, std::string fragmentShaderFile) {
 	// Load and compile shaders from source
 	const GLuint vertexId = ContentManager::LoadShader(vertexShaderFile, GL_VERTEX_SHADER);
 	const GLuint fragmentId = ContentManager::LoadShader(fragmentShaderFile, GL_FRAGMENT_SHADER);
 
-	// Link the shaders into a program
+	// Link the shaders into a program. They stay attached until CheckShaderPrograms has read their errors.
 	const GLuint programId = glCreateProgram();
 	glAttachShader(programId, vertexId);
 	glAttachShader(programId, fragmentId);
 	glLinkProgram(programId);
 
-	// Check link status and print errors
-	GLint status;
-	glGetProgramiv(programId, GL_LINK_STATUS, &status);
-	if (status == GL_FALSE) {
-		GLint length;
-		glGetProgramiv(programId, GL_INFO_LOG_LENGTH, &length);
-		std::string info(length, ' ');
-		glGetProgramInfoLog(programId, info.length(), &length, &info[0]);
-		std::cerr << "ERROR linking shader program:" << std::endl << info << std::endl;
-	}
-
-	glDeleteShader(vertexId);
-	glDeleteShader(fragmentId);
-
 	// Return the program's ID
-	return new ShaderProgram(programId);
+	return new ShaderProgram(programId, &renderState);
 }
 
 // TODO: Fix this uglyness lol
-ShaderProgram* Graphics::LoadShaderProgram(std::string vertexShaderFile, std::string fragmentShaderFile, std::string geometryShaderFile) const {
+ShaderProgram* Graphics::LoadShaderProgram(std::string vertexShaderFile, std::string fragmentShaderFile, std::string geometryShaderFile) {
     // Load and compile shaders from source
     const GLuint vertexId = ContentManager::LoadShader(vertexShaderFile, GL_VERTEX_SHADER);
     const GLuint fragmentId = ContentManager::LoadShader(fragmentShaderFile, GL_FRAGMENT_SHADER);
     const GLuint geometryId = ContentManager::LoadShader(geometryShaderFile, GL_GEOMETRY_SHADER);
 
-    // Link the shaders into a program
+    // Link the shaders into a program. They stay attached until CheckShaderPrograms has read their errors.
     const GLuint programId = glCreateProgram();
     glAttachShader(programId, vertexId);
     glAttachShader(programId, fragmentId);
     glAttachShader(programId, geometryId);
     glLinkProgram(programId);
 
-    // Check link status and print errors
-    GLint status;
-    glGetProgramiv(programId, GL_LINK_STATUS, &status);
-    if (status == GL_FALSE) {
-        GLint length;
-        glGetProgramiv(programId, GL_INFO_LOG_LENGTH, &length);
-        std::string info(length, ' ');
-        glGetProgramInfoLog(programId, info.length(), &length, &info[0]);
-        std::cerr << "ERROR linking shader program:" << std::endl << info << std::endl;
-    }
+    // Return the program's ID
+    return new ShaderProgram(programId, &renderState);
+}
 
-    glDeleteShader(vertexId);
-    glDeleteShader(fragmentId);
-    glDeleteShader(geometryId);
+ShaderProgram* Graphics::LoadComputeProgram(std::string computeShaderFile) {
+    // Load and compile the shader from source
+    const GLuint computeId = ContentManager::LoadShader(computeShaderFile, GL_COMPUTE_SHADER);
+
+    // Link the shader into a program. It stays attached until CheckShaderPrograms has read its errors.
+    const GLuint programId = glCreateProgram();
+    glAttachShader(programId, computeId);
+    glLinkProgram(programId);
 
     // Return the program's ID
-    return new ShaderProgram(programId);
+    return new ShaderProgram(programId, &renderState);
+}
+
+void Graphics::CheckShaderPrograms() const {
+    const double start = StartupProfile::Now();
+
+    for (size_t i = 0; i < Shaders::Count; ++i) {
+        if (!shaders[i]) continue;
+
+        const GLuint programId = shaders[i]->GetId();
+        GLuint shaderIds[3];
+        GLsizei shaderCount;
+        glGetAttachedShaders(programId, 3, &shaderCount, shaderIds);
+
+        // Check link status and print errors, along with the compile errors behind them
+        GLint status;
+        glGetProgramiv(programId, GL_LINK_STATUS, &status);
+        if (status == GL_FALSE) {
+            for (GLsizei j = 0; j < shaderCount; ++j) {
+                glGetShaderiv(shaderIds[j], GL_COMPILE_STATUS, &status);
+                if (status == GL_TRUE) continue;
+
+                GLint length;
+                glGetShaderiv(shaderIds[j], GL_INFO_LOG_LENGTH, &length);
+                std::string info(length, ' ');
+                glGetShaderInfoLog(shaderIds[j], info.length(), &length, &info[0]);
+                std::cerr << "ERROR Compiling Shader:" << std::endl << info << std::endl;
+            }
+
+            GLint length;
+            glGetProgramiv(programId, GL_INFO_LOG_LENGTH, &length);
+            std::string info(length, ' ');
+            glGetProgramInfoLog(programId, info.length(), &length, &info[0]);
+            std::cerr << "ERROR linking shader program:" << std::endl << info << std::endl;
+        }
+
+        for (GLsizei j = 0; j < shaderCount; ++j) {
+            glDetachShader(programId, shaderIds[j]);
+            glDeleteShader(shaderIds[j]);
+        }
+    }
+
+    // Compiles and links finished in the background show up as the time left to wait here
+    StartupProfile::Record(StartupAsset_Shader, "(driver compile and link)", 0, 0.0, StartupProfile::Now() - start);
 }
 
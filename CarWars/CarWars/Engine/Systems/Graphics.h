@@ -17,28 +17,53 @@
 #include "../Components/PointLightComponent.h"
 #include "../Components/DirectionLightComponent.h"
 #include "Content/SpotLight.h"
-
-#define BLUR_LEVEL_COUNT 4
+#include "Memory/FrameAllocator.h"
+#include "Graphics/BloomChain.h"
+#include "Graphics/Frustum.h"
+#include "Graphics/DynamicBuffer.h"
+#include "Graphics/LodSelection.h"
+#include "Graphics/OcclusionBuffer.h"
+#include "Graphics/RenderState.h"
+#include "Graphics/DebugDraw.h"
+#include "Graphics/ResolutionScaler.h"
+
+#define BLOOM_WORK_GROUP_SIZE 8
+#define FRAGMENT_QUERY_COUNT 3      // Frames a fragment count is read back after, so reading it never stalls
+#define DEBUG_TEXT_SIZE 16          // Pixels
+#define FRAME_TIMER_QUERY_COUNT 3   // Frames a GPU frame time is read back after
 
 struct Triangle;
 class Material;
 class MeshComponent;
 class Mesh;
 class CameraComponent;
+class FTFont;
 
 struct Camera {
 	Camera(glm::vec3 _position, glm::mat4 _viewMatrix, glm::mat4 _projectionMatrix, Entity *_guiRoot) :
-        viewMatrix(_viewMatrix), projectionMatrix(_projectionMatrix), position(_position), guiRoot(_guiRoot) {}
+        viewMatrix(_viewMatrix), projectionMatrix(_projectionMatrix), viewProjectionMatrix(_projectionMatrix * _viewMatrix),
+        frustum(viewProjectionMatrix), position(_position), guiRoot(_guiRoot) {}
 	
 	glm::mat4 viewMatrix;
 	glm::mat4 projectionMatrix;
+	glm::mat4 viewProjectionMatrix;
+	Frustum frustum;
 	glm::vec2 viewportPosition;
 	glm::vec2 viewportSize;
+    glm::vec2 renderViewportPosition;   // The viewport in the scene framebuffer, at the render scale
+    glm::vec2 renderViewportSize;
     glm::vec3 position;
 	Entity *guiRoot;
 	CameraComponent* component;
 };
 
+// A camera as the shaders see it, uploaded once per frame for every draw to index by instance
+struct CameraData {
+    glm::mat4 viewMatrix;
+    glm::mat4 projectionMatrix;
+    glm::mat4 viewProjectionMatrix;
+};
+
 struct EABs {
     enum { Triangles=0, Count };
 };
@@ -52,7 +77,12 @@ struct VBOs {
 };
 
 struct SSBOs {
-	enum { PointLights=0, DirectionLights, SpotLights, Count };
+	enum { PointLights=0, DirectionLights, SpotLights, Cameras, Count };
+};
+
+// Vertex layouts for data that lives in the dynamic buffer, with the buffer bound per draw
+struct DynamicVAOs {
+    enum { Particles=0, DebugVertices, Count };
 };
 
 struct FBOs {
@@ -68,7 +98,7 @@ struct Textures {
 };
 
 struct Shaders {
-	enum { Geometry=0, Billboard, GUI, ShadowMap, Skybox, Screen, Blur, Copy, NavMesh, Path, Count };
+	enum { Geometry=0, Billboard, GUI, ShadowMap, Skybox, Screen, BloomDownsample, BloomUpsample, BloomDownsampleCompute, BloomUpsampleCompute, DebugDraw, DepthPrepass, Count };
 };
 
 class Graphics : public System {
@@ -85,15 +115,13 @@ public:
     static const std::string SKYBOX_FRAGMENT_SHADER;
     static const std::string SCREEN_VERTEX_SHADER;
     static const std::string SCREEN_FRAGMENT_SHADER;
-    static const std::string BLUR_VERTEX_SHADER;
-    static const std::string BLUR_FRAGMENT_SHADER;
-    static const std::string COPY_VERTEX_SHADER;
-    static const std::string COPY_FRAGMENT_SHADER;
-    static const std::string NAV_VERTEX_SHADER;
-    static const std::string NAV_GEOMETRY_SHADER;
-    static const std::string NAV_FRAGMENT_SHADER;
-    static const std::string PATH_VERTEX_SHADER;
-    static const std::string PATH_FRAGMENT_SHADER;
+    static const std::string BLOOM_VERTEX_SHADER;
+    static const std::string BLOOM_DOWNSAMPLE_FRAGMENT_SHADER;
+    static const std::string BLOOM_UPSAMPLE_FRAGMENT_SHADER;
+    static const std::string BLOOM_DOWNSAMPLE_COMPUTE_SHADER;
+    static const std::string BLOOM_UPSAMPLE_COMPUTE_SHADER;
+    static const std::string DEBUG_DRAW_VERTEX_SHADER;
+    static const std::string DEBUG_DRAW_FRAGMENT_SHADER;
     static const std::string GUI_VERTEX_SHADER;
     static const std::string GUI_FRAGMENT_SHADER;
     static const std::string BILLBOARD_VERTEX_SHADER;
@@ -117,6 +145,7 @@ public:
 	// System calls
 	bool Initialize(char* windowTitle);
 	void Update() override;
+	SystemAccess GetAccess() const override;
 
     void SceneChanged();
     
@@ -133,6 +162,9 @@ public:
 	glm::vec2 GetWindowSize() const;
 	glm::vec2 GetViewportSize(int index) const;
 
+    // Shapes added here during a frame are drawn at the end of it
+    DebugDraw& GetDebugDraw();
+
 private:
 	// No instantiation or copying
 	Graphics();
@@ -142,8 +174,99 @@ private:
 	void LoadModel(ShaderProgram* shaderProgram, MeshComponent* model);
     void Graphics::LoadModel(ShaderProgram *shaderProgram, glm::mat4 modelMatrix, Material *material, Mesh* mesh, Texture *texture = nullptr, glm::vec2 uvScale = glm::vec2(1.f));
 
-	void LoadCameras(std::vector<Component*> cameraComponents);
+	void LoadCameras(const FrameVector<Component*>& cameraComponents);
 	std::vector<Camera> cameras;
+
+    // Split-screen draws each object once, instanced to the cameras that can see it, with each instance routed to
+    // its camera's viewport. Without shader viewport selection they fall back to a draw per camera.
+    bool layeredViewportsSupported;
+    bool layeredViewportsEnabled;
+
+    void LoadCameraViewports();
+    unsigned int GetCameraMask(const Mesh* mesh, const glm::mat4& modelMatrix) const;
+    unsigned int GetAllCamerasMask() const;
+    void DrawElements(ShaderProgram* shaderProgram, unsigned int cameraMask, GLenum mode, GLsizei count, GLenum indexType,
+        size_t firstIndex=0);
+
+    // Meshes are drawn at the coarsest level of detail whose error stays under lodPixelError on screen, picked per
+    // camera so a car close to one player and far from another is drawn at both levels
+    bool lodEnabled;
+    float lodPixelError;
+    size_t drawnTriangleCount;
+
+    size_t SelectLod(const Mesh* mesh, const glm::mat4& modelMatrix, const glm::mat4& projectionMatrix, float viewportHeight,
+        const glm::vec3& viewPosition, size_t current) const;
+    void DrawMesh(ShaderProgram* shaderProgram, unsigned int cameraMask, const Mesh* mesh, const glm::mat4& modelMatrix, LodState& lod);
+
+    // Each camera rasterizes the occluders it can see, then takes itself out of the mask of every model hidden
+    // behind them. One buffer is reused camera by camera.
+    OcclusionBuffer occlusionBuffer;
+    bool occlusionCullingEnabled;
+    size_t occlusionTestedCount;
+    size_t occlusionCulledCount;
+    double occlusionTime;
+
+    void CullOccluded(const FrameVector<Component*>& meshes, const FrameVector<glm::mat4>& modelMatrices,
+        FrameVector<unsigned int>& cameraMasks);
+
+    // Opaque models are drawn front to back into the depth buffer alone first, then lit with an equal depth test so
+    // each pixel is only lit once, for the surface that ends up in front
+    bool depthPrepassEnabled;
+
+    // How far in front of a camera the nearest part of a model's bounding sphere is
+    float GetViewDepth(const Camera& camera, const Mesh* mesh, const glm::mat4& modelMatrix) const;
+    void DrawDepthPrepass(const FrameVector<Component*>& meshes, const FrameVector<size_t>& order, size_t opaqueCount,
+        const FrameVector<glm::mat4>& modelMatrices, const FrameVector<unsigned int>& cameraMasks,
+        const FrameVector<float>& viewDepths);
+
+    // Fragment shader invocations of the lit mesh pass, counted with GL_ARB_pipeline_statistics_query where it's
+    // supported and read back a few frames later
+    bool fragmentQueriesSupported;
+    GLuint fragmentQueryIds[FRAGMENT_QUERY_COUNT];
+    bool fragmentQueriesPending[FRAGMENT_QUERY_COUNT];
+    size_t fragmentQueryIndex;
+    GLuint64 litFragmentCount;
+
+    void DrawArrays(ShaderProgram* shaderProgram, unsigned int cameraMask, GLenum mode, GLsizei count);
+
+    // The debug views and anything else's debug drawing, drawn in a couple of draws whatever's in them
+    DebugDraw debugDraw;
+    FTFont* debugFont;
+
+    void AddDebugViews(const FrameVector<Component*>& rigidbodyComponents, const FrameVector<Component*>& aiComponents);
+    void DrawDebug(bool overlay);
+    void DrawDebugText();
+
+    void RenderGuis(const FrameVector<Component*>& guiComponents);
+
+    // The scene, its glow and the bloom levels are rendered at a fraction of the window's size, picked each frame to
+    // keep the GPU within its frame time. The composite upsamples them and the GUI is drawn over it at full size.
+    // The targets stay allocated at the window's size, and a scaled frame only uses their bottom left corner, so
+    // changing the scale never reallocates anything. Whatever samples them scales its UVs down to that corner.
+    ResolutionScaler resolutionScaler;
+    bool dynamicResolutionEnabled;
+    float renderScale;
+    size_t renderWidth;
+    size_t renderHeight;
+    size_t targetWidth;             // What the scene's render targets are allocated at, i.e. the window's size
+    size_t targetHeight;
+
+    // GPU time of a whole frame, read back a few frames later so it never stalls, and the CPU time between swaps
+    GLuint frameTimerIds[FRAME_TIMER_QUERY_COUNT];
+    bool frameTimersPending[FRAME_TIMER_QUERY_COUNT];
+    float frameTimerScales[FRAME_TIMER_QUERY_COUNT];     // The scale each timed frame was rendered at
+    size_t frameTimerIndex;
+    double gpuFrameTime;
+    double cpuFrameTime;
+    double lastSwapTime;
+
+    // Picks the part of the render targets the scene is drawn into at the current scale
+    void UpdateRenderTargets();
+    // Reallocates the scene's render targets at the window's size
+    void ResizeRenderTargets();
+    // Fraction of a bloom level, or of the screen and its glow for BLOOM_SOURCE_LEVEL, that the current render size
+    // fills, and the size of one of its texels in UVs
+    void GetTargetUvs(int level, glm::vec2& uvScale, glm::vec2& texelSize) const;
 	
 	GLFWwindow* window;
 	size_t windowWidth;
@@ -158,14 +281,26 @@ private:
     GLuint screenVbo;
     GLuint billboardVbo;
 	
-    GLuint ssboIds[SSBOs::Count];
 	GLuint fboIds[FBOs::Count];
 	GLuint rboIds[RBOs::Count];
 	GLuint textureIds[Textures::Count];
 	ShaderProgram* shaders[Shaders::Count];
 
-    GLuint blurLevelIds[BLUR_LEVEL_COUNT];
-    GLuint blurTempLevelIds[BLUR_LEVEL_COUNT];
+    // Binds and uniforms go through here during a frame, so the ones that wouldn't change anything are skipped
+    RenderState renderState;
+
+    // Every level is allocated so the level count can change without reallocating
+    GLuint bloomLevelIds[BLOOM_MAX_LEVEL_COUNT];
+    std::vector<BloomPass> bloomPasses;
+
+    // Lights, cameras and every vertex that changes between frames are written here each frame, then drawn from
+    // through the layouts in dynamicVaoIds or bound to their SSBO index by range
+    DynamicBuffer dynamicBuffer;
+    GLuint dynamicVaoIds[DynamicVAOs::Count];
+    bool persistentMappingEnabled;
+
+    bool LoadDynamicVertices(GLuint vao, const void* data, size_t size, GLsizei stride);
+    void LoadStorageBuffer(GLuint index, const void* data, size_t size);
 
     // FPS counter
     double framesPerSecond;
@@ -179,10 +314,13 @@ private:
     bool renderNavigationMesh;
     bool renderNavigationPaths;
     bool bloomEnabled;
+    bool bloomComputeEnabled;
     float bloomScale;
+    float bloomIntensity;
+    int bloomLevelCount;
 
-	void LoadLights(std::vector<Component*> _pointLights, std::vector<Component*> _directionLights, std::vector<Component*> _spotLights);
-	void LoadLights(std::vector<PointLight> pointLights, std::vector<DirectionLight> directionLights, std::vector<SpotLight> spotLights);
+	void LoadLights(const FrameVector<Component*>& _pointLights, const FrameVector<Component*>& _directionLights, const FrameVector<Component*>& _spotLights);
+	void LoadLights(const FrameVector<PointLight>& pointLights, const FrameVector<DirectionLight>& directionLights, const FrameVector<SpotLight>& spotLights);
 
 	void DestroyIds();
 	void GenerateIds();
@@ -193,9 +331,16 @@ private:
     void InitializeBillboardVbo();
     void InitializeBillboardVao();
 
+    void InitializeDynamicVaos();
+
     void InitializeGlowFramebuffer();
+    void ResizeBloomLevels();
     void InitializeScreenFramebuffer();
 	void InitializeShadowMapFramebuffer();
-	ShaderProgram* LoadShaderProgram(std::string vertexShaderFile, std::string fragmentShaderFile) const;
-    ShaderProgram* LoadShaderProgram(std::string vertexShaderFile, std::string fragmentShaderFile, std::string geometryShaderFile) const;
+	ShaderProgram* LoadShaderProgram(std::string vertexShaderFile, std::string fragmentShaderFile);
+    ShaderProgram* LoadShaderProgram(std::string vertexShaderFile, std::string fragmentShaderFile, std::string geometryShaderFile);
+    ShaderProgram* LoadComputeProgram(std::string computeShaderFile);
+
+    // Waits for the driver to finish the programs, prints any errors and releases their shaders
+    void CheckShaderPrograms() const;
 };
@@ -0,0 +1,53 @@
+#include "BloomChain.h"
+
+#include <algorithm>
+
+using namespace std;
+
+size_t BloomChain::GetLevelCount(size_t width, size_t height, size_t requestedCount) {
+    size_t count = 0;
+    while (count < min(requestedCount, static_cast<size_t>(BLOOM_MAX_LEVEL_COUNT))) {
+        size_t levelWidth, levelHeight;
+        GetLevelSize(width, height, static_cast<int>(count), levelWidth, levelHeight);
+        if (levelWidth < 2 || levelHeight < 2) break;
+        count++;
+    }
+    return count;
+}
+
+void BloomChain::GetLevelSize(size_t width, size_t height, int level, size_t& levelWidth, size_t& levelHeight) {
+    levelWidth = max(width >> (level + 1), static_cast<size_t>(1));
+    levelHeight = max(height >> (level + 1), static_cast<size_t>(1));
+}
+
+void BloomChain::BuildPasses(size_t width, size_t height, size_t levelCount, vector<BloomPass>& passes) {
+    passes.clear();
+
+    levelCount = GetLevelCount(width, height, levelCount);
+    if (levelCount == 0) return;
+
+    const int lastLevel = static_cast<int>(levelCount) - 1;
+    passes.reserve(levelCount * 2);
+
+    const auto addPass = [&](BloomPassType type, int source, int target) {
+        BloomPass pass;
+        pass.type = type;
+        pass.source = source;
+        pass.target = target;
+        GetLevelSize(width, height, source, pass.sourceWidth, pass.sourceHeight);
+        GetLevelSize(width, height, target, pass.width, pass.height);
+        passes.push_back(pass);
+    };
+
+    // Down the chain, each level from the one above it
+    for (int level = 0; level <= lastLevel; ++level) {
+        addPass(BloomPass_Downsample, level - 1, level);
+    }
+
+    // Back up, adding each level onto the one above it
+    for (int level = lastLevel; level > 0; --level) {
+        addPass(BloomPass_Upsample, level, level - 1);
+    }
+
+    addPass(BloomPass_Composite, 0, BLOOM_SOURCE_LEVEL);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#define BLOOM_MAX_LEVEL_COUNT 8
+#define BLOOM_DEFAULT_LEVEL_COUNT 4
+#define BLOOM_SOURCE_LEVEL -1           // The full resolution glow buffer
+
+enum BloomPassType {
+    BloomPass_Downsample = 0,           // Wide filter from the level above into a level half its size
+    BloomPass_Upsample,                 // Tent filter from a level, added onto the level above it
+    BloomPass_Composite                 // The screen plus the top level, to the default framebuffer
+};
+
+struct BloomPass {
+    BloomPassType type;
+    int source;                         // Level sampled, or BLOOM_SOURCE_LEVEL
+    int target;                         // Level written, or BLOOM_SOURCE_LEVEL for the composite
+    size_t sourceWidth;
+    size_t sourceHeight;
+    size_t width;                       // Of the target, i.e. the viewport or dispatch size
+    size_t height;
+};
+
+// Works out the bloom passes on the CPU, with no GL, so the chain can be checked on its own. Level i is the glow
+// buffer at 1/2^(i+1) size. The glow buffer is downsampled one level at a time, then each level is upsampled and
+// added onto the one above, so level 0 ends up holding the whole chain and is composited with the screen once.
+class BloomChain {
+public:
+    // Clamps a requested level count to the levels that are still at least 2x2 for the given size
+    static size_t GetLevelCount(size_t width, size_t height, size_t requestedCount);
+    static void GetLevelSize(size_t width, size_t height, int level, size_t& levelWidth, size_t& levelHeight);
+
+    // Fills passes in the order they run: one downsample per level, one upsample per level but the top one, then the
+    // composite. Passes is left empty if the size can't fit a single level.
+    static void BuildPasses(size_t width, size_t height, size_t levelCount, std::vector<BloomPass>& passes);
+
+private:
+    // No instantiation
+    BloomChain() = delete;
+};
@@ -0,0 +1,94 @@
+#include "BloomChainCheck.h"
+#include "BloomChain.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+namespace {
+    struct BloomCase {
+        size_t width;
+        size_t height;
+        size_t requestedCount;
+        size_t levelCount;              // Expected after clamping to the size and BLOOM_MAX_LEVEL_COUNT
+    };
+
+    const BloomCase CASES[] = {
+        { 1280, 720, BLOOM_DEFAULT_LEVEL_COUNT, 4 },
+        { 1920, 1080, BLOOM_MAX_LEVEL_COUNT, 8 },
+        { 1920, 1080, 20, 8 },
+        { 2560, 1440, 1, 1 },
+        { 64, 64, BLOOM_MAX_LEVEL_COUNT, 5 },
+        { 4, 4, BLOOM_DEFAULT_LEVEL_COUNT, 1 },
+        { 800, 3, BLOOM_DEFAULT_LEVEL_COUNT, 0 },
+        { 0, 0, BLOOM_DEFAULT_LEVEL_COUNT, 0 }
+    };
+
+    // Level sizes worked out independently of BloomChain: the glow buffer halved level + 1 times
+    size_t LevelDimension(size_t dimension, int level) {
+        for (int i = -1; i < level; ++i) dimension /= 2;
+        return max(dimension, static_cast<size_t>(1));
+    }
+
+    bool CheckPass(const BloomCase& c, const BloomPass& pass, BloomPassType type, int source, int target,
+        const string& name) {
+
+        const bool sourceRight = pass.sourceWidth == (source < 0 ? c.width : LevelDimension(c.width, source)) &&
+            pass.sourceHeight == (source < 0 ? c.height : LevelDimension(c.height, source));
+        const bool targetRight = pass.width == (target < 0 ? c.width : LevelDimension(c.width, target)) &&
+            pass.height == (target < 0 ? c.height : LevelDimension(c.height, target));
+        if (pass.type == type && pass.source == source && pass.target == target && sourceRight && targetRight) return true;
+
+        cerr << "ERROR: " << name << " pass from " << pass.source << " to " << pass.target << " ("
+            << pass.sourceWidth << "x" << pass.sourceHeight << " to " << pass.width << "x" << pass.height
+            << ") should be of type " << type << " from " << source << " to " << target << endl;
+        return false;
+    }
+
+    bool CheckCase(const BloomCase& c) {
+        const string name = to_string(c.width) + "x" + to_string(c.height) +
+            " (" + to_string(c.requestedCount) + " levels requested)";
+
+        vector<BloomPass> passes;
+        BloomChain::BuildPasses(c.width, c.height, c.requestedCount, passes);
+        const size_t levelCount = BloomChain::GetLevelCount(c.width, c.height, c.requestedCount);
+        cout << name << ": " << levelCount << " levels, " << passes.size() << " passes" << endl;
+
+        // A downsample per level, an upsample per level but the top one and the composite, or nothing at all
+        const size_t passCount = c.levelCount ? c.levelCount * 2 : 0;
+        if (levelCount != c.levelCount || passes.size() != passCount) {
+            cerr << "ERROR: " << name << " should have " << c.levelCount << " levels and " << passCount << " passes" << endl;
+            return false;
+        }
+        if (passes.empty()) return true;
+
+        const int lastLevel = static_cast<int>(c.levelCount) - 1;
+        if (LevelDimension(c.width, lastLevel) < 2 || LevelDimension(c.height, lastLevel) < 2) {
+            cerr << "ERROR: " << name << " has a level smaller than 2x2" << endl;
+            return false;
+        }
+
+        bool passed = true;
+        size_t index = 0;
+        for (int level = 0; level <= lastLevel; ++level) {
+            passed &= CheckPass(c, passes[index++], BloomPass_Downsample, level - 1, level, name);
+        }
+        for (int level = lastLevel; level > 0; --level) {
+            passed &= CheckPass(c, passes[index++], BloomPass_Upsample, level, level - 1, name);
+        }
+        passed &= CheckPass(c, passes[index++], BloomPass_Composite, 0, BLOOM_SOURCE_LEVEL, name);
+        return passed;
+    }
+}
+
+bool BloomChainCheck::Run() {
+    bool passed = true;
+    for (const BloomCase& c : CASES) {
+        passed &= CheckCase(c);
+    }
+
+    cout << (passed ? "Bloom chain check passed" : "Bloom chain check FAILED") << endl;
+    return passed;
+}
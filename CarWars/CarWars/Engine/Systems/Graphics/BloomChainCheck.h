@@ -0,0 +1,14 @@
+#pragma once
+
+// Offline check for the bloom chain (CarWars.exe --check-bloom). Builds the passes for a few window sizes and level
+// counts, from full HD down to sizes too small for a single level, and checks how many levels each gets, the order
+// and kind of every pass and the size of every level it reads and writes. Needs no GL context.
+class BloomChainCheck {
+public:
+    // Returns false if any chain differs from what's expected
+    static bool Run();
+
+private:
+    // No instantiation
+    BloomChainCheck() = delete;
+};
@@ -0,0 +1,146 @@
+#include "DebugDraw.h"
+#include "../Content/Mesh.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+    // Corners of the unit box, indexed by bits x, y and z, and the pairs of them its edges join
+    const int BOX_EDGES[12][2] = {
+        { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+        { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+        { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }
+    };
+}
+
+DebugDraw::DebugDraw() : lastVertexCount(0), overflowed(false) {}
+
+void DebugDraw::Line(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color, bool overlay) {
+    if (!Reserve(2)) return;
+    AddLine(from, to, PackColor(color), overlay);
+}
+
+void DebugDraw::LineStrip(const glm::vec3* points, size_t count, const glm::vec4& color, bool overlay) {
+    if (count < 2 || !Reserve((count - 1) * 2)) return;
+
+    const uint32_t packed = PackColor(color);
+    for (size_t i = 1; i < count; ++i) {
+        AddLine(points[i - 1], points[i], packed, overlay);
+    }
+}
+
+void DebugDraw::Box(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::vec4& color, bool overlay) {
+    Box(glm::mat4(), boundsMin, boundsMax, color, overlay);
+}
+
+void DebugDraw::Box(const glm::mat4& modelMatrix, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+    const glm::vec4& color, bool overlay) {
+
+    if (!Reserve(24)) return;
+
+    glm::vec3 corners[8];
+    for (int i = 0; i < 8; ++i) {
+        const glm::vec3 corner = glm::vec3(i & 1 ? boundsMax.x : boundsMin.x, i & 2 ? boundsMax.y : boundsMin.y,
+            i & 4 ? boundsMax.z : boundsMin.z);
+        corners[i] = glm::vec3(modelMatrix * glm::vec4(corner, 1.f));
+    }
+
+    const uint32_t packed = PackColor(color);
+    for (const int* edge : BOX_EDGES) {
+        AddLine(corners[edge[0]], corners[edge[1]], packed, overlay);
+    }
+}
+
+void DebugDraw::Sphere(const glm::vec3& center, float radius, const glm::vec4& color, bool overlay) {
+    glm::mat4 modelMatrix;
+    modelMatrix[3] = glm::vec4(center, 1.f);
+    Sphere(modelMatrix, radius, color, overlay);
+}
+
+void DebugDraw::Sphere(const glm::mat4& modelMatrix, float radius, const glm::vec4& color, bool overlay) {
+    if (!Reserve(DEBUG_DRAW_SPHERE_SEGMENTS * 6)) return;
+
+    const uint32_t packed = PackColor(color);
+    const float step = glm::radians(360.f) / DEBUG_DRAW_SPHERE_SEGMENTS;
+    for (int axis = 0; axis < 3; ++axis) {
+        // The circle's in the plane of the other two axes
+        const glm::vec3 u = glm::vec3(modelMatrix[(axis + 1) % 3]) * radius;
+        const glm::vec3 v = glm::vec3(modelMatrix[(axis + 2) % 3]) * radius;
+        const glm::vec3 center = glm::vec3(modelMatrix[3]);
+
+        glm::vec3 previous = center + u;
+        for (int i = 1; i <= DEBUG_DRAW_SPHERE_SEGMENTS; ++i) {
+            const glm::vec3 point = center + u * cos(step * i) + v * sin(step * i);
+            AddLine(previous, point, packed, overlay);
+            previous = point;
+        }
+    }
+}
+
+void DebugDraw::WireMesh(const Mesh* mesh, const glm::mat4& modelMatrix, const glm::vec4& color, bool overlay) {
+    if (mesh->triangleCount > DEBUG_DRAW_MAX_MESH_TRIANGLES) {
+        meshes[overlay].push_back({ mesh, modelMatrix, PackColor(color) });
+        return;
+    }
+
+    const vector<glm::vec3>& edges = mesh->GetEdges();
+    if (!Reserve(edges.size())) return;
+
+    const uint32_t packed = PackColor(color);
+    for (size_t i = 0; i + 1 < edges.size(); i += 2) {
+        const glm::vec3 from = glm::vec3(modelMatrix * glm::vec4(edges[i], 1.f));
+        const glm::vec3 to = glm::vec3(modelMatrix * glm::vec4(edges[i + 1], 1.f));
+        AddLine(from, to, packed, overlay);
+    }
+}
+
+void DebugDraw::Text(const glm::vec3& position, const string& text, const glm::vec4& color) {
+    texts.push_back({ position, color, text });
+}
+
+const vector<DebugVertex>& DebugDraw::GetVertices(bool overlay) const {
+    return vertices[overlay];
+}
+
+const vector<DebugMesh>& DebugDraw::GetMeshes(bool overlay) const {
+    return meshes[overlay];
+}
+
+const vector<DebugText>& DebugDraw::GetTexts() const {
+    return texts;
+}
+
+size_t DebugDraw::GetLastVertexCount() const {
+    return lastVertexCount;
+}
+
+void DebugDraw::Clear() {
+    lastVertexCount = vertices[0].size() + vertices[1].size();
+    for (int i = 0; i < 2; ++i) {
+        vertices[i].clear();
+        meshes[i].clear();
+    }
+    texts.clear();
+    overflowed = false;
+}
+
+uint32_t DebugDraw::PackColor(const glm::vec4& color) {
+    const glm::vec4 clamped = glm::clamp(color, 0.f, 1.f) * 255.f + 0.5f;
+    return static_cast<uint32_t>(clamped.r) | static_cast<uint32_t>(clamped.g) << 8 |
+        static_cast<uint32_t>(clamped.b) << 16 | static_cast<uint32_t>(clamped.a) << 24;
+}
+
+bool DebugDraw::Reserve(size_t count) {
+    if (vertices[0].size() + vertices[1].size() + count <= DEBUG_DRAW_MAX_VERTICES) return true;
+
+    if (!overflowed) cerr << "WARNING: Debug drawing is over its vertex budget, skipping shapes this frame" << endl;
+    overflowed = true;
+    return false;
+}
+
+void DebugDraw::AddLine(const glm::vec3& from, const glm::vec3& to, uint32_t color, bool overlay) {
+    vertices[overlay].push_back({ from, color });
+    vertices[overlay].push_back({ to, color });
+}
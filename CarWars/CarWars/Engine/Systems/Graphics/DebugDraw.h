@@ -0,0 +1,79 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define DEBUG_DRAW_MAX_VERTICES 131072          // Line vertices a frame can draw, 2 MB of the dynamic buffer
+#define DEBUG_DRAW_MAX_MESH_TRIANGLES 4096      // Larger wire meshes are drawn from their own buffers, not copied
+#define DEBUG_DRAW_SPHERE_SEGMENTS 24           // Segments in each of a sphere's three circles
+
+class Mesh;
+
+// A line end as it's uploaded, its color packed into 8 bits a channel
+struct DebugVertex {
+    glm::vec3 position;
+    uint32_t color;
+};
+
+// A wire mesh too big to copy into the line list, drawn from its own buffers
+struct DebugMesh {
+    const Mesh* mesh;
+    glm::mat4 modelMatrix;
+    uint32_t color;
+};
+
+struct DebugText {
+    glm::vec3 position;
+    glm::vec4 color;
+    std::string text;
+};
+
+// Immediate mode debug drawing, in world space, for anything to call during a frame. Shapes are accumulated into one
+// line list for those tested against the scene's depth and one for overlays drawn over everything, so Graphics draws
+// each in a single instanced draw before clearing them for the next frame.
+class DebugDraw {
+public:
+    DebugDraw();
+
+    void Line(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color, bool overlay = false);
+    void LineStrip(const glm::vec3* points, size_t count, const glm::vec4& color, bool overlay = false);
+
+    // Axis aligned, or in a model's space
+    void Box(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::vec4& color, bool overlay = false);
+    void Box(const glm::mat4& modelMatrix, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+        const glm::vec4& color, bool overlay = false);
+
+    // A circle around each axis
+    void Sphere(const glm::vec3& center, float radius, const glm::vec4& color, bool overlay = false);
+    void Sphere(const glm::mat4& modelMatrix, float radius, const glm::vec4& color, bool overlay = false);
+
+    // Every edge of a mesh's triangles
+    void WireMesh(const Mesh* mesh, const glm::mat4& modelMatrix, const glm::vec4& color, bool overlay = false);
+
+    // Centred on a point and always drawn over everything
+    void Text(const glm::vec3& position, const std::string& text, const glm::vec4& color);
+
+    const std::vector<DebugVertex>& GetVertices(bool overlay) const;
+    const std::vector<DebugMesh>& GetMeshes(bool overlay) const;
+    const std::vector<DebugText>& GetTexts() const;
+    size_t GetLastVertexCount() const;
+
+    // Keeps the lists' capacity, so a steady frame doesn't allocate
+    void Clear();
+
+    static uint32_t PackColor(const glm::vec4& color);
+
+private:
+    std::vector<DebugVertex> vertices[2];       // Depth tested, then overlay
+    std::vector<DebugMesh> meshes[2];
+    std::vector<DebugText> texts;
+    size_t lastVertexCount;
+    bool overflowed;
+
+    // Space for count more vertices, or false (warning once a frame) when the frame's budget is spent
+    bool Reserve(size_t count);
+    void AddLine(const glm::vec3& from, const glm::vec3& to, uint32_t color, bool overlay);
+};
@@ -0,0 +1,124 @@
+#include "DynamicBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+DynamicBuffer::DynamicBuffer() : bufferId(0), mapping(nullptr), region(0), used(0), lastUsed(0), peakUsed(0),
+    storageAlignment(1), overflowed(false) {
+
+    for (GLsync& fence : fences) fence = nullptr;
+}
+
+void DynamicBuffer::Initialize(bool persistent) {
+    GLint alignment = 1;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    storageAlignment = static_cast<size_t>(max(alignment, 1));
+
+    const GLsizeiptr size = static_cast<GLsizeiptr>(DYNAMIC_BUFFER_REGION_SIZE) * DYNAMIC_BUFFER_REGION_COUNT;
+    glGenBuffers(1, &bufferId);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, bufferId);
+    if (persistent && GLEW_ARB_buffer_storage) {
+        // Dynamic storage too, so glBufferSubData still works if the mapping is refused
+        const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, mapFlags | GL_DYNAMIC_STORAGE_BIT);
+        mapping = static_cast<char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, mapFlags));
+        if (!mapping) cerr << "WARNING: Failed to map the dynamic buffer, falling back to glBufferSubData" << endl;
+    } else {
+        glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    region = 0;
+    used = 0;
+    overflowed = false;
+}
+
+void DynamicBuffer::Destroy() {
+    for (GLsync& fence : fences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    if (mapping) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, bufferId);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        mapping = nullptr;
+    }
+
+    glDeleteBuffers(1, &bufferId);
+    bufferId = 0;
+}
+
+void DynamicBuffer::BeginFrame() {
+    region = (region + 1) % DYNAMIC_BUFFER_REGION_COUNT;
+    used = 0;
+    overflowed = false;
+
+    GLsync& fence = fences[region];
+    if (!fence) return;
+
+    // Normally signalled frames ago. The first wait flushes so the fence is sure to reach the GPU.
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (true) {
+        const GLenum result = glClientWaitSync(fence, flags, DYNAMIC_BUFFER_WAIT_TIMEOUT);
+        if (result != GL_TIMEOUT_EXPIRED) break;
+        flags = 0;
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void DynamicBuffer::EndFrame() {
+    GLsync& fence = fences[region];
+    if (fence) glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    lastUsed = used;
+}
+
+bool DynamicBuffer::Upload(const void* data, size_t size, size_t alignment, DynamicAllocation& allocation) {
+    const size_t offset = (used + alignment - 1) / alignment * alignment;
+    if (offset + size > DYNAMIC_BUFFER_REGION_SIZE) {
+        if (!overflowed) cerr << "WARNING: Dynamic buffer region is full, skipping uploads this frame" << endl;
+        overflowed = true;
+        return false;
+    }
+
+    const size_t bufferOffset = region * DYNAMIC_BUFFER_REGION_SIZE + offset;
+    if (mapping) {
+        memcpy(mapping + bufferOffset, data, size);
+    } else {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, bufferId);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, bufferOffset, size, data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    used = offset + size;
+    peakUsed = max(peakUsed, used);
+
+    allocation.buffer = bufferId;
+    allocation.offset = static_cast<GLintptr>(bufferOffset);
+    allocation.size = static_cast<GLsizeiptr>(size);
+    return true;
+}
+
+size_t DynamicBuffer::GetStorageAlignment() const {
+    return storageAlignment;
+}
+
+bool DynamicBuffer::IsPersistent() const {
+    return mapping != nullptr;
+}
+
+size_t DynamicBuffer::GetLastUsed() const {
+    return lastUsed;
+}
+
+size_t DynamicBuffer::GetPeakUsed() const {
+    return peakUsed;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <cstddef>
+
+#define DYNAMIC_BUFFER_REGION_COUNT 3                   // Frames the CPU may get ahead of the GPU
+#define DYNAMIC_BUFFER_REGION_SIZE (4 * 1024 * 1024)    // Bytes each frame can upload
+#define DYNAMIC_BUFFER_WAIT_TIMEOUT 1000000             // Nanoseconds per wait on a fence before trying again
+
+// Where an upload landed, for glBindBufferRange or glBindVertexBuffer
+struct DynamicAllocation {
+    DynamicAllocation() : buffer(0), offset(0), size(0) {}
+
+    GLuint buffer;
+    GLintptr offset;
+    GLsizeiptr size;
+};
+
+// One buffer for everything that is re-sent every frame (lights, cameras, lines, paths, particles, the nav mesh),
+// split into a region per frame in flight. Each frame writes its data one after another into its own region and
+// draws from offsets into it. A fence after the frame keeps the CPU from writing over a region again until the GPU
+// is done with it, so uploads never stall on a buffer the GPU is still reading.
+// The buffer is mapped once and written directly when the driver has GL_ARB_buffer_storage. Otherwise, or when
+// persistent mapping is turned off (e.g. to test the path software GL like Mesa llvmpipe takes), the same regions are
+// written with glBufferSubData.
+class DynamicBuffer {
+public:
+    DynamicBuffer();
+
+    void Initialize(bool persistent);
+    void Destroy();
+
+    // Waits until the GPU is done with the next region and starts writing at its beginning
+    void BeginFrame();
+    // Fences everything drawn from this frame's region
+    void EndFrame();
+
+    // Copies the data into this frame's region at the given alignment. Returns false when the region is full.
+    bool Upload(const void* data, size_t size, size_t alignment, DynamicAllocation& allocation);
+
+    // Offsets bound to GL_SHADER_STORAGE_BUFFER must be multiples of this
+    size_t GetStorageAlignment() const;
+
+    bool IsPersistent() const;
+    size_t GetLastUsed() const;         // Bytes the last finished frame uploaded
+    size_t GetPeakUsed() const;
+
+private:
+    GLuint bufferId;
+    char* mapping;                      // The whole buffer, or nullptr when written with glBufferSubData
+    GLsync fences[DYNAMIC_BUFFER_REGION_COUNT];
+
+    size_t region;
+    size_t used;
+    size_t lastUsed;
+    size_t peakUsed;
+    size_t storageAlignment;
+    bool overflowed;                    // Already warned this frame
+};
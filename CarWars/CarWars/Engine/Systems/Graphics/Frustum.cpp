@@ -0,0 +1,50 @@
+#include "Frustum.h"
+
+Frustum::Frustum() {
+    // Everything is in view until given a matrix
+    for (glm::vec4& plane : planes) {
+        plane = glm::vec4(0.f, 0.f, 0.f, 1.f);
+    }
+}
+
+Frustum::Frustum(const glm::mat4& viewProjectionMatrix) {
+    const glm::mat4& m = viewProjectionMatrix;
+    const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes[0] = row3 + row0;
+    planes[1] = row3 - row0;
+    planes[2] = row3 + row1;
+    planes[3] = row3 - row1;
+    planes[4] = row3 + row2;
+    planes[5] = row3 - row2;
+
+    for (glm::vec4& plane : planes) {
+        const float length = glm::length(glm::vec3(plane));
+        if (length > 0.f) plane /= length;
+    }
+}
+
+bool Frustum::Intersects(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& modelMatrix) const {
+    const glm::vec3 center = glm::vec3(modelMatrix * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.f));
+
+    // The world space box around the transformed box
+    const glm::vec3 halfSize = (boundsMax - boundsMin) * 0.5f;
+    const glm::vec3 extents = glm::abs(glm::vec3(modelMatrix[0])) * halfSize.x +
+        glm::abs(glm::vec3(modelMatrix[1])) * halfSize.y +
+        glm::abs(glm::vec3(modelMatrix[2])) * halfSize.z;
+
+    return Intersects(center, extents);
+}
+
+bool Frustum::Intersects(const glm::vec3& center, const glm::vec3& extents) const {
+    for (const glm::vec4& plane : planes) {
+        const glm::vec3 normal(plane);
+        const float distance = glm::dot(normal, center) + plane.w;
+        const float radius = glm::dot(glm::abs(normal), extents);
+        if (distance + radius < 0.f) return false;
+    }
+    return true;
+}
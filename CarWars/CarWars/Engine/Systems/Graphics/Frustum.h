@@ -0,0 +1,18 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// A camera's view volume as six inward facing planes, taken straight from its view projection matrix
+class Frustum {
+public:
+    Frustum();
+    explicit Frustum(const glm::mat4& viewProjectionMatrix);
+
+    // Whether any of a model space box is in view once transformed by modelMatrix. Conservative, so boxes just off
+    // a corner of the frustum can still pass.
+    bool Intersects(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& modelMatrix) const;
+    bool Intersects(const glm::vec3& center, const glm::vec3& extents) const;
+
+private:
+    glm::vec4 planes[6];            // Left, right, bottom, top, near, far. xyz is the normal, w the distance.
+};
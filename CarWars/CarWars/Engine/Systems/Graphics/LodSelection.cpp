@@ -0,0 +1,39 @@
+#include "LodSelection.h"
+#include "../Content/MeshSimplifier.h"
+
+#include <algorithm>
+
+using namespace std;
+
+LodState::LodState() : shadowLevel(0) {
+    fill(cameraLevels, cameraLevels + LOD_MAX_CAMERAS, 0);
+}
+
+float LodSelection::GetScreenRadius(const glm::mat4& projectionMatrix, float viewportHeight, float radius, float distance) {
+    // [1][1] is cot(fov / 2) for a perspective projection and 2 / height for an orthographic one, and only
+    // perspective projections copy -z into w
+    const float pixelsPerUnit = projectionMatrix[1][1] * 0.5f * viewportHeight;
+    if (projectionMatrix[2][3] == 0.f) return radius * pixelsPerUnit;
+    return radius * pixelsPerUnit / max(distance, 0.001f);
+}
+
+float LodSelection::GetScreenRadius(const glm::mat4& projectionMatrix, float viewportHeight, const glm::vec3& boundsMin,
+    const glm::vec3& boundsMax, const glm::mat4& modelMatrix, const glm::vec3& viewPosition) {
+
+    // The bounding sphere in world space, grown by the model's largest scale
+    const float scale = max(glm::length(glm::vec3(modelMatrix[0])),
+        max(glm::length(glm::vec3(modelMatrix[1])), glm::length(glm::vec3(modelMatrix[2]))));
+    const float radius = MeshSimplifier::GetBoundingRadius(boundsMin, boundsMax) * scale;
+    const glm::vec3 center = glm::vec3(modelMatrix * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.f));
+
+    return GetScreenRadius(projectionMatrix, viewportHeight, radius, glm::length(center - viewPosition));
+}
+
+size_t LodSelection::Select(const MeshLod* lods, size_t lodCount, float screenRadius, float pixelError, size_t current) {
+    if (lodCount == 0) return 0;
+
+    size_t level = min(current, lodCount - 1);
+    while (level > 0 && lods[level].error * screenRadius > pixelError * (1.f + LOD_HYSTERESIS)) level--;
+    while (level + 1 < lodCount && lods[level + 1].error * screenRadius < pixelError * (1.f - LOD_HYSTERESIS)) level++;
+    return level;
+}
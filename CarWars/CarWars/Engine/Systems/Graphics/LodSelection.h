@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../Content/MeshFile.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+#define LOD_MAX_CAMERAS 4                   // Graphics::MAX_CAMERAS
+#define LOD_DEFAULT_PIXEL_ERROR 1.f         // How far on screen a level may move the surface before a finer one is drawn
+#define LOD_HYSTERESIS 0.25f                // Fraction past the threshold a level's error must be before switching
+
+// The level an object was drawn at last frame by each camera and in the shadow map
+struct LodState {
+    LodState();
+
+    uint8_t cameraLevels[LOD_MAX_CAMERAS];
+    uint8_t shadowLevel;
+};
+
+// Picks levels of detail with no GL. A level's error is how far it moves the surface as a fraction of the mesh's
+// bounding radius, so on screen it is that fraction of the radius the mesh projects to.
+class LodSelection {
+public:
+    // Radius in pixels of a sphere at a distance through a perspective projection. Orthographic projections (e.g. the
+    // shadow map) ignore the distance.
+    static float GetScreenRadius(const glm::mat4& projectionMatrix, float viewportHeight, float radius, float distance);
+    // The same for a model space box's bounding sphere once transformed by modelMatrix, seen from viewPosition
+    static float GetScreenRadius(const glm::mat4& projectionMatrix, float viewportHeight, const glm::vec3& boundsMin,
+        const glm::vec3& boundsMax, const glm::mat4& modelMatrix, const glm::vec3& viewPosition);
+
+    // Coarsest level whose error on screen stays under pixelError. Leaving the current level takes its error (or the
+    // next level's) being LOD_HYSTERESIS past the threshold, so objects sitting on a boundary don't flicker.
+    static size_t Select(const MeshLod* lods, size_t lodCount, float screenRadius, float pixelError, size_t current);
+
+private:
+    // No instantiation
+    LodSelection() = delete;
+};
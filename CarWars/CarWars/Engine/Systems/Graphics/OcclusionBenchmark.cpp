@@ -0,0 +1,125 @@
+#include "OcclusionBenchmark.h"
+#include "OcclusionBuffer.h"
+#include "Frustum.h"
+
+#include "../Content/ContentManager.h"
+#include "../Content/HeightMap.h"
+#include "../Content/TerrainChunks.h"
+#include "../../Components/CameraComponent.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <chrono>
+#include <iostream>
+#include <experimental/filesystem>
+
+using namespace std;
+namespace fs = std::experimental::filesystem;
+
+namespace {
+    double Seconds(chrono::steady_clock::time_point start) {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+}
+
+bool OcclusionBenchmark::RunAll() {
+    const string& dirPath = ContentManager::MAP_DIR_PATH;
+
+    size_t mapCount = 0;
+    error_code error;
+    for (const fs::directory_entry& entry : fs::directory_iterator(dirPath, error)) {
+        if (!fs::is_directory(entry.status())) continue;
+
+        const string mapDirPath = entry.path().filename().string() + "/";
+        if (!fs::exists(dirPath + mapDirPath + "Map.png")) continue;
+        if (Run(mapDirPath)) mapCount++;
+    }
+
+    if (error) {
+        cerr << "ERROR: Failed to read map directory: " << dirPath << endl;
+        return false;
+    }
+    return mapCount > 0;
+}
+
+bool OcclusionBenchmark::Run(const string& dirPath) {
+    MeshData meshData;
+    HeightMap heightMap(dirPath, meshData);
+    if (meshData.vertices.empty()) return false;
+
+    const size_t rowCount = heightMap.rowCount + heightMap.wallVertices * 2;
+    const size_t columnCount = heightMap.colCount + heightMap.wallVertices * 2;
+    vector<MeshData> chunks;
+    TerrainChunks::Build(meshData.vertices.data(), rowCount, columnCount, chunks);
+
+    vector<OccluderProxy> proxies(chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        OcclusionBuffer::BuildProxy(chunks[i].GetView(), proxies[i]);
+    }
+
+    // Car-sized boxes standing on the ground all over the arena
+    const float width = heightMap.GetWidth();
+    const float length = heightMap.GetLength();
+    const glm::vec3 boxExtents(1.f, 0.75f, 2.f);
+    vector<glm::vec3> boxes;
+    for (float z = -length * 0.5f; z < length * 0.5f; z += OCCLUSION_BENCHMARK_BOX_SPACING) {
+        for (float x = -width * 0.5f; x < width * 0.5f; x += OCCLUSION_BENCHMARK_BOX_SPACING) {
+            const glm::vec3 ground(x, 0.f, z);
+            boxes.push_back(ground + glm::vec3(0.f, heightMap.GetHeight(ground) + boxExtents.y, 0.f));
+        }
+    }
+
+    const glm::mat4 projectionMatrix = glm::perspective(glm::radians(CameraComponent::DEFAULT_FIELD_OF_VIEW), 16.f / 9.f,
+        CameraComponent::NEAR_CLIPPING_PLANE, CameraComponent::FAR_CLIPPING_PLANE);
+    const glm::mat4 identity(1.f);
+
+    OcclusionBuffer buffer;
+    size_t viewCount = 0;
+    size_t occluderTriangleCount = 0;
+    size_t testedCount = 0;
+    size_t culledCount = 0;
+    double rasterizeTime = 0.0;
+    double testTime = 0.0;
+
+    for (int i = 0; i < OCCLUSION_BENCHMARK_VIEW_GRID; ++i) {
+        for (int j = 0; j < OCCLUSION_BENCHMARK_VIEW_GRID; ++j) {
+            glm::vec3 position((j + 0.5f) / OCCLUSION_BENCHMARK_VIEW_GRID - 0.5f, 0.f, (i + 0.5f) / OCCLUSION_BENCHMARK_VIEW_GRID - 0.5f);
+            position *= glm::vec3(width, 0.f, length);
+            position.y = heightMap.GetHeight(position) + OCCLUSION_BENCHMARK_VIEW_HEIGHT;
+
+            for (int k = 0; k < 8; ++k) {
+                const float yaw = glm::radians(45.f * k);
+                const glm::vec3 target = position + glm::vec3(sin(yaw) * 10.f, -1.f, cos(yaw) * 10.f);
+                const glm::mat4 viewMatrix = glm::lookAt(position, target, glm::vec3(0.f, 1.f, 0.f));
+                const Frustum frustum(projectionMatrix * viewMatrix);
+
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                buffer.Clear(projectionMatrix, viewMatrix, position);
+                for (size_t c = 0; c < chunks.size(); ++c) {
+                    if (!frustum.Intersects(chunks[c].boundsMin, chunks[c].boundsMax, identity)) continue;
+                    buffer.RasterizeOccluder(proxies[c], identity);
+                }
+                rasterizeTime += Seconds(start);
+                occluderTriangleCount += buffer.GetTriangleCount();
+
+                start = chrono::steady_clock::now();
+                for (const MeshData& chunk : chunks) {
+                    if (!frustum.Intersects(chunk.boundsMin, chunk.boundsMax, identity)) continue;
+                    testedCount++;
+                    if (!buffer.IsVisible(chunk.boundsMin, chunk.boundsMax, identity)) culledCount++;
+                }
+                for (const glm::vec3& box : boxes) {
+                    if (!frustum.Intersects(box, boxExtents)) continue;
+                    testedCount++;
+                    if (!buffer.IsVisible(box - boxExtents, box + boxExtents, identity)) culledCount++;
+                }
+                testTime += Seconds(start);
+                viewCount++;
+            }
+        }
+    }
+
+    cout << dirPath << ": " << chunks.size() << " chunks, " << boxes.size() << " boxes, " << viewCount << " views, "
+        << (testedCount ? 100.0 * culledCount / testedCount : 0.0) << "% of " << testedCount << " tests culled, "
+        << occluderTriangleCount / viewCount << " occluder triangles, " << rasterizeTime * 1000.0 / viewCount
+        << " ms rasterizing and " << testTime * 1000.0 / viewCount << " ms testing per view" << endl;
+    return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+#define OCCLUSION_BENCHMARK_VIEW_GRID 4         // Views come from a grid this many points across the arena
+#define OCCLUSION_BENCHMARK_VIEW_HEIGHT 3.f     // Above the ground, about where a chase camera sits
+#define OCCLUSION_BENCHMARK_BOX_SPACING 10.f    // Distance between the car-sized boxes tested along with the terrain
+
+// Offline benchmark for the occlusion culler (CarWars.exe --benchmark-occlusion). For every map it generates the
+// height map and its terrain chunks from Map.png, then looks eight ways from a grid of points at car height. Each
+// view rasterizes the terrain chunks in its frustum and tests them along with a field of car-sized boxes. Prints how
+// many were hidden and what rasterizing and testing cost per view. Needs no GL context.
+class OcclusionBenchmark {
+public:
+    // Returns false if no map could be benchmarked
+    static bool RunAll();
+
+    // Benchmarks the map in dirPath (relative to ContentManager::MAP_DIR_PATH)
+    static bool Run(const std::string& dirPath);
+
+private:
+    // No instantiation
+    OcclusionBenchmark() = delete;
+};
@@ -0,0 +1,192 @@
+#include "OcclusionBuffer.h"
+#include "LodSelection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
+using namespace std;
+
+namespace {
+    // Pixel coordinates, with y up like NDC, and NDC depth
+    glm::vec3 ToScreen(const glm::vec4& clip) {
+        const float inverseW = 1.f / clip.w;
+        return glm::vec3((clip.x * inverseW * 0.5f + 0.5f) * OCCLUSION_BUFFER_WIDTH,
+            (clip.y * inverseW * 0.5f + 0.5f) * OCCLUSION_BUFFER_HEIGHT, clip.z * inverseW);
+    }
+}
+
+OcclusionBuffer::OcclusionBuffer() : depths(OCCLUSION_BUFFER_WIDTH * OCCLUSION_BUFFER_HEIGHT, 1.f), triangleCount(0) {}
+
+void OcclusionBuffer::Clear(const glm::mat4& _projectionMatrix, const glm::mat4& viewMatrix, const glm::vec3& _viewPosition) {
+    projectionMatrix = _projectionMatrix;
+    viewProjectionMatrix = projectionMatrix * viewMatrix;
+    viewPosition = _viewPosition;
+    fill(depths.begin(), depths.end(), 1.f);
+    triangleCount = 0;
+}
+
+void OcclusionBuffer::RasterizeOccluder(const OccluderProxy& proxy, const glm::mat4& modelMatrix) {
+    // e.g. a mesh with no triangles
+    if (proxy.lods.empty() || proxy.vertices.empty()) return;
+
+    const glm::mat4 modelViewProjectionMatrix = viewProjectionMatrix * modelMatrix;
+
+    // At this resolution most occluders are only a few pixels across, so their fine levels would be all triangle setup
+    const float screenRadius = LodSelection::GetScreenRadius(projectionMatrix, static_cast<float>(OCCLUSION_BUFFER_HEIGHT),
+        proxy.boundsMin, proxy.boundsMax, modelMatrix, viewPosition);
+    const MeshLod& lod = proxy.lods[LodSelection::Select(proxy.lods.data(), proxy.lods.size(), screenRadius,
+        OCCLUSION_PIXEL_ERROR, 0)];
+
+    // Vertices are shared by about six triangles each, so they're projected once up front
+    vector<glm::vec4>& screen = screenPositions;
+    screen.resize(proxy.vertices.size());
+    for (size_t i = 0; i < proxy.vertices.size(); ++i) {
+        const glm::vec4 clip = modelViewProjectionMatrix * glm::vec4(proxy.vertices[i], 1.f);
+        screen[i] = clip.w < OCCLUSION_NEAR_W ? glm::vec4(0.f, 0.f, 0.f, clip.w) : glm::vec4(ToScreen(clip), clip.w);
+    }
+
+    const size_t end = lod.indexOffset + lod.indexCount;
+    for (size_t i = lod.indexOffset; i + 2 < end; i += 3) {
+        const glm::vec4& a = screen[proxy.indices[i]];
+        const glm::vec4& b = screen[proxy.indices[i + 1]];
+        const glm::vec4& c = screen[proxy.indices[i + 2]];
+
+        // Clipping would only add occlusion close to the camera, so triangles crossing the near plane are dropped
+        if (a.w < OCCLUSION_NEAR_W || b.w < OCCLUSION_NEAR_W || c.w < OCCLUSION_NEAR_W) continue;
+        RasterizeTriangle(glm::vec3(a), glm::vec3(b), glm::vec3(c));
+    }
+}
+
+void OcclusionBuffer::RasterizeTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    // Counter-clockwise on screen is a front face
+    const float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (!(area > 0.f)) return;
+
+    // Pixels whose centres fall in the triangle's bounds. Columns start on a multiple of 4 for whole SSE lanes.
+    const int minX = max(static_cast<int>(ceil(min(a.x, min(b.x, c.x)) - 0.5f)), 0) & ~3;
+    const int maxX = min(static_cast<int>(floor(max(a.x, max(b.x, c.x)) - 0.5f)) + 1, OCCLUSION_BUFFER_WIDTH);
+    const int minY = max(static_cast<int>(ceil(min(a.y, min(b.y, c.y)) - 0.5f)), 0);
+    const int maxY = min(static_cast<int>(floor(max(a.y, max(b.y, c.y)) - 0.5f)) + 1, OCCLUSION_BUFFER_HEIGHT);
+    if (minX >= maxX || minY >= maxY) return;
+    triangleCount++;
+
+    // Edge functions and depth are all planes over the screen: value = x * dx + y * dy + constant
+    const float inverseArea = 1.f / area;
+    const glm::vec2 edgeStep[3] = {
+        glm::vec2(-(c.y - b.y), c.x - b.x),     // Opposite a, so its value over the area is a's weight
+        glm::vec2(-(a.y - c.y), a.x - c.x),
+        glm::vec2(-(b.y - a.y), b.x - a.x)
+    };
+    const glm::vec3 origin[3] = { b, c, a };
+    const glm::vec2 depthStep = (edgeStep[0] * a.z + edgeStep[1] * b.z + edgeStep[2] * c.z) * inverseArea;
+
+    const float startX = minX + 0.5f;
+    const float startY = minY + 0.5f;
+    float rowEdges[3];
+    for (int e = 0; e < 3; ++e) {
+        rowEdges[e] = (startX - origin[e].x) * edgeStep[e].x + (startY - origin[e].y) * edgeStep[e].y;
+    }
+    float rowDepth = a.z + ((startX - a.x) * depthStep.x + (startY - a.y) * depthStep.y);
+
+    const __m128 lanes = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 edgeLaneStep[3];
+    __m128 edgeQuadStep[3];
+    for (int e = 0; e < 3; ++e) {
+        edgeLaneStep[e] = _mm_mul_ps(lanes, _mm_set1_ps(edgeStep[e].x));
+        edgeQuadStep[e] = _mm_set1_ps(edgeStep[e].x * 4.f);
+    }
+    const __m128 depthLaneStep = _mm_mul_ps(lanes, _mm_set1_ps(depthStep.x));
+    const __m128 depthQuadStep = _mm_set1_ps(depthStep.x * 4.f);
+
+    for (int y = minY; y < maxY; ++y) {
+        __m128 edge0 = _mm_add_ps(_mm_set1_ps(rowEdges[0]), edgeLaneStep[0]);
+        __m128 edge1 = _mm_add_ps(_mm_set1_ps(rowEdges[1]), edgeLaneStep[1]);
+        __m128 edge2 = _mm_add_ps(_mm_set1_ps(rowEdges[2]), edgeLaneStep[2]);
+        __m128 depth = _mm_add_ps(_mm_set1_ps(rowDepth), depthLaneStep);
+
+        float* row = depths.data() + y * OCCLUSION_BUFFER_WIDTH;
+        for (int x = minX; x < maxX; x += 4) {
+            const __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)),
+                _mm_cmpge_ps(edge2, zero));
+            if (_mm_movemask_ps(inside)) {
+                const __m128 stored = _mm_loadu_ps(row + x);
+                const __m128 nearest = _mm_min_ps(stored, depth);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, stored)));
+            }
+
+            edge0 = _mm_add_ps(edge0, edgeQuadStep[0]);
+            edge1 = _mm_add_ps(edge1, edgeQuadStep[1]);
+            edge2 = _mm_add_ps(edge2, edgeQuadStep[2]);
+            depth = _mm_add_ps(depth, depthQuadStep);
+        }
+
+        for (int e = 0; e < 3; ++e) rowEdges[e] += edgeStep[e].y;
+        rowDepth += depthStep.y;
+    }
+}
+
+bool OcclusionBuffer::IsVisible(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& modelMatrix) const {
+    if (triangleCount == 0) return true;
+
+    const glm::mat4 modelViewProjectionMatrix = viewProjectionMatrix * modelMatrix;
+    glm::vec2 screenMin(INFINITY);
+    glm::vec2 screenMax(-INFINITY);
+    float nearest = INFINITY;
+    for (int i = 0; i < 8; ++i) {
+        const glm::vec3 corner((i & 1) ? boundsMax.x : boundsMin.x, (i & 2) ? boundsMax.y : boundsMin.y,
+            (i & 4) ? boundsMax.z : boundsMin.z);
+        const glm::vec4 clip = modelViewProjectionMatrix * glm::vec4(corner, 1.f);
+
+        // Reaches behind the camera, so it may cover the whole screen
+        if (clip.w < OCCLUSION_NEAR_W) return true;
+
+        const glm::vec3 screen = ToScreen(clip);
+        screenMin = glm::min(screenMin, glm::vec2(screen));
+        screenMax = glm::max(screenMax, glm::vec2(screen));
+        nearest = min(nearest, screen.z);
+    }
+
+    // Every pixel the rectangle touches, widened to whole SSE lanes (testing extra pixels only makes it more visible)
+    const int minX = max(static_cast<int>(floor(screenMin.x)), 0) & ~3;
+    const int maxX = min(static_cast<int>(floor(screenMax.x)) + 1, OCCLUSION_BUFFER_WIDTH);
+    const int minY = max(static_cast<int>(floor(screenMin.y)), 0);
+    const int maxY = min(static_cast<int>(floor(screenMax.y)) + 1, OCCLUSION_BUFFER_HEIGHT);
+    if (minX >= maxX || minY >= maxY) return true;
+
+    const __m128 boxDepth = _mm_set1_ps(nearest);
+    for (int y = minY; y < maxY; ++y) {
+        const float* row = depths.data() + y * OCCLUSION_BUFFER_WIDTH;
+        for (int x = minX; x < maxX; x += 4) {
+            if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(row + x), boxDepth))) return true;
+        }
+    }
+    return false;
+}
+
+size_t OcclusionBuffer::GetTriangleCount() const {
+    return triangleCount;
+}
+
+void OcclusionBuffer::BuildProxy(const MeshView& view, OccluderProxy& proxy) {
+    proxy.vertices.resize(view.vertexCount);
+    for (size_t i = 0; i < view.vertexCount; ++i) {
+        proxy.vertices[i] = view.vertices[i].position;
+    }
+
+    proxy.indices.resize(view.indexCount);
+    for (size_t i = 0; i < view.indexCount; ++i) {
+        proxy.indices[i] = view.indexSize == sizeof(uint16_t) ?
+            static_cast<const uint16_t*>(view.indices)[i] : static_cast<const uint32_t*>(view.indices)[i];
+    }
+
+    proxy.lods.assign(view.lods, view.lods + view.lodCount);
+    if (proxy.lods.empty()) {
+        const MeshLod all = { 0, static_cast<uint32_t>(view.indexCount), 0.f };
+        proxy.lods.push_back(all);
+    }
+
+    proxy.boundsMin = view.boundsMin;
+    proxy.boundsMax = view.boundsMax;
+}
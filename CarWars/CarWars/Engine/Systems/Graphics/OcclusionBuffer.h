@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../Content/MeshFile.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#define OCCLUSION_BUFFER_WIDTH 256          // Pixels, a multiple of 4 so rows split evenly into SSE lanes
+#define OCCLUSION_BUFFER_HEIGHT 128
+#define OCCLUSION_NEAR_W 0.01f              // Occluder triangles with a corner closer than this are skipped, not clipped
+#define OCCLUSION_PIXEL_ERROR 0.5f          // How far in buffer pixels an occluder's level of detail may move its surface
+
+// A CPU copy of a mesh's positions and the indices of all its levels of detail, to rasterize it as an occluder
+struct OccluderProxy {
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<MeshLod> lods;          // At least one, level 0 being every index when the mesh has no levels
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+};
+
+// A small CPU depth buffer for one camera at a time. Designated occluders (walls, pillars, the terrain) are
+// rasterized into it with SSE, four pixels at a time, then every other model's bounding box is tested against it
+// before it is drawn. No GL, so it can be benchmarked headless (CarWars.exe --benchmark-occlusion).
+// Errs towards visible: only pixels whose centre an occluder covers are written, and a box is only hidden when every
+// pixel its screen rectangle touches has an occluder in front of its nearest corner. Occluders are drawn at the
+// coarsest level of detail that stays within OCCLUSION_PIXEL_ERROR of this buffer's pixels, which is how far they may
+// stray from what GL draws.
+class OcclusionBuffer {
+public:
+    OcclusionBuffer();
+
+    // Empties the buffer to the far plane for a camera
+    void Clear(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix, const glm::vec3& viewPosition);
+
+    // Front faces only, matching what GL draws with back-face culling
+    void RasterizeOccluder(const OccluderProxy& proxy, const glm::mat4& modelMatrix);
+
+    // Whether any of a model space box may show in front of the occluders
+    bool IsVisible(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& modelMatrix) const;
+
+    size_t GetTriangleCount() const;    // Rasterized since the last clear
+
+    static void BuildProxy(const MeshView& view, OccluderProxy& proxy);
+
+private:
+    glm::mat4 projectionMatrix;
+    glm::mat4 viewProjectionMatrix;
+    glm::vec3 viewPosition;
+    std::vector<float> depths;          // NDC depth of the nearest occluder at each pixel centre, row by row
+    std::vector<glm::vec4> screenPositions; // Pixel x and y, NDC depth and w. Kept between occluders so they don't allocate.
+    size_t triangleCount;
+
+    void RasterizeTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+};
@@ -0,0 +1,269 @@
+#include "RenderState.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace {
+    const GLenum CACHED_CAPABILITIES[] = { GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_STENCIL_TEST };
+
+    // Index into RenderState::capabilities, or -1 when the capability isn't cached
+    int GetCapabilityIndex(GLenum capability) {
+        for (int i = 0; i < 4; ++i) {
+            if (CACHED_CAPABILITIES[i] == capability) return i;
+        }
+        return -1;
+    }
+
+    // Index into a unit's RenderState::textures, or -1 when the target isn't cached
+    int GetTargetIndex(GLenum target) {
+        if (target == GL_TEXTURE_2D) return 0;
+        if (target == GL_TEXTURE_CUBE_MAP) return 1;
+        return -1;
+    }
+
+    class GlBackend : public RenderStateBackend {
+    public:
+        void UseProgram(GLuint program) override { glUseProgram(program); }
+        void BindVertexArray(GLuint vao) override { glBindVertexArray(vao); }
+        void ActiveTexture(GLenum unit) override { glActiveTexture(unit); }
+        void BindTexture(GLenum target, GLuint texture) override { glBindTexture(target, texture); }
+        void SetEnabled(GLenum capability, bool enabled) override {
+            if (enabled) {
+                glEnable(capability);
+            } else {
+                glDisable(capability);
+            }
+        }
+        void BlendFunc(GLenum source, GLenum destination) override { glBlendFunc(source, destination); }
+        void DepthFunc(GLenum func) override { glDepthFunc(func); }
+        void DepthMask(bool enabled) override { glDepthMask(enabled ? GL_TRUE : GL_FALSE); }
+        void StencilFunc(GLenum func, GLint reference, GLuint mask) override { glStencilFunc(func, reference, mask); }
+        void StencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass) override {
+            glStencilOp(stencilFail, depthFail, depthPass);
+        }
+        void StencilMask(GLuint mask) override { glStencilMask(mask); }
+        void Viewport(GLint x, GLint y, GLsizei width, GLsizei height) override { glViewport(x, y, width, height); }
+        void PolygonMode(GLenum mode) override { glPolygonMode(GL_FRONT_AND_BACK, mode); }
+
+        void Uniform(GLint location, const UniformValue& value) override {
+            const GLfloat* floats = reinterpret_cast<const GLfloat*>(value.data);
+            switch (value.type) {
+            case GL_BOOL:
+                glUniform1ui(location, *reinterpret_cast<const GLuint*>(value.data));
+                break;
+            case GL_INT:
+                glUniform1i(location, *reinterpret_cast<const GLint*>(value.data));
+                break;
+            case GL_FLOAT:
+                glUniform1f(location, floats[0]);
+                break;
+            case GL_FLOAT_VEC2:
+                glUniform2f(location, floats[0], floats[1]);
+                break;
+            case GL_FLOAT_VEC3:
+                glUniform3f(location, floats[0], floats[1], floats[2]);
+                break;
+            case GL_FLOAT_VEC4:
+                glUniform4f(location, floats[0], floats[1], floats[2], floats[3]);
+                break;
+            case GL_FLOAT_MAT4:
+                glUniformMatrix4fv(location, 1, GL_FALSE, floats);
+                break;
+            default:
+                break;
+            }
+        }
+    };
+}
+
+RenderStateBackend& RenderStateBackend::GetGl() {
+    static GlBackend backend;
+    return backend;
+}
+
+RecordingRenderStateBackend::RecordingRenderStateBackend() : callCount(0), uniformCount(0) {}
+
+void RecordingRenderStateBackend::UseProgram(GLuint) { callCount++; }
+void RecordingRenderStateBackend::BindVertexArray(GLuint) { callCount++; }
+void RecordingRenderStateBackend::ActiveTexture(GLenum) { callCount++; }
+void RecordingRenderStateBackend::BindTexture(GLenum, GLuint) { callCount++; }
+void RecordingRenderStateBackend::SetEnabled(GLenum, bool) { callCount++; }
+void RecordingRenderStateBackend::BlendFunc(GLenum, GLenum) { callCount++; }
+void RecordingRenderStateBackend::DepthFunc(GLenum) { callCount++; }
+void RecordingRenderStateBackend::DepthMask(bool) { callCount++; }
+void RecordingRenderStateBackend::StencilFunc(GLenum, GLint, GLuint) { callCount++; }
+void RecordingRenderStateBackend::StencilOp(GLenum, GLenum, GLenum) { callCount++; }
+void RecordingRenderStateBackend::StencilMask(GLuint) { callCount++; }
+void RecordingRenderStateBackend::Viewport(GLint, GLint, GLsizei, GLsizei) { callCount++; }
+void RecordingRenderStateBackend::PolygonMode(GLenum) { callCount++; }
+
+void RecordingRenderStateBackend::Uniform(GLint, const UniformValue&) {
+    callCount++;
+    uniformCount++;
+}
+
+void RecordingRenderStateBackend::Reset() {
+    callCount = 0;
+    uniformCount = 0;
+}
+
+size_t RecordingRenderStateBackend::GetCallCount() const {
+    return callCount;
+}
+
+size_t RecordingRenderStateBackend::GetUniformCount() const {
+    return uniformCount;
+}
+
+RenderState::RenderState(RenderStateBackend& _backend) : backend(_backend), issuedCount(0), filteredCount(0) {
+    Invalidate();
+}
+
+void RenderState::Invalidate() {
+    program = RENDER_STATE_UNKNOWN;
+    vao = RENDER_STATE_UNKNOWN;
+    activeUnit = RENDER_STATE_UNKNOWN;
+    for (GLuint (&unit)[2] : textures) {
+        unit[0] = RENDER_STATE_UNKNOWN;
+        unit[1] = RENDER_STATE_UNKNOWN;
+    }
+    for (GLuint& capability : capabilities) capability = RENDER_STATE_UNKNOWN;
+    blendSource = RENDER_STATE_UNKNOWN;
+    blendDestination = RENDER_STATE_UNKNOWN;
+    depthFunc = RENDER_STATE_UNKNOWN;
+    depthMask = RENDER_STATE_UNKNOWN;
+    stencilFunc = RENDER_STATE_UNKNOWN;
+    stencilReference = 0;
+    stencilFuncMask = 0;
+    for (GLenum& op : stencilOps) op = RENDER_STATE_UNKNOWN;
+    stencilMask = RENDER_STATE_UNKNOWN;
+    viewportKnown = false;
+    polygonMode = RENDER_STATE_UNKNOWN;
+}
+
+void RenderState::BeginFrame() {
+    Invalidate();
+    issuedCount = 0;
+    filteredCount = 0;
+}
+
+bool RenderState::Issue(bool changed) {
+    if (changed) {
+        issuedCount++;
+    } else {
+        filteredCount++;
+    }
+    return changed;
+}
+
+void RenderState::UseProgram(GLuint _program) {
+    if (!Issue(program != _program)) return;
+    program = _program;
+    backend.UseProgram(program);
+}
+
+void RenderState::BindVertexArray(GLuint _vao) {
+    if (!Issue(vao != _vao)) return;
+    vao = _vao;
+    backend.BindVertexArray(vao);
+}
+
+void RenderState::ActiveTexture(GLuint unit) {
+    if (!Issue(activeUnit != unit)) return;
+    activeUnit = unit;
+    backend.ActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void RenderState::BindTexture(GLuint unit, GLenum target, GLuint texture) {
+    const int targetIndex = GetTargetIndex(target);
+    const bool cached = unit < RENDER_STATE_TEXTURE_UNITS && targetIndex >= 0;
+    if (!Issue(!cached || textures[unit][targetIndex] != texture)) return;
+
+    ActiveTexture(unit);
+    if (cached) textures[unit][targetIndex] = texture;
+    backend.BindTexture(target, texture);
+}
+
+void RenderState::SetEnabled(GLenum capability, bool enabled) {
+    const int index = GetCapabilityIndex(capability);
+    const GLuint value = enabled ? 1 : 0;
+    if (!Issue(index < 0 || capabilities[index] != value)) return;
+    if (index >= 0) capabilities[index] = value;
+    backend.SetEnabled(capability, enabled);
+}
+
+void RenderState::BlendFunc(GLenum source, GLenum destination) {
+    if (!Issue(blendSource != source || blendDestination != destination)) return;
+    blendSource = source;
+    blendDestination = destination;
+    backend.BlendFunc(source, destination);
+}
+
+void RenderState::DepthFunc(GLenum func) {
+    if (!Issue(depthFunc != func)) return;
+    depthFunc = func;
+    backend.DepthFunc(func);
+}
+
+void RenderState::DepthMask(bool enabled) {
+    const GLuint value = enabled ? 1 : 0;
+    if (!Issue(depthMask != value)) return;
+    depthMask = value;
+    backend.DepthMask(enabled);
+}
+
+void RenderState::StencilFunc(GLenum func, GLint reference, GLuint mask) {
+    if (!Issue(stencilFunc != func || stencilReference != reference || stencilFuncMask != mask)) return;
+    stencilFunc = func;
+    stencilReference = reference;
+    stencilFuncMask = mask;
+    backend.StencilFunc(func, reference, mask);
+}
+
+void RenderState::StencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass) {
+    if (!Issue(stencilOps[0] != stencilFail || stencilOps[1] != depthFail || stencilOps[2] != depthPass)) return;
+    stencilOps[0] = stencilFail;
+    stencilOps[1] = depthFail;
+    stencilOps[2] = depthPass;
+    backend.StencilOp(stencilFail, depthFail, depthPass);
+}
+
+void RenderState::StencilMask(GLuint mask) {
+    if (!Issue(stencilMask != mask)) return;
+    stencilMask = mask;
+    backend.StencilMask(mask);
+}
+
+void RenderState::Viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    const bool changed = !viewportKnown || viewport[0] != x || viewport[1] != y || viewport[2] != width || viewport[3] != height;
+    if (!Issue(changed)) return;
+    viewport[0] = x;
+    viewport[1] = y;
+    viewport[2] = width;
+    viewport[3] = height;
+    viewportKnown = true;
+    backend.Viewport(x, y, width, height);
+}
+
+void RenderState::PolygonMode(GLenum mode) {
+    if (!Issue(polygonMode != mode)) return;
+    polygonMode = mode;
+    backend.PolygonMode(mode);
+}
+
+void RenderState::LoadUniform(GLint location, GLenum type, const void* data, size_t size, UniformValue& value) {
+    if (!Issue(value.type != type || value.size != size || memcmp(value.data, data, size) != 0)) return;
+    value.type = type;
+    value.size = size;
+    memcpy(value.data, data, size);
+    backend.Uniform(location, value);
+}
+
+size_t RenderState::GetIssuedCount() const {
+    return issuedCount;
+}
+
+size_t RenderState::GetFilteredCount() const {
+    return filteredCount;
+}
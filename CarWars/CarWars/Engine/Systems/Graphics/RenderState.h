@@ -0,0 +1,135 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+
+#define RENDER_STATE_TEXTURE_UNITS 8        // Units whose bindings are cached, more than any pass uses
+#define RENDER_STATE_UNKNOWN 0xFFFFFFFFu    // What a cached name or enum holds until it's next set
+
+// The last value uploaded to one uniform of one program
+struct UniformValue {
+    UniformValue() : type(GL_NONE), size(0) {}
+
+    GLenum type;                        // GL_BOOL, GL_INT, GL_FLOAT, GL_FLOAT_VEC2-4 or GL_FLOAT_MAT4, GL_NONE until loaded
+    size_t size;
+    unsigned char data[sizeof(glm::mat4)];
+};
+
+// Every GL call the render state cache makes. Graphics uses the one that calls straight through to GL, and a backend
+// that records calls instead can stand in for the driver to count what the cache lets through.
+class RenderStateBackend {
+public:
+    virtual ~RenderStateBackend() {}
+
+    virtual void UseProgram(GLuint program) = 0;
+    virtual void BindVertexArray(GLuint vao) = 0;
+    virtual void ActiveTexture(GLenum unit) = 0;
+    virtual void BindTexture(GLenum target, GLuint texture) = 0;
+    virtual void SetEnabled(GLenum capability, bool enabled) = 0;
+    virtual void BlendFunc(GLenum source, GLenum destination) = 0;
+    virtual void DepthFunc(GLenum func) = 0;
+    virtual void DepthMask(bool enabled) = 0;
+    virtual void StencilFunc(GLenum func, GLint reference, GLuint mask) = 0;
+    virtual void StencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass) = 0;
+    virtual void StencilMask(GLuint mask) = 0;
+    virtual void Viewport(GLint x, GLint y, GLsizei width, GLsizei height) = 0;
+    virtual void PolygonMode(GLenum mode) = 0;
+    virtual void Uniform(GLint location, const UniformValue& value) = 0;
+
+    static RenderStateBackend& GetGl();
+};
+
+// Counts the calls it's given instead of making them, so the cache can be checked without a GL context
+class RecordingRenderStateBackend : public RenderStateBackend {
+public:
+    RecordingRenderStateBackend();
+
+    void UseProgram(GLuint program) override;
+    void BindVertexArray(GLuint vao) override;
+    void ActiveTexture(GLenum unit) override;
+    void BindTexture(GLenum target, GLuint texture) override;
+    void SetEnabled(GLenum capability, bool enabled) override;
+    void BlendFunc(GLenum source, GLenum destination) override;
+    void DepthFunc(GLenum func) override;
+    void DepthMask(bool enabled) override;
+    void StencilFunc(GLenum func, GLint reference, GLuint mask) override;
+    void StencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass) override;
+    void StencilMask(GLuint mask) override;
+    void Viewport(GLint x, GLint y, GLsizei width, GLsizei height) override;
+    void PolygonMode(GLenum mode) override;
+    void Uniform(GLint location, const UniformValue& value) override;
+
+    void Reset();
+    size_t GetCallCount() const;        // Calls of any kind since the last reset
+    size_t GetUniformCount() const;     // Uniform uploads since the last reset
+
+private:
+    size_t callCount;
+    size_t uniformCount;
+};
+
+// Remembers the GL state the renderer last set and only passes calls on to the backend when they change something,
+// so per-object draws can set everything they need without re-binding the same program, VAO, textures and viewport.
+// Uniform values are remembered per program by ShaderProgram, and compared here.
+// Anything that changes GL state without going through the cache (uploads, FTGL, ImGui) must be followed by
+// Invalidate, or be known to restore what it changed.
+class RenderState {
+public:
+    explicit RenderState(RenderStateBackend& backend);
+
+    // Forgets the cached state, so the next call of each kind goes through
+    void Invalidate();
+    // Invalidates and starts counting calls again
+    void BeginFrame();
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    // Units are indices (0 for GL_TEXTURE0)
+    void ActiveTexture(GLuint unit);
+    // Binds on the given unit. GL_TEXTURE_2D and GL_TEXTURE_CUBE_MAP are cached, other targets aren't.
+    void BindTexture(GLuint unit, GLenum target, GLuint texture);
+    // GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST and GL_STENCIL_TEST are cached, other capabilities aren't
+    void SetEnabled(GLenum capability, bool enabled);
+    void BlendFunc(GLenum source, GLenum destination);
+    void DepthFunc(GLenum func);
+    void DepthMask(bool enabled);
+    void StencilFunc(GLenum func, GLint reference, GLuint mask);
+    void StencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass);
+    void StencilMask(GLuint mask);
+    void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    void PolygonMode(GLenum mode);
+
+    // Uploads to the current program unless value already holds the same type and bytes, then updates value
+    void LoadUniform(GLint location, GLenum type, const void* data, size_t size, UniformValue& value);
+
+    size_t GetIssuedCount() const;      // Calls passed on to the backend since BeginFrame
+    size_t GetFilteredCount() const;    // Calls skipped since BeginFrame because they'd have changed nothing
+
+private:
+    RenderStateBackend& backend;
+
+    GLuint program;
+    GLuint vao;
+    GLuint activeUnit;
+    GLuint textures[RENDER_STATE_TEXTURE_UNITS][2];     // GL_TEXTURE_2D then GL_TEXTURE_CUBE_MAP
+    GLuint capabilities[4];                             // 0 or 1 for each of the cached capabilities, in order
+    GLenum blendSource;
+    GLenum blendDestination;
+    GLenum depthFunc;
+    GLuint depthMask;
+    GLenum stencilFunc;
+    GLint stencilReference;
+    GLuint stencilFuncMask;
+    GLenum stencilOps[3];
+    GLuint stencilMask;
+    GLint viewport[4];
+    bool viewportKnown;
+    GLenum polygonMode;
+
+    size_t issuedCount;
+    size_t filteredCount;
+
+    // Counts a call, returning whether it should go through
+    bool Issue(bool changed);
+};
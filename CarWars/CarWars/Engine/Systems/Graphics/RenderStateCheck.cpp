@@ -0,0 +1,88 @@
+#include "RenderStateCheck.h"
+#include "RenderState.h"
+
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+namespace {
+    // What one draw of a mesh sets: 8 calls, 9 issued when none are cached because binding the texture also
+    // selects its unit
+    void DrawIdentical(RenderState& renderState, UniformValue& matrixValue, UniformValue& colorValue) {
+        const glm::mat4 matrix(1.f);
+        const glm::vec3 color(1.f, 0.5f, 0.25f);
+
+        renderState.UseProgram(1);
+        renderState.BindVertexArray(2);
+        renderState.BindTexture(0, GL_TEXTURE_2D, 3);
+        renderState.SetEnabled(GL_DEPTH_TEST, true);
+        renderState.DepthFunc(GL_LESS);
+        renderState.Viewport(0, 0, 1280, 720);
+        renderState.LoadUniform(0, GL_FLOAT_MAT4, &matrix, sizeof(matrix), matrixValue);
+        renderState.LoadUniform(1, GL_FLOAT_VEC3, &color, sizeof(color), colorValue);
+    }
+
+    bool Expect(const string& name, const RenderState& renderState, const RecordingRenderStateBackend& backend,
+        size_t issued, size_t filtered, size_t uniforms) {
+
+        cout << name << ": " << renderState.GetIssuedCount() << " issued, " << renderState.GetFilteredCount()
+            << " filtered, " << backend.GetUniformCount() << " uniform uploads" << endl;
+
+        const bool passed = renderState.GetIssuedCount() == issued && renderState.GetFilteredCount() == filtered &&
+            backend.GetCallCount() == issued && backend.GetUniformCount() == uniforms;
+        if (!passed) {
+            cerr << "ERROR: " << name << " expected " << issued << " issued (and as many backend calls), " << filtered
+                << " filtered and " << uniforms << " uniform uploads, but the backend got " << backend.GetCallCount()
+                << " calls" << endl;
+        }
+        return passed;
+    }
+}
+
+bool RenderStateCheck::Run() {
+    const size_t draws = RENDER_STATE_CHECK_DRAW_COUNT;
+    bool passed = true;
+
+    RecordingRenderStateBackend backend;
+    RenderState renderState(backend);
+    UniformValue matrixValue;
+    UniformValue colorValue;
+
+    // Only the first draw changes anything
+    renderState.BeginFrame();
+    for (size_t i = 0; i < draws; ++i) {
+        DrawIdentical(renderState, matrixValue, colorValue);
+    }
+    passed &= Expect("Identical draws", renderState, backend, 9, (draws - 1) * 8, 2);
+
+    // The next frame forgets the GL state, but the program still holds its uniforms
+    backend.Reset();
+    renderState.BeginFrame();
+    for (size_t i = 0; i < draws; ++i) {
+        DrawIdentical(renderState, matrixValue, colorValue);
+    }
+    passed &= Expect("Identical draws, next frame", renderState, backend, 7, (draws - 1) * 8 + 2, 0);
+
+    // Every draw changes the texture and the uniform. After the first, selecting the unit is filtered.
+    backend.Reset();
+    renderState.BeginFrame();
+    UniformValue scaleValue;
+    for (size_t i = 0; i < draws; ++i) {
+        const float scale = i % 2 ? 1.f : 0.5f;
+        renderState.BindTexture(0, GL_TEXTURE_2D, 3 + i % 2);
+        renderState.LoadUniform(2, GL_FLOAT, &scale, sizeof(scale), scaleValue);
+    }
+    passed &= Expect("Alternating draws", renderState, backend, 3 + (draws - 1) * 2, draws - 1, draws);
+
+    // Anything that bypassed the cache invalidates it, after which everything but the uniforms goes through once more
+    backend.Reset();
+    renderState.BeginFrame();
+    DrawIdentical(renderState, matrixValue, colorValue);
+    renderState.Invalidate();
+    DrawIdentical(renderState, matrixValue, colorValue);
+    passed &= Expect("Invalidated draws", renderState, backend, 14, 4, 0);
+
+    cout << (passed ? "Render state cache check passed" : "Render state cache check FAILED") << endl;
+    return passed;
+}
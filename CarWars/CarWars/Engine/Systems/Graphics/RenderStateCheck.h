@@ -0,0 +1,16 @@
+#pragma once
+
+#define RENDER_STATE_CHECK_DRAW_COUNT 100     // Draws per frame, each setting the same state as the last
+
+// Offline check for the render state cache (CarWars.exe --check-render-state). Drives the cache through a recording
+// backend with frames of identical draws, then with draws that alternate a texture and a uniform, and compares what
+// went through to the backend and what was filtered against what the cache should let by. Needs no GL context.
+class RenderStateCheck {
+public:
+    // Returns false if any count differs from what's expected
+    static bool Run();
+
+private:
+    // No instantiation
+    RenderStateCheck() = delete;
+};
@@ -0,0 +1,115 @@
+#include "ResolutionScaler.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+    // Rounded in towards the bounds, so a bound that isn't a whole step is never passed
+    int StepsAtLeast(float scale) {
+        return max(1, static_cast<int>(ceil(scale / RESOLUTION_STEP - 0.001f)));
+    }
+
+    int StepsAtMost(float scale) {
+        return max(1, static_cast<int>(floor(scale / RESOLUTION_STEP + 0.001f)));
+    }
+}
+
+ResolutionScaler::ResolutionScaler() : step(0), minStep(0), maxStep(0), targetTime(RESOLUTION_DEFAULT_TARGET_TIME),
+    averageCpuTime(0.0), averageGpuTime(0.0), sampled(false), raiseFrames(0) {
+
+    SetBounds(RESOLUTION_DEFAULT_MIN_SCALE, RESOLUTION_DEFAULT_MAX_SCALE);
+    step = maxStep;
+}
+
+void ResolutionScaler::SetBounds(float minScale, float maxScale) {
+    minStep = StepsAtLeast(minScale);
+    maxStep = max(minStep, StepsAtMost(maxScale));
+    SetStep(min(max(step, minStep), maxStep));
+}
+
+void ResolutionScaler::SetTargetTime(double seconds) {
+    targetTime = seconds;
+    raiseFrames = 0;
+}
+
+float ResolutionScaler::Update(double cpuTime, double gpuTime, float gpuScale) {
+    if (gpuTime <= 0.0 || gpuScale <= 0.f) return GetScale();
+
+    // Frames still in flight when the scale changed were measured at the old one
+    const double ratio = GetScale() / gpuScale;
+    gpuTime *= ratio * ratio;
+
+    if (sampled) {
+        averageCpuTime += (cpuTime - averageCpuTime) * RESOLUTION_SMOOTHING;
+        averageGpuTime += (gpuTime - averageGpuTime) * RESOLUTION_SMOOTHING;
+    } else {
+        averageCpuTime = cpuTime;
+        averageGpuTime = gpuTime;
+        sampled = true;
+    }
+
+    // The largest scale whose GPU time should fit the budget
+    const double budget = targetTime * RESOLUTION_HEADROOM;
+    const double fittingScale = GetScale() * sqrt(budget / max(averageGpuTime, 1e-6));
+    const int fittingStep = static_cast<int>(floor(fittingScale / RESOLUTION_STEP + 0.001));
+
+    if (fittingStep < step) {
+        SetStep(max(fittingStep, minStep));
+    } else if (fittingStep > step && step < maxStep) {
+        if (++raiseFrames >= RESOLUTION_RAISE_FRAMES) SetStep(step + 1);
+    } else {
+        raiseFrames = 0;
+    }
+
+    return GetScale();
+}
+
+void ResolutionScaler::Reset() {
+    step = maxStep;
+    averageCpuTime = 0.0;
+    averageGpuTime = 0.0;
+    sampled = false;
+    raiseFrames = 0;
+}
+
+float ResolutionScaler::GetScale() const {
+    return step * RESOLUTION_STEP;
+}
+
+float ResolutionScaler::GetMinScale() const {
+    return minStep * RESOLUTION_STEP;
+}
+
+float ResolutionScaler::GetMaxScale() const {
+    return maxStep * RESOLUTION_STEP;
+}
+
+double ResolutionScaler::GetTargetTime() const {
+    return targetTime;
+}
+
+double ResolutionScaler::GetAverageCpuTime() const {
+    return averageCpuTime;
+}
+
+double ResolutionScaler::GetAverageGpuTime() const {
+    return averageGpuTime;
+}
+
+bool ResolutionScaler::IsCpuBound() const {
+    return sampled && averageCpuTime > targetTime && averageGpuTime <= targetTime * RESOLUTION_HEADROOM;
+}
+
+void ResolutionScaler::SetStep(int newStep) {
+    // The average was measured at the old scale, so it's carried over to what the new one should take. Otherwise it
+    // would keep reading over budget for a few frames after a drop and drop again.
+    if (sampled && step > 0 && newStep != step) {
+        const double ratio = static_cast<double>(newStep) / step;
+        averageGpuTime *= ratio * ratio;
+    }
+
+    step = newStep;
+    raiseFrames = 0;
+}
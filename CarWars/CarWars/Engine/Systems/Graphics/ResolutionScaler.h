@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+
+#define RESOLUTION_STEP 0.05f                   // Scales are whole steps, so the render size doesn't change every frame
+#define RESOLUTION_DEFAULT_MIN_SCALE 0.5f
+#define RESOLUTION_DEFAULT_MAX_SCALE 1.f
+#define RESOLUTION_DEFAULT_TARGET_TIME (1.0 / 60.0)     // Seconds
+#define RESOLUTION_HEADROOM 0.9                 // Fraction of the target the GPU is steered towards, leaving room for spikes
+#define RESOLUTION_SMOOTHING 0.1                // Weight of each new frame in the running averages
+#define RESOLUTION_RAISE_FRAMES 30              // Frames in a row with room for a larger scale before it's raised a step
+
+// Picks the scale the scene is rendered at, on each axis, from measured frame times, with no GL so it can be run over
+// recorded or made up frame time traces. GPU time is taken to grow with pixel count, i.e. the square of the scale, so
+// when the average is over budget the scale drops straight to what should fit. Raising it waits until a whole step
+// larger would still fit for RESOLUTION_RAISE_FRAMES frames, so a scale on the edge of the budget doesn't flicker.
+// CPU time is only tracked, since the resolution doesn't change it.
+class ResolutionScaler {
+public:
+    ResolutionScaler();
+
+    void SetBounds(float minScale, float maxScale);
+    void SetTargetTime(double seconds);
+
+    // Takes a frame's CPU and GPU times in seconds and returns the scale to render the next one at. GPU timers come
+    // back a few frames late, so gpuScale is the scale that frame was rendered at, and the time is carried over to the
+    // current scale before it's averaged. Frames without a GPU time (e.g. before the first timer is read back) leave
+    // the scale as it was.
+    float Update(double cpuTime, double gpuTime, float gpuScale);
+
+    // Back to the largest scale with no history, e.g. when it's switched on
+    void Reset();
+
+    float GetScale() const;
+    float GetMinScale() const;
+    float GetMaxScale() const;
+    double GetTargetTime() const;
+    double GetAverageCpuTime() const;
+    double GetAverageGpuTime() const;
+
+    // Missing the target with the GPU inside its budget, so scaling down won't help
+    bool IsCpuBound() const;
+
+private:
+    int step;                   // The scale, in steps
+    int minStep;
+    int maxStep;
+    double targetTime;
+    double averageCpuTime;
+    double averageGpuTime;
+    bool sampled;
+    size_t raiseFrames;
+
+    void SetStep(int newStep);
+};
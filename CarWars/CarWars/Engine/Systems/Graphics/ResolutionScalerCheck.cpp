@@ -0,0 +1,101 @@
+#include "ResolutionScalerCheck.h"
+#include "ResolutionScaler.h"
+
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <utility>
+
+using namespace std;
+
+namespace {
+    const double FIXED_GPU_TIME = 0.004;         // Seconds the scene takes on the GPU at any scale
+    const size_t TIMER_LATENCY = 3;             // Frames before a GPU time is read back
+
+    struct TracePhase {
+        string name;
+        size_t frameCount;
+        double cpuTime;                         // Seconds
+        double fullGpuTime;                     // Seconds at a scale of 1
+        double jitter;                          // Seconds added to odd frames and taken off even ones
+        size_t settleFrames;                    // Frames before the scale must stop changing
+        bool cpuBound;
+    };
+
+    const TracePhase PHASES[] = {
+        { "Light load", 200, 0.008, 0.010, 0.002, 0, false },
+        { "Heavy load", 200, 0.008, 0.028, 0.002, 40, false },
+        { "Moderate load", 400, 0.008, 0.012, 0.002, 300, false },
+        { "CPU bound", 100, 0.025, 0.010, 0.0, 0, true }
+    };
+
+    double GpuTimeAt(float scale, double fullGpuTime) {
+        return FIXED_GPU_TIME + (fullGpuTime - FIXED_GPU_TIME) * scale * scale;
+    }
+
+    // Worked out independently of ResolutionScaler: the largest whole step whose GPU time fits under the headroom
+    float ExpectedScale(const ResolutionScaler& scaler, double fullGpuTime) {
+        const double budget = scaler.GetTargetTime() * RESOLUTION_HEADROOM;
+        const int minStep = static_cast<int>(scaler.GetMinScale() / RESOLUTION_STEP + 0.5f);
+        int step = static_cast<int>(scaler.GetMaxScale() / RESOLUTION_STEP + 0.5f);
+        while (step > minStep && GpuTimeAt(step * RESOLUTION_STEP, fullGpuTime) > budget) --step;
+        return step * RESOLUTION_STEP;
+    }
+
+    bool SameScale(float a, float b) {
+        return abs(a - b) < RESOLUTION_STEP * 0.5f;
+    }
+}
+
+bool ResolutionScalerCheck::Run() {
+    ResolutionScaler scaler;
+    deque<pair<double, float>> inFlight;        // GPU times and the scales they were rendered at, oldest first
+    float scale = scaler.GetScale();
+
+    bool passed = true;
+    for (const TracePhase& phase : PHASES) {
+        const float expected = ExpectedScale(scaler, phase.fullGpuTime);
+        const float floor = min(expected, scale);   // Nothing below what fits, unless it started lower
+        float lowest = scale;
+        size_t lastChange = 0;                  // A scale that flickers keeps changing until the end
+
+        for (size_t frame = 0; frame < phase.frameCount; ++frame) {
+            const double jitter = frame % 2 ? phase.jitter : -phase.jitter;
+            inFlight.push_back(make_pair(GpuTimeAt(scale, phase.fullGpuTime) + jitter, scale));
+            if (inFlight.size() <= TIMER_LATENCY) continue;
+
+            const float previous = scale;
+            scale = scaler.Update(phase.cpuTime, inFlight.front().first, inFlight.front().second);
+            inFlight.pop_front();
+
+            lowest = min(lowest, scale);
+            if (!SameScale(scale, previous)) lastChange = frame + 1;
+        }
+
+        cout << phase.name << ": scale " << scale << " (expected " << expected << "), lowest " << lowest
+            << ", last changed on frame " << lastChange << ", average GPU time "
+            << scaler.GetAverageGpuTime() * 1000.0 << " ms" << endl;
+
+        if (!SameScale(scale, expected)) {
+            cerr << "ERROR: " << phase.name << " ends at a scale of " << scale << " instead of " << expected << endl;
+            passed = false;
+        }
+        if (lastChange > phase.settleFrames) {
+            cerr << "ERROR: " << phase.name << " changes the scale on frame " << lastChange << ", later than "
+                << phase.settleFrames << endl;
+            passed = false;
+        }
+        if (lowest < floor - RESOLUTION_STEP * 0.5f) {
+            cerr << "ERROR: " << phase.name << " drops to a scale of " << lowest << ", below " << floor << endl;
+            passed = false;
+        }
+        if (scaler.IsCpuBound() != phase.cpuBound) {
+            cerr << "ERROR: " << phase.name << (phase.cpuBound ? " isn't" : " is") << " reported as CPU bound" << endl;
+            passed = false;
+        }
+    }
+
+    cout << (passed ? "Resolution scaler check passed" : "Resolution scaler check FAILED") << endl;
+    return passed;
+}
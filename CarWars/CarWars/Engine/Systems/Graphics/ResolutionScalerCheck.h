@@ -0,0 +1,15 @@
+#pragma once
+
+// Offline check for the resolution scaler (CarWars.exe --check-resolution). Runs it over a made up trace: a scene
+// whose GPU time is a fixed cost plus a part that grows with pixel count, timers that come back a few frames late,
+// and loads that go from light to heavy to moderate and then CPU bound. Checks the scale it settles at under each
+// load, how fast it gets there and that it doesn't flicker once it has. Needs no GL context.
+class ResolutionScalerCheck {
+public:
+    // Returns false if the scaler strays from what's expected under any load
+    static bool Run();
+
+private:
+    // No instantiation
+    ResolutionScalerCheck() = delete;
+};
@@ -39,6 +39,9 @@ InputManager &InputManager::Instance() {
 }
 
 void InputManager::Update() {
+	// Poll here rather than in Graphics so Graphics can run alongside other systems
+	glfwPollEvents();
+
 	HandleMouse();
 	HandleKeyboard();
 	HandleController();
@@ -54,8 +57,8 @@ void InputManager::HandleMouse() {
 		glfwSetInputMode(graphicsInstance.GetWindow(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 		HumanData& player = Game::humanPlayers[0];
 		if (!player.ready || !player.alive) return;
-		VehicleComponent* vehicle = player.vehicleEntity->GetComponent<VehicleComponent>();
-		WeaponComponent* weapon = player.vehicleEntity->GetComponent<WeaponComponent>();
+		VehicleComponent* vehicle = player.vehicle;
+		WeaponComponent* weapon = player.weapon;
 		CameraComponent* cameraC = player.camera;
 
 		//Shoot Weapon
@@ -66,25 +69,17 @@ void InputManager::HandleMouse() {
 			PxScene* scene = &Physics::Instance().GetScene();
 			glm::vec3 cameraDirection = glm::normalize(cameraC->GetTarget() - cameraC->GetPosition());
 
-			float lowestDot = 999.0f;
-			Entity* closestAimVehicle = nullptr;
+			// Aim Assist: best aligned enemy vehicle inside a narrow cone around the camera direction
+			SpatialQueryFilter filter;
+			filter.tag = "Vehicle";
+			filter.excludeTeam = static_cast<int>(player.teamIndex);
+			filter.exclude = vehicle->GetEntity();
+			const FrameVector<Entity*> aimVehicles = Physics::Instance().GetSpatialIndex().QueryCone(
+				vehicle->GetEntity()->transform.GetGlobalPosition(), cameraDirection, M_PI_4 / 16.0f, 40.0f, filter);
+
 			glm::vec3 cameraHit;
-			for (Component* component : EntityManager::GetComponents(ComponentType_Vehicle)) {
-				VehicleComponent* vehicleComponent = static_cast<VehicleComponent*>(component);
-				Entity* vehicleEntity = vehicleComponent->GetEntity();
-				if ((vehicleEntity->GetId() != vehicle->GetEntity()->GetId()) && (Game::GetPlayerFromEntity(vehicleEntity)->teamIndex != Game::GetPlayerFromEntity(vehicle->GetEntity())->teamIndex)) {
-					glm::vec3 otherVehiclePos = vehicleEntity->transform.GetGlobalPosition();
-					glm::vec3 dirToOtherVehicle = otherVehiclePos - vehicle->GetEntity()->transform.GetGlobalPosition();
-					if (glm::length(dirToOtherVehicle) < 40.0f) {
-						if (glm::dot(cameraDirection, glm::normalize(dirToOtherVehicle)) < lowestDot) {
-							closestAimVehicle = vehicleEntity;
-							lowestDot = glm::dot(cameraDirection, glm::normalize(dirToOtherVehicle));
-						}
-					}
-				}
-			}
-			if (closestAimVehicle && acos(lowestDot) < (M_PI_4 / 16.0f)) {
-				cameraHit = closestAimVehicle->transform.GetGlobalPosition();
+			if (!aimVehicles.empty()) {
+				cameraHit = aimVehicles.front()->transform.GetGlobalPosition();
 			} else {
 				PxQueryFilterData filterData;
 				filterData.data.word0 = RaycastGroups::GetGroupsMask(vehicle->GetRaycastGroup() | RaycastGroups::GetPowerUpGroup());
@@ -265,8 +260,8 @@ Entity* OpenMenu(int playerIndex, std::string menuName, std::string prefabName,
     }
     Entity* menu = EntityManager::FindFirstChild(guiRoot, menuName);
 
-    Effects::Instance().DestroyTween(menuName + "Out" + to_string(playerIndex));
-    Effects::Instance().DestroyTween(menuName + "OutS" + to_string(playerIndex));
+    Effects::Instance().DestroyTween(TweenTag(menuName + "Out", playerIndex));
+    Effects::Instance().DestroyTween(TweenTag(menuName + "OutS", playerIndex));
 
     if (!menu) {
         menu = ContentManager::LoadEntity(prefabName, guiRoot);
@@ -277,18 +272,18 @@ Entity* OpenMenu(int playerIndex, std::string menuName, std::string prefabName,
     background->SetOpacity(1.f);
 
     auto tween = GuiHelper::TweenOpacityRecursive<easing::Quad::easeOut>(menu, 1.f, 0.1, StateManager::globalTime, { background });
-    tween->SetDelay(0.05);
-    tween->SetTag(menuName + "In" + to_string(playerIndex));
-    tween->Start();
+    tween.SetDelay(0.05);
+    tween.SetTag(TweenTag(menuName + "In", playerIndex));
+    tween.Start();
 
     const glm::vec3 start = background->transform.GetLocalScale();
     const glm::vec3 end = glm::vec3(dims.x, dims.y, 0);
     auto tween2 = Effects::Instance().CreateTween<glm::vec3, easing::Back::easeOut>(start, end, 0.4, StateManager::globalTime);
-    tween2->SetUpdateCallback([background](glm::vec3& value) mutable {
+    tween2.SetUpdateCallback([background](glm::vec3& value) mutable {
         background->transform.SetScale(value);
     });
-    tween2->SetTag(menuName + "InS" + to_string(playerIndex));
-    tween2->Start();
+    tween2.SetTag(TweenTag(menuName + "InS", playerIndex));
+    tween2.Start();
 
     return menu;
 }
@@ -298,27 +293,27 @@ void CloseMenu(int playerIndex, std::string menuName) {
     Entity* menu = EntityManager::FindFirstChild(guiRoot, menuName);
     if (!menu) return;
 
-    Effects::Instance().DestroyTween(menuName + "In" + to_string(playerIndex));
-    Effects::Instance().DestroyTween(menuName + "InS" + to_string(playerIndex));
+    Effects::Instance().DestroyTween(TweenTag(menuName + "In", playerIndex));
+    Effects::Instance().DestroyTween(TweenTag(menuName + "InS", playerIndex));
 
     GuiComponent* background = GuiHelper::GetFirstGui(menu);
 
     auto tween = GuiHelper::TweenOpacityRecursive<easing::Quad::easeOut>(menu, 0.f, 0.1, StateManager::globalTime, { background });
-    tween->SetTag(menuName + "Out" + to_string(playerIndex));
-    tween->SetDelay(0.2);
-    tween->Start();
+    tween.SetTag(TweenTag(menuName + "Out", playerIndex));
+    tween.SetDelay(0.2);
+    tween.Start();
 
     const glm::vec3 start = background->transform.GetLocalScale();
     const glm::vec3 end;
     auto tween2 = Effects::Instance().CreateTween<glm::vec3, easing::Back::easeIn>(start, end, 0.4, StateManager::globalTime);
-    tween2->SetUpdateCallback([background](glm::vec3& value) mutable {
+    tween2.SetUpdateCallback([background](glm::vec3& value) mutable {
         background->transform.SetScale(value);
     });
-    tween2->SetFinishedCallback([menu](glm::vec3& value) mutable {
+    tween2.SetFinishedCallback([menu](glm::vec3& value) mutable {
         EntityManager::DestroyEntity(menu);
     });
-    tween2->SetTag(menuName + "OutS" + to_string(playerIndex));
-    tween2->Start();
+    tween2.SetTag(TweenTag(menuName + "OutS", playerIndex));
+    tween2.Start();
 }
 
 void InputManager::NavigateGuis(GuiNavData navData) {
@@ -521,7 +516,7 @@ void InputManager::NavigateGuis(GuiNavData navData) {
 		} else if (gameState == GameState_Menu_GameEnd) {
             GuiComponent* selected = GuiHelper::GetSelectedGui("Buttons");
             if (selected) {
-                std::vector<Entity*> entities = EntityManager::FindEntities("LeaderboardMenu");
+                FrameVector<Entity*> entities = EntityManager::FindEntities("LeaderboardMenu");
                 if (entities.size() > 0) {
                     Game::Instance().ResetGame();
                     StateManager::SetState(GameState_Menu);
@@ -529,13 +524,13 @@ void InputManager::NavigateGuis(GuiNavData navData) {
                     GuiComponent* winnerTitle = GuiHelper::GetFirstGui("WinnerTitle");
                     
                     auto tween = Effects::Instance().CreateTween<float, easing::Expo::easeOut>(0.f, 1.f, 1.0, StateManager::globalTime);
-					tween->SetTag("WinnerTitle");
-                    tween->SetUpdateCallback([winnerTitle](float& value) mutable {
+					tween.SetTag("WinnerTitle");
+                    tween.SetUpdateCallback([winnerTitle](float& value) mutable {
                         winnerTitle->SetFontSize(glm::mix(128.f, 64.f, value));
                         winnerTitle->SetScaledPosition(glm::mix(glm::vec2(0.5f, 0.5f), glm::vec2(0.5f, 0.f), value));
                         winnerTitle->transform.SetPosition(glm::mix(glm::vec3(0.f, 0.f, 0.f), glm::vec3(0.f, 100.f, 0.f), value));
                     });
-                    tween->Start();
+                    tween.Start();
 
                     Entity* leaderboard = OpenMenu(-1, "LeaderboardMenu", "Menu/LeaderboardMenu.json", glm::vec2(800.f, 550.f));
                     CreateLeaderboardMenu(leaderboard, -1);
@@ -654,8 +649,8 @@ void InputManager::HandleKeyboard() {
 		HumanData& player = Game::humanPlayers[0];
 		if (!player.alive) return;
 
-		VehicleComponent* vehicle = player.vehicleEntity->GetComponent<VehicleComponent>();
-		WeaponComponent* weapon = player.vehicleEntity->GetComponent<WeaponComponent>();
+		VehicleComponent* vehicle = player.vehicle;
+		WeaponComponent* weapon = player.weapon;
 		CameraComponent* cameraC = player.camera;
 
 		float forwardPower = 0;
@@ -736,8 +731,8 @@ void InputManager::HandleVehicleControllerInput(size_t controllerNum, int &leftV
 		// -------------------------------------------------------------------------------------------------------------- //
 		HumanData& player = Game::humanPlayers[controllerNum];
 		if (!player.alive) return;
-		VehicleComponent* vehicle = player.vehicleEntity->GetComponent<VehicleComponent>();
-		WeaponComponent* weapon = player.vehicleEntity->GetComponent<WeaponComponent>();
+		VehicleComponent* vehicle = player.vehicle;
+		WeaponComponent* weapon = player.weapon;
 		CameraComponent* cameraC = player.camera;
 
 		// -------------------------------------------------------------------------------------------------------------- //
@@ -855,23 +850,26 @@ void InputManager::HandleVehicleControllerInput(size_t controllerNum, int &leftV
 			if (!(player.weaponType == WeaponType::RocketLauncher)) {
 				// Aim Assist
 				glm::vec3 cameraDirection = glm::normalize(cameraC->GetTarget() - cameraC->GetPosition());
-				float lowestDot = 999.0f;
+				SpatialQueryFilter filter;
+				filter.tag = "Vehicle";
+				filter.excludeTeam = static_cast<int>(player.teamIndex);
+				filter.exclude = vehicle->GetEntity();
+				const glm::vec3 vehiclePos = vehicle->GetEntity()->transform.GetGlobalPosition();
+
+				// The allowed angle shrinks with distance, so keep the best aligned vehicle that is inside its own cone
+				float highestDot = -1.0f;
 				Entity* closestAimVehicle = nullptr;
-				for (Component* component : EntityManager::GetComponents(ComponentType_Vehicle)) {
-					VehicleComponent* vehicleComponent = static_cast<VehicleComponent*>(component);
-					Entity* vehicleEntity = vehicleComponent->GetEntity();
-					if ((vehicleEntity->GetId() != vehicle->GetEntity()->GetId()) && (Game::GetPlayerFromEntity(vehicleEntity)->teamIndex != Game::GetPlayerFromEntity(vehicle->GetEntity())->teamIndex)) {
-						glm::vec3 otherVehiclePos = vehicleEntity->transform.GetGlobalPosition();
-						glm::vec3 dirToOtherVehicle = otherVehiclePos - vehicle->GetEntity()->transform.GetGlobalPosition();
-						if (glm::length(dirToOtherVehicle) < 150.0f) {
-							if (glm::dot(cameraDirection, glm::normalize(dirToOtherVehicle)) < lowestDot) {
-								closestAimVehicle = vehicleEntity;
-								lowestDot = glm::dot(cameraDirection, glm::normalize(dirToOtherVehicle));
-							}
-						}
+				for (Entity* vehicleEntity : Physics::Instance().GetSpatialIndex().QueryRadius(vehiclePos, 150.0f, filter)) {
+					const glm::vec3 dirToOtherVehicle = vehicleEntity->transform.GetGlobalPosition() - vehiclePos;
+					const float distance = glm::length(dirToOtherVehicle);
+					if (distance <= 0.0f) continue;
+					const float dot = glm::clamp(glm::dot(cameraDirection, dirToOtherVehicle / distance), -1.0f, 1.0f);
+					if (acos(dot) < (6.0f / distance) && dot > highestDot) {
+						closestAimVehicle = vehicleEntity;
+						highestDot = dot;
 					}
 				}
-				if (closestAimVehicle && acos(lowestDot) < (6.0f / glm::length(closestAimVehicle->transform.GetGlobalPosition() - vehicle->GetEntity()->transform.GetGlobalPosition()))) {
+				if (closestAimVehicle) {
 					float pull = 1.f;
 					cameraHit = closestAimVehicle->transform.GetGlobalPosition() * pull + cameraHit * (1 - pull);
 				}
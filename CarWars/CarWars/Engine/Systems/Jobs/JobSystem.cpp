@@ -0,0 +1,186 @@
+#include "JobSystem.h"
+
+#include "task/PxTask.h"
+#include <algorithm>
+
+namespace {
+	// Index of the deque owned by the current thread. Threads outside the pool share the main thread's deque.
+	thread_local size_t workerIndex = 0;
+}
+
+JobCounter::JobCounter() : count(0) {}
+
+bool JobCounter::IsDone() const {
+	return count.load() == 0;
+}
+
+void JobCounter::Increment() {
+	count++;
+}
+
+void JobCounter::Decrement() {
+	std::vector<std::pair<std::function<void()>, JobCounter*>> ready;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (count.load() == 1) ready.swap(continuations);
+		count--;
+	}
+
+	for (auto& continuation : ready) {
+		JobSystem::Instance().Push({ continuation.first, continuation.second });
+	}
+}
+
+// Singleton
+JobSystem::JobSystem() : queuedJobs(0), quit(false) {
+	queues.push_back(new Worker());
+}
+
+JobSystem &JobSystem::Instance() {
+	static JobSystem instance;
+	return instance;
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		quit = true;
+	}
+	wake.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+
+	for (Worker* queue : queues) {
+		delete queue;
+	}
+}
+
+void JobSystem::Initialize(size_t workerCount) {
+	if (!workers.empty()) return;
+
+	if (workerCount == 0) {
+		const size_t cores = std::thread::hardware_concurrency();
+		workerCount = cores > 1 ? cores - 1 : 1;
+	}
+
+	for (size_t i = 0; i < workerCount; ++i) {
+		queues.push_back(new Worker());
+	}
+	for (size_t i = 0; i < workerCount; ++i) {
+		workers.push_back(std::thread(&JobSystem::WorkerLoop, this, i + 1));
+	}
+}
+
+void JobSystem::Run(std::function<void()> job, JobCounter* counter) {
+	if (counter) counter->Increment();
+	Push({ job, counter });
+}
+
+void JobSystem::RunAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter) {
+	if (counter) counter->Increment();
+	{
+		std::lock_guard<std::mutex> lock(dependency.mutex);
+		if (!dependency.IsDone()) {
+			dependency.continuations.push_back(std::make_pair(job, counter));
+			return;
+		}
+	}
+	Push({ job, counter });
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+	while (!counter.IsDone()) {
+		Job job;
+		if (Pop(job) || Steal(job)) {
+			Execute(job);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+
+	// The last job may still be releasing the counter's continuations
+	std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+size_t JobSystem::GetThreadCount() const {
+	return workers.size() + 1;
+}
+
+void JobSystem::submitTask(physx::PxBaseTask& task) {
+	physx::PxBaseTask* pxTask = &task;
+	Run([pxTask]() {
+		pxTask->run();
+		pxTask->release();
+	});
+}
+
+uint32_t JobSystem::getWorkerCount() const {
+	return static_cast<uint32_t>(workers.size());
+}
+
+void JobSystem::Push(Job job) {
+	// Without any workers everything runs inline
+	if (workers.empty()) {
+		Execute(job);
+		return;
+	}
+
+	Worker* queue = queues[workerIndex];
+	{
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		queue->jobs.push_back(job);
+	}
+	queuedJobs++;
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+	}
+	wake.notify_one();
+}
+
+bool JobSystem::Pop(Job& job) {
+	Worker* queue = queues[workerIndex];
+	std::lock_guard<std::mutex> lock(queue->mutex);
+	if (queue->jobs.empty()) return false;
+
+	job = queue->jobs.back();
+	queue->jobs.pop_back();
+	queuedJobs--;
+	return true;
+}
+
+bool JobSystem::Steal(Job& job) {
+	for (size_t i = 1; i < queues.size(); ++i) {
+		Worker* queue = queues[(workerIndex + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		if (queue->jobs.empty()) continue;
+
+		job = queue->jobs.front();
+		queue->jobs.pop_front();
+		queuedJobs--;
+		return true;
+	}
+	return false;
+}
+
+void JobSystem::Execute(Job& job) {
+	job.function();
+	if (job.counter) job.counter->Decrement();
+}
+
+void JobSystem::WorkerLoop(size_t index) {
+	workerIndex = index;
+
+	while (true) {
+		Job job;
+		if (Pop(job) || Steal(job)) {
+			Execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wake.wait(lock, [this]() { return quit || queuedJobs.load() > 0; });
+		if (quit) return;
+	}
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "task/PxCpuDispatcher.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+// Counts outstanding jobs. Wait on it to block until they are all finished,
+// or queue jobs after it that are only submitted once it reaches zero.
+class JobCounter {
+public:
+	JobCounter();
+
+	bool IsDone() const;
+
+private:
+	friend class JobSystem;
+
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator= (const JobCounter&) = delete;
+
+	void Increment();
+	void Decrement();
+
+	std::atomic<int> count;
+
+	// Jobs waiting on this counter, guarded by mutex so they can't be added while the last job finishes
+	std::mutex mutex;
+	std::vector<std::pair<std::function<void()>, JobCounter*>> continuations;
+};
+
+// Pool of worker threads with one work-stealing deque each.
+// Workers take their own newest job first and steal the oldest job from other workers when they run dry.
+// The main thread owns deque 0 and helps out whenever it waits on a counter.
+// The pool is also handed to PhysX as its CPU dispatcher so that the simulation shares the same threads.
+class JobSystem : public physx::PxCpuDispatcher {
+public:
+	// Access the singleton instance
+	static JobSystem& Instance();
+	~JobSystem();
+
+	// Starts the workers. One thread per core is kept for the main thread.
+	void Initialize(size_t workerCount = 0);
+
+	// Queue a job. If counter is given it is incremented now and decremented when the job finishes.
+	void Run(std::function<void()> job, JobCounter* counter = nullptr);
+
+	// Queue a job that only starts once dependency has reached zero
+	void RunAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter = nullptr);
+
+	// Runs other jobs on this thread until counter reaches zero
+	void Wait(JobCounter& counter);
+
+	// Calls body(begin, end) over [0, count) in chunks of at most grainSize, and returns when every chunk is done
+	template <typename F>
+	void ParallelFor(size_t count, size_t grainSize, F body) {
+		if (count == 0) return;
+		if (grainSize == 0) grainSize = 1;
+		if (count <= grainSize || workers.empty()) {
+			body(static_cast<size_t>(0), count);
+			return;
+		}
+
+		JobCounter counter;
+		for (size_t begin = grainSize; begin < count; begin += grainSize) {
+			const size_t end = begin + grainSize < count ? begin + grainSize : count;
+			Run([&body, begin, end]() { body(begin, end); }, &counter);
+		}
+
+		// Do the first chunk here rather than sitting idle
+		body(static_cast<size_t>(0), grainSize);
+		Wait(counter);
+	}
+
+	// Calls body(i) for every i in [0, count)
+	template <typename F>
+	void ParallelForEach(size_t count, size_t grainSize, F body) {
+		ParallelFor(count, grainSize, [&body](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) body(i);
+		});
+	}
+
+	size_t GetThreadCount() const;
+
+	// PxCpuDispatcher
+	void submitTask(physx::PxBaseTask& task) override;
+	uint32_t getWorkerCount() const override;
+
+private:
+	friend class JobCounter;
+
+	// No instantiation or copying
+	JobSystem();
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator= (const JobSystem&) = delete;
+
+	struct Job {
+		std::function<void()> function;
+		JobCounter* counter;
+	};
+
+	struct Worker {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	void Push(Job job);
+	bool Pop(Job& job);
+	bool Steal(Job& job);
+	void Execute(Job& job);
+	void WorkerLoop(size_t index);
+
+	// Deque 0 belongs to the main thread, the rest to the worker threads
+	std::vector<Worker*> queues;
+	std::vector<std::thread> workers;
+
+	// Sleeping workers are woken when jobs are queued
+	std::atomic<int> queuedJobs;
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+	bool quit;
+};
@@ -0,0 +1,214 @@
+#include "FrameAllocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+	// Every bump is rounded up to this so the next one starts aligned for anything but over-aligned types
+	constexpr size_t ARENA_ALIGNMENT = 16;
+
+	// Arenas don't grow past this (e.g. after loading a scene); bigger frames keep spilling to the heap instead
+	constexpr size_t MAX_ARENA_CAPACITY = 64 * 1024 * 1024;
+
+	std::atomic<size_t> heapAllocationCount(0);
+
+	size_t RoundUp(size_t value, size_t alignment) {
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	void* AlignPointer(void* pointer, size_t alignment) {
+		return reinterpret_cast<void*>(RoundUp(reinterpret_cast<uintptr_t>(pointer), alignment));
+	}
+
+	void* CountedMalloc(size_t size) {
+		heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+		return malloc(size ? size : 1);
+	}
+}
+
+// Replace the global allocation functions so that the debug GUI can show how many heap allocations each frame makes
+
+void* operator new(size_t size) {
+	void* memory = CountedMalloc(size);
+	if (!memory) abort();
+	return memory;
+}
+
+void* operator new[](size_t size) {
+	void* memory = CountedMalloc(size);
+	if (!memory) abort();
+	return memory;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	return CountedMalloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	return CountedMalloc(size);
+}
+
+void operator delete(void* memory) noexcept {
+	free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+	free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+	free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+	free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+	free(memory);
+}
+
+FrameArena::FrameArena(size_t _capacity) : buffer(nullptr), capacity(RoundUp(_capacity, ARENA_ALIGNMENT)),
+	offset(0), allocationCount(0), overflowBytes(0), overflowCount(0), lastUsed(0), peakUsed(0) {
+	buffer = static_cast<char*>(malloc(capacity));
+	if (!buffer) capacity = 0;
+}
+
+FrameArena::~FrameArena() {
+	Reset();
+	free(buffer);
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	// Over-aligned types need room to shift the pointer forwards
+	const size_t padding = alignment > ARENA_ALIGNMENT ? alignment : 0;
+	const size_t bytes = RoundUp(size + padding, ARENA_ALIGNMENT);
+
+	const size_t start = offset.fetch_add(bytes, std::memory_order_relaxed);
+	if (start + bytes > capacity) return AllocateOverflow(size, alignment);
+
+	char* memory = buffer + start;
+	return padding ? AlignPointer(memory, alignment) : memory;
+}
+
+void* FrameArena::AllocateOverflow(size_t size, size_t alignment) {
+	const size_t padding = alignment > ARENA_ALIGNMENT ? alignment : 0;
+	const size_t bytes = std::max<size_t>(size + padding, 1);
+	void* block = malloc(bytes);
+	if (!block) abort();
+
+	overflowBytes.fetch_add(bytes, std::memory_order_relaxed);
+	overflowCount.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(overflowMutex);
+		overflowBlocks.push_back(block);
+	}
+
+	return padding ? AlignPointer(block, alignment) : block;
+}
+
+void FrameArena::Reset() {
+	lastUsed = GetUsed();
+	peakUsed = std::max(peakUsed, lastUsed);
+
+	for (void* block : overflowBlocks) {
+		free(block);
+	}
+	overflowBlocks.clear();
+
+	// Grow to fit everything this frame needed so that the next frame like it stays in the arena
+	if (overflowCount > 0 && capacity < MAX_ARENA_CAPACITY) {
+		size_t newCapacity = std::max(capacity, ARENA_ALIGNMENT);
+		while (newCapacity < lastUsed && newCapacity < MAX_ARENA_CAPACITY) newCapacity *= 2;
+		newCapacity = std::min(newCapacity, MAX_ARENA_CAPACITY);
+
+		char* newBuffer = static_cast<char*>(malloc(newCapacity));
+		if (newBuffer) {
+			free(buffer);
+			buffer = newBuffer;
+			capacity = newCapacity;
+		}
+	}
+
+	offset = 0;
+	allocationCount = 0;
+	overflowBytes = 0;
+	overflowCount = 0;
+}
+
+size_t FrameArena::GetCapacity() const {
+	return capacity;
+}
+
+size_t FrameArena::GetUsed() const {
+	// Failed bumps still advance the offset, so clamp to what actually came from the buffer
+	return std::min(offset.load(), capacity) + overflowBytes.load();
+}
+
+size_t FrameArena::GetLastUsed() const {
+	return lastUsed;
+}
+
+size_t FrameArena::GetPeakUsed() const {
+	return peakUsed;
+}
+
+size_t FrameArena::GetAllocationCount() const {
+	return allocationCount;
+}
+
+size_t FrameArena::GetOverflowCount() const {
+	return overflowCount;
+}
+
+FrameAllocator& FrameAllocator::Instance() {
+	static FrameAllocator instance;
+	return instance;
+}
+
+FrameAllocator::FrameAllocator() : arena(1024 * 1024), twoFrameIndex(0), heapAllocationsAtFrameStart(0), heapAllocationsLastFrame(0) {}
+
+void FrameAllocator::BeginFrame() {
+	heapAllocationsLastFrame = GetTotalHeapAllocationCount() - heapAllocationsAtFrameStart;
+
+	arena.Reset();
+
+	// The arena written two frames ago is free again; the one written last frame is left alone
+	twoFrameIndex = 1 - twoFrameIndex;
+	twoFrameArenas[twoFrameIndex].Reset();
+
+	// Don't count the arenas growing against the frame that's starting
+	heapAllocationsAtFrameStart = GetTotalHeapAllocationCount();
+}
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment) {
+	return arena.Allocate(size, alignment);
+}
+
+void* FrameAllocator::AllocateTwoFrame(size_t size, size_t alignment) {
+	return twoFrameArenas[twoFrameIndex].Allocate(size, alignment);
+}
+
+const FrameArena& FrameAllocator::GetArena() const {
+	return arena;
+}
+
+const FrameArena& FrameAllocator::GetTwoFrameArena() const {
+	return twoFrameArenas[twoFrameIndex];
+}
+
+size_t FrameAllocator::GetHeapAllocationCount() const {
+	return heapAllocationsLastFrame;
+}
+
+size_t FrameAllocator::GetTotalHeapAllocationCount() {
+	return heapAllocationCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Linear allocator that releases everything it handed out in one go when it is reset.
+// Allocating is a single atomic bump, so any thread can allocate from the same arena. Requests that don't fit
+// fall back to the heap and the arena grows to cover them on the next reset, so steady-state frames never hit the heap.
+class FrameArena {
+public:
+	explicit FrameArena(size_t capacity = 256 * 1024);
+	~FrameArena();
+
+	void* Allocate(size_t size, size_t alignment);
+
+	// Frees every allocation at once. Must not be called while another thread is allocating.
+	void Reset();
+
+	size_t GetCapacity() const;
+	size_t GetUsed() const;				// Bytes handed out since the last reset
+	size_t GetLastUsed() const;			// Bytes handed out between the last two resets
+	size_t GetPeakUsed() const;			// Most bytes handed out between any two resets
+	size_t GetAllocationCount() const;	// Allocations since the last reset
+	size_t GetOverflowCount() const;	// Allocations since the last reset that didn't fit and went to the heap
+
+private:
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator= (const FrameArena&) = delete;
+
+	void* AllocateOverflow(size_t size, size_t alignment);
+
+	char* buffer;
+	size_t capacity;
+
+	std::atomic<size_t> offset;
+	std::atomic<size_t> allocationCount;
+	std::atomic<size_t> overflowBytes;
+	std::atomic<size_t> overflowCount;
+
+	size_t lastUsed;
+	size_t peakUsed;
+
+	// Heap blocks for allocations that didn't fit, freed on reset
+	std::mutex overflowMutex;
+	std::vector<void*> overflowBlocks;
+};
+
+// Owns the per-frame arenas. Memory from Allocate lives until the next BeginFrame, memory from AllocateTwoFrame
+// lives until the BeginFrame after that (e.g. for results produced one frame and consumed the next).
+class FrameAllocator {
+public:
+	// Access the singleton instance
+	static FrameAllocator& Instance();
+
+	// Releases the memory from the previous frame. Call once at the very start of each frame.
+	void BeginFrame();
+
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+	void* AllocateTwoFrame(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	const FrameArena& GetArena() const;
+	const FrameArena& GetTwoFrameArena() const;
+
+	// Number of global heap allocations (operator new) made during the last full frame and in total
+	size_t GetHeapAllocationCount() const;
+	static size_t GetTotalHeapAllocationCount();
+
+private:
+	// Singleton
+	FrameAllocator();
+	FrameAllocator(const FrameAllocator&) = delete;
+	FrameAllocator& operator= (const FrameAllocator&) = delete;
+
+	FrameArena arena;
+	FrameArena twoFrameArenas[2];
+	size_t twoFrameIndex;
+
+	size_t heapAllocationsAtFrameStart;
+	size_t heapAllocationsLastFrame;
+};
+
+// STL allocator over the frame arenas. Deallocation is a no-op, so containers using it must not outlive the frame
+// (or the frame after, for TwoFrame) and must not be stored anywhere that does.
+template <class T, bool TwoFrame = false>
+class FrameStlAllocator {
+public:
+	typedef T value_type;
+
+	template <class U>
+	struct rebind {
+		typedef FrameStlAllocator<U, TwoFrame> other;
+	};
+
+	FrameStlAllocator() {}
+	template <class U>
+	FrameStlAllocator(const FrameStlAllocator<U, TwoFrame>&) {}
+
+	T* allocate(size_t count) {
+		FrameAllocator& allocator = FrameAllocator::Instance();
+		void* memory = TwoFrame ?
+			allocator.AllocateTwoFrame(count * sizeof(T), alignof(T)) :
+			allocator.Allocate(count * sizeof(T), alignof(T));
+		return static_cast<T*>(memory);
+	}
+
+	void deallocate(T*, size_t) {}
+
+	template <class U>
+	bool operator== (const FrameStlAllocator<U, TwoFrame>&) const { return true; }
+	template <class U>
+	bool operator!= (const FrameStlAllocator<U, TwoFrame>&) const { return false; }
+};
+
+template <class T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+template <class T>
+using TwoFrameVector = std::vector<T, FrameStlAllocator<T, true>>;
+
+template <class K, class V>
+using FrameUnorderedMap = std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, FrameStlAllocator<std::pair<const K, V>>>;
+
+typedef std::basic_string<char, std::char_traits<char>, FrameStlAllocator<char>> FrameString;
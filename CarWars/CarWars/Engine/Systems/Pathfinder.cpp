@@ -32,18 +32,19 @@ std::vector<glm::vec3> Pathfinder::FindPath(NavigationMesh* navigationMesh, glm:
         return {};
     }
     
-    std::vector<size_t> closedSet;
-    std::vector<size_t> openSet = {startIndex};
+    // All of the search state is scratch memory for this frame
+    FrameVector<size_t> closedSet;
+    FrameVector<size_t> openSet = {startIndex};
 
     // TODO: Use array instead?
-    std::unordered_map<size_t, size_t> cameFrom;
+    FrameUnorderedMap<size_t, size_t> cameFrom;
 
     // TODO: Use array instead?
-    std::unordered_map<size_t, float> gScore;
+    FrameUnorderedMap<size_t, float> gScore;
     gScore[startIndex] = 0.f;
 
     // TODO: Use array instead?
-    std::unordered_map<size_t, float> fScore;
+    FrameUnorderedMap<size_t, float> fScore;
     fScore[startIndex] = HeuristicCostEstimate(navigationMesh, startIndex, goalIndex);
 
     int iterationsLeft = 2500;
@@ -57,7 +58,7 @@ std::vector<glm::vec3> Pathfinder::FindPath(NavigationMesh* navigationMesh, glm:
         openSet.erase(std::remove(openSet.begin(), openSet.end(), current), openSet.end());
         closedSet.push_back(current);
 
-        std::vector<size_t> neighbours = navigationMesh->GetNeighbours(current);
+        const FrameVector<size_t> neighbours = navigationMesh->GetNeighbours(current);
         for (size_t neighbour : neighbours) {
             if (std::find(closedSet.begin(), closedSet.end(), neighbour) != closedSet.end()) continue;
 
@@ -91,7 +92,7 @@ float Pathfinder::HeuristicCostEstimate(glm::vec3 pos0, glm::vec3 pos1) {
     return glm::length(pos0 - pos1);
 }
 
-size_t Pathfinder::GetCurrent(std::vector<size_t>& openSet, std::unordered_map<size_t, float>& fScore) {
+size_t Pathfinder::GetCurrent(FrameVector<size_t>& openSet, FrameUnorderedMap<size_t, float>& fScore) {
     size_t lowest = openSet[0];
     float lowestScore = GetScore(fScore, lowest);
     for (size_t i = 1; i < openSet.size(); ++i) {
@@ -105,7 +106,7 @@ size_t Pathfinder::GetCurrent(std::vector<size_t>& openSet, std::unordered_map<s
     return lowest;
 }
 
-float Pathfinder::GetScore(std::unordered_map<size_t, float>& scoreMap, size_t index) {
+float Pathfinder::GetScore(FrameUnorderedMap<size_t, float>& scoreMap, size_t index) {
     const auto it = scoreMap.find(index);
     if (it == scoreMap.end()) {
         return INFINITY;
@@ -113,7 +114,7 @@ float Pathfinder::GetScore(std::unordered_map<size_t, float>& scoreMap, size_t i
     return it->second;
 }
 
-std::vector<glm::vec3> Pathfinder::ReconstructPath(NavigationMesh *navigationMesh, std::unordered_map<size_t, size_t>& cameFrom, size_t goal) {
+std::vector<glm::vec3> Pathfinder::ReconstructPath(NavigationMesh *navigationMesh, FrameUnorderedMap<size_t, size_t>& cameFrom, size_t goal) {
     std::vector<glm::vec3> totalPath = { navigationMesh->GetPosition(goal) };
 
     while (true) {
@@ -17,6 +17,8 @@
 #include "StateManager.h"
 #include "Physics/CollisionGroups.h"
 #include "Content/ContentManager.h"
+#include "../Events/EventBus.h"
+#include "Jobs/JobSystem.h"
 #include <iostream>
 
 using namespace std;
@@ -44,7 +46,6 @@ Physics::~Physics() {
     pxMaterial->release();
     pxCooking->release();
     pxScene->release();
-    pxDispatcher->release();
     pxPhysics->release();
     PxPvdTransport* transport = pxPvd->getTransport();
     pxPvd->release();
@@ -64,6 +65,10 @@ physx::PxScene& Physics::GetScene() const {
     return *pxScene;
 }
 
+SpatialIndex& Physics::GetSpatialIndex() {
+    return spatialIndex;
+}
+
 const PxVehiclePadSmoothingData Physics::gPadSmoothingData =
 {
     {
@@ -124,9 +129,8 @@ void Physics::Initialize() {
     PxSceneDesc sceneDesc(pxPhysics->getTolerancesScale());
     sceneDesc.gravity = PxVec3(0.0f, -9.81f, 0.0f) * 2.f;
 
-    const PxU32 numWorkers = 3;
-    pxDispatcher = PxDefaultCpuDispatcherCreate(numWorkers);
-    sceneDesc.cpuDispatcher = pxDispatcher;
+    // Share the engine's worker threads instead of creating a separate pool
+    sceneDesc.cpuDispatcher = &JobSystem::Instance();
     sceneDesc.filterShader = CollisionGroups::FilterShader;
 
     pxScene = pxPhysics->createScene(sceneDesc);
@@ -167,8 +171,9 @@ void Physics::Update() {
     const PxF32 timestep = 1.0f / 60.0f;
 
     //Raycasts.
-    vector<Component*> vehicleComponents = EntityManager::GetComponents(ComponentType_Vehicle);
-    vector<PxVehicleWheels*> vehicles;
+    const FrameVector<Component*> vehicleComponents = EntityManager::GetComponents(ComponentType_Vehicle);
+    FrameVector<PxVehicleWheels*> vehicles;
+    vehicles.reserve(vehicleComponents.size());
     for (Component* component : vehicleComponents) {
         VehicleComponent* vehicle = static_cast<VehicleComponent*>(component);
         vehicles.push_back(vehicle->pxVehicle);
@@ -188,7 +193,8 @@ void Physics::Update() {
     //Vehicle update.
     const PxVec3 grav = pxScene->getGravity();
     PxWheelQueryResult wheelQueryResults[PX_MAX_NB_WHEELS];
-    vector<PxVehicleWheelQueryResult> vehicleQueryResults;
+    FrameVector<PxVehicleWheelQueryResult> vehicleQueryResults;
+    vehicleQueryResults.reserve(vehicles.size());
     for (PxVehicleWheels* vehicle : vehicles) {
         vehicleQueryResults.push_back({ wheelQueryResults, vehicle->mWheelsSimData.getNbWheels() });
     }
@@ -214,18 +220,23 @@ void Physics::Update() {
     PxActor** activeActors = pxScene->getActiveActors(nbActiveActors);
 
     // Update each render object with the new transform
-    vector<Component*> navMeshUpdate;
+    FrameVector<Component*> navMeshUpdate;
     for (PxU32 i = 0; i < nbActiveActors; ++i) {
         PxRigidActor* activeActor = static_cast<PxRigidActor*>(activeActors[i]);
 
         Component* component = static_cast<Component*>(activeActor->userData);
         if (component != NULL && !component->GetEntity()->IsMarkedForDeletion()) {
-            component->UpdateFromPhysics(activeActor->getGlobalPose());
+            const PxTransform pose = activeActor->getGlobalPose();
+            component->UpdateFromPhysics(pose);
+            spatialIndex.Update(static_cast<RigidbodyComponent*>(component), Transform::FromPx(pose.p));
 
             if (component->GetType() != ComponentType_Vehicle) navMeshUpdate.push_back(component);
         }
     }
 
+    // Deliver events raised during the step while the entities they refer to still exist
+    EventBus::Instance().Dispatch();
+
     ClearDeleteList();
 
 	Game::Instance().GetNavigationMesh()->UpdateMesh(navMeshUpdate);
@@ -6,6 +6,7 @@
 #include "Physics/CollisionCallback.h"
 #include "PxPhysicsAPI.h"
 #include "Physics/VehicleSceneQuery.h"
+#include "Physics/SpatialIndex.h"
 #include <unordered_set>
 
 #include <unordered_set>
@@ -21,6 +22,7 @@ public:
     physx::PxPhysics& GetApi() const;
     physx::PxCooking& GetCooking() const;
     physx::PxScene& GetScene() const;
+    SpatialIndex& GetSpatialIndex();
 
     void Initialize();
 
@@ -39,6 +41,8 @@ private:
 	CollisionCallback collisionCallbackInstance;
 	std::unordered_set<Entity*> toDelete;
 
+    SpatialIndex spatialIndex;
+
     void InitializeVehicles();
 
     static const PxVehiclePadSmoothingData gPadSmoothingData;
@@ -52,7 +56,6 @@ private:
     physx::PxFoundation* pxFoundation = NULL;
     physx::PxPhysics* pxPhysics = NULL;
     
-    physx::PxDefaultCpuDispatcher* pxDispatcher = NULL;
     physx::PxScene* pxScene = NULL;
 
     physx::PxCooking* pxCooking = NULL;
@@ -12,6 +12,9 @@
 #include "PennerEasing/Linear.h"
 #include "../../Components/ParticleEmitterComponent.h"
 #include "PennerEasing/Back.h"
+#include "../../Events/EventBus.h"
+#include "../../Events/GameEvents.h"
+#include "../Game.h"
 
 void HandleMissileCollision(Entity* _actor0, Entity* _actor1) {
 	if (_actor0->HasTag("Missile")) {
@@ -21,7 +24,7 @@ void HandleMissileCollision(Entity* _actor0, Entity* _actor1) {
 
             const glm::vec3 pos = _actor0->transform.GetGlobalPosition();
 			const float explosionRadius = missile->GetExplosionRadius();
-            Audio::Instance().PlayAudio3D(Audio::Instance().Weapons.explosion, pos, glm::vec3(0.f, 0.f, 0.f), 2.f);
+            Audio::Instance().PlayAudio3D(Audio::Instance().Weapons.explosion, pos, glm::vec3(0.f, 0.f, 0.f), 2.f, VoicePriority_High);
 
 		    Entity* explosionEffect = ContentManager::LoadEntity("ExplosionEffect.json");
             explosionEffect->transform.SetPosition(_actor0->transform.GetGlobalPosition());
@@ -31,35 +34,39 @@ void HandleMissileCollision(Entity* _actor0, Entity* _actor1) {
                 constexpr float power = 150.f;
                 
                 auto tweenIn = Effects::Instance().CreateTween<float, easing::Quint::easeOut>(0.f, power, 0.2, StateManager::gameTime);
-                tweenIn->SetUpdateCallback([light](float& value) mutable {
+                tweenIn.SetUpdateCallback([light](float& value) mutable {
                     light->SetPower(value);
                 });
 
                 auto tweenOut = Effects::Instance().CreateTween<float, easing::Quint::easeIn>(power, 0.f, 0.1, StateManager::gameTime);
-                tweenOut->SetUpdateCallback([light](float& value) mutable {
+                tweenOut.SetUpdateCallback([light](float& value) mutable {
                     light->SetPower(value);
                 });
 
-                tweenIn->SetNext(tweenOut);
-                tweenIn->Start();
+                tweenIn.SetNext(tweenOut);
+                tweenIn.Start();
             }
             
 		    ParticleEmitterComponent* emitter = explosionEffect->GetComponent<ParticleEmitterComponent>();
             auto tween = Effects::Instance().CreateTween<float, easing::Linear::easeNone>(0.f, 1.f, emitter->GetLifetimeSeconds(), StateManager::gameTime);
-            tween->SetFinishedCallback([explosionEffect, _actor0](float& value) mutable {
+            tween.SetFinishedCallback([explosionEffect, _actor0](float& value) mutable {
                 Physics::Instance().AddToDelete(_actor0);
                 EntityManager::DestroyEntity(explosionEffect);
             });
-            tween->Start();
+            tween.Start();
 
-			vector<Component*> carComponents = EntityManager::GetComponents(ComponentType_Vehicle);
-			for (Component* component : carComponents) {
-				if (glm::length(component->GetEntity()->transform.GetGlobalPosition() - _actor0->transform.GetGlobalPosition()) < explosionRadius) {
-					RocketLauncherComponent* weapon = _actor0->GetComponent<MissileComponent>()->GetOwner()->GetComponent<RocketLauncherComponent>();
+			RocketLauncherComponent* weapon = missile->GetOwner()->GetComponent<RocketLauncherComponent>();
+			const float missileDamage = missile->GetDamage();
+
+			SpatialQueryFilter filter;
+			filter.tag = "Vehicle";
+			for (Entity* car : Physics::Instance().GetSpatialIndex().QueryRadius(pos, explosionRadius, filter)) {
+				PlayerData* player = Game::GetPlayerFromEntity(car);
+				VehicleComponent* component = player ? player->vehicle : nullptr;
+				if (component) {
 					//Take Damage Equal to damage / 1 + distanceFromExplosion?
-					float missileDamage = _actor0->GetComponent<MissileComponent>()->GetDamage();
 					float damageToTake = missileDamage - (15.0f * (glm::length(component->GetEntity()->transform.GetGlobalPosition() - _actor0->transform.GetGlobalPosition())));
-					static_cast<VehicleComponent*>(component)->pxVehicle->getRigidDynamicActor()->addForce(Transform::ToPx(glm::normalize(component->GetEntity()->transform.GetGlobalPosition() - _actor0->transform.GetGlobalPosition()) * 20000.0f), PxForceMode::eIMPULSE, true);
+					component->pxVehicle->getRigidDynamicActor()->addForce(Transform::ToPx(glm::normalize(component->GetEntity()->transform.GetGlobalPosition() - _actor0->transform.GetGlobalPosition()) * 20000.0f), PxForceMode::eIMPULSE, true);
 					component->TakeDamage(weapon, damageToTake);
 				}
 			}
@@ -96,4 +103,9 @@ void CollisionCallback::onContact(const physx::PxContactPairHeader& pairHeader,
 
     actor0RB->OnContact(actor1RB);
     actor1RB->OnContact(actor0RB);
+
+    CollisionEvent event;
+    event.actor0 = actor0RB->GetEntity();
+    event.actor1 = actor1RB->GetEntity();
+    EventBus::Instance().Publish(event);
 }
@@ -0,0 +1,216 @@
+#include "SpatialIndex.h"
+
+#include "../../Entities/Entity.h"
+#include "../../Components/RigidbodyComponents/RigidbodyComponent.h"
+#include <algorithm>
+#include <climits>
+
+SpatialIndex::SpatialIndex(float _cellSize) : cellSize(_cellSize),
+    minCellX(INT_MAX), minCellZ(INT_MAX), maxCellX(INT_MIN), maxCellZ(INT_MIN) {}
+
+void SpatialIndex::Insert(RigidbodyComponent* body, glm::vec3 position) {
+    if (entries.find(body) != entries.end()) return Update(body, position);
+
+    Entry entry;
+    entry.body = body;
+    entry.position = position;
+    entry.cell = GetCellKey(GetCellCoordinate(position.x), GetCellCoordinate(position.z));
+    entry.team = -1;
+    entries[body] = entry;
+
+    AddToCell(entry.cell, body);
+}
+
+void SpatialIndex::Remove(RigidbodyComponent* body) {
+    const auto it = entries.find(body);
+    if (it == entries.end()) return;
+
+    RemoveFromCell(it->second.cell, body);
+    entries.erase(it);
+}
+
+void SpatialIndex::Update(RigidbodyComponent* body, glm::vec3 position) {
+    const auto it = entries.find(body);
+    if (it == entries.end()) return;
+
+    Entry& entry = it->second;
+    entry.position = position;
+
+    // Only touch the cells when the body actually crossed into a new one
+    const long long cell = GetCellKey(GetCellCoordinate(position.x), GetCellCoordinate(position.z));
+    if (cell != entry.cell) {
+        RemoveFromCell(entry.cell, body);
+        AddToCell(cell, body);
+        entry.cell = cell;
+    }
+}
+
+void SpatialIndex::Clear() {
+    entries.clear();
+    cells.clear();
+    minCellX = minCellZ = INT_MAX;
+    maxCellX = maxCellZ = INT_MIN;
+}
+
+void SpatialIndex::SetTeam(RigidbodyComponent* body, int team) {
+    const auto it = entries.find(body);
+    if (it != entries.end()) it->second.team = team;
+}
+
+size_t SpatialIndex::GetCount() const {
+    return entries.size();
+}
+
+float SpatialIndex::GetCellSize() const {
+    return cellSize;
+}
+
+template <typename F>
+void SpatialIndex::VisitCells(glm::vec3 center, float halfExtent, F visit) const {
+    const int minX = glm::max(GetCellCoordinate(center.x - halfExtent), minCellX);
+    const int maxX = glm::min(GetCellCoordinate(center.x + halfExtent), maxCellX);
+    const int minZ = glm::max(GetCellCoordinate(center.z - halfExtent), minCellZ);
+    const int maxZ = glm::min(GetCellCoordinate(center.z + halfExtent), maxCellZ);
+
+    for (int x = minX; x <= maxX; ++x) {
+        for (int z = minZ; z <= maxZ; ++z) {
+            const auto it = cells.find(GetCellKey(x, z));
+            if (it == cells.end()) continue;
+            for (RigidbodyComponent* body : it->second) {
+                visit(entries.at(body));
+            }
+        }
+    }
+}
+
+FrameVector<Entity*> SpatialIndex::QueryRadius(glm::vec3 center, float radius, const SpatialQueryFilter& filter) const {
+    FrameVector<Entity*> results;
+    const float radiusSquared = radius * radius;
+    VisitCells(center, radius, [&](const Entry& entry) {
+        const glm::vec3 offset = entry.position - center;
+        if (glm::dot(offset, offset) < radiusSquared && Matches(entry, filter)) {
+            results.push_back(entry.body->GetEntity());
+        }
+    });
+    return results;
+}
+
+FrameVector<Entity*> SpatialIndex::QueryNearest(glm::vec3 center, size_t k, float maxRadius, const SpatialQueryFilter& filter) const {
+    FrameVector<Entity*> results;
+    if (k == 0 || entries.empty()) return results;
+
+    FrameVector<std::pair<float, Entity*>> found;
+    const float maxRadiusSquared = maxRadius * maxRadius;
+    const int centerX = GetCellCoordinate(center.x);
+    const int centerZ = GetCellCoordinate(center.z);
+
+    // Search rings of cells outwards from the center cell. Anything in ring r + 1 is at least r cells away,
+    // so we can stop once we have k results closer than that.
+    for (int ring = 0; ; ++ring) {
+        for (int x = centerX - ring; x <= centerX + ring; ++x) {
+            const bool edgeColumn = x == centerX - ring || x == centerX + ring;
+            for (int z = centerZ - ring; z <= centerZ + ring; z += edgeColumn ? 1 : 2 * ring) {
+                const auto it = cells.find(GetCellKey(x, z));
+                if (it != cells.end()) {
+                    for (RigidbodyComponent* body : it->second) {
+                        const Entry& entry = entries.at(body);
+                        const glm::vec3 offset = entry.position - center;
+                        const float distanceSquared = glm::dot(offset, offset);
+                        if (distanceSquared <= maxRadiusSquared && Matches(entry, filter)) {
+                            found.push_back(std::make_pair(distanceSquared, entry.body->GetEntity()));
+                        }
+                    }
+                }
+                if (ring == 0) break;
+            }
+        }
+
+        const float searchedDistance = ring * cellSize;
+        if (found.size() >= k) {
+            std::nth_element(found.begin(), found.begin() + (k - 1), found.end());
+            if (found[k - 1].first <= searchedDistance * searchedDistance) break;
+        }
+        if (searchedDistance > maxRadius) break;
+        if (centerX - ring <= minCellX && centerX + ring >= maxCellX &&
+            centerZ - ring <= minCellZ && centerZ + ring >= maxCellZ) break;
+    }
+
+    std::sort(found.begin(), found.end(), [](const std::pair<float, Entity*>& a, const std::pair<float, Entity*>& b) {
+        return a.first < b.first;
+    });
+    if (found.size() > k) found.resize(k);
+
+    results.reserve(found.size());
+    for (const auto& pair : found) results.push_back(pair.second);
+    return results;
+}
+
+FrameVector<Entity*> SpatialIndex::QueryCone(glm::vec3 origin, glm::vec3 direction, float halfAngle, float range, const SpatialQueryFilter& filter) const {
+    FrameVector<std::pair<float, Entity*>> found;
+    const glm::vec3 axis = glm::normalize(direction);
+    const float minDot = cos(halfAngle);
+    const float rangeSquared = range * range;
+    VisitCells(origin, range, [&](const Entry& entry) {
+        const glm::vec3 offset = entry.position - origin;
+        const float distanceSquared = glm::dot(offset, offset);
+        if (distanceSquared >= rangeSquared || distanceSquared <= 0.f) return;
+
+        const float alignment = glm::dot(axis, offset / sqrt(distanceSquared));
+        if (alignment >= minDot && Matches(entry, filter)) {
+            found.push_back(std::make_pair(alignment, entry.body->GetEntity()));
+        }
+    });
+
+    std::sort(found.begin(), found.end(), [](const std::pair<float, Entity*>& a, const std::pair<float, Entity*>& b) {
+        return a.first > b.first;
+    });
+
+    FrameVector<Entity*> results;
+    results.reserve(found.size());
+    for (const auto& pair : found) results.push_back(pair.second);
+    return results;
+}
+
+long long SpatialIndex::GetCellKey(int x, int z) const {
+    return (static_cast<long long>(x) << 32) | static_cast<unsigned int>(z);
+}
+
+int SpatialIndex::GetCellCoordinate(float value) const {
+    // Clamp so that unbounded queries don't overflow the cell coordinates
+    constexpr float limit = static_cast<float>(INT_MAX / 2);
+    return static_cast<int>(floor(glm::clamp(value / cellSize, -limit, limit)));
+}
+
+void SpatialIndex::AddToCell(long long cell, RigidbodyComponent* body) {
+    cells[cell].push_back(body);
+
+    const int x = static_cast<int>(cell >> 32);
+    const int z = static_cast<int>(static_cast<unsigned int>(cell & 0xFFFFFFFF));
+    minCellX = glm::min(minCellX, x);
+    minCellZ = glm::min(minCellZ, z);
+    maxCellX = glm::max(maxCellX, x);
+    maxCellZ = glm::max(maxCellZ, z);
+}
+
+void SpatialIndex::RemoveFromCell(long long cell, RigidbodyComponent* body) {
+    const auto it = cells.find(cell);
+    if (it == cells.end()) return;
+
+    std::vector<RigidbodyComponent*>& bodies = it->second;
+    const auto it2 = std::find(bodies.begin(), bodies.end(), body);
+    if (it2 != bodies.end()) {
+        *it2 = bodies.back();
+        bodies.pop_back();
+    }
+    if (bodies.empty()) cells.erase(it);
+}
+
+bool SpatialIndex::Matches(const Entry& entry, const SpatialQueryFilter& filter) const {
+    Entity* entity = entry.body->GetEntity();
+    if (!entity || entity == filter.exclude || entity->IsMarkedForDeletion()) return false;
+    if (filter.team >= 0 && entry.team != filter.team) return false;
+    if (filter.excludeTeam >= 0 && entry.team == filter.excludeTeam) return false;
+    if (!filter.tag.empty() && !entity->HasTag(filter.tag)) return false;
+    if (filter.accept && !filter.accept(entity)) return false;
+    return true;
+}
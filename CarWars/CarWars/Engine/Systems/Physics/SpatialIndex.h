@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../Memory/FrameAllocator.h"
+#include <glm/glm.hpp>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class Entity;
+class RigidbodyComponent;
+
+struct SpatialQueryFilter {
+    SpatialQueryFilter() : team(-1), excludeTeam(-1), exclude(nullptr), accept(nullptr) {}
+
+    std::string tag;            // Only entities with this tag (empty matches any tag)
+    int team;                   // Only entities on this team (-1 matches any team)
+    int excludeTeam;            // Skip entities on this team (-1 skips none)
+    Entity* exclude;            // Skip this entity (usually the one doing the query)
+    bool (*accept)(Entity*);    // Optional extra test run after the cheaper filters
+};
+
+// Loose uniform grid over the XZ plane holding the position of every rigidbody in the scene.
+// Dynamic bodies are refreshed from the PhysX active actors list, so bodies at rest cost nothing.
+class SpatialIndex {
+public:
+    explicit SpatialIndex(float _cellSize = 20.f);
+
+    void Insert(RigidbodyComponent* body, glm::vec3 position);
+    void Remove(RigidbodyComponent* body);
+    void Update(RigidbodyComponent* body, glm::vec3 position);
+    void Clear();
+
+    void SetTeam(RigidbodyComponent* body, int team);
+
+    size_t GetCount() const;
+    float GetCellSize() const;
+
+    // Results live in frame memory, so they must not be kept past the current frame
+
+    // All matching entities within radius of center (unordered)
+    FrameVector<Entity*> QueryRadius(glm::vec3 center, float radius, const SpatialQueryFilter& filter = SpatialQueryFilter()) const;
+
+    // Up to k matching entities within maxRadius of center, closest first
+    FrameVector<Entity*> QueryNearest(glm::vec3 center, size_t k, float maxRadius = INFINITY, const SpatialQueryFilter& filter = SpatialQueryFilter()) const;
+
+    // All matching entities within range of origin and halfAngle radians of direction, most aligned first
+    FrameVector<Entity*> QueryCone(glm::vec3 origin, glm::vec3 direction, float halfAngle, float range, const SpatialQueryFilter& filter = SpatialQueryFilter()) const;
+
+private:
+    struct Entry {
+        RigidbodyComponent* body;
+        glm::vec3 position;
+        long long cell;
+        int team;
+    };
+
+    long long GetCellKey(int x, int z) const;
+    int GetCellCoordinate(float value) const;
+
+    void AddToCell(long long cell, RigidbodyComponent* body);
+    void RemoveFromCell(long long cell, RigidbodyComponent* body);
+
+    bool Matches(const Entry& entry, const SpatialQueryFilter& filter) const;
+
+    // Calls visit on every entry in the cells overlapping the square of the given half extent around center
+    template <typename F>
+    void VisitCells(glm::vec3 center, float halfExtent, F visit) const;
+
+    float cellSize;
+
+    // Bounds of all cells ever occupied, used to stop expanding nearest-neighbour searches
+    int minCellX, minCellZ;
+    int maxCellX, maxCellZ;
+
+    std::unordered_map<RigidbodyComponent*, Entry> entries;
+    std::unordered_map<long long, std::vector<RigidbodyComponent*>> cells;
+};
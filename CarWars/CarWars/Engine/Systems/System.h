@@ -1,9 +1,41 @@
 #pragma once
 #include "Time.h"
 
+// Shared state touched by a system's Update, used by the SystemScheduler to find systems that can run at the same time
+enum SystemResource {
+	SystemResource_Input = 1 << 0,
+	SystemResource_GameState = 1 << 1,
+	SystemResource_Entities = 1 << 2,
+	SystemResource_Physics = 1 << 3,
+	SystemResource_Navigation = 1 << 4,
+	SystemResource_Tweens = 1 << 5,
+	SystemResource_Events = 1 << 6,
+	SystemResource_Render = 1 << 7,
+	SystemResource_Audio = 1 << 8,
+	SystemResource_Content = 1 << 9,
+
+	SystemResource_All = 0xFFFFFFFF
+};
+
+struct SystemAccess {
+	SystemAccess(unsigned int _reads = SystemResource_All, unsigned int _writes = SystemResource_All, bool _mainThreadOnly = true)
+		: reads(_reads), writes(_writes), mainThreadOnly(_mainThreadOnly) {}
+
+	bool ConflictsWith(const SystemAccess& other) const {
+		return (writes & (other.reads | other.writes)) != 0 || (other.writes & reads) != 0;
+	}
+
+	unsigned int reads;
+	unsigned int writes;
+	bool mainThreadOnly;		// Must run on the thread that owns the GL context and window
+};
+
 class System {
 public:
 	virtual void Update() = 0;
 
+	// By default a system may touch anything and must run on the main thread, so it always runs on its own
+	virtual SystemAccess GetAccess() const { return SystemAccess(); }
+
 private:
 };
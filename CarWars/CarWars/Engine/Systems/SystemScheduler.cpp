@@ -0,0 +1,74 @@
+#include "SystemScheduler.h"
+#include "Jobs/JobSystem.h"
+
+void SystemScheduler::AddSystem(System* system) {
+	AddSystem(system, [system]() { system->Update(); });
+}
+
+void SystemScheduler::AddSystem(System* system, std::function<void()> update) {
+	Entry entry;
+	entry.system = system;
+	entry.update = update;
+	entries.push_back(entry);
+}
+
+void SystemScheduler::BuildPhases() {
+	phases.clear();
+	for (Entry& entry : entries) {
+		entry.access = entry.system->GetAccess();
+	}
+
+	bool phaseHasMainThread = false;
+	for (size_t i = 0; i < entries.size(); ++i) {
+		const SystemAccess& access = entries[i].access;
+
+		// A system joins the current phase only if it can run alongside everything already in it
+		bool fits = !phases.empty() && !(access.mainThreadOnly && phaseHasMainThread);
+		if (fits) {
+			for (size_t j : phases.back()) {
+				if (access.ConflictsWith(entries[j].access)) {
+					fits = false;
+					break;
+				}
+			}
+		}
+
+		if (!fits) {
+			phases.push_back(std::vector<size_t>());
+			phaseHasMainThread = false;
+		}
+		phases.back().push_back(i);
+		phaseHasMainThread |= access.mainThreadOnly;
+	}
+}
+
+void SystemScheduler::Update() {
+	// Accesses can change from frame to frame (e.g. when debug tools are opened), and there are only a handful of systems
+	BuildPhases();
+
+	JobSystem& jobSystem = JobSystem::Instance();
+	for (const std::vector<size_t>& phase : phases) {
+		if (phase.size() == 1) {
+			entries[phase[0]].update();
+			continue;
+		}
+
+		// Hand the other systems to the workers and run the main thread one (if any) here
+		JobCounter counter;
+		Entry* mainThreadEntry = nullptr;
+		for (size_t index : phase) {
+			Entry& entry = entries[index];
+			if (entry.access.mainThreadOnly) {
+				mainThreadEntry = &entry;
+			} else {
+				jobSystem.Run(entry.update, &counter);
+			}
+		}
+		if (mainThreadEntry) mainThreadEntry->update();
+		jobSystem.Wait(counter);
+	}
+}
+
+size_t SystemScheduler::GetPhaseCount() const {
+	return phases.size();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "System.h"
+#include <functional>
+#include <vector>
+
+// Runs systems in the order they were added, grouping neighbouring systems whose declared accesses don't conflict
+// into phases. Systems in the same phase run at the same time on the job system, at most one of them on the main thread.
+class SystemScheduler {
+public:
+	void AddSystem(System* system);
+
+	// Use update instead of System::Update, e.g. to step the system several times per frame
+	void AddSystem(System* system, std::function<void()> update);
+
+	void Update();
+
+	size_t GetPhaseCount() const;
+
+private:
+	struct Entry {
+		System* system;
+		std::function<void()> update;
+		SystemAccess access;
+	};
+
+	void BuildPhases();
+
+	std::vector<Entry> entries;
+	std::vector<std::vector<size_t>> phases;
+};
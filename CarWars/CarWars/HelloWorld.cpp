@@ -12,23 +12,88 @@
 #include "Engine/Systems/Physics/CollisionGroups.h"
 #include "Engine/Systems/Content/ContentManager.h"
 #include "Engine/Systems/Effects.h"
+#include "Engine/Events/EventBus.h"
+#include "Engine/Systems/SystemScheduler.h"
+#include "Engine/Systems/Jobs/JobSystem.h"
+#include "Engine/Systems/Memory/FrameAllocator.h"
+#include "Engine/Systems/Content/MeshImporter.h"
+#include "Engine/Systems/Content/TextureBaker.h"
+#include "Engine/Systems/Content/MapBaker.h"
+#include "Engine/Systems/Content/ContentStreamer.h"
+#include "Engine/Systems/Content/StartupProfile.h"
+#include "Engine/Systems/Graphics/OcclusionBenchmark.h"
+#include "Engine/Systems/Graphics/RenderStateCheck.h"
+#include "Engine/Systems/Graphics/BloomChainCheck.h"
+#include "Engine/Systems/Graphics/ResolutionScalerCheck.h"
 
 using namespace std;
 
-int main() {
-	//Declare System Vector
-	vector<System*> systems;
+int main(int argc, char* argv[]) {
+	// Offline content tools run instead of the game
+	if (argc > 1 && string(argv[1]) == "--convert-meshes") {
+		return MeshImporter::ConvertDirectory(ContentManager::MESH_DIR_PATH) ? 0 : 1;
+	}
+	if (argc > 1 && string(argv[1]) == "--bake-textures") {
+		const bool compress = !(argc > 2 && string(argv[2]) == "--uncompressed");
+		return TextureBaker::BakeDirectory(ContentManager::TEXTURE_DIR_PATH, compress) ? 0 : 1;
+	}
+	if (argc > 1 && string(argv[1]) == "--bake-maps") {
+		// Cooking the collision meshes needs PhysX, which needs the worker threads
+		JobSystem::Instance().Initialize();
+		Physics::Instance().Initialize();
+		return MapBaker::BakeAll() ? 0 : 1;
+	}
+	if (argc > 1 && string(argv[1]) == "--benchmark-occlusion") {
+		return OcclusionBenchmark::RunAll() ? 0 : 1;
+	}
+	if (argc > 1 && string(argv[1]) == "--check-render-state") {
+		return RenderStateCheck::Run() ? 0 : 1;
+	}
+	if (argc > 1 && string(argv[1]) == "--check-bloom") {
+		return BloomChainCheck::Run() ? 0 : 1;
+	}
+	if (argc > 1 && string(argv[1]) == "--check-resolution") {
+		return ResolutionScalerCheck::Run() ? 0 : 1;
+	}
+
+	// Prints how long booting took, and with --startup-report also writes the time spent on every asset
+	const bool startupReport = argc > 1 && string(argv[1]) == "--startup-report";
+
+	// Create the frame allocator first so that it outlives every system that uses frame memory
+	FrameAllocator &frameAllocator = FrameAllocator::Instance();
+
+	// Start the worker threads (MUST come before Physics, which uses them as its CPU dispatcher)
+	JobSystem &jobSystem = JobSystem::Instance();
+	jobSystem.Initialize();
+	StartupProfile::EndPhase("Job system");
 
 	// Initialize systems
 	// Initialize graphics (MUST come before Game)
 	Graphics &graphicsManager = Graphics::Instance();
 	graphicsManager.Initialize("Car Wars");
+	StartupProfile::EndPhase("Graphics");
+
+	// Start streaming content in the background (MUST come after Graphics and before Game), beginning with everything
+	// the menus and maps use so that it loads on the loader threads while the rest of the game boots
+	ContentStreamer &contentStreamer = ContentStreamer::Instance();
+	contentStreamer.Initialize();
+	contentStreamer.PreloadManifest();
+	StartupProfile::EndPhase("Content streamer");
 
     Effects &guiEffectsManager = Effects::Instance();
+
+    // Events are dispatched after each physics step and again once the game has updated
+    EventBus &eventBus = EventBus::Instance();
 	
 	// Initialize input
 	InputManager &inputManager = InputManager::Instance();
 
+    // Initialize audio. Its sounds decode in the background too.
+    Audio &audioManager = Audio::Instance();
+    audioManager.Initialize();
+    //audioManager.PlayAudio2D("Content/Music/unity.mp3");
+	StartupProfile::EndPhase("Audio");
+
     // Initialize physics (MUST come before Game)
     Physics &physicsManager = Physics::Instance();
     physicsManager.Initialize();
@@ -36,31 +101,45 @@ int main() {
     // Load and initialize collision groups (MUST come before Game)
     ContentManager::LoadCollisionGroups("Vehicles.json");
     CollisionGroups::InitializeMasks();     // MUST come after all collision groups have been loaded
+	StartupProfile::EndPhase("Physics");
 
     // Initialize game
     Game &gameManager = Game::Instance();
     gameManager.Initialize();
+	StartupProfile::EndPhase("Game");
 
-    // Initialize audio
-    Audio &audioManager = Audio::Instance();
-    audioManager.Initialize();
-    //audioManager.PlayAudio2D("Content/Music/unity.mp3");
-
+	// Wait for the background loads so that the main menu's first frame is complete
+	contentStreamer.Flush();
+	audioManager.FinishLoading();
+	StartupProfile::EndPhase("Preloading");
+	StartupProfile::Finish(startupReport ? "StartupReport.csv" : "");
 
-	// Add systems in desired order
-	systems.push_back(&inputManager);
-	systems.push_back(&physicsManager);
-	systems.push_back(&gameManager);
-	systems.push_back(&guiEffectsManager);
-	systems.push_back(&graphicsManager);
-    systems.push_back(&audioManager);
 
     // Define the fixed physics time step
     constexpr double physicsTimeStep = 1.0 / 60.0;
     Time physicsTime;
 
+	// Add systems in desired order. Neighbouring systems that don't touch the same data run at the same time.
+	SystemScheduler scheduler;
+	scheduler.AddSystem(&inputManager);
+	scheduler.AddSystem(&physicsManager, [&physicsManager, &physicsTime, physicsTimeStep]() {
+		while (physicsTime < StateManager::globalTime) {
+			physicsTime += physicsTimeStep;
+			physicsManager.Update();
+		}
+	});
+	scheduler.AddSystem(&gameManager);
+	scheduler.AddSystem(&eventBus);
+	scheduler.AddSystem(&guiEffectsManager);
+	scheduler.AddSystem(&contentStreamer);
+	scheduler.AddSystem(&graphicsManager);
+	scheduler.AddSystem(&audioManager);
+
 	//Game Loop
 	while (!glfwWindowShouldClose(graphicsManager.GetWindow())) {
+		// Release last frame's transient memory
+		frameAllocator.BeginFrame();
+
 		//Calculate Delta Time
         const Time lastTime = StateManager::globalTime;
         StateManager::globalTime = glfwGetTime();
@@ -71,16 +150,7 @@ int main() {
 			StateManager::gameTime += StateManager::deltaTime;
 		}
 
-		// Iterate through each system and call their update methods
-        for (System* system : systems) {
-            if (system != &physicsManager) {
-                system->Update();
-            } else {
-                while (physicsTime < StateManager::globalTime) {
-                    physicsTime += physicsTimeStep;
-                    system->Update();
-                }
-            }
-		}
+		// Update each system
+		scheduler.Update();
 	}
 }